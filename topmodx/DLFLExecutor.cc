@@ -0,0 +1,77 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#include "DLFLExecutor.hh"
+
+#include <DLFLProfile.hh>
+
+DLFLExecutor::DLFLExecutor( QObject *parent )
+	: QThread(parent), mOperation(NULL), mObject(), mProgress(), mName(), mProfileName("") {
+}
+
+DLFLExecutor::~DLFLExecutor( ) {
+	// Don't leave the thread running on an object which is about to go away
+	if ( isRunning() ) {
+		mProgress.cancel();
+		wait();
+	}
+	delete mOperation;
+}
+
+bool DLFLExecutor::execute( DLFLOperation *op, const DLFLObject& obj, const QString& name ) {
+	if ( isBusy() ) {
+		delete op;
+		return false;
+	}
+	mOperation = op;
+	mName = name;
+	mProfileName = DLFLProfiler::instance().intern(string(name.toLocal8Bit().constData()));
+	mProgress.reset();
+
+	// The copy is made here, on the calling thread, since copying sets the
+	// index fields of the original. It keeps the element order and holds what
+	// an undo state holds
+	mObject.reset();
+	mObject.appendCopy(obj);
+
+	start();
+	return true;
+}
+
+void DLFLExecutor::release( ) {
+	if ( isRunning() ) return;
+	delete mOperation; mOperation = NULL;
+	mObject.reset();
+}
+
+void DLFLExecutor::run( ) {
+	DLFLProgressScope scope(&mProgress);
+	DLFLProfileScope profile(mProfileName);
+	mOperation->run(&mObject);
+}
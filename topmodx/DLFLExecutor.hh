@@ -0,0 +1,155 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifndef _DLFL_EXECUTOR_HH_
+#define _DLFL_EXECUTOR_HH_
+
+// Runs long operations on a worker thread. The operation works on a private
+// copy of the object made when it is started, so the viewports keep drawing
+// the original meanwhile. When the thread is done the finished() signal is
+// emitted and the owner swaps the result into its object (see
+// DLFLObject::swap), or throws it away if the operation was cancelled.
+// Progress and cancellation go through a DLFLProgress installed for the
+// worker thread, which the dlflaux algorithms report to.
+
+#include <DLFLObject.hh>
+#include <DLFLProgress.hh>
+
+#include <QThread>
+#include <QString>
+
+using namespace DLFL;
+
+// An operation on an object. The arguments are copied when it is created
+class DLFLOperation {
+public :
+	virtual ~DLFLOperation( ) { }
+	virtual void run( DLFLObjectPtr obj ) = 0;
+};
+
+// Operations calling a dlflaux function with up to 3 arguments after the
+// object. Create them with makeOperation()
+template <class R>
+class DLFLOperation0 : public DLFLOperation {
+	R (*func)(DLFLObjectPtr);
+public :
+	DLFLOperation0( R (*f)(DLFLObjectPtr) ) : func(f) { }
+	void run( DLFLObjectPtr obj ) { func(obj); }
+};
+
+template <class R, class A1>
+class DLFLOperation1 : public DLFLOperation {
+	R (*func)(DLFLObjectPtr, A1);
+	A1 a1;
+public :
+	DLFLOperation1( R (*f)(DLFLObjectPtr, A1), A1 x1 ) : func(f), a1(x1) { }
+	void run( DLFLObjectPtr obj ) { func(obj,a1); }
+};
+
+template <class R, class A1, class A2>
+class DLFLOperation2 : public DLFLOperation {
+	R (*func)(DLFLObjectPtr, A1, A2);
+	A1 a1; A2 a2;
+public :
+	DLFLOperation2( R (*f)(DLFLObjectPtr, A1, A2), A1 x1, A2 x2 ) : func(f), a1(x1), a2(x2) { }
+	void run( DLFLObjectPtr obj ) { func(obj,a1,a2); }
+};
+
+template <class R, class A1, class A2, class A3>
+class DLFLOperation3 : public DLFLOperation {
+	R (*func)(DLFLObjectPtr, A1, A2, A3);
+	A1 a1; A2 a2; A3 a3;
+public :
+	DLFLOperation3( R (*f)(DLFLObjectPtr, A1, A2, A3), A1 x1, A2 x2, A3 x3 ) : func(f), a1(x1), a2(x2), a3(x3) { }
+	void run( DLFLObjectPtr obj ) { func(obj,a1,a2,a3); }
+};
+
+// The argument types are taken from the function only, so eg. a float can be
+// passed for a double parameter. Parameters must be passed by value
+template <class R>
+inline DLFLOperation * makeOperation( R (*f)(DLFLObjectPtr) ) {
+	return new DLFLOperation0<R>(f);
+}
+
+template <class R, class A1, class B1>
+inline DLFLOperation * makeOperation( R (*f)(DLFLObjectPtr, A1), const B1& x1 ) {
+	return new DLFLOperation1<R,A1>(f,x1);
+}
+
+template <class R, class A1, class A2, class B1, class B2>
+inline DLFLOperation * makeOperation( R (*f)(DLFLObjectPtr, A1, A2), const B1& x1, const B2& x2 ) {
+	return new DLFLOperation2<R,A1,A2>(f,x1,x2);
+}
+
+template <class R, class A1, class A2, class A3, class B1, class B2, class B3>
+inline DLFLOperation * makeOperation( R (*f)(DLFLObjectPtr, A1, A2, A3), const B1& x1, const B2& x2, const B3& x3 ) {
+	return new DLFLOperation3<R,A1,A2,A3>(f,x1,x2,x3);
+}
+
+class DLFLExecutor : public QThread {
+	Q_OBJECT
+
+public :
+
+	DLFLExecutor( QObject *parent = 0 );
+	~DLFLExecutor( );
+
+	// Start running the operation on a copy of the object. Takes over the
+	// operation. Returns false, and deletes the operation, if one is running already
+	bool execute( DLFLOperation *op, const DLFLObject& obj, const QString& name );
+
+	bool isBusy( ) const { return mOperation != NULL; }
+	const QString& name( ) const { return mName; }
+
+	// Progress of the running operation, may be read while it runs
+	const DLFLProgress& progress( ) const { return mProgress; }
+
+	// Ask the running operation to stop. It ends with the next step it reports
+	void cancel( ) { mProgress.cancel(); }
+	bool wasCancelled( ) const { return mProgress.isCancelled(); }
+
+	// The changed copy, once finished() was emitted. Swap it with the object
+	// and call release() to free what is left
+	DLFLObject& result( ) { return mObject; }
+
+	// Free the copy and the operation, after which a new one can be started
+	void release( );
+
+protected :
+
+	void run( );
+
+	DLFLOperation *mOperation;
+	DLFLObject mObject;                   // The copy the operation works on
+	DLFLProgress mProgress;
+	QString mName;
+	const char *mProfileName;             // Interned name for the profiler
+};
+
+#endif /* #ifndef _DLFL_EXECUTOR_HH_ */
@@ -32,6 +32,7 @@
 */
 
 #include "DLFLLighting.hh"
+#include <DLFLProfile.hh>
 
 void computeLighting( DLFLFacePtr fp, LightPtr lightptr, bool usegpu ) {
   if ( fp->front() ) {
@@ -91,6 +92,8 @@ void computeLighting( DLFLFacePtr fp, LightPtr lightptr, bool usegpu ) {
 }
 
 void computeLighting(DLFLObjectPtr obj, TMPatchObjectPtr po, LightPtr lightptr, bool usegpu) {
+	DLFLProfileScope profile("computeLighting");
+	long n = 0;
 		// std::cout<< "usegpu = " << usegpu << "\n";
 	// int patchsize = (po)?po->list().size():0;
 	// 
@@ -108,11 +111,12 @@ void computeLighting(DLFLObjectPtr obj, TMPatchObjectPtr po, LightPtr lightptr,
 		
     faceptr = (*first);
     computeLighting(faceptr,lightptr, usegpu);
-    ++first;
+    ++first; ++n;
   }
+  profile.setElements(n);
   if( po ) {
-    TMPatchFacePtrList patch_list = po->list( );
-    TMPatchFacePtrList::iterator pfirst = patch_list.begin(), plast = patch_list.end();
+    const TMPatchFacePtrList& patch_list = po->list( );
+    TMPatchFacePtrList::const_iterator pfirst = patch_list.begin(), plast = patch_list.end();
     TMPatchFacePtr pfp = NULL;
     while ( pfirst != plast ) {
 			// progress->setValue(progressvalue++);
@@ -121,6 +125,7 @@ void computeLighting(DLFLObjectPtr obj, TMPatchObjectPtr po, LightPtr lightptr,
       pfp = (*pfirst); ++pfirst;
       pfp->computeLighting(lightptr);
     }
+    po->updatePatchColors();
   }
 	// progress->setValue(obj->num_faces() + patchsize);
 }
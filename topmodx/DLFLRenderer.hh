@@ -51,6 +51,7 @@
 
 #include <DLFLObject.hh>
 #include "GeometryRenderer.hh"
+#include "SilhouetteExtractor.hh"
 #include "TMPatchObject.hh"
 
 #include "CgData.hh"
@@ -257,10 +258,11 @@ public :
     glPolygonMode(GL_FRONT_AND_BACK,GL_LINE);
     glColor4f(DLFLRenderer::mSilhouetteColor.redF(),DLFLRenderer::mSilhouetteColor.greenF(),DLFLRenderer::mSilhouetteColor.blueF(),DLFLRenderer::mSilhouetteColor.alphaF());
     glDepthRange(0.1,1.0);
+    // Only the edges between front and back facing faces are drawn
     if ( DLFLRenderer::reverse_object ) //object->renderEdges(mWireframeThickness);
-      gr->renderEdges( object, DLFLRenderer::mWireframeThickness );
+      SilhouetteExtractor::instance().render( object, DLFLRenderer::mWireframeThickness );
     else //object->renderEdges(mSilhouetteThickness);
-      gr->renderEdges( object, DLFLRenderer::mSilhouetteThickness );
+      SilhouetteExtractor::instance().render( object, DLFLRenderer::mSilhouetteThickness );
     glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
   };
 
@@ -9,7 +9,7 @@
 #endif // Q_WS_MAC
 
 DLFLScriptEditor::DLFLScriptEditor( DLFLObjectPtr obj, QWidget *parent, Qt::WindowFlags f ) 
-	: QWidget(parent), dlfl_module(NULL),dlfl_dict(NULL),mEchoing(true),pathPython(""),mTabWidth(3),addToPath(".") {
+	: QWidget(parent), dlfl_module(NULL),dlfl_dict(NULL),mMainThreadState(NULL),mOutputLineStart(true),mEchoing(true),pathPython(""),mTabWidth(3),addToPath(".") {
 
 	setMinimumSize( 350, 200 );
 
@@ -133,14 +133,42 @@ DLFLScriptEditor::DLFLScriptEditor( DLFLObjectPtr obj, QWidget *parent, Qt::Wind
 	CFRelease(macPath);
 #endif
 
+	// Script thread
+	mScriptThread = new DLFLScriptThread( &mObjectLock, this );
+	connect(mScriptThread, SIGNAL(commandStarted(QString)), this, SLOT(scriptCommandStarted(QString)));
+	connect(mScriptThread, SIGNAL(output(QString)), this, SLOT(scriptOutput(QString)));
+	connect(mScriptThread, SIGNAL(redrawRequested()), this, SLOT(scriptRedraw()));
+	connect(mScriptThread, SIGNAL(loadRequested(QString)), this, SLOT(scriptLoad(QString)));
+	connect(mScriptThread, SIGNAL(finished()), this, SLOT(scriptFinished()));
+
+	mScriptProgress = new QProgressDialog(this);
+	mScriptProgress->setWindowModality(Qt::WindowModal);
+	mScriptProgress->setCancelButtonText(tr("Interrupt"));
+	mScriptProgress->setRange(0,0);
+	mScriptProgress->setAutoClose(false);
+	mScriptProgress->setAutoReset(false);
+	mScriptProgress->reset();
+	connect(mScriptProgress, SIGNAL(canceled()), this, SLOT(interruptScript()));
+	mScriptTimer = new QTimer(this);
+	mScriptTimer->setSingleShot(true);
+	connect(mScriptTimer, SIGNAL(timeout()), mScriptProgress, SLOT(show()));
+
   PyInit( );
 	if( dlfl_module )
 		PyDLFL_PassObject( obj );
 }
 
 DLFLScriptEditor::~DLFLScriptEditor( ) {
-  if( Py_IsInitialized() )
+	// Stop a running script before the interpreter goes away
+	if( mScriptThread->isRunning() ) {
+		mScriptThread->interrupt();
+		mScriptThread->wait();
+	}
+  if( Py_IsInitialized() ) {
+		if( mMainThreadState )
+			PyEval_RestoreThread( mMainThreadState );
     Py_Finalize( );
+	}
 }
 
 void DLFLScriptEditor::executeCommand( ) {
@@ -151,139 +179,114 @@ void DLFLScriptEditor::executeCommand( ) {
 		// if some text was selected, then only execute that as the command
     command = mCommandEdit->textCursor().selection().toPlainText();
   }
+
+  if( command.isEmpty() || !Py_IsInitialized() || mScriptThread->isRunning() )
+    return;
   
 	// split up entered code by line
   QStringList cmdList = command.split('\n',QString::SkipEmptyParts);
-  QStringList resultList;
 
-  QString result;
+  emit makingChange(); // for undo push
 
-  mHistoryBox->moveCursor( QTextCursor::End );
-
-  if( !command.isEmpty() ) {
-    emit makingChange(); // for undo push
-
-    if( Py_IsInitialized() ) {
-			// Have to regrab these things every time
-			// to get updated dictionary from last exec
-
-			// Grab dlfl dictionary
-			dlfl_module = PyImport_AddModule("dlfl");
-			dlfl_dict = PyModule_GetDict( dlfl_module );
-			// Grab __main__ dictionary
-			main_module = PyImport_AddModule("__main__");
-			main_dict = PyModule_GetDict( main_module );
-
-			// Into main_dict: from dlfl import *
-			PyDict_Update(main_dict, dlfl_dict);
-
-			// Run this to redirect python stdout
-      PyRun_SimpleString( "import sys, __main__" );
-      PyRun_SimpleString( "__main__.mio = MyIO()" );
-      PyRun_SimpleString( "sys.stdout = __main__.mio" );
-			// Loop through each line of code looking for block statements
-      for(int i = 0; i < cmdList.size(); i++ ) {
-				QString si = cmdList.at(i);
-				if( si.endsWith(":") ) { 
-					// then it is a block statement
-					int j = i+1;
-					while( j < cmdList.size() && (cmdList.at(j).startsWith("\t") || cmdList.at(j).startsWith(" ")) ) {
-						/*// If it begins with a space figure out if we're in the same indentation level
-						if( cmdList.at(j).startsWith(" ") ) {
-							QRegExp rx = QRegExp("(^[ ])([ ])*");
-							int pos = rx.indexIn( cmdList.at(j) );
-							QStringList list = rx.capturedTexts();
-							
-							}*/
-
-						// keep going until the tab indent level goes back out
-						QString sj = cmdList.at(j);
-						si += QString("\n")+sj;
-						cmdList.removeAt(j);
-					}
-					// update with new multiline command
-					cmdList.replace(i,si);
-				}
-				// Check if it is a load command (let TopMod handle this instead of Python)
-				if( cmdList.at(i).contains(QRegExp("\\bload\\("))) {
-					QStringList list = cmdList.at(i).split("\"", QString::SkipEmptyParts);
-					cmdList.removeAt(i);
-					emit requestObject(list.at(1)); // 3 parts: load(, filename.obj, and )
-					emit cmdExecuted(); // print out in history window
-					continue;
-				}
-
-				// Clear out stdout
-				PyRun_SimpleString( "__main__.mio.clear()" );
-
-				// ** Run The Command
-				const char *cmd = cmdList.at(i).toLocal8Bit().constData();
-				PyObject *rstring = PyRun_String( cmd, Py_file_input, main_dict, main_dict );
-				// Grab the result from redirected stdout class into a global variable
-				PyRun_SimpleString( "__main__.__result = __main__.mio.s" );
-
-				if( rstring != NULL ) {
-					// resultObject1 has any possible result from running the command
-					PyObject *resultObject1 = PyObject_Str( rstring );
-					// resultObject2 has any possible thing printed to stdout from running the command
-					PyObject *resultObject2 = PyDict_GetItemString( main_dict, "__result" );
-					if( resultObject1 != NULL && resultObject2 != NULL ) {
-						char *string1 = PyString_AsString( resultObject1 );
-						char *string2 = PyString_AsString( PyObject_Str(resultObject2) );
-						result = QString( string1 );
-						// Go for string1 first, if nothing then try string2
-						if( result.isEmpty() || result == "" || result == "None" )
-							result = QString( string2 );
-						Py_DECREF( resultObject1 );
-						Py_DECREF( resultObject2 );
-					}
-					Py_DECREF( rstring );
-					emit cmdExecuted();
-				} else {
-					// There was an error with the command
-					// Print the error message
-					PyObject *object, *data, *traceback;
-					PyErr_Fetch( &object, &data, &traceback );
-					PyObject * traceStr = PyObject_Str( data );
-					char *string = PyString_AsString( traceStr );
-					result = QString( string ) + QString("  "); // the spaces b/c I chop(2) later
-				}
-				resultList << result; // append result to resultList
-      } // for loop
-    } // end Py_IsInitialized
-    emit addToHistory(command);
-  } else { // enter when command.isEmpty() == true
-    command = QString("");
-    result = QString("");
-  }
-
-	// Now create the output for the history window
+	// Loop through each line of code looking for block statements
   for(int i = 0; i < cmdList.size(); i++ ) {
-		// print each command
-    mHistoryBox->insertPlainText( "\n" + cmdList.at(i) );
-    if( i < resultList.size() ) {
-			// followed by all the items in it's result list
-      QString res = resultList.at(i);
-      if( !res.isEmpty() && res != QString("None") ) { // don't print if None
-				res.replace(QRegExp("\\n"), "\n# "); // print as a comment at each line for copy/paste ease
-				res.chop(2);
-				mHistoryBox->insertPlainText( "\n# "+ res ); // # is a comment in python
-      }
-    }
+		QString si = cmdList.at(i);
+		if( si.endsWith(":") ) { 
+			// then it is a block statement
+			int j = i+1;
+			while( j < cmdList.size() && (cmdList.at(j).startsWith("\t") || cmdList.at(j).startsWith(" ")) ) {
+				// keep going until the tab indent level goes back out
+				QString sj = cmdList.at(j);
+				si += QString("\n")+sj;
+				cmdList.removeAt(j);
+			}
+			// update with new multiline command
+			cmdList.replace(i,si);
+		}
   }
-	mHistoryBox->insertPlainText("\n");
-	
+  emit addToHistory(command);
+
 	// If the user highlighted to execute only a portion of the command
 	// then don't erase, otherwise do:
   if( !mCommandEdit->textCursor().hasSelection() ) {
 		clearInput( );
   }
 
+  runCommands( cmdList );
+}
+
+void DLFLScriptEditor::runCommands( const QStringList& cmdList ) {
+  mHistoryBox->moveCursor( QTextCursor::End );
+  // Before the thread starts, so the main window lets go of the object first
+  emit runningChanged(true);
+  if( mScriptThread->execute(cmdList) ) {
+    mScriptProgress->setLabelText(tr("Running script..."));
+    mScriptTimer->start(500);
+  } else emit runningChanged(false);
+}
+
+void DLFLScriptEditor::scriptCommandStarted( QString cmd ) {
+	// print each command
+  mHistoryBox->moveCursor( QTextCursor::End );
+  mHistoryBox->insertPlainText( "\n" + cmd );
+  mOutputLineStart = true;
+  QScrollBar *vBar = mHistoryBox->verticalScrollBar();
+  vBar->triggerAction(QAbstractSlider::SliderToMaximum);
+}
+
+void DLFLScriptEditor::scriptOutput( QString text ) {
+	// followed by what it prints, as a comment at each line for copy/paste ease
+  mHistoryBox->moveCursor( QTextCursor::End );
+  QStringList lines = text.split('\n');
+  for(int i = 0; i < lines.size(); i++ ) {
+    if( i > 0 ) mOutputLineStart = true;
+    if( lines.at(i).isEmpty() ) continue;
+    if( mOutputLineStart ) {
+      mHistoryBox->insertPlainText( "\n# " ); // # is a comment in python
+      mOutputLineStart = false;
+    }
+    mHistoryBox->insertPlainText( lines.at(i) );
+  }
+  QScrollBar *vBar = mHistoryBox->verticalScrollBar();
+  vBar->triggerAction(QAbstractSlider::SliderToMaximum);
+}
+
+void DLFLScriptEditor::scriptRedraw( ) {
+	// The script thread waits until resume(). If it gave up waiting it has the lock again
+  if( mObjectLock.tryLockForWrite() ) {
+    emit cmdExecuted();
+    mObjectLock.unlock();
+    emit redrawRequested();
+  }
+  mScriptThread->resume();
+}
+
+void DLFLScriptEditor::scriptLoad( QString fileName ) {
+  mObjectLock.lockForWrite();
+  emit requestObject(fileName);
+  emit cmdExecuted();
+  mObjectLock.unlock();
+  mScriptThread->resume();
+}
+
+void DLFLScriptEditor::scriptFinished( ) {
+  mScriptTimer->stop();
+  mScriptProgress->reset();
+	mHistoryBox->moveCursor( QTextCursor::End );
+	mHistoryBox->insertPlainText("\n");
+  emit cmdExecuted();
+  emit runningChanged(false);
+
 	// Make sure history window is scrolled all the way down to latest command
   QScrollBar *vBar = mHistoryBox->verticalScrollBar();
   vBar->triggerAction(QAbstractSlider::SliderToMaximum);
 }
 
+void DLFLScriptEditor::interruptScript( ) {
+  mScriptThread->interrupt();
+  mScriptProgress->setLabelText(tr("Interrupting script..."));
+}
+
 void DLFLScriptEditor::echoCommand( QString cmd ) {
 	if( mEchoing ) {
 		mHistoryBox->insertPlainText( "\n" + cmd + "\n" );
@@ -297,6 +300,8 @@ void DLFLScriptEditor::PyInit( ) {
   Py_Initialize( );
 
   if( Py_IsInitialized() ) {
+		// Scripts run on another thread
+		PyEval_InitThreads( );
     PyRun_SimpleString( "import sys, __main__" );
 		loadDLFLModule( addToPath );
 
@@ -327,6 +332,9 @@ void DLFLScriptEditor::PyInit( ) {
       mHistoryBox->insertPlainText("\n");
       PyErr_Print();
     }
+
+		// Let go of the GIL so the script thread can take it
+		mMainThreadState = PyEval_SaveThread( );
   }
 }
 
@@ -361,20 +369,17 @@ static bool syspath_append( const char *dirname ) {
 }
 
 void DLFLScriptEditor::loadDLFLModule( QString newPath ) {
-	if( !syspath_append( newPath.toLocal8Bit().constData() ) )
+	if( !Py_IsInitialized() )
 		return;
-	if( dlfl_module == NULL && Py_IsInitialized() ) {
+	PyGILState_STATE gstate = PyGILState_Ensure( );
+	if( syspath_append( newPath.toLocal8Bit().constData() ) && dlfl_module == NULL )
 		dlfl_module = PyImport_ImportModule("dlfl");
-	}
+	PyGILState_Release( gstate );
 }
 
 void DLFLScriptEditor::execFile( ) {
-	// Grab dlfl dictionary
-	dlfl_module = PyImport_AddModule("dlfl");
-	dlfl_dict = PyModule_GetDict( dlfl_module );
-	// Grab __main__ dictionary
-	main_module = PyImport_AddModule("__main__");
-	main_dict = PyModule_GetDict( main_module );
+	if( !Py_IsInitialized() || mScriptThread->isRunning() )
+		return;
 
 	QString filename = 
 		QFileDialog::getOpenFileName(this,
@@ -382,28 +387,12 @@ void DLFLScriptEditor::execFile( ) {
 																 "$HOME",
 																 tr("Python Files (*.py);;All Files (*)"),
 																0, QFileDialog::DontUseSheet);
-	QString error("");
 
 	if( !filename.isEmpty() ) {
 		QString execfileString = QString("execfile(\"") + filename + QString("\")");
-		if( Py_IsInitialized() && main_dict != NULL ) {
-			const char *cmd = execfileString.toLocal8Bit().constData();
-			PyRun_SimpleString( "import sys" );
-			PyObject *rstring = PyRun_String( cmd, Py_file_input, main_dict, main_dict );
-			if( rstring == NULL ) {
-				// There was an error with the command
-				// Print the error message
-				PyObject *object, *data, *traceback;
-				PyErr_Fetch( &object, &data, &traceback );
-				PyObject * traceStr = PyObject_Str( data );
-				char *string = PyString_AsString( traceStr );
-				error = QString("# ") + QString(string);
-			}
-			Py_DECREF( rstring );
-			emit addToHistory(execfileString);
-			echoCommand( execfileString );
-			if( !error.isEmpty() ) { echoCommand( error ); }
-		}
+		emit makingChange(); // for undo push
+		emit addToHistory(execfileString);
+		runCommands( QStringList(execfileString) );
 	}
 }
 
@@ -40,14 +40,18 @@
 #include <QToolBar>
 #include <QPushButton>
 #include <QSpinBox>
+#include <QReadWriteLock>
 #include <iostream>
 
 //class QLineEdit;
 class QTextEdit;
 class QProcess;
+class QProgressDialog;
+class QTimer;
 
 #include <DLFLObject.hh>
 #include "editor.hh"
+#include "DLFLScriptThread.hh"
 
 #include "PythonHighlighter.hh"
 
@@ -71,15 +75,28 @@ public:
   QColor& inputBgColor( ) { return mInputBgColor; };
 	void retranslateUi();
 
+	// Held for writing while a script changes the object, see DLFLScriptThread
+	QReadWriteLock * objectLock( ) { return &mObjectLock; };
+	bool isRunning( ) const { return mScriptThread->isRunning(); };
+
 signals :
   void makingChange( ); // for undo push
   void cmdExecuted( );
   void addToHistory( const QString& item );
   void requestObject( QString fileName );
+  void redrawRequested( ); // the object can be drawn right now
+  void runningChanged( bool running ); // nothing else may touch the object while a script runs
 private slots :
   void executeCommand( );
 	void echoCommand( QString cmd );
 	void toggleTabWidthWidget( );
+	// From the script thread
+	void scriptCommandStarted( QString cmd );
+	void scriptOutput( QString text );
+	void scriptRedraw( );
+	void scriptLoad( QString fileName );
+	void scriptFinished( );
+	void interruptScript( );
 public slots :
   void loadObject( DLFLObject* obj, QString fileName );
 	void loadDLFLModule( QString newPath );
@@ -119,6 +136,15 @@ private :
   void PyInit();
   PyObject *dlfl_module, *dlfl_dict;
   PyObject *main_module, *main_dict;
+	PyThreadState *mMainThreadState; // Of the GUI thread, which doesn't hold the GIL after PyInit
+
+	// Scripts run on their own thread
+	DLFLScriptThread *mScriptThread;
+	QReadWriteLock mObjectLock;
+	QProgressDialog *mScriptProgress;
+	QTimer *mScriptTimer;           // Shows mScriptProgress if the script takes a while
+	bool mOutputLineStart;          // Next output goes on a new line
+	void runCommands( const QStringList& cmdList );
 
 	bool mEchoing;
 
@@ -0,0 +1,196 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifdef WITH_PYTHON
+
+#include "DLFLScriptThread.hh"
+
+#include <QRegExp>
+
+// Printed output is handed to the GUI at most this often (ms)
+#define SCRIPT_FLUSH_INTERVAL 100
+// Shortest time between redraws (ms), and how long to wait for one
+#define SCRIPT_REDRAW_INTERVAL 250
+#define SCRIPT_REDRAW_TIMEOUT 1000
+
+DLFLScriptThread::DLFLScriptThread( QReadWriteLock *lock, QObject *parent )
+	: QThread(parent), mLock(lock), mCommands(), mResumed(0),
+		mRedrawInterval(SCRIPT_REDRAW_INTERVAL), mInterrupted(false), mStdout(NULL) {
+}
+
+DLFLScriptThread::~DLFLScriptThread( ) {
+	if ( isRunning() ) {
+		interrupt();
+		wait();
+	}
+}
+
+bool DLFLScriptThread::execute( const QStringList& commands ) {
+	if ( isRunning() ) return false;
+	mCommands = commands;
+	mInterrupted = false;
+	mRedrawInterval = SCRIPT_REDRAW_INTERVAL;
+	start();
+	return true;
+}
+
+void DLFLScriptThread::run( ) {
+	PyGILState_STATE gstate = PyGILState_Ensure();
+
+	// Have to regrab these things every time
+	// to get updated dictionary from last exec
+	PyObject *dlfl_module = PyImport_AddModule("dlfl");
+	PyObject *main_module = PyImport_AddModule("__main__");
+	PyObject *main_dict = PyModule_GetDict( main_module );
+
+	// Into main_dict: from dlfl import *
+	if ( dlfl_module ) PyDict_Update(main_dict, PyModule_GetDict(dlfl_module));
+
+	// Run this to redirect python stdout
+	PyRun_SimpleString( "import sys, __main__" );
+	PyRun_SimpleString( "__main__.mio = MyIO()" );
+	PyRun_SimpleString( "sys.stdout = __main__.mio" );
+	mStdout = PyDict_GetItemString( main_dict, "mio" );
+	Py_XINCREF( mStdout );
+
+	PyObject *self = PyCObject_FromVoidPtr( this, NULL );
+	mLock->lockForWrite();
+	mLastFlush.start(); mLastRedraw.start();
+	PyEval_SetTrace( trace, self );
+
+	for (int i = 0; i < mCommands.size() && !mInterrupted; i++ )
+		runCommand( mCommands.at(i), main_dict );
+
+	PyEval_SetTrace( NULL, NULL );
+	Py_DECREF( self );
+	mLock->unlock();
+
+	Py_XDECREF( mStdout ); mStdout = NULL;
+	PyGILState_Release( gstate );
+}
+
+void DLFLScriptThread::runCommand( const QString& command, PyObject *dict ) {
+	// Check if it is a load command (let TopMod handle this instead of Python)
+	if ( command.contains(QRegExp("\\bload\\(")) ) {
+		QStringList list = command.split("\"", QString::SkipEmptyParts);
+		if ( list.size() > 1 ) { // 3 parts: load(, filename.obj, and )
+			releaseLock();
+			emit loadRequested( list.at(1) );
+			waitForGUI( -1 );
+		}
+		return;
+	}
+
+	emit commandStarted( command );
+
+	// ** Run The Command, compiled to bytecode first
+	QByteArray source = command.toLocal8Bit();
+	PyObject *code = Py_CompileString( source.constData(), "<script>", Py_file_input );
+	PyObject *result = NULL;
+	if ( code != NULL ) {
+		result = PyEval_EvalCode( (PyCodeObject *)code, dict, dict );
+		Py_DECREF( code );
+	}
+	if ( result != NULL ) {
+		Py_DECREF( result );
+		flushOutput();
+		return;
+	}
+
+	// There was an error with the command
+	// Print the error message after what was printed before it
+	PyObject *type, *value, *traceback;
+	PyErr_Fetch( &type, &value, &traceback );
+	QString error;
+	if ( type != NULL && PyErr_GivenExceptionMatches(type, PyExc_KeyboardInterrupt) )
+		error = QString("KeyboardInterrupt");
+	else if ( value != NULL ) {
+		PyObject *traceStr = PyObject_Str( value );
+		if ( traceStr != NULL ) {
+			error = QString( PyString_AsString(traceStr) );
+			Py_DECREF( traceStr );
+		}
+	}
+	Py_XDECREF( type ); Py_XDECREF( value ); Py_XDECREF( traceback );
+	flushOutput();
+	emit output( error + QString("\n") );
+}
+
+int DLFLScriptThread::trace( PyObject *obj, PyFrameObject *frame, int what, PyObject *arg ) {
+	if ( what != PyTrace_LINE ) return 0;
+	DLFLScriptThread *t = (DLFLScriptThread *)PyCObject_AsVoidPtr(obj);
+
+	if ( t->mInterrupted ) {
+		PyErr_SetNone( PyExc_KeyboardInterrupt );
+		return -1;
+	}
+	if ( t->mLastFlush.elapsed() >= SCRIPT_FLUSH_INTERVAL ) {
+		t->flushOutput();
+		t->mLastFlush.restart();
+	}
+	if ( t->mLastRedraw.elapsed() >= t->mRedrawInterval ) {
+		QTime redraw; redraw.start();
+		t->releaseLock();
+		emit t->redrawRequested();
+		t->waitForGUI( SCRIPT_REDRAW_TIMEOUT );
+		// Don't spend more than a fifth of the time redrawing
+		t->mRedrawInterval = qMax( SCRIPT_REDRAW_INTERVAL, 4*redraw.elapsed() );
+		t->mLastRedraw.restart();
+	}
+	return 0;
+}
+
+void DLFLScriptThread::flushOutput( ) {
+	if ( mStdout == NULL ) return;
+	PyObject *s = PyObject_GetAttrString( mStdout, "s" );
+	if ( s != NULL && PyString_Check(s) && PyString_Size(s) > 0 ) {
+		emit output( QString::fromLocal8Bit(PyString_AsString(s)) );
+		PyObject *r = PyObject_CallMethod( mStdout, (char *)"clear", NULL );
+		Py_XDECREF( r );
+	}
+	Py_XDECREF( s );
+	PyErr_Clear();
+}
+
+void DLFLScriptThread::releaseLock( ) {
+	// Forget answers to requests which timed out
+	while ( mResumed.tryAcquire() ) ;
+	mLock->unlock();
+}
+
+void DLFLScriptThread::waitForGUI( int timeout ) {
+	// The GUI doesn't need Python meanwhile, but don't hold it up
+	Py_BEGIN_ALLOW_THREADS
+	if ( timeout >= 0 ) mResumed.tryAcquire( 1, timeout );
+	else while ( !mInterrupted && !mResumed.tryAcquire(1, 100) ) ;
+	mLock->lockForWrite();
+	Py_END_ALLOW_THREADS
+}
+
+#endif // WITH_PYTHON
@@ -0,0 +1,118 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifndef _DLFL_SCRIPT_THREAD_HH_
+#define _DLFL_SCRIPT_THREAD_HH_
+
+// Runs script commands on their own thread, so long scripts don't freeze the
+// GUI and can be interrupted. Unlike DLFLExecutor the commands work on the
+// object itself. The thread holds the object lock for writing while Python
+// runs, and the viewports skip frames while it is held (see
+// GLWidget::setObjectLock). Every so often, between two lines of the
+// script, the thread hands what was printed to the GUI, lets go of the lock
+// and waits for the GUI to redraw. The time between redraws grows with the
+// time the GUI needs for them, so the script keeps most of the time.
+//
+// Interrupting raises KeyboardInterrupt at the next line of the script. An
+// operation which is running is finished first, the object is never left
+// half changed.
+//
+// The interpreter must have been set up for threads (PyEval_InitThreads) and
+// the GUI thread must not hold the GIL while a script runs.
+
+#ifdef WITH_PYTHON
+
+#undef slots
+#include <Python.h>
+#include <frameobject.h>
+#define slots
+
+#include <DLFLObject.hh>
+
+#include <QThread>
+#include <QStringList>
+#include <QReadWriteLock>
+#include <QSemaphore>
+#include <QTime>
+
+using namespace DLFL;
+
+class DLFLScriptThread : public QThread {
+	Q_OBJECT
+
+public :
+
+	DLFLScriptThread( QReadWriteLock *lock, QObject *parent = 0 );
+	~DLFLScriptThread( );
+
+	// Start running the commands one after the other in __main__.
+	// Returns false if a script is running already
+	bool execute( const QStringList& commands );
+
+	void interrupt( ) { mInterrupted = true; }
+	bool wasInterrupted( ) const { return mInterrupted; }
+
+	// Called by the GUI when it is done with a redraw or load request
+	void resume( ) { mResumed.release(); }
+
+signals :
+	void commandStarted( QString command );
+	void output( QString text );          // Printed by the script since the last one
+	void redrawRequested( );              // The lock is free until resume()
+	void loadRequested( QString fileName ); // The lock is free until resume()
+
+protected :
+
+	void run( );
+	void runCommand( const QString& command, PyObject *dict );
+
+	// Called by Python for every line of the script
+	static int trace( PyObject *obj, PyFrameObject *frame, int what, PyObject *arg );
+
+	void flushOutput( );
+
+	// Let go of the lock before asking the GUI for something
+	void releaseLock( );
+
+	// Wait for the GUI to call resume(), at most timeout ms or until
+	// interrupted if timeout is negative. Then take the lock again
+	void waitForGUI( int timeout );
+
+	QReadWriteLock *mLock;
+	QStringList mCommands;
+	QSemaphore mResumed;
+	QTime mLastFlush, mLastRedraw;
+	int mRedrawInterval;                  // ms between redraws
+	volatile bool mInterrupted;
+	PyObject *mStdout;                    // __main__.mio while running
+};
+
+#endif // WITH_PYTHON
+
+#endif /* #ifndef _DLFL_SCRIPT_THREAD_HH_ */
@@ -0,0 +1,312 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#include "DLFLSyncSession.hh"
+
+#include <DLFLObject.hh>
+
+#include <QTcpServer>
+#include <QTcpSocket>
+
+// Longer messages are taken as garbage
+#define DLFL_SYNC_MAX_MESSAGE (1<<30)
+
+static void putUInt32( QByteArray& a, quint32 n ) {
+	a.append((char)(n >> 24)); a.append((char)(n >> 16));
+	a.append((char)(n >> 8)); a.append((char)n);
+}
+
+static quint32 getUInt32( const QByteArray& a ) {
+	const uchar *p = (const uchar *)a.constData();
+	return ((quint32)p[0] << 24) | ((quint32)p[1] << 16) | ((quint32)p[2] << 8) | (quint32)p[3];
+}
+
+DLFLSyncSession::DLFLSyncSession( QObject *parent )
+	: QObject(parent), mServer(NULL), mPeers(), mIncoming(), mSync(),
+	  mHost(false), mJoined(false), mAttach(false), mNextPeer(2), mBandwidth(0) {
+	mClock.start();
+}
+
+DLFLSyncSession::~DLFLSyncSession( ) {
+	leave();
+}
+
+bool DLFLSyncSession::host( quint16 port ) {
+	leave();
+	mServer = new QTcpServer(this);
+	connect(mServer, SIGNAL(newConnection()), this, SLOT(acceptPeer()));
+	if ( !mServer->listen(QHostAddress::Any, port) ) {
+		emit message(tr("Can't host a session on port %1: %2").arg(port).arg(mServer->errorString()));
+		delete mServer; mServer = NULL;
+		return false;
+	}
+	mHost = mJoined = mAttach = true;
+	mNextPeer = 2;
+	mSync.clear();
+	mSync.setPeer(1);
+	emit message(tr("Hosting a session on port %1").arg(port));
+	return true;
+}
+
+void DLFLSyncSession::join( const QString& address, quint16 port ) {
+	leave();
+	QTcpSocket *socket = new QTcpSocket(this);
+	addPeer(socket);
+	connect(socket, SIGNAL(connected()), this, SLOT(peerConnected()));
+	socket->connectToHost(address, port);
+	emit message(tr("Connecting to %1:%2...").arg(address).arg(port));
+}
+
+void DLFLSyncSession::leave( ) {
+	while ( !mPeers.isEmpty() )
+		removePeer(mPeers.front());
+	if ( mServer ) {
+		mServer->close();
+		delete mServer; mServer = NULL;
+	}
+	mIncoming.clear();
+	mSync.clear();
+	mHost = mJoined = mAttach = false;
+}
+
+DLFLSyncSession::Peer * DLFLSyncSession::addPeer( QTcpSocket *socket ) {
+	Peer *peer = new Peer;
+	peer->socket = socket;
+	peer->needsState = false;
+	peer->allowance = 0.0;
+	connect(socket, SIGNAL(readyRead()), this, SLOT(readPeer()));
+	connect(socket, SIGNAL(disconnected()), this, SLOT(peerDisconnected()));
+	connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(peerError(QAbstractSocket::SocketError)));
+	mPeers.append(peer);
+	return peer;
+}
+
+DLFLSyncSession::Peer * DLFLSyncSession::findPeer( QObject *socket ) {
+	for (int i=0; i < mPeers.size(); ++i)
+		if ( mPeers[i]->socket == socket ) return mPeers[i];
+	return NULL;
+}
+
+void DLFLSyncSession::removePeer( Peer *peer ) {
+	mPeers.removeAll(peer);
+	// What it sent is still applied, but not sent back to it
+	for (int i=0; i < mIncoming.size(); ++i)
+		if ( mIncoming[i].from == peer ) mIncoming[i].from = NULL;
+	peer->socket->disconnect(this);
+	peer->socket->abort();
+	peer->socket->deleteLater();
+	delete peer;
+}
+
+void DLFLSyncSession::acceptPeer( ) {
+	while ( mServer && mServer->hasPendingConnections() ) {
+		Peer *peer = addPeer(mServer->nextPendingConnection());
+		peer->needsState = true;
+		// The peer number goes first, the peer makes its keys from it
+		QByteArray body;
+		putUInt32(body, mNextPeer++);
+		send(peer, frame('H', body));
+		emit message(tr("%1 joined the session").arg(peer->socket->peerAddress().toString()));
+	}
+}
+
+void DLFLSyncSession::peerConnected( ) {
+	emit message(tr("Connected, waiting for the object..."));
+}
+
+void DLFLSyncSession::peerDisconnected( ) {
+	Peer *peer = findPeer(sender());
+	if ( !peer ) return;
+	if ( mHost ) {
+		emit message(tr("%1 left the session").arg(peer->socket->peerAddress().toString()));
+		removePeer(peer);
+	} else {
+		emit message(tr("Disconnected from the session"));
+		leave();
+	}
+}
+
+void DLFLSyncSession::peerError( QAbstractSocket::SocketError error ) {
+	Peer *peer = findPeer(sender());
+	// A closed connection is handled by peerDisconnected
+	if ( !peer || error == QAbstractSocket::RemoteHostClosedError ) return;
+	emit message(tr("Session: %1").arg(peer->socket->errorString()));
+	if ( mHost ) removePeer(peer);
+	else leave();
+}
+
+void DLFLSyncSession::readPeer( ) {
+	Peer *peer = findPeer(sender());
+	if ( !peer ) return;
+	peer->in.append(peer->socket->readAll());
+	while ( peer->in.size() >= 4 ) {
+		quint32 n = getUInt32(peer->in);
+		if ( n > DLFL_SYNC_MAX_MESSAGE ) {
+			emit message(tr("Session: broken message from %1").arg(peer->socket->peerAddress().toString()));
+			if ( mHost ) removePeer(peer);
+			else leave();
+			return;
+		}
+		if ( (quint32)peer->in.size() < 4+n ) break;
+		Message m;
+		m.from = peer;
+		m.frame = peer->in.left(4+n);
+		peer->in.remove(0,4+n);
+		QByteArray data = qUncompress(m.frame.mid(4));
+		if ( data.isEmpty() ) continue;
+		m.type = data[0];
+		m.body = data.mid(1);
+		if ( m.type == 'H' ) {
+			if ( !mHost && m.body.size() == 4 ) mSync.setPeer(getUInt32(m.body));
+			continue;
+		}
+		mIncoming.append(m);
+	}
+}
+
+QByteArray DLFLSyncSession::frame( char type, const QByteArray& body ) {
+	QByteArray data;
+	data.reserve(body.size()+1);
+	data.append(type);
+	data.append(body);
+	QByteArray compressed = qCompress(data);
+	QByteArray f;
+	f.reserve(compressed.size()+4);
+	putUInt32(f, compressed.size());
+	f.append(compressed);
+	return f;
+}
+
+void DLFLSyncSession::send( Peer *peer, const QByteArray& frame ) {
+	peer->out.append(frame);
+}
+
+void DLFLSyncSession::sendAll( const QByteArray& frame, Peer *except ) {
+	for (int i=0; i < mPeers.size(); ++i)
+		if ( mPeers[i] != except ) send(mPeers[i], frame);
+}
+
+void DLFLSyncSession::flush( ) {
+	double elapsed = mClock.restart() / 1000.0;
+	for (int i=0; i < mPeers.size(); ++i) {
+		Peer *peer = mPeers[i];
+		qint64 n = peer->out.size();
+		if ( mBandwidth > 0 ) {
+			// Bandwidth which isn't used is saved up for a second at most
+			peer->allowance = qMin(peer->allowance + elapsed * mBandwidth, (double)mBandwidth);
+			n = qMin(n, (qint64)peer->allowance);
+		}
+		if ( n <= 0 || peer->socket->state() != QAbstractSocket::ConnectedState ) continue;
+		n = peer->socket->write(peer->out.constData(), n);
+		if ( n > 0 ) {
+			peer->out.remove(0, n);
+			if ( mBandwidth > 0 ) peer->allowance -= n;
+		}
+	}
+}
+
+DLFLSync::Result DLFLSyncSession::update( DLFLObjectPtr obj, DLFLVertexPtrArray& moved, bool rebuild ) {
+	DLFLSync::Result result = DLFLSync::Unchanged;
+	moved.clear();
+	if ( !isActive() ) return result;
+	if ( mAttach ) {
+		mSync.attach(obj);
+		mAttach = false;
+	}
+
+	// Local changes are taken first, a delta is applied to the synchronized
+	// state and the object has to match it. Otherwise they wait
+	// until the last delta has gone out, and are sent together
+	bool waiting = false;
+	for (int i=0; i < mPeers.size(); ++i)
+		if ( !mPeers[i]->out.isEmpty() ) waiting = true;
+	if ( mJoined && ( !waiting || !mIncoming.isEmpty() ) ) {
+		DLFLSyncDelta d;
+		if ( mSync.diff(obj, d) ) {
+			string s;
+			d.encode(s);
+			sendAll(frame('D', QByteArray(s.data(), s.size())));
+		}
+	}
+
+	// New peers get the object as it is now
+	if ( mHost ) {
+		QByteArray state;
+		for (int i=0; i < mPeers.size(); ++i) {
+			if ( !mPeers[i]->needsState ) continue;
+			if ( state.isEmpty() ) {
+				DLFLSyncDelta d;
+				string s;
+				mSync.state(d);
+				d.encode(s);
+				state = frame('S', QByteArray(s.data(), s.size()));
+			}
+			send(mPeers[i], state);
+			mPeers[i]->needsState = false;
+		}
+	}
+
+	while ( !mIncoming.isEmpty() ) {
+		Message m = mIncoming.front();
+		DLFLSyncDelta d;
+		bool state = ( m.type == 'S' );
+		if ( ( !state && m.type != 'D' ) || ( state && mHost ) || !d.decode(m.body.constData(), m.body.size()) ) {
+			mIncoming.removeFirst();
+			continue;
+		}
+		if ( !rebuild && ( state || d.changesTopology() ) ) break;
+		mIncoming.removeFirst();
+
+		DLFLVertexPtrArray mv;
+		DLFLSync::Result r;
+		if ( state ) {
+			// The session's object replaces ours
+			mSync.clear();
+			obj->reset();
+			mSync.apply(obj, d, mv);
+			r = DLFLSync::Rebuilt;
+			mJoined = true;
+			emit message(tr("Joined the session, %1 faces").arg((int)obj->num_faces()));
+		} else {
+			r = mSync.apply(obj, d, mv);
+			// The host passes it on to everybody else
+			if ( mHost ) sendAll(m.frame, m.from);
+		}
+		if ( r == DLFLSync::Rebuilt ) {
+			result = DLFLSync::Rebuilt;
+			moved.clear();
+		} else if ( r == DLFLSync::Moved && result != DLFLSync::Rebuilt ) {
+			result = DLFLSync::Moved;
+			moved.insert(moved.end(), mv.begin(), mv.end());
+		}
+	}
+
+	flush();
+	return result;
+}
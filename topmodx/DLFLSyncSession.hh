@@ -0,0 +1,142 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifndef _DLFL_SYNC_SESSION_HH_
+#define _DLFL_SYNC_SESSION_HH_
+
+// Editing one object together from several TopMod instances. One instance
+// hosts the session and listens for the others, which connect to it over TCP
+// (on localhost, or the local network). The host passes what it gets from one
+// instance on to all the others.
+//
+// Instances send each other deltas (see DLFLSync) rather than meshes: a joining
+// instance gets the whole object once, after that only changes are sent. The
+// window calls update() from a timer when the object may be changed, which
+// sends out everything that changed since the last call as one delta, then
+// applies the deltas which came in. While a delta is still waiting to go out
+// no new one is made, so under a low bandwidth edits are merged into fewer,
+// larger deltas instead of queueing up. Every message is compressed.
+//
+// A message is a 4 byte length followed by the compressed type byte and body.
+
+#include <DLFLSync.hh>
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QTime>
+#include <QAbstractSocket>
+
+class QTcpServer;
+class QTcpSocket;
+
+using namespace DLFL;
+
+class DLFLSyncSession : public QObject {
+	Q_OBJECT
+
+public :
+
+	enum { DefaultPort = 4951 };
+
+	DLFLSyncSession( QObject *parent = 0 );
+	~DLFLSyncSession( );
+
+	// Start a session with the object as it is when update() is next called
+	bool host( quint16 port = DefaultPort );
+
+	// Join a session. The object is replaced with the host's once it arrives
+	void join( const QString& address, quint16 port = DefaultPort );
+
+	void leave( );
+
+	bool isActive( ) const { return mHost || !mPeers.isEmpty(); }
+	bool isHost( ) const { return mHost; }
+
+	// Bytes per second given to each connection, 0 for no limit
+	void setBandwidth( int bytes ) { mBandwidth = bytes; }
+
+	// Send the local changes and apply what came in. Deltas which change the
+	// topology are held back if rebuild is false (eg. while the user drags a
+	// vertex). Returns what happened to the object, the moved vertices are
+	// returned for Moved
+	DLFLSync::Result update( DLFLObjectPtr obj, DLFLVertexPtrArray& moved, bool rebuild = true );
+
+signals :
+
+	void message( const QString& text );
+
+protected slots :
+
+	void acceptPeer( );
+	void readPeer( );
+	void peerConnected( );
+	void peerDisconnected( );
+	void peerError( QAbstractSocket::SocketError error );
+
+protected :
+
+	struct Peer {
+		QTcpSocket *socket;
+		QByteArray in;                    // Received, not yet split into messages
+		QByteArray out;                   // Waiting for bandwidth
+		bool needsState;                  // Joined the host, hasn't been sent the object yet
+		double allowance;                 // Bytes which may still be written
+	};
+
+	// A message waiting to be applied. The frame is kept for passing it on
+	struct Message {
+		Peer *from;
+		char type;
+		QByteArray body;
+		QByteArray frame;
+	};
+
+	QTcpServer *mServer;
+	QList<Peer *> mPeers;                // The clients of the host, or the host of a client
+	QList<Message> mIncoming;
+	DLFLSync mSync;
+	bool mHost;
+	bool mJoined;                        // Has the object of the session
+	bool mAttach;                        // Host: take the object on the next update
+	uint mNextPeer;
+	int mBandwidth;
+	QTime mClock;
+
+	Peer * addPeer( QTcpSocket *socket );
+	Peer * findPeer( QObject *socket );
+	void removePeer( Peer *peer );
+
+	static QByteArray frame( char type, const QByteArray& body );
+	void send( Peer *peer, const QByteArray& frame );
+	void sendAll( const QByteArray& frame, Peer *except = NULL );
+	void flush( );
+};
+
+#endif /* #ifndef _DLFL_SYNC_SESSION_HH_ */
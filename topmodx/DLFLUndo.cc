@@ -33,11 +33,15 @@
 
 /* $Id: DLFLUndo.cc,v 4.1 2004/02/24 20:41:44 vinod Exp $ */
 
+#include <QtGui>
+#include <fstream>
 #include "MainWindow.hh"
 
 //-- Subroutines dealing with undo and redo for DLFLWindow --//
 
 void MainWindow::clearUndoList(void) {
+	// A shown preview stays, without the object before it
+	endPreview();
   StringStreamPtrList::iterator first, firstmtl, last;
 	firstmtl = undoMtlList.begin();
   first = undoList.begin(); last = undoList.end();
@@ -68,8 +72,14 @@ void MainWindow::clearRedoList(void)
 
 void MainWindow::undoPush(void)
 {
+  beginOperation();
+
+	// Operations on a shown preview keep it
+	commitPreview();
+
      // Don't do anything unless undo is required
   if ( useUndo == false ) return;
+  DLFL_PROFILE("undoPush");
 
      // Put current object on top of undo list
      // Check if we have reached undo limit, in which case remove oldest state
@@ -95,7 +105,54 @@ void MainWindow::undoPush(void)
 	clearRedoList();
 }
 
+// Time the operation which called undoPush, until control gets back to the event
+// loop. Nearly every operation calls undoPush before it changes the object, so
+// this covers all of them. The operation is named after the action which triggered it
+void MainWindow::beginOperation(void) {
+	if ( mOperationStart >= 0.0 ) return; // Already timing one
+
+	QAction *action = qobject_cast<QAction*>(sender());
+	QString name = action ? action->text().remove('&') : tr("Operation");
+	DLFLProfiler& prof = DLFLProfiler::instance();
+	mOperationName = prof.intern(string(name.toLocal8Bit().constData()));
+	mOperationAllocs = DLFLProfiler::allocations();
+	mOperationStart = prof.now();
+	QTimer::singleShot(0, this, SLOT(endOperation()));
+}
+
+void MainWindow::endOperation(void) {
+	if ( mOperationStart < 0.0 ) return;
+	DLFLProfiler& prof = DLFLProfiler::instance();
+	long allocs = DLFLProfiler::allocations();
+	prof.add(mOperationName, mOperationStart, prof.now() - mOperationStart,
+					 (allocs < 0) ? -1 : allocs - mOperationAllocs, object.num_faces());
+	mOperationStart = -1.0;
+}
+
+void MainWindow::saveProfilerTrace(void) {
+	QString fileName = QFileDialog::getSaveFileName(this,
+																									tr("Save Profiler Trace..."),
+																									mSaveDirectory + "/topmod-trace.json",
+																									tr("Trace Files (*.json);;All Files (*)"),
+																									0, QFileDialog::DontUseSheet );
+	if (fileName.isEmpty()) return;
+
+	QByteArray ba = fileName.toLocal8Bit();
+	ofstream file(ba.data());
+	if (!file) {
+		QMessageBox::warning(this, tr("Save Profiler Trace"), tr("Cannot write file %1.").arg(fileName));
+		return;
+	}
+	DLFLProfiler::instance().writeTrace(file);
+	statusBar()->showMessage(tr("Profiler trace saved"), 2000);
+}
+
 void MainWindow::undo(void) {
+	// Undoing a preview goes back to the object before it
+	if ( mPreviewShownKind != NoPreview ) {
+		discardPreview();
+		return;
+	}
 	
 	if ( !undoList.empty() ) {		
  		// Restore previous object
@@ -123,6 +180,7 @@ void MainWindow::undo(void) {
 		active->recomputeNormals();
 		// Clear selection lists to avoid dangling pointers
 		MainWindow::clearSelected();
+		crust_info.clear();
 		redraw();
 		/* is document modified? - dave */
 		setModified(true);
@@ -136,6 +194,7 @@ void MainWindow::undo(void) {
 }
 
 void MainWindow::redo(void) {
+	discardPreview();
 	
   if ( !redoList.empty() ) {
 		// Redo previously undone operation
@@ -157,6 +216,7 @@ void MainWindow::redo(void) {
 		active->recomputeNormals();
 		// Clear selection lists to avoid dangling pointers
 		MainWindow::clearSelected();
+		crust_info.clear();
 		redraw();
 		/* is document modified? - dave */
 		setModified(true);
@@ -371,6 +371,7 @@ QDoubleSpinBox *ExtrusionsMode::createDoubleSpinBox(QGridLayout *layout, QLabel
 	spinbox->setMaximumSize(75,25);
 	layout->addWidget(label,row,col);
   layout->addWidget(spinbox,row,col+1);
+	connect(spinbox, SIGNAL(valueChanged(double)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 
 	return spinbox;
 }
@@ -474,6 +475,7 @@ void ExtrusionsMode::setupDodecahedralExtrude(){
 	//mesh flat edges checkbox
 	hexagonalizeCheckBox = new QCheckBox(tr("Hexagonalize"),this);
 	connect(hexagonalizeCheckBox, SIGNAL(stateChanged(int)),((MainWindow*)mParent), SLOT(toggleHexagonalizeDodecaExtrudeFlag(int)));
+	connect(hexagonalizeCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 	
 	mDodecahedralExtrudeLayout->addWidget(hexagonalizeCheckBox,5,1);
 
@@ -554,6 +556,7 @@ void ExtrusionsMode::setupOctahedralExtrude(){
 	//mesh flat edges checkbox
 	meshFlatEdgesCheckBox = new QCheckBox(tr("Mesh Flat Edges"),this);
 	connect(meshFlatEdgesCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(toggleDualMeshEdgesFlag(int)));
+	connect(meshFlatEdgesCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 
 	mOctahedralExtrudeLayout->addWidget(meshFlatEdgesCheckBox,4,1);
 	
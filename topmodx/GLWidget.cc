@@ -46,6 +46,11 @@
   \see GLWidget
 */
 
+// Navigation frames are at most this far apart (ms), about one per display refresh
+#define NAV_FRAME_INTERVAL 16
+// Time without camera motion (ms) after which the full object is drawn again
+#define NAV_IDLE_TIME 200
+
 DLFLLocatorPtrArray GLWidget::sel_lptr_array;
 /*DLFLVertexPtrArray GLWidget::sel_vptr_array;
   DLFLEdgePtrArray GLWidget::sel_eptr_array;
@@ -78,7 +83,8 @@ DLFLLocatorPtrArray GLWidget::sel_lptr_array;
 
 GLWidget::GLWidget(int w, int h, DLFLRendererPtr rp, QColor color, QColor vcolor, DLFLObjectPtr op, const QGLFormat & format, QWidget * parent ) 
   : 	QGLWidget(format, parent, NULL), /*viewport(w,h,v),*/ object(op), patchObject(NULL), renderer(rp), renderObject(true),
-	mRenderColor(color), mViewportColor(vcolor),/*grid(ZX,20.0,10),*/ showgrid(false), showaxes(false), mUseGPU(false), mAntialiasing(true) { 
+	mRenderColor(color), mViewportColor(vcolor),/*grid(ZX,20.0,10),*/ showgrid(false), showaxes(false), mUseGPU(false), mAntialiasing(true), mPatchResolution(12), mIDGlyphWidth(0),
+	mNavigating(false), mNavProxyFaces(20000), mNavProxyResolution(64), mObjectLock(NULL) { 
   mParent = parent;
   // Vector3d neweye = eye - center;
   // double eyedist = norm(neweye);
@@ -150,6 +156,12 @@ GLWidget::GLWidget(int w, int h, DLFLRendererPtr rp, QColor color, QColor vcolor
   // Up = WindowY;
   // normalize(Up);
 
+  mFrameTimer.setSingleShot(true);
+  connect(&mFrameTimer, SIGNAL(timeout()), this, SLOT(renderScheduledFrame()));
+  mNavIdleTimer.setSingleShot(true);
+  mNavIdleTimer.setInterval(NAV_IDLE_TIME);
+  connect(&mNavIdleTimer, SIGNAL(timeout()), this, SLOT(endNavigation()));
+  mLastFrame.start();
 }
 
 GLWidget::~GLWidget(){ 
@@ -164,6 +176,132 @@ void GLWidget::redraw() {
   repaint();
 }
 
+void GLWidget::scheduleNavigationFrame( ) {
+  mNavigating = true;
+  mNavIdleTimer.start();
+  if ( mFrameTimer.isActive() ) return; // A frame is already due
+  int wait = NAV_FRAME_INTERVAL - mLastFrame.elapsed();
+  if ( wait <= 0 ) QGLWidget::update(); // Queued, further events before the paint are merged
+  else mFrameTimer.start(wait);
+}
+
+void GLWidget::renderScheduledFrame( ) {
+  QGLWidget::update();
+}
+
+void GLWidget::endNavigation( ) {
+  mNavIdleTimer.stop();
+  if ( !mNavigating ) return;
+  mNavigating = false;
+  QGLWidget::update();
+}
+
+bool GLWidget::updateNavProxy( ) {
+  NavProxy& px = mNavProxy;
+  if ( object == NULL ) return false;
+  if ( px.valid && px.object == object && px.stamp == object->changeCount() ) return px.used;
+  DLFL_PROFILE("updateNavProxy");
+
+  px.object = object; px.stamp = object->changeCount(); px.valid = true;
+  px.coords.clear(); px.lit.clear(); px.flat.clear(); px.tris.clear();
+  px.used = ( object->num_faces() >= (size_t)mNavProxyFaces );
+  if ( !px.used ) return false;
+
+  Vector3d min, max;
+  object->boundingBox(min,max);
+  Vector3d ext = max - min;
+  double size = qMax(ext[0],qMax(ext[1],ext[2]));
+  if ( size <= 0.0 ) size = 1.0;
+  int res = mNavProxyResolution;
+  double scale = res / size;
+  int n = res+1; // Points on the max side land in an extra cell
+  px.grid.assign(n*n*n,-1);
+
+  std::vector<uint> count;
+  std::vector<GLuint> corners;
+  DLFLFacePtrList::iterator ff = object->beginFace(), fl = object->endFace();
+  while ( ff != fl ) {
+    DLFLFacePtr fp = (*ff); ++ff;
+    RGBColor matcolor = fp->material() ? fp->material()->color : RGBColor(1,1,1);
+    corners.clear();
+    DLFLFaceVertexPtr head = fp->front(), fvp = head;
+    if ( head == NULL ) continue;
+    do {
+      const Vector3d& p = fvp->vertex->coords;
+      int i = (int)((p[0]-min[0])*scale), j = (int)((p[1]-min[1])*scale), k = (int)((p[2]-min[2])*scale);
+      int& cell = px.grid[(k*n + j)*n + i];
+      if ( cell < 0 ) {
+        cell = count.size(); count.push_back(0);
+        for (int c=0; c < 3; ++c) { px.coords.push_back(0); px.lit.push_back(0); px.flat.push_back(0); }
+      }
+      GLfloat *co = &px.coords[3*cell], *li = &px.lit[3*cell], *mc = &px.flat[3*cell];
+      co[0] += p[0]; co[1] += p[1]; co[2] += p[2];
+      li[0] += fvp->color.r; li[1] += fvp->color.g; li[2] += fvp->color.b;
+      mc[0] += matcolor.r; mc[1] += matcolor.g; mc[2] += matcolor.b;
+      ++count[cell];
+      if ( corners.empty() || corners.back() != (GLuint)cell ) corners.push_back(cell);
+      fvp = fvp->next();
+    } while ( fvp != head );
+    if ( corners.size() > 1 && corners.back() == corners.front() ) corners.pop_back();
+
+    // Fan triangulate, skipping triangles which collapsed into a line
+    for (uint c=2; c < corners.size(); ++c) {
+      if ( corners[c-1] == corners[0] || corners[c] == corners[0] || corners[c] == corners[c-1] ) continue;
+      px.tris.push_back(corners[0]); px.tris.push_back(corners[c-1]); px.tris.push_back(corners[c]);
+    }
+  }
+
+  for (uint c=0; c < count.size(); ++c) {
+    GLfloat inv = 1.0 / count[c];
+    for (int d=0; d < 3; ++d) {
+      px.coords[3*c+d] *= inv; px.lit[3*c+d] *= inv; px.flat[3*c+d] *= inv;
+    }
+  }
+  px.colors.resize(4*count.size());
+  return true;
+}
+
+void GLWidget::drawNavProxy( ) {
+  NavProxy& px = mNavProxy;
+  if ( px.tris.empty() ) return;
+  DLFLProfiler::instance().count("proxy triangles", px.tris.size()/3);
+
+  // Pick the colors the way GeometryRenderer::renderFaceVertex does for the current state
+  GeometryRenderer *gr = GeometryRenderer::instance();
+  const GLdouble *rc = gr->renderColor;
+  uint nc = px.coords.size()/3;
+  for (uint c=0; c < nc; ++c) {
+    GLfloat *col = &px.colors[4*c];
+    const GLfloat *li = &px.lit[3*c];
+    for (int d=0; d < 3; ++d) {
+      if ( gr->useLighting && gr->useMaterial ) col[d] = rc[d]*li[d];
+      else if ( gr->useColorable ) col[d] = px.flat[3*c+d];
+      else if ( gr->useLighting ) col[d] = li[d];
+      else col[d] = rc[d];
+    }
+    col[3] = rc[3];
+  }
+
+  double mat[16];
+  object->tr.fillArrayColumnMajor(mat);
+  glPushAttrib(GL_ENABLE_BIT | GL_POLYGON_BIT);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_TEXTURE_2D);
+  glDisable(GL_LIGHTING);
+  glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
+  glPushMatrix();
+  glMultMatrixd(mat);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(3,GL_FLOAT,0,&px.coords[0]);
+  glColorPointer(4,GL_FLOAT,0,&px.colors[0]);
+  glDrawElements(GL_TRIANGLES,px.tris.size(),GL_UNSIGNED_INT,&px.tris[0]);
+  glPopClientAttrib();
+  glPopMatrix();
+  glPopAttrib();
+}
+
 void GLWidget::initializeGL( ) {
 		
 	
@@ -202,6 +340,7 @@ void GLWidget::initializeGL( ) {
   mShowFaceVertexIDs = false;
   mShowSelectedIDs = false;
   mShowHUD = false;
+  mShowProfiler = false;
   mBrushSize = 2.5;
   mShowBrush = false;
   mShowSelectionWindow = false;
@@ -325,6 +464,13 @@ void GLWidget::paintEvent(QPaintEvent *event){
   // //transform the camera
   //   mCamera->SetProjection(width(),height());
 
+  // The object is being changed on another thread, keep the last frame
+  if ( mObjectLock && !mObjectLock->tryLockForRead() ) return;
+
+  mLastFrame.restart();
+  DLFLProfiler::instance().beginFrame();
+  bool proxy = mNavigating && renderObject && updateNavProxy();
+
   QPainter painter;
   painter.begin(this);
   painter.setRenderHint(QPainter::Antialiasing);
@@ -427,7 +573,11 @@ void GLWidget::paintEvent(QPaintEvent *event){
       //glRotatef(90,1,0,0);	
     }
 #endif // GPU_OK
-    if (renderObject){
+    if (proxy) {
+      DLFL_PROFILE("render proxy");
+      drawNavProxy();
+    } else if (renderObject){
+      DLFL_PROFILE("render");
       if(patchObject) 
 	renderer->render(patchObject);
       renderer->render(object);
@@ -476,8 +626,10 @@ void GLWidget::paintEvent(QPaintEvent *event){
   drawSelectionWindow(&painter);	
   //drawBrush(&painter);
   drawHUD(&painter);
+  drawProfiler(&painter);
   drawSelectedIDs(&painter, &model[0][0], &proj[0][0], &view[0]);
-  drawIDs(&painter, &model[0][0], &proj[0][0], &view[0]); // draw vertex, edge and face ids
+  if ( !proxy )
+    drawIDs(&painter, &model[0][0], &proj[0][0], &view[0]); // draw vertex, edge and face ids
 	
 	
 	
@@ -530,6 +682,8 @@ void GLWidget::paintEvent(QPaintEvent *event){
   glPopMatrix();
 	
   painter.end();
+  DLFLProfiler::instance().endFrame();
+  if ( mObjectLock ) mObjectLock->unlock();
 }
 
 void GLWidget::resizeGL( int width, int height ){
@@ -664,131 +818,242 @@ void GLWidget::drawHUD(QPainter *painter){
   }
 }
 
+// Slowest last call first
+static bool slowerLastCall( const DLFLProfileStat& a, const DLFLProfileStat& b ) {
+  return a.last > b.last;
+}
+
+// Timings from the profiler: frame time, the scopes and operations whose last
+// call took longest, and the counters of the last frame
+void GLWidget::drawProfiler(QPainter *painter){
+  if (!mShowProfiler) return;
+  DLFLProfiler& prof = DLFLProfiler::instance();
+  vector<DLFLProfileStat> stats;
+  vector<DLFLProfileCounter> counters;
+  prof.getStats(stats);
+  prof.getCounters(counters);
+  sort(stats.begin(),stats.end(),slowerLastCall);
+
+  QString s = QString("Frame: %1 ms  (avg %2 ms)\n\n")
+    .arg(prof.lastFrameTime()*1000.0,0,'f',1).arg(prof.averageFrameTime()*1000.0,0,'f',1);
+  s += QString("%1 %2 %3 %4 %5 %6\n").arg("",-22).arg("last ms",9).arg("avg ms",9)
+    .arg("calls",7).arg("allocs",8).arg("elements",9);
+  for (uint i=0; i < stats.size() && i < 16; ++i) {
+    const DLFLProfileStat& st = stats[i];
+    QString name = QString(st.name).left(22);
+    s += QString("%1 %2 %3 %4 %5 %6\n").arg(name,-22)
+      .arg(st.last*1000.0,9,'f',2).arg(st.total*1000.0/st.calls,9,'f',2).arg(st.calls,7)
+      .arg(st.allocations >= 0 ? QString::number(st.allocations) : QString("-"),8)
+      .arg(st.elements >= 0 ? QString::number(st.elements) : QString("-"),9);
+  }
+  for (uint i=0; i < counters.size(); ++i)
+    s += QString("\n%1 %2").arg(QString(counters[i].name).left(22),-22).arg(counters[i].value);
+
+  QFont font("Courier", 10);
+  font.setStyleHint(QFont::TypeWriter);
+  QFontMetrics fm(font);
+  QRect r = fm.boundingRect(QRect(0,0,width(),height()), Qt::AlignLeft, s);
+
+  painter->save();
+  painter->setFont(font);
+  painter->setPen(Qt::NoPen);
+  painter->setBrush(QBrush(QColor(0,0,0,160)));
+  painter->drawRect(QRect(5, 5, r.width()+10, r.height()+10));
+  painter->setPen(Qt::white);
+  painter->drawText(QRect(10, 10, r.width(), r.height()), Qt::AlignLeft, s);
+  painter->restore();
+}
+
+// Size of an ID label, also the cell size used to thin out overlapping labels
+#define ID_LABEL_WIDTH 35
+#define ID_LABEL_HEIGHT 20
+
+// r = a * b for 4x4 column major matrices
+static void multMatrix( const double *a, const double *b, double *r ) {
+  for (int c=0; c < 4; ++c)
+    for (int i=0; i < 4; ++i)
+      r[c*4+i] = a[i]*b[c*4] + a[4+i]*b[c*4+1] + a[8+i]*b[c*4+2] + a[12+i]*b[c*4+3];
+}
+
+// Render the label backgrounds (one per element type) and the digits 0-9 into a
+// single pixmap, so the labels can be drawn with one call without any text layout
+void GLWidget::updateIDAtlas( const QFont& font ) {
+  QColor colors[3] = { mVertexIDBgColor, mEdgeIDBgColor, mFaceIDBgColor };
+  if ( !mIDAtlas.isNull() && font == mIDAtlasFont &&
+       colors[0] == mIDAtlasColors[0] && colors[1] == mIDAtlasColors[1] && colors[2] == mIDAtlasColors[2] )
+    return;
+
+  QFontMetrics fm(font);
+  mIDGlyphWidth = 0;
+  for (int i=0; i < 10; ++i)
+    mIDGlyphWidth = qMax(mIDGlyphWidth,fm.width(QChar('0'+i)));
+
+  mIDAtlas = QPixmap(3*ID_LABEL_WIDTH + 10*mIDGlyphWidth, ID_LABEL_HEIGHT);
+  mIDAtlas.fill(Qt::transparent);
+  QPainter painter(&mIDAtlas);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setFont(font);
+  painter.setPen(Qt::NoPen);
+  for (int i=0; i < 3; ++i) {
+    painter.setBrush(QColor(colors[i].red(),colors[i].green(),colors[i].blue()));
+    painter.drawRoundRect(QRectF(i*ID_LABEL_WIDTH,0,ID_LABEL_WIDTH,ID_LABEL_HEIGHT),6,6);
+    mIDAtlasColors[i] = colors[i];
+  }
+  painter.setPen(Qt::white);
+  for (int i=0; i < 10; ++i)
+    painter.drawText(QRectF(3*ID_LABEL_WIDTH + i*mIDGlyphWidth,0,mIDGlyphWidth,ID_LABEL_HEIGHT),Qt::AlignCenter,QString(QChar('0'+i)));
+  mIDAtlasFont = font;
+}
+
+// Project a point with the combined matrix and keep it if its label is on screen
+void GLWidget::addIDLabel( const double *mvp, const GLint *view, const Vector3d& p, double dist, uint id, int type ) {
+  double x = p[0], y = p[1], z = p[2];
+  double cw = mvp[3]*x + mvp[7]*y + mvp[11]*z + mvp[15];
+  if ( cw <= 0.0 ) return; // behind the eye
+  double cz = (mvp[2]*x + mvp[6]*y + mvp[10]*z + mvp[14])/cw;
+  if ( cz < -1.0 || cz > 1.0 ) return;
+  double win_x = view[0] + view[2]*((mvp[0]*x + mvp[4]*y + mvp[8]*z + mvp[12])/cw + 1.0)*0.5;
+  double win_y = view[1] + view[3]*((mvp[1]*x + mvp[5]*y + mvp[9]*z + mvp[13])/cw + 1.0)*0.5;
+  win_y = height() - win_y; // y is inverted
+  if ( win_x <= -ID_LABEL_WIDTH || win_x >= width() || win_y <= -ID_LABEL_HEIGHT || win_y >= height() ) return;
+
+  IDLabel label;
+  label.x = win_x; label.y = win_y; label.dist = dist;
+  label.id = id; label.type = type;
+  mIDLabels.push_back(label);
+}
+
 void GLWidget::drawIDs( QPainter *painter, const GLdouble *model, const GLdouble *proj, const GLint	*view) {
+  if ( !mShowVertexIDs && !mShowEdgeIDs && !mShowFaceIDs ) return;
+  DLFL_PROFILE("drawIDs");
+
   glDisable(GL_DEPTH_TEST);
-  GLdouble win_x = 0, win_y = 0, win_z = 0;	
-  double min_dist=100000000.0, max_dist=-100000000.0, x,y,z,d;
-  int count, min_alpha = 25, max_alpha = 255;
-  // Vector3d coord = viewport.camera.getPos(); //use this to find the dist from the camera
-  Vector3d coord = mCamera->getEye(); //use this to find the dist from the camera
-  QBrush brush;
-	
-  Vector3d offset = object->position;
-	
-  /* Draw Vertex IDs */
+  int min_alpha = 25, max_alpha = 255;
+
+  // Everything is projected with proj * model * object transform in one go. Back facing
+  // elements are found in object space, so take the eye there as well
+  double trmat[16], mv[16], mvp[16];
+  object->tr.fillArrayColumnMajor(trmat);
+  multMatrix(model,trmat,mv);
+  multMatrix(proj,mv,mvp);
+  Transformation invtr(object->tr);
+  invtr.invert();
+  Vector3d eye = invtr.applyTo(mCamera->getEye());
+
+  mIDLabels.clear();
+
+  /* Vertex IDs */
   if( mShowVertexIDs ) {
-    DLFLVertexPtrArray vparray;
-    object->getVertices(vparray);
-    double vlsqr_array[vparray.size()];
-    count = 0;
-    DLFLVertexPtrArray::iterator it;
-    for( it = vparray.begin(); it != vparray.end(); it++) {
-      Vector3d dist = (*it)->coords - coord;
-      vlsqr_array[count] = dist.lengthsqr();
-      max_dist = (vlsqr_array[count] > max_dist ) ? vlsqr_array[count] : max_dist;
-      min_dist = (vlsqr_array[count] < min_dist ) ? vlsqr_array[count] : min_dist;
-      count++;
-    }
-    count = 0;
-    for( it = vparray.begin(); it != vparray.end(); it++) {
-      Vector3d point = (*it)->coords;
-      point = object->tr.applyTo(point);
-      //point += object->position;
-      point.get(x,y,z);		
-      QString id = QString::number((*it)->getID() );
-      if(max_dist == min_dist)
-	d = min_alpha;
-      else
-	d = (vlsqr_array[count]-min_dist)*(max_alpha-min_alpha)/(max_dist - min_dist) + min_alpha;
-      gluProject(x, y, z, model, proj, view, &win_x, &win_y, &win_z);
-      win_y = height() - win_y; // y is inverted
-      painter->setPen(Qt::NoPen);
-      brush = QBrush(QColor(mVertexIDBgColor.red(),mVertexIDBgColor.green(),mVertexIDBgColor.blue(),min_alpha+max_alpha-d));
-      painter->setBrush(brush);
-      QRectF rectangle(win_x, win_y, 35, 20);
-      painter->drawRoundRect(rectangle,6,6);
-      painter->setPen(QColor(255,255,255,min_alpha+max_alpha-d));
-      painter->drawText(rectangle, Qt::AlignCenter,id);
-      count++;
+    DLFLVertexPtrList::iterator first = object->beginVertex(), last = object->endVertex();
+    while ( first != last ) {
+      DLFLVertexPtr vp = (*first); ++first;
+      Vector3d dir = vp->coords - eye;
+      if ( (vp->getNormal() * dir) > 0.0 ) continue; // back facing
+      addIDLabel(mvp,view,vp->coords,dir.lengthsqr(),vp->getID(),0);
     }
   }
 
-  /* Draw Edge IDs */
+  /* Edge IDs, shown if either adjacent face is front facing */
   if( mShowEdgeIDs ) {
-    DLFLEdgePtrArray eparray;
-    object->getEdges(eparray);
-    double elsqr_array[eparray.size()];
-    count = 0;
-    DLFLEdgePtrArray::iterator it;
-    for( it = eparray.begin(); it != eparray.end(); it++) {
-      Vector3d dist = (*it)->getMidPoint() - coord;
-      elsqr_array[count] = dist.lengthsqr();
-      max_dist = (elsqr_array[count] > max_dist ) ? elsqr_array[count] : max_dist;
-      min_dist = (elsqr_array[count] < min_dist ) ? elsqr_array[count] : min_dist;
-      count++;
-    }
-    count=0;
-    for( it = eparray.begin(); it != eparray.end(); it++) {
-      QString id = QString::number( (*it)->getID() );
-      Vector3d point = (*it)->getMidPoint();
-      point = object->tr.applyTo(point);
-      point.get(x,y,z);
-      if(max_dist == min_dist)
-	d = min_alpha;
-      else
-	d = (elsqr_array[count]-min_dist)*(max_alpha-min_alpha)/(max_dist - min_dist) + min_alpha;
-      gluProject(x, y, z, model, proj, view, &win_x, &win_y, &win_z);
-      win_y = height() - win_y; // y is inverted
-      painter->setPen(Qt::NoPen);
-      // std::cout<< min_alpha << " " << max_alpha << " "<< d << std::endl;
-      brush = QBrush(QColor(mEdgeIDBgColor.red(),mEdgeIDBgColor.green(),mEdgeIDBgColor.blue(),min_alpha+max_alpha-d));
-      painter->setBrush(brush);
-      QRectF rectangle(win_x, win_y, 35, 20);
-      painter->drawRoundRect(rectangle,6,6);
-      painter->setPen(QColor(255,255,255,min_alpha+max_alpha-d));
-      painter->drawText(rectangle, Qt::AlignCenter,id);
-      count++;
+    DLFLEdgePtrList::iterator first = object->beginEdge(), last = object->endEdge();
+    DLFLVertexPtr vp1, vp2;
+    DLFLFacePtr fp1, fp2;
+    while ( first != last ) {
+      DLFLEdgePtr ep = (*first); ++first;
+      ep->getVertexPointers(vp1,vp2);
+      ep->getFacePointers(fp1,fp2);
+      Vector3d point = 0.5*(vp1->coords + vp2->coords);
+      Vector3d dir = point - eye;
+      if ( fp1 && fp2 && (fp1->normal * dir) > 0.0 && (fp2->normal * dir) > 0.0 ) continue;
+      addIDLabel(mvp,view,point,dir.lengthsqr(),ep->getID(),1);
     }
   }
-	
-  /* Draw Face IDs */
+
+  /* Face IDs */
   if( mShowFaceIDs ) {
-    DLFLFacePtrArray fparray;
-    object->getFaces(fparray);
-    double flsqr_array[fparray.size()];
-    count = 0;
-    DLFLFacePtrArray::iterator it;
-    for( it = fparray.begin(); it != fparray.end(); it++) {
-      Vector3d dist = (*it)->geomCentroid() - coord;
-      flsqr_array[count] = dist.lengthsqr();
-      max_dist = (flsqr_array[count] > max_dist ) ? flsqr_array[count] : max_dist;
-      min_dist = (flsqr_array[count] < min_dist ) ? flsqr_array[count] : min_dist;
-      count++;
-    }
-    count=0;
-    for( it = fparray.begin(); it != fparray.end(); it++) {
-      QString id = QString::number( (*it)->getID() );
-      Vector3d point = (*it)->geomCentroid();// + (*it)->getNormal();
-      point = object->tr.applyTo(point);
-      point.get(x,y,z);
-      if(max_dist == min_dist)
-	d = min_alpha;
-      else
-	d = (flsqr_array[count]-min_dist)*(max_alpha-min_alpha)/(max_dist - min_dist) + min_alpha;
-      gluProject(x, y, z, model, proj, view, &win_x, &win_y, &win_z);
-      win_y = height() - win_y; // y is inverted
-      painter->setPen(Qt::NoPen);
-      brush = QBrush(QColor(mFaceIDBgColor.red(),mFaceIDBgColor.green(),mFaceIDBgColor.blue(),min_alpha+max_alpha-d));
-      painter->setBrush(brush);
-      QRectF rectangle(win_x, win_y, 35, 20);
-      painter->drawRoundRect(rectangle,6,6);
-      painter->setPen(QColor(255,255,255,min_alpha+max_alpha-d));
-      painter->drawText(rectangle, Qt::AlignCenter,id);
-      count++;
+    DLFLFacePtrList::iterator first = object->beginFace(), last = object->endFace();
+    while ( first != last ) {
+      DLFLFacePtr fp = (*first); ++first;
+      DLFLFaceVertexPtr head = fp->front(), current = head;
+      if ( head == NULL ) continue;
+      Vector3d point;
+      int num = 0;
+      do {
+        point += current->getVertexCoords(); ++num;
+        current = current->next();
+      } while ( current != head );
+      point /= num;
+      Vector3d dir = point - eye;
+      if ( (fp->normal * dir) > 0.0 ) continue;
+      addIDLabel(mvp,view,point,dir.lengthsqr(),fp->getID(),2);
     }
   }
 
-  glPopMatrix( );
+  if ( mIDLabels.empty() ) {
+    glEnable(GL_DEPTH_TEST);
+    return;
+  }
+  DLFLProfiler::instance().count("ID labels", mIDLabels.size());
+
+  // Keep only the nearest label in each label sized cell of the window
+  int gw = width()/ID_LABEL_WIDTH + 1, gh = height()/ID_LABEL_HEIGHT + 1;
+  double min_dist = mIDLabels[0].dist, max_dist = mIDLabels[0].dist;
+  mIDGrid.assign(gw*gh,-1);
+  for (uint i=0; i < mIDLabels.size(); ++i) {
+    const IDLabel& label = mIDLabels[i];
+    min_dist = qMin(min_dist,(double)label.dist);
+    max_dist = qMax(max_dist,(double)label.dist);
+    int cx = qBound(0,(int)(label.x + 0.5*ID_LABEL_WIDTH)/ID_LABEL_WIDTH,gw-1);
+    int cy = qBound(0,(int)(label.y + 0.5*ID_LABEL_HEIGHT)/ID_LABEL_HEIGHT,gh-1);
+    int& cell = mIDGrid[cy*gw+cx];
+    if ( cell < 0 || label.dist < mIDLabels[cell].dist ) cell = i;
+  }
+
+  updateIDAtlas(painter->font());
+
+#if QT_VERSION >= 0x040700
+  QVector<QPainter::PixmapFragment> fragments;
+  fragments.reserve(mIDGrid.size()*4);
+#endif
+  char digits[16];
+  for (uint c=0; c < mIDGrid.size(); ++c) {
+    if ( mIDGrid[c] < 0 ) continue;
+    const IDLabel& label = mIDLabels[mIDGrid[c]];
+    // Farther labels fade out
+    double d = min_alpha;
+    if ( max_dist > min_dist )
+      d = (label.dist-min_dist)*(max_alpha-min_alpha)/(max_dist - min_dist) + min_alpha;
+    qreal opacity = (min_alpha+max_alpha-d)/255.0;
+
+    int n = 0;
+    uint id = label.id;
+    do { digits[n++] = id%10; id /= 10; } while ( id > 0 );
+    qreal w = qMax(ID_LABEL_WIDTH,n*mIDGlyphWidth+6);
+    qreal cy = label.y + 0.5*ID_LABEL_HEIGHT;
+    qreal x = label.x + 0.5*(w - n*mIDGlyphWidth) + 0.5*mIDGlyphWidth;
+#if QT_VERSION >= 0x040700
+    fragments.append(QPainter::PixmapFragment::create(QPointF(label.x + 0.5*w,cy),
+                                                      QRectF(label.type*ID_LABEL_WIDTH,0,ID_LABEL_WIDTH,ID_LABEL_HEIGHT),
+                                                      w/ID_LABEL_WIDTH,1.0,0.0,opacity));
+    for (int i=n-1; i >= 0; --i, x += mIDGlyphWidth)
+      fragments.append(QPainter::PixmapFragment::create(QPointF(x,cy),
+                                                        QRectF(3*ID_LABEL_WIDTH + digits[i]*mIDGlyphWidth,0,mIDGlyphWidth,ID_LABEL_HEIGHT),
+                                                        1.0,1.0,0.0,opacity));
+#else
+    painter->setOpacity(opacity);
+    painter->drawPixmap(QRectF(label.x,label.y,w,ID_LABEL_HEIGHT),mIDAtlas,
+                        QRectF(label.type*ID_LABEL_WIDTH,0,ID_LABEL_WIDTH,ID_LABEL_HEIGHT));
+    for (int i=n-1; i >= 0; --i, x += mIDGlyphWidth)
+      painter->drawPixmap(QPointF(x - 0.5*mIDGlyphWidth,label.y),mIDAtlas,
+                          QRectF(3*ID_LABEL_WIDTH + digits[i]*mIDGlyphWidth,0,mIDGlyphWidth,ID_LABEL_HEIGHT));
+#endif
+  }
+#if QT_VERSION >= 0x040700
+  painter->drawPixmapFragments(fragments.constData(),fragments.size(),mIDAtlas);
+#else
+  painter->setOpacity(1.0);
+#endif
+
   glEnable(GL_DEPTH_TEST);
 }
 
@@ -809,7 +1074,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 	
     if( !mShowVertexIDs ) {
       if ( !object->sel_vptr_array.empty() ){
-	DLFLVertexPtrArray::iterator first, last;
+	DLFLVertexPtrArray::const_iterator first, last;
 	first = object->sel_vptr_array.begin(); last = object->sel_vptr_array.end();
 	while ( first != last ){
 	  QString id = QString::number( (*first)->getID() );
@@ -834,7 +1099,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 	
     if( !mShowEdgeIDs ) {
       if ( !object->sel_eptr_array.empty() ){
-	DLFLEdgePtrArray::iterator first, last;
+	DLFLEdgePtrArray::const_iterator first, last;
 	first = object->sel_eptr_array.begin(); last = object->sel_eptr_array.end();
 	while ( first != last ){
 	  QString id = QString::number( (*first)->getID() );
@@ -858,7 +1123,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 
     if( !mShowFaceIDs ) {
       if ( !object->sel_fptr_array.empty() ){
-	DLFLFacePtrArray::iterator first, last;
+	DLFLFacePtrArray::const_iterator first, last;
 	first = object->sel_fptr_array.begin(); last = object->sel_fptr_array.end();
 	while ( first != last )	{
 	  QString id = QString::number( (*first)->getID() );
@@ -883,7 +1148,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 
     if( !mShowFaceVertexIDs ) {
       if ( !object->sel_fvptr_array.empty() ) {
-	DLFLFaceVertexPtrArray::iterator first, last;
+	DLFLFaceVertexPtrArray::const_iterator first, last;
 	first = object->sel_fvptr_array.begin(); last = object->sel_fvptr_array.end();
 	while ( first != last ){
 	  QString id = QString::number( (*first)->vertex->getID() );
@@ -931,6 +1196,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 
 // Subroutine for selecting a Vertex
 DLFLVertexPtr GLWidget::selectVertex(int mx, int my, int w, int h) {
+  DLFL_PROFILE("selectVertex");
   GLuint selectBuf[8192];
   uint closest;
   GLuint dist;
@@ -990,6 +1256,7 @@ DLFLVertexPtr GLWidget::selectVertex(int mx, int my, int w, int h) {
 
 // Subroutine for selecting a Vertex
 DLFLVertexPtrArray GLWidget::selectVertices(int mx, int my, int w, int h) {
+  DLFL_PROFILE("selectVertices");
   GLuint selectBuf[8192];
   long hits, index;
   DLFLVertexPtrArray vparray;
@@ -1045,6 +1312,7 @@ DLFLVertexPtrArray GLWidget::selectVertices(int mx, int my, int w, int h) {
 // Subroutine for selecting a locator
 DLFLLocatorPtr GLWidget::selectLocator(int mx, int my, int w, int h) // brianb
 {
+  DLFL_PROFILE("selectLocator");
   GLuint selectBuf[8192];
   uint closest;
   GLuint dist;
@@ -1110,6 +1378,7 @@ DLFLLocatorPtr GLWidget::selectLocator(int mx, int my, int w, int h) // brianb
 
 // Subroutine for selecting an Edge
 DLFLEdgePtr GLWidget::selectEdge(int mx, int my,int w, int h) {
+  DLFL_PROFILE("selectEdge");
   GLuint selectBuf[8192];
   uint closest;
   GLuint dist;
@@ -1167,6 +1436,7 @@ DLFLEdgePtr GLWidget::selectEdge(int mx, int my,int w, int h) {
 
 // Subroutine for selecting an Edge
 DLFLEdgePtrArray GLWidget::selectEdges(int mx, int my,int w, int h) {
+  DLFL_PROFILE("selectEdges");
   GLuint selectBuf[8192];
   long hits, index;
   DLFLEdgePtr sel(NULL);
@@ -1216,6 +1486,7 @@ DLFLEdgePtrArray GLWidget::selectEdges(int mx, int my,int w, int h) {
 
 // Subroutine for selecting a Face
 DLFLFacePtr GLWidget::selectFace(int mx, int my, int w, int h) {
+  DLFL_PROFILE("selectFace");
   GLuint selectBuf[8192];
   uint closest;
   GLuint dist;
@@ -1274,6 +1545,7 @@ DLFLFacePtr GLWidget::selectFace(int mx, int my, int w, int h) {
 
 // Subroutine for selecting multiple faces at once
 DLFLFacePtrArray GLWidget::selectFaces(int mx, int my, int w, int h) {
+  DLFL_PROFILE("selectFaces");
   // glEnable(GL_CULL_FACE);
   GLuint selectBuf[8192];
   long hits, index;
@@ -1397,6 +1669,7 @@ DLFLFacePtr GLWidget::deselectFaces(int mx, int my, int w, int h) {
 
 // Subroutine for selecting a FaceVertex (Corner) within a Face
 DLFLFaceVertexPtr GLWidget::selectFaceVertex(DLFLFacePtr fp, int mx, int my, int w, int h) {
+  DLFL_PROFILE("selectFaceVertex");
   GLuint selectBuf[8192];
   uint closest;
   GLuint dist;
@@ -1453,6 +1726,7 @@ DLFLFaceVertexPtr GLWidget::selectFaceVertex(DLFLFacePtr fp, int mx, int my, int
 
 // Draw the selected items
 void GLWidget::drawSelected(void) {
+  DLFL_PROFILE("drawSelected");
   if ( !sel_lptr_array.empty() ) {
     sel_lptr_array[0]->render();
   }
@@ -1461,7 +1735,7 @@ void GLWidget::drawSelected(void) {
     glPointSize(mSelectedVertexThickness);
     //glBegin(GL_POINTS);
     glColor4f(mSelectedVertexColor.redF(),mSelectedVertexColor.greenF(),mSelectedVertexColor.blueF(),mSelectedVertexColor.alphaF());
-    DLFLVertexPtrArray::iterator first, last;
+    DLFLVertexPtrArray::const_iterator first, last;
     first = object->sel_vptr_array.begin(); last = object->sel_vptr_array.end();
     while ( first != last ){
       GeometryRenderer::instance()->renderVertex(*first);
@@ -1475,7 +1749,7 @@ void GLWidget::drawSelected(void) {
   if ( !object->sel_eptr_array.empty() ){
     glLineWidth(mSelectedEdgeThickness);
     glColor4f(mSelectedEdgeColor.redF(),mSelectedEdgeColor.greenF(),mSelectedEdgeColor.blueF(),mSelectedEdgeColor.alphaF());
-    DLFLEdgePtrArray::iterator first, last;
+    DLFLEdgePtrArray::const_iterator first, last;
     first = object->sel_eptr_array.begin(); last = object->sel_eptr_array.end();
     while ( first != last ){
       glBegin(GL_LINES); {
@@ -1490,7 +1764,7 @@ void GLWidget::drawSelected(void) {
   if ( !object->sel_fptr_array.empty() ){
     glLineWidth(mSelectedEdgeThickness);
     glColor4f(mSelectedFaceColor.redF(),mSelectedFaceColor.greenF(),mSelectedFaceColor.blueF(),mSelectedFaceColor.alphaF());
-    DLFLFacePtrArray::iterator first, last;
+    DLFLFacePtrArray::const_iterator first, last;
     first = object->sel_fptr_array.begin(); last = object->sel_fptr_array.end();
     while ( first != last )	{
       GeometryRenderer::instance()->renderFace(*first,false);
@@ -1504,7 +1778,7 @@ void GLWidget::drawSelected(void) {
     glPointSize(mSelectedVertexThickness);
     glColor4f(mSelectedVertexColor.redF(),mSelectedVertexColor.greenF(),mSelectedVertexColor.blueF(),mSelectedVertexColor.alphaF());
     glBegin(GL_POINTS);
-    DLFLFaceVertexPtrArray::iterator first, last;
+    DLFLFaceVertexPtrArray::const_iterator first, last;
     first = object->sel_fvptr_array.begin(); last = object->sel_fvptr_array.end();
     while ( first != last ){
       GeometryRenderer::instance()->renderFaceVertex(*first,false);
@@ -1523,7 +1797,7 @@ void GLWidget::wheelEvent(QWheelEvent *event) {
   // int numSteps = numDegrees / 15;
   // double z;
   mCamera->HandleMouseWheel(event->delta(), width(),height());
-  repaint();
+  scheduleNavigationFrame();
 
   // if ( viewport.current() == VPRotate) {
   // 	viewport.handle_rotate(VPRelease,x,y); // Stop rotating
@@ -1611,7 +1885,7 @@ void GLWidget::mousePressEvent(QMouseEvent *event) {
   if ( QApplication::keyboardModifiers() == Qt::AltModifier || 
        (event->buttons() == Qt::LeftButton && QApplication::keyboardModifiers() == (Qt::ShiftModifier | Qt::AltModifier)) ){
     mCamera->HandleMouseEvent(event->button(), event->type(), event->x(), event->y());
-    repaint();	
+    scheduleNavigationFrame();
   }	
   else event->ignore();
 	
@@ -1684,7 +1958,7 @@ void GLWidget::mouseMoveEvent(QMouseEvent *event) {
   if ( QApplication::keyboardModifiers() == Qt::AltModifier || 
        (event->buttons() == Qt::LeftButton && QApplication::keyboardModifiers() == (Qt::ShiftModifier | Qt::AltModifier)) ){
     mCamera->HandleMouseMotion(event->x(),event->y(), width(), height() );
-    repaint();	
+    scheduleNavigationFrame();
   }	
   else event->ignore();
 	
@@ -1713,7 +1987,7 @@ void GLWidget::mouseReleaseEvent(QMouseEvent *event) {
   if ( QApplication::keyboardModifiers() == Qt::AltModifier || 
        (event->buttons() == Qt::LeftButton && QApplication::keyboardModifiers() == (Qt::ShiftModifier | Qt::AltModifier)) ){
     mCamera->HandleMouseEvent(event->button(), event->type(), event->x(), event->y());
-    repaint();	
+    endNavigation(); // Drag is over, draw the full object right away
   }	
   else event->ignore();
 
@@ -1751,15 +2025,18 @@ void GLWidget::recomputeNormals(void)     // Recompute normals and lighting
 {
   object->computeNormals();
   computeLighting( object, patchObject, &plight, mUseGPU);
+  mNavProxy.valid = false;
 }
 
 void GLWidget::recomputeLighting(void)                // Recompute lighting
 {
   computeLighting( object, patchObject, &plight, mUseGPU);
+  mNavProxy.valid = false; // Proxy colors come from the lighting
 }
 
 void GLWidget::recomputePatches(void) // Recompute the patches for patch rendering
 {
+  DLFL_PROFILE("recomputePatches");
   if(patchObject)
     patchObject->updatePatches(object);
 }
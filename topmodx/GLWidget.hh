@@ -43,8 +43,12 @@
 #include <QKeyEvent>
 #include <QFont>
 #include <QPushButton>
+#include <QTimer>
+#include <QTime>
+#include <QReadWriteLock>
 
 #include <DLFLObject.hh>
+#include <DLFLProfile.hh>
 #include "DLFLRenderer.hh"
 #include "TMPatchObject.hh"
 
@@ -90,6 +94,8 @@ public :
 	public slots :
 
 	// void toggleFullScreen( ); //not needed anymore... moved to main window
+	void renderScheduledFrame( );
+	void endNavigation( );
 	void update() { repaint(); };
 	// void switchTo(VPView view);
 
@@ -112,6 +118,7 @@ public :
 	void setFaceCentroidThickness(double t){ if( renderer ) renderer->setFaceCentroidThickness(t); redraw(); };
 	void setNormalThickness(double t){ if( renderer ) renderer->setNormalThickness(t); redraw(); };
 	void setNormalLength(double l){ if( renderer ) renderer->setNormalLength(l); redraw(); };
+	void setPatchResolution(double r){ mPatchResolution = (int)r; if( patchObject ) patchObject->setResolution(mPatchResolution); redraw(); };
 
 	//setters for properties in glwidget... always call redraw()
 	void setSelectedVertexThickness(double t){ mSelectedVertexThickness = t; redraw(); };
@@ -129,19 +136,28 @@ public :
 	void setFarPlane(double f){ mCamera->setFarPlane(f); redraw(); };
 	void setFOV(double fov){ mCamera->setFOV(fov); redraw(); };
 	
-	void zoomIn(){ mCamera->HandleMouseWheel(100, width(),height()); repaint(); };
-	void zoomOut(){ mCamera->HandleMouseWheel(-100, width(),height()); repaint(); };
+	void zoomIn(){ mCamera->HandleMouseWheel(100, width(),height()); scheduleNavigationFrame(); };
+	void zoomOut(){ mCamera->HandleMouseWheel(-100, width(),height()); scheduleNavigationFrame(); };
 	
 		//compute lighting and normals functions now moved here from MainWindow
 	void recomputeNormals();
 	void recomputeLighting();
 	void recomputePatches();	
 
+	// Lock of a thread which changes the object while it runs (eg. scripts).
+	// It is held for reading while drawing, frames are skipped while it is held for writing
+	void setObjectLock(QReadWriteLock *lock){ mObjectLock = lock; };
+
 	void toggleHUD() {
 		mShowHUD = !mShowHUD;
 		this->repaint();
 	}
 
+	void toggleProfiler() {
+		mShowProfiler = !mShowProfiler;
+		this->repaint();
+	}
+
 	#ifdef GPU_OK
 	void toggleGPU(){
 		if (renderer)
@@ -259,20 +275,17 @@ public :
 	}
 
 	void selectAllFaces(){
-		clearSelectedFaces();
-		object->getFaces(object->sel_fptr_array);
+		object->sel_fptr_array.assign(object->beginFace(),object->endFace());
 		repaint();
 	}
 
 	void selectAllEdges(){
-		clearSelectedEdges();
-		object->getEdges(object->sel_eptr_array);
+		object->sel_eptr_array.assign(object->beginEdge(),object->endEdge());
 		repaint();
 	}
 
 	void selectAllVertices(){
-		clearSelectedVertices();
-		object->getVertices(object->sel_vptr_array);
+		object->sel_vptr_array.assign(object->beginVertex(),object->endVertex());
 		repaint();
 	}
 
@@ -283,41 +296,17 @@ public :
 	}
 	
 	void selectInverseFaces(){
-		DLFLFacePtrArray fparray;
-		vector<DLFLFacePtr>::iterator it;
-		object->getFaces(fparray);
-		for (it = fparray.begin(); it != fparray.end(); it++){
-			if (!isSelected(*it)){
-				addToSelection(*it);
-			}
-			else clearSelectedFace(*it);
-		}
+		object->selectInverseFaces();
 		repaint();
 	}
 
 	void selectInverseEdges(){
-		DLFLEdgePtrArray eparray;
-		vector<DLFLEdgePtr>::iterator it;
-		object->getEdges(eparray);
-		for (it = eparray.begin(); it != eparray.end(); it++){
-			if (!isSelected(*it)){
-				addToSelection(*it);
-			}
-			else clearSelectedEdge(*it);
-		}
+		object->selectInverseEdges();
 		repaint();
 	}
 
 	void selectInverseVertices(){
-		DLFLVertexPtrArray vparray;
-		vector<DLFLVertexPtr>::iterator it;
-		object->getVertices(vparray);
-		for (it = vparray.begin(); it != vparray.end(); it++){
-			if (!isSelected(*it)){
-				addToSelection(*it);
-			}
-			else clearSelectedVertex(*it);
-		}
+		object->selectInverseVertices();
 		repaint();
 	}
 		//maybe this isn't necessary? ??
@@ -355,14 +344,24 @@ public :
 
 	void drawText( int width, int height );
 	void drawIDs( QPainter *painter, const GLdouble *model, const GLdouble *proj, const GLint	*view);
+	void addIDLabel( const double *mvp, const GLint *view, const Vector3d& p, double dist, uint id, int type );
+	void updateIDAtlas( const QFont& font );
 	void drawSelectedIDs( QPainter *painter, const GLdouble *model, const GLdouble *proj, const GLint	*view);
 	void drawHUD(QPainter *painter);
+	void drawProfiler(QPainter *painter);
 	void drawBrush(QPainter *painter);
 	void drawSelectionWindow(QPainter *painter);
 	void resizeGL( int width, int height );
 
 	void setupViewport(int width, int height);
 
+	// Camera navigation. Input events only ask for a frame, frames are drawn at most
+	// once per NAV_FRAME_INTERVAL ms. Large objects are drawn as a clustered proxy
+	// while the camera moves and at full quality once it has been still for a while
+	void scheduleNavigationFrame( );
+	bool updateNavProxy( );             // Returns false if the object is drawn as is
+	void drawNavProxy( );
+
 	#ifdef GPU_OK
 		void enableGLLights(); //gl lighting for use in cg shaders
 	  CgData *cg;
@@ -382,11 +381,54 @@ public :
 	bool mShowSelectedIDs;
 	bool mShowFaceVertexIDs;
 	bool mShowHUD;
+	bool mShowProfiler;
 	bool mShowBrush;
 	bool mShowSelectionWindow;
 	bool mUseGPU;
 	bool mAntialiasing;
+	int mPatchResolution; // tessellation steps per patch direction
 	int mBrushStartX;
+
+	// ID overlay. Labels are projected and culled into mIDLabels, thinned out
+	// to one per screen cell and drawn from a prerendered atlas holding the
+	// label backgrounds and the digits
+	struct IDLabel {
+		float x, y;         // Window position of the top left corner
+		float dist;         // Squared distance from the eye, nearer labels win a cell
+		uint id;
+		int type;           // 0 vertex, 1 edge, 2 face
+	};
+	std::vector<IDLabel> mIDLabels;
+	std::vector<int> mIDGrid;
+	QPixmap mIDAtlas;
+	QFont mIDAtlasFont;
+	QColor mIDAtlasColors[3];
+	int mIDGlyphWidth;
+
+	// Navigation proxy. Vertices are merged per cell of a grid over the bounding box,
+	// faces are fan triangulated on the cells and degenerate triangles dropped.
+	// Rebuilt when the object changes (see DLFLObject::touch()) or is relit
+	struct NavProxy {
+		DLFLObjectPtr object;
+		uint stamp;
+		bool valid;
+		bool used;                       // Object is large enough for a proxy
+		std::vector<GLfloat> coords;     // Cell centroids, 3 per cell
+		std::vector<GLfloat> lit;        // Average lit face-vertex color, 3 per cell
+		std::vector<GLfloat> flat;       // Average material color, 3 per cell
+		std::vector<GLfloat> colors;     // Colors for the current render state, 4 per cell
+		std::vector<GLuint> tris;
+		std::vector<int> grid;           // Cell -> index into coords, -1 if empty
+		NavProxy( ) : object(NULL), stamp(0), valid(false), used(false) { }
+	};
+	NavProxy mNavProxy;
+	bool mNavigating;                      // Camera moved within the last NAV_IDLE_TIME ms
+	int mNavProxyFaces;                    // Objects with more faces use the proxy
+	int mNavProxyResolution;               // Grid cells along the longest side
+	QTimer mFrameTimer;
+	QTimer mNavIdleTimer;
+	QTime mLastFrame;
+	QReadWriteLock *mObjectLock;           // See setObjectLock, NULL if there is none
 	
 	//temporarily disable object rendering
 	bool renderObject;
@@ -490,19 +532,19 @@ public :
 	}
 
 	void addToSelection(DLFLVertexPtr vp) {
-		if ( vp ) object->sel_vptr_array.push_back(vp);
+		object->sel_vptr_array.add(vp);
 	}
 
 	void addToSelection(DLFLEdgePtr ep) {
-		if ( ep ) object->sel_eptr_array.push_back(ep);
+		object->sel_eptr_array.add(ep);
 	}
 
 	void addToSelection(DLFLFacePtr fp) {
-		if ( fp ) object->sel_fptr_array.push_back(fp);
+		object->sel_fptr_array.add(fp);
 	}
 
 	void addToSelection(DLFLFaceVertexPtr fvp) {
-		if ( fvp ) object->sel_fvptr_array.push_back(fvp);
+		object->sel_fvptr_array.add(fvp);
 	}
 
 		//--- Check if given item is there in the selection list ---//
@@ -522,55 +564,19 @@ public :
 	}
 
 	bool isSelected(DLFLVertexPtr vp) {
-		bool found = false;
-		if ( vp )
-		{
-			for (uint i=0; i < object->sel_vptr_array.size(); ++i)
-				if ( object->sel_vptr_array[i] == vp )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_vptr_array.contains(vp);
 	}
 
 	bool isSelected(DLFLEdgePtr ep) {
-		bool found = false;
-		if ( ep )
-		{
-			for (uint i=0; i < object->sel_eptr_array.size(); ++i)
-				if ( object->sel_eptr_array[i] == ep )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_eptr_array.contains(ep);
 	}
 
 	bool isSelected(DLFLFacePtr fp) {
-		bool found = false;
-		if ( fp )
-		{
-			for (uint i=0; i < object->sel_fptr_array.size(); ++i)
-				if ( object->sel_fptr_array[i] == fp )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_fptr_array.contains(fp);
 	}
 
 	bool isSelected(DLFLFaceVertexPtr fvp) {
-		bool found = false;
-		if ( fvp )
-		{
-			for (uint i=0; i < object->sel_fvptr_array.size(); ++i)
-				if ( object->sel_fvptr_array[i] == fvp )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_fvptr_array.contains(fvp);
 	}
 
 		//--- Set the selected item at given index ---//
@@ -585,75 +591,35 @@ public :
 	}
 
 	void setSelectedVertex(int index, DLFLVertexPtr vp) {
-		if ( vp && index >= 0 )
-		{
-			if ( (uint) index < object->sel_vptr_array.size() ) object->sel_vptr_array[index] = vp;
-			else object->sel_vptr_array.push_back(vp);
-		}
+		if ( index >= 0 ) object->sel_vptr_array.set(index,vp);
 	}
 
 	void setSelectedEdge(int index, DLFLEdgePtr ep) {
-		if ( ep && index >= 0 )
-		{
-			if ( (uint) index < object->sel_eptr_array.size() ) object->sel_eptr_array[index] = ep;
-			else object->sel_eptr_array.push_back(ep);
-		}
+		if ( index >= 0 ) object->sel_eptr_array.set(index,ep);
 	}
 
 	void setSelectedFace(int index, DLFLFacePtr fp) {
-		if ( fp && index >= 0 )
-		{
-			if ( (uint) index < object->sel_fptr_array.size() ) object->sel_fptr_array[index] = fp;
-			else object->sel_fptr_array.push_back(fp);
-		}
+		if ( index >= 0 ) object->sel_fptr_array.set(index,fp);
 	}
 
 	void setSelectedFaceVertex(int index, DLFLFaceVertexPtr fvp) {
-		if ( fvp && index >= 0 )
-		{
-			if ( (uint) index < object->sel_fvptr_array.size() ) object->sel_fvptr_array[index] = fvp;
-			else object->sel_fvptr_array.push_back(fvp);
-		}
+		if ( index >= 0 ) object->sel_fvptr_array.set(index,fvp);
 	}
 
 	void setSelectedVertex(DLFLVertexPtr vp) {
-		if ( vp )
-		{
-			if (!isSelected(vp)){
-				// if ( (uint) index < object->sel_vptr_array.size() ) object->sel_vptr_array[index] = vp;
-				object->sel_vptr_array.push_back(vp);
-			}
-		}
+		object->sel_vptr_array.add(vp);
 	}
 
 	void setSelectedEdge(DLFLEdgePtr ep) {
-		if ( ep )
-		{
-			if (!isSelected(ep)){
-				// if ( (uint) index < object->sel_eptr_array.size() ) object->sel_eptr_array[index] = ep;
-				 object->sel_eptr_array.push_back(ep);
-			}
-		}
+		object->sel_eptr_array.add(ep);
 	}
 
 	void setSelectedFace(DLFLFacePtr fp) {
-		if ( fp )
-		{
-			if (!isSelected(fp)){
-				// if ( (uint) index < object->sel_fptr_array.size() ) object->sel_fptr_array[index] = fp;
-				object->sel_fptr_array.push_back(fp);
-			}
-		}
+		object->sel_fptr_array.add(fp);
 	}
 
 	void setSelectedFaceVertex(DLFLFaceVertexPtr fvp) {
-		if ( fvp )
-		{
-			if (!isSelected(fvp)){
-				// if ( (uint) index < object->sel_fvptr_array.size() ) object->sel_fvptr_array[index] = fvp;
-				object->sel_fvptr_array.push_back(fvp);
-			}
-		}
+		object->sel_fvptr_array.add(fvp);
 	}
 
 		//--- Return the selected items at given index ---//
@@ -747,44 +713,19 @@ void clearSelectedCorners(void) {
 }
 
 void clearSelectedFace(DLFLFacePtr fp){
-	vector<DLFLFacePtr>::iterator fiterator;
-	for(fiterator = object->sel_fptr_array.begin(); fiterator != object->sel_fptr_array.end(); fiterator++) {
-		if (fp == *fiterator){
-			// delete fp;
-			object->sel_fptr_array.erase(fiterator);
-			return;
-		}
-	}
+	object->sel_fptr_array.remove(fp);
 }
 
 void clearSelectedEdge(DLFLEdgePtr ep){
-	vector<DLFLEdgePtr>::iterator it;
-	for(it = object->sel_eptr_array.begin(); it != object->sel_eptr_array.end(); it++) {
-		if (ep == *it){
-			object->sel_eptr_array.erase(it);
-			return;
-		}
-	}
+	object->sel_eptr_array.remove(ep);
 }
 
 void clearSelectedVertex(DLFLVertexPtr vp){
-	vector<DLFLVertexPtr>::iterator it;
-	for(it = object->sel_vptr_array.begin(); it != object->sel_vptr_array.end(); it++) {
-		if (vp == *it){
-			object->sel_vptr_array.erase(it);
-			return;
-		}
-	}
+	object->sel_vptr_array.remove(vp);
 }
 
 void clearSelectedFaceVertex(DLFLFaceVertexPtr fvp){
-	vector<DLFLFaceVertexPtr>::iterator it;
-	for(it = object->sel_fvptr_array.begin(); it != object->sel_fvptr_array.end(); it++) {
-		if (fvp == *it){
-			object->sel_fvptr_array.erase(it);
-			return;
-		}
-	}
+	object->sel_fvptr_array.remove(fvp);
 }
 
 void clearSelectedFaceVertices(void) {
@@ -818,8 +759,10 @@ void drawSelected(void);
 			delete patchObject; patchObject = 0; 
 		}
 		patchObject = new TMPatchObject( object->getID() );
-		if( patchObject )
+		if( patchObject ) {
+			patchObject->setResolution( mPatchResolution );
 			patchObject->updatePatches( object );
+		}
 	};
 
 		// Set the renderer for this viewport
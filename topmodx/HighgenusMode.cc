@@ -269,18 +269,21 @@ void HighgenusMode::triggerWireframeModeling(){
 	
 	((MainWindow*)mParent)->setToolOptions(mWireframeModelingWidget);
 	((MainWindow*)mParent)->setMode(MainWindow::NormalMode);
+	((MainWindow*)mParent)->setPreviewKind(MainWindow::WireframePreview);
 }
 
 void HighgenusMode::triggerWireframeModeling2(){
 	
 	((MainWindow*)mParent)->setToolOptions(mWireframeModeling2Widget);
 	((MainWindow*)mParent)->setMode(MainWindow::NormalMode);
+	((MainWindow*)mParent)->setPreviewKind(MainWindow::Wireframe2Preview);
 }
 
 void HighgenusMode::triggerColumnModeling(){
 	
 	((MainWindow*)mParent)->setToolOptions(mColumnModelingWidget);
 	((MainWindow*)mParent)->setMode(MainWindow::NormalMode);
+	((MainWindow*)mParent)->setPreviewKind(MainWindow::ColumnsPreview);
 }
 
 void HighgenusMode::triggerSierpinsky(){
@@ -299,6 +302,7 @@ void HighgenusMode::triggerMengerSponge(){
 	
 	((MainWindow*)mParent)->setToolOptions(mMengerSpongeWidget);
 	((MainWindow*)mParent)->setMode(MainWindow::NormalMode);
+	((MainWindow*)mParent)->setPreviewKind(MainWindow::SpongePreview);
 }
 
 void HighgenusMode::toggleCrustCleanupFlag(int state)
@@ -328,6 +332,7 @@ QDoubleSpinBox *HighgenusMode::createDoubleSpinBox(QGridLayout *layout, QLabel *
 	spinbox->setMaximumSize(75,25);
 	layout->addWidget(label,row,col);
   layout->addWidget(spinbox,row,col+1);
+	connect(spinbox, SIGNAL(valueChanged(double)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 
 	return spinbox;
 }
@@ -572,6 +577,7 @@ void HighgenusMode::setupWireframeModeling(){
 	wireframeSplitCheckBox = new QCheckBox(tr("Split Valence-2 Vertices"),this);
 	wireframeSplitCheckBox->setChecked(Qt::Checked);
 	connect(wireframeSplitCheckBox, SIGNAL(stateChanged(int)), this, SLOT(toggleWireframeSplit(int)));
+	connect(wireframeSplitCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 	mWireframeModelingLayout->addWidget(wireframeSplitCheckBox,1,0,1,2);
 	
 	//create wireframe button
@@ -603,6 +609,7 @@ void HighgenusMode::setupWireframeModeling2(){
 	wireframe2SplitCheckBox = new QCheckBox(tr("Split Valence-2 Vertices"),this);
 	wireframe2SplitCheckBox->setChecked(Qt::Checked);
 	connect(wireframe2SplitCheckBox, SIGNAL(stateChanged(int)), this, SLOT(toggleWireframeSplit(int)));
+	connect(wireframe2SplitCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 	mWireframeModeling2Layout->addWidget(wireframe2SplitCheckBox,2,0,1,2);
 	
 	//create wireframe button
@@ -112,6 +112,9 @@ int MainWindow::num_e_subdivs = 2;
 // Split valence 2 vertices
 double MainWindow::vertex_split_offset=-0.1;
 
+// Weld vertices
+double MainWindow::weld_tolerance = 1.0e-5;
+
 // Crust modeling
 double MainWindow::crust_thickness = 0.5;
 double MainWindow::crust_scale_factor = 0.9;
@@ -229,7 +232,7 @@ QColor MainWindow::paint_bucket_color = QColor(0.5,0.5,0.5);
  * asdfl;jkas;df
  **/
 MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(), undoMtlList(), redoList(), redoMtlList(), 
-																				 undolimit(20), useUndo(true), mIsModified(false), mIsPrimitive(false), mWasPrimitive(false), mSpinBoxMode(None) {
+																				 undolimit(20), useUndo(true), mOperationName(NULL), mOperationStart(-1.0), mOperationAllocs(0), mWeldOnImport(false), mIsModified(false), mIsPrimitive(false), mWasPrimitive(false), mSpinBoxMode(None) {
 																					
 																					
 	// i18n stuff
@@ -246,6 +249,39 @@ MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(),
 	mAutoSaveTimer = new QTimer(this);
 	connect(mAutoSaveTimer, SIGNAL(timeout()), this, SLOT(saveFile(/*normals and texture options should go here... eventually*/)));
 
+	//long operations run in the background, see runOperation
+	mExecutor = new DLFLExecutor(this);
+	connect(mExecutor, SIGNAL(finished()), this, SLOT(operationFinished()));
+	mExecutorProgress = new QProgressDialog(this);
+	mExecutorProgress->setWindowModality(Qt::WindowModal);
+	mExecutorProgress->setMinimumDuration(500);
+	mExecutorProgress->setAutoClose(false);
+	mExecutorProgress->setAutoReset(false);
+	mExecutorProgress->reset();
+	connect(mExecutorProgress, SIGNAL(canceled()), this, SLOT(cancelOperation()));
+	mExecutorTimer = new QTimer(this);
+	connect(mExecutorTimer, SIGNAL(timeout()), this, SLOT(updateOperationProgress()));
+	mExecutorStamp = 0;
+
+	//live preview of the current tool, see schedulePreview
+	mPreviewExecutor = new DLFLExecutor(this);
+	connect(mPreviewExecutor, SIGNAL(finished()), this, SLOT(previewFinished()));
+	mPreviewTimer = new QTimer(this);
+	mPreviewTimer->setSingleShot(true);
+	mPreviewTimer->setInterval(300);
+	connect(mPreviewTimer, SIGNAL(timeout()), this, SLOT(startPreview()));
+	mPreviewKind = mPreviewShownKind = NoPreview;
+	mPreviewGeneration = mPreviewRunGeneration = mPreviewShownGeneration = 0;
+	mPreviewStamp = 0;
+	mPreviewPending = false;
+
+	//editing the object together with other instances, see updateSession
+	mSyncSession = new DLFLSyncSession(this);
+	connect(mSyncSession, SIGNAL(message(const QString&)), statusBar(), SLOT(showMessage(const QString&)));
+	mSyncTimer = new QTimer(this);
+	mSyncTimer->setInterval(100);
+	connect(mSyncTimer, SIGNAL(timeout()), this, SLOT(updateSession()));
+
 	//QSettings Path for windows     
 	#ifdef WIN32 
 	QSettings::setPath(QSettings::IniFormat,QSettings::UserScope,QString("%APPDATA%"));
@@ -315,6 +351,10 @@ MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(),
 	connect( mScriptEditor, SIGNAL(cmdExecuted()), this, SLOT(recomputeAll()) );
 	connect( mScriptEditor, SIGNAL(cmdExecuted()), this->getActive(), SLOT(update()) );
 	connect( mScriptEditor, SIGNAL(requestObject(QString)), this, SLOT(openFile(QString)) );
+	connect( mScriptEditor, SIGNAL(redrawRequested()), this, SLOT(redraw()) );
+	connect( mScriptEditor, SIGNAL(runningChanged(bool)), this, SLOT(setScriptRunning(bool)) );
+	// Scripts change the object on their own thread
+	active->setObjectLock( mScriptEditor->objectLock() );
 
 	if( !Py_IsInitialized() )
 		Py_Initialize( );
@@ -400,6 +440,7 @@ MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(),
 	
 	retranslateUi();
 	setExtrusionMode(CubicalExtrude);
+	setPreviewKind(NoPreview); // until a tool is picked
 	setMode(MainWindow::NormalMode);
 	
 	
@@ -513,6 +554,24 @@ void MainWindow::createActions() {
 	mExitAct->setStatusTip(tr("Exit the application"));
 	connect(mExitAct, SIGNAL(triggered()), this, SLOT(close()));
 	// mActionListWidget->addAction(mExitAct);
+
+	mHostSessionAct = new QAction(tr("&Host Session..."), this);
+	sm->registerAction(mHostSessionAct, "File Menu", "");
+	mHostSessionAct->setStatusTip(tr("Let other TopMod instances connect and edit this object together"));
+	connect(mHostSessionAct, SIGNAL(triggered()), this, SLOT(hostSession()));
+	mActionListWidget->addAction(mHostSessionAct);
+
+	mJoinSessionAct = new QAction(tr("&Join Session..."), this);
+	sm->registerAction(mJoinSessionAct, "File Menu", "");
+	mJoinSessionAct->setStatusTip(tr("Connect to a session hosted by another TopMod instance, replaces the object"));
+	connect(mJoinSessionAct, SIGNAL(triggered()), this, SLOT(joinSession()));
+	mActionListWidget->addAction(mJoinSessionAct);
+
+	mLeaveSessionAct = new QAction(tr("&Leave Session"), this);
+	sm->registerAction(mLeaveSessionAct, "File Menu", "");
+	mLeaveSessionAct->setStatusTip(tr("Stop sharing the object"));
+	connect(mLeaveSessionAct, SIGNAL(triggered()), this, SLOT(leaveSession()));
+	mActionListWidget->addAction(mLeaveSessionAct);
 	
 	//quick command quicksilver like interface
 	#ifdef QCOMPLETER
@@ -548,6 +607,13 @@ void MainWindow::createActions() {
 	connect(mClearUndoListAct, SIGNAL(triggered()), this, SLOT(clearUndoList()));
 	mActionListWidget->addAction(mClearUndoListAct);
 
+	mLivePreviewAct = new QAction(tr("&Live Preview"), this);
+	mLivePreviewAct->setCheckable(true);
+	sm->registerAction(mLivePreviewAct, "Edit Menu", "");
+	mLivePreviewAct->setStatusTip(tr("Preview the current remeshing, extrusion or high genus tool while its parameters are changed"));
+	connect(mLivePreviewAct, SIGNAL(toggled(bool)), this, SLOT(toggleLivePreview(bool)));
+	mActionListWidget->addAction(mLivePreviewAct);
+
 	//View Menu Actions
 	mPerspViewAct = new QAction( tr("&Reset Camera"), this);
 	sm->registerAction(mPerspViewAct, "View Menu", "F");
@@ -694,6 +760,19 @@ void MainWindow::createActions() {
 	connect(showHUDAct, SIGNAL(triggered()), this->getActive(), SLOT(toggleHUD()));
 	mActionListWidget->addAction(showHUDAct);
 
+	showProfilerAct = new QAction(tr("Show &Profiler"), this);
+	showProfilerAct->setCheckable(true);
+	sm->registerAction(showProfilerAct, "Display Menu", "");
+	showProfilerAct->setStatusTip(tr("Show frame and operation timings"));
+	connect(showProfilerAct, SIGNAL(triggered()), this->getActive(), SLOT(toggleProfiler()));
+	mActionListWidget->addAction(showProfilerAct);
+
+	saveProfilerTraceAct = new QAction(tr("Save Profiler &Trace..."), this);
+	sm->registerAction(saveProfilerTraceAct, "Display Menu", "");
+	saveProfilerTraceAct->setStatusTip(tr("Save the recent timings as a trace file (chrome://tracing)"));
+	connect(saveProfilerTraceAct, SIGNAL(triggered()), this, SLOT(saveProfilerTrace()));
+	mActionListWidget->addAction(saveProfilerTraceAct);
+
 	#ifdef GPU_OK
 	mUseGPUAct = new QAction(tr("&Use GPU Shading"), this);
 	mUseGPUAct->setCheckable(true);
@@ -874,6 +953,12 @@ void MainWindow::createActions() {
 	connect(mCleanup2gonsAct, SIGNAL(triggered()), this, SLOT(cleanup2gons()));
 	mActionListWidget->addAction(mCleanup2gonsAct);
 
+	mWeldVerticesAct = new QAction(tr("Weld Vertices"), this);
+	sm->registerAction(mWeldVerticesAct, "Tools", "");
+	mWeldVerticesAct->setStatusTip(tr("Merge coincident vertices and join up the edges at them"));
+	connect(mWeldVerticesAct, SIGNAL(triggered()), this, SLOT(weldVertices()));
+	mActionListWidget->addAction(mWeldVerticesAct);
+
 	mCleanupWingedVerticesAct = new QAction(tr("Remove valence-2 vertices"), this);
 	sm->registerAction(mCleanupWingedVerticesAct, "Tools", "SHIFT+CTRL+V");
 	connect(mCleanupWingedVerticesAct, SIGNAL(triggered()), this, SLOT(cleanupWingedVertices()));
@@ -1411,6 +1496,12 @@ void MainWindow::createMenus(){
 	// mVerseMenu->addAction(mVerseDisconnectAct);
 	// mVerseMenu->addAction(mVerseDisconnectAllAct);
 #endif
+	mFileMenu->addSeparator();
+	mSessionMenu = new QMenu(tr("&Session"));
+	mFileMenu->addMenu(mSessionMenu);
+	mSessionMenu->addAction(mHostSessionAct);
+	mSessionMenu->addAction(mJoinSessionAct);
+	mSessionMenu->addAction(mLeaveSessionAct);
 	mFileMenu->addSeparator();
 	mFileMenu->addAction(loadTextureAct);
 	// mFileMenu->addAction(printInfoAct);
@@ -1430,6 +1521,7 @@ void MainWindow::createMenus(){
 	mEditMenu->setTearOffEnabled(true);
 	mEditMenu->addSeparator();
 	mEditMenu->addAction(mClearUndoListAct);
+	mEditMenu->addAction(mLivePreviewAct);
 	mEditMenu->addSeparator();
 	mEditMenu->addAction(mPreferencesAct);
 
@@ -1479,6 +1571,8 @@ void MainWindow::createMenus(){
 	mDisplayMenu->addAction(showCoordinateAxesAct);
 	// mDisplayMenu->addAction(showGridAct); //removed for now 
 	mDisplayMenu->addAction(showHUDAct);
+	mDisplayMenu->addAction(showProfilerAct);
+	mDisplayMenu->addAction(saveProfilerTraceAct);
 	#ifdef GPU_OK
 	mDisplayMenu->addAction(mUseGPUAct);
 	#endif
@@ -1579,6 +1673,7 @@ void MainWindow::createMenus(){
 	mObjectMenu->addSeparator();
 	mObjectMenu->addAction(mCleanupWingedVerticesAct);
 	mObjectMenu->addAction(mCleanup2gonsAct);
+	mObjectMenu->addAction(mWeldVerticesAct);
 	mObjectMenu->addAction(mSplitValence2VerticesAct);
 	mObjectMenu->addSeparator();
 	mToolsMenu->addAction(mClearMaterialsAct);
@@ -1917,6 +2012,9 @@ void MainWindow::hideAllToolBars(){
 }
 
 void MainWindow::setToolOptions(QWidget *optionsWidget) {
+	// A preview belongs to the tool it was made with
+	discardPreview();
+	mPreviewKind = NoPreview;
 	mToolOptionsDockWidget->setWindowTitle(tr("Tool Options - ") + optionsWidget->windowTitle());
 	mToolOptionsStackedWidget->setCurrentWidget(optionsWidget);
 	// show or hide the dockwidget options
@@ -2227,6 +2325,8 @@ void MainWindow::doDrag(int x, int y) { // brianb
 					}
 
 				vptr->setCoords(Vector3d(obj_world[0],obj_world[1],obj_world[2]));
+				// Only the normals around the vertex change, lighting is redone on release
+				object.updateNormals(DLFLVertexPtrArray(1,vptr));
 
 				// Reset drag start points
 				startDrag(drag_endx,drag_endy);
@@ -2308,6 +2408,7 @@ void MainWindow::doDrag(int x, int y) { // brianb
 
 // Do selection of various entities depending on current mode
 void MainWindow::doSelection(int x, int y) {
+	if ( isScriptRunning() ) return;
 	DLFLVertexPtr svptr = NULL;
 	DLFLEdgePtr septr = NULL;
 	DLFLFacePtr sfptr = NULL;
@@ -2491,14 +2592,10 @@ void MainWindow::doSelection(int x, int y) {
 						num_sel_faces++;
 					}
 					DLFLFacePtrArray sfptrarray;
-					vector<DLFLFacePtr>::iterator it;
-					DLFL::selectMatchingFaces(&object, sfptr, sfptrarray);
-					for (it = sfptrarray.begin(); it != sfptrarray.end(); it++){
-						if (!active->isSelected(*it)){
-							active->setSelectedFace(*it);
-							num_sel_faces++;
-						}
-					}
+					similarityIndex.matchingFaces(&object, sfptr, sfptrarray);
+					for (uint i = 0; i < sfptrarray.size(); ++i)
+						active->setSelectedFace(sfptrarray[i]);
+					num_sel_faces = active->numSelectedFaces();
 				}
 				break;
 				case MaskEdges:
@@ -2513,14 +2610,10 @@ void MainWindow::doSelection(int x, int y) {
 						num_sel_edges++;
 					}
 					DLFLEdgePtrArray septrarray;
-					vector<DLFLEdgePtr>::iterator eit;
-					DLFL::selectMatchingEdges(&object, septr, septrarray);
-					for (eit = septrarray.begin(); eit != septrarray.end(); eit++){
-						if (!active->isSelected(*eit)){
-							active->setSelectedEdge(*eit);
-							num_sel_edges++;
-						}
-					}
+					similarityIndex.matchingEdges(&object, septr, septrarray);
+					for (uint i = 0; i < septrarray.size(); ++i)
+						active->setSelectedEdge(septrarray[i]);
+					num_sel_edges = active->numSelectedEdges();
 				}
 				break;
 			// } else if (selectionmask == MainWindow::MaskVertices){
@@ -2535,14 +2628,10 @@ void MainWindow::doSelection(int x, int y) {
 						num_sel_verts++;
 					}
 					DLFLVertexPtrArray svptrarray;
-					vector<DLFLVertexPtr>::iterator vit;
-					DLFL::selectMatchingVertices(&object, svptr, svptrarray);
-					for (vit = svptrarray.begin(); vit != svptrarray.end(); vit++){
-						if (!active->isSelected(*vit)){
-							active->setSelectedVertex(*vit);
-							num_sel_verts++;
-						}
-					}
+					similarityIndex.matchingVertices(&object, svptr, svptrarray);
+					for (uint i = 0; i < svptrarray.size(); ++i)
+						active->setSelectedVertex(svptrarray[i]);
+					num_sel_verts = active->numSelectedVertices();
 				}
 			// }
 			active->redraw();
@@ -2563,14 +2652,10 @@ void MainWindow::doSelection(int x, int y) {
 					num_sel_faces++;
 				}
 				DLFLFacePtrArray sfptrarray;
-				vector<DLFLFacePtr>::iterator it;
-				DLFL::selectFacesByArea(&object, sfptr, sfptrarray, MainWindow::face_area_tolerance);
-				for (it = sfptrarray.begin(); it != sfptrarray.end(); it++){
-					if (!active->isSelected(*it)){
-						active->setSelectedFace(*it);
-						num_sel_faces++;
-					}
-				}
+				similarityIndex.facesByArea(&object, sfptr, sfptrarray, MainWindow::face_area_tolerance);
+				for (uint i = 0; i < sfptrarray.size(); ++i)
+					active->setSelectedFace(sfptrarray[i]);
+				num_sel_faces = active->numSelectedFaces();
 			}
 		active->redraw();
 		break;
@@ -2586,14 +2671,10 @@ void MainWindow::doSelection(int x, int y) {
 					num_sel_faces++;
 				}
 				DLFLFacePtrArray sfptrarray;
-				vector<DLFLFacePtr>::iterator it;
-				DLFL::selectFacesByColor(&object, sfptr, sfptrarray, MainWindow::face_color_tolerance);
-				for (it = sfptrarray.begin(); it != sfptrarray.end(); it++){
-					if (!active->isSelected(*it)){
-						active->setSelectedFace(*it);
-						num_sel_faces++;
-					}
-				}
+				similarityIndex.facesByColor(&object, sfptr, sfptrarray, MainWindow::face_color_tolerance);
+				for (uint i = 0; i < sfptrarray.size(); ++i)
+					active->setSelectedFace(sfptrarray[i]);
+				num_sel_faces = active->numSelectedFaces();
 			}
 		active->redraw();
 		break;
@@ -2644,6 +2725,9 @@ void MainWindow::doSelection(int x, int y) {
 	case ExtrudeMultipleFaces :
 	case MultiSelectFace :
 	case SubdivideFace :
+		// Pick from the faces the extrusion is previewed on, and preview again with the new selection
+		if ( mPreviewShownKind == ExtrusionPreview ) discardPreview();
+		schedulePreview();
 		sfptr = active->selectFace(x,y);
 		if ( QApplication::keyboardModifiers() == Qt::ControlModifier) {
 			if ( active->isSelected(sfptr)){
@@ -2750,6 +2834,8 @@ void MainWindow::dropEvent(QDropEvent *event) {
 
 // Handle keyboard and mouse events
 void MainWindow::mousePressEvent(QMouseEvent *event) {
+	// Selection and dragging change the object, which a running script has
+	if ( isScriptRunning() ) { event->ignore(); return; }
 
 	//experimental for crossing window selection
 	// if (event->buttons() == Qt::LeftButton && mode == SelectionWindow){
@@ -2947,6 +3033,7 @@ void MainWindow::getRightClickMenu(){
 
 
 void MainWindow::mouseMoveEvent(QMouseEvent *event) {
+	if ( isScriptRunning() ) { event->ignore(); return; }
 	// if (active->isBrushVisible()) active->redraw();
 	if ( mode != NormalMode && event->buttons() == Qt::LeftButton)
 		// doSelection(event->x(),this->size().height()-event->y() );
@@ -3015,6 +3102,7 @@ void MainWindow::setSpinBoxes(QDoubleSpinBox *one,QDoubleSpinBox *two,QDoubleSpi
 }
 
 void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
+	if ( isScriptRunning() ) { event->ignore(); return; }
 	QString cmd;
 	// The mouse was dragged or released
 	// Send this event to the subroutine handling the current event, if any
@@ -3025,6 +3113,8 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 			switch ( mode )
 				{
 				case EditVertex :       // brianb
+					// Normals were kept up to date while dragging
+					if ( is_editing ) active->recomputeLighting();
 					is_editing = false;
 					if ( active->numSelectedVertices() >= 1 )	{
 						DLFLVertexPtr vp = active->getSelectedVertex(0);
@@ -3143,14 +3233,10 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								DLFLFacePtr sfptr = active->getSelectedFace(0);			
 								if (sfptr){
 									DLFLFacePtrArray sfptrarray;
-									vector<DLFLFacePtr>::iterator it;
-									DLFL::selectMatchingFaces(&object, sfptr, sfptrarray);
-									for (it = sfptrarray.begin(); it != sfptrarray.end(); it++){
-										if (!active->isSelected(*it)){
-											active->setSelectedFace(*it);
-											num_sel_faces++;
-										}
-									}
+									similarityIndex.matchingFaces(&object, sfptr, sfptrarray);
+									for (uint i = 0; i < sfptrarray.size(); ++i)
+										active->setSelectedFace(sfptrarray[i]);
+									num_sel_faces = active->numSelectedFaces();
 								}
 							}
 						} else if (selectionmask == MainWindow::MaskEdges){
@@ -3158,14 +3244,10 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								DLFLEdgePtr septr = active->getSelectedEdge(0);
 								if (septr){
 									DLFLEdgePtrArray septrarray;
-									vector<DLFLEdgePtr>::iterator eit;
-									DLFL::selectMatchingEdges(&object, septr, septrarray);
-									for (eit = septrarray.begin(); eit != septrarray.end(); eit++){
-										if (!active->isSelected(*eit)){
-											active->setSelectedEdge(*eit);
-											num_sel_edges++;
-										}
-									}
+									similarityIndex.matchingEdges(&object, septr, septrarray);
+									for (uint i = 0; i < septrarray.size(); ++i)
+										active->setSelectedEdge(septrarray[i]);
+									num_sel_edges = active->numSelectedEdges();
 								}
 							}
 						} else if (selectionmask == MainWindow::MaskVertices){
@@ -3177,14 +3259,10 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 										num_sel_verts++;
 									}
 									DLFLVertexPtrArray svptrarray;
-									vector<DLFLVertexPtr>::iterator vit;
-									DLFL::selectMatchingVertices(&object, svptr, svptrarray);
-									for (vit = svptrarray.begin(); vit != svptrarray.end(); vit++){
-										if (!active->isSelected(*vit)){
-											active->setSelectedVertex(*vit);
-											num_sel_verts++;
-										}
-									}
+									similarityIndex.matchingVertices(&object, svptr, svptrarray);
+									for (uint i = 0; i < svptrarray.size(); ++i)
+										active->setSelectedVertex(svptrarray[i]);
+									num_sel_verts = active->numSelectedVertices();
 								}
 							}
 						}
@@ -3195,14 +3273,10 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								DLFLFacePtr sfptr = active->getSelectedFace(0);			
 								if (sfptr){
 									DLFLFacePtrArray sfptrarray;
-									vector<DLFLFacePtr>::iterator it;
-									DLFL::selectFacesByArea(&object, sfptr, sfptrarray, MainWindow::face_area_tolerance);
-									for (it = sfptrarray.begin(); it != sfptrarray.end(); it++){
-										if (!active->isSelected(*it)){
-											active->setSelectedFace(*it);
-											num_sel_faces++;
-										}
-									}
+									similarityIndex.facesByArea(&object, sfptr, sfptrarray, MainWindow::face_area_tolerance);
+									for (uint i = 0; i < sfptrarray.size(); ++i)
+										active->setSelectedFace(sfptrarray[i]);
+									num_sel_faces = active->numSelectedFaces();
 									redraw();
 								}
 							}
@@ -3238,8 +3312,11 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 									cmd += QString().setNum(sfvptr2->getVertexID()) + QString("))");
 									emit echoCommand(cmd);
 									if( Py_IsInitialized() ) {
+										// The script editor gives up the GIL after starting Python
+										PyGILState_STATE gstate = PyGILState_Ensure( );
 										PyRun_SimpleString( "from dlfl import *");
 										PyRun_SimpleString( cmd.toLocal8Bit().constData() );
+										PyGILState_Release( gstate );
 									}
 #else
 									DLFL::insertEdge(&object,sfvptr1,sfvptr2,false,mptr);
@@ -3595,13 +3672,13 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 									// will be different
 									if ( QApplication::keyboardModifiers() == Qt::ShiftModifier )
 										{
-											DLFL::tagMatchingFaces(&object,sfptr);
-											DLFL::punchHoles(&object);
+											DLFL::tagMatchingFaces(&object,crust_info,sfptr);
+											DLFL::punchHoles(&object,crust_info);
 											active->recomputePatches();
 											active->recomputeNormals();
 										}
 									else
-										DLFL::cmMakeHole(&object,sfptr,crust_cleanup);
+										DLFL::cmMakeHole(&object,crust_info,sfptr,crust_cleanup);
 									//                                                  active->recomputeNormals();
 								}
 							active->clearSelectedFaces();
@@ -3823,127 +3900,235 @@ void MainWindow::testConvexHull(void) {
 }
 
 void MainWindow::performRemeshing(void) {
-	setModified(true);
+	if ( keepPreview(RemeshingPreview) ) return;
+	RemeshingParameters p;
+	runOperation(makeOperation(MainWindow::applyRemeshing, remeshingscheme, p), tr("Remeshing"),
+							 remeshingCommand(remeshingscheme, p));
+	setMode(mode);
+	redraw();
+}
 
-	switch ( remeshingscheme )
+MainWindow::RemeshingParameters::RemeshingParameters()
+	: accurate_dual(MainWindow::accurate_dual), doo_sabin_check(MainWindow::doo_sabin_check),
+		star_offset(MainWindow::star_offset), fractal_offset(MainWindow::fractal_offset),
+		vertex_cutting_offset(MainWindow::vertex_cutting_offset), corner_cutting_alpha(MainWindow::corner_cutting_alpha),
+		modified_corner_cutting_thickness(MainWindow::modified_corner_cutting_thickness),
+		checkerboard_thickness(MainWindow::checkerboard_thickness), pentagonal_offset(MainWindow::pentagonal_offset),
+		pentagonal_scale(MainWindow::pentagonal_scale), weight_factor(MainWindow::weight_factor),
+		twist_factor(MainWindow::twist_factor), dual1264_scale_factor(MainWindow::dual1264_scale_factor),
+		loopLength_factor(MainWindow::loopLength_factor), substellate_height(MainWindow::substellate_height),
+		substellate_curve(MainWindow::substellate_curve), domeLength_factor(MainWindow::domeLength_factor),
+		domeScale_factor(MainWindow::domeScale_factor), dooSabinBCnewScale_factor(MainWindow::dooSabinBCnewScale_factor),
+		dooSabinBCnewLength_factor(MainWindow::dooSabinBCnewLength_factor) {
+}
+
+// What performRemeshing does to the object, without undo, echo or redraw.
+// Runs on a copy on another thread, so it only reads the parameters it is given
+void MainWindow::applyRemeshing(DLFLObjectPtr obj, RemeshingScheme scheme, RemeshingParameters p) {
+	switch ( scheme )
 		{
 		case Dual :
-			createDual();
+			DLFL::createDual(obj,p.accurate_dual);
 			break;
 		case Root3 :
-			subdivideRoot3();
+			DLFL::createDual(obj,true);
+			DLFL::honeycombSubdivide(obj);
+			DLFL::createDual(obj,true);
 			break;
 		case Triangulate :
-			triangulate();
+			DLFL::triangulateAllFaces(obj);
 			break;
 		case DualVertexTrunc :
-			subdivideSqrt3();
+			DLFL::sqrt3Subdivide(obj);
 			break;
 		case GlobalStellate :
-			globalStellate();
+			DLFL::subdivideAllFaces(obj,false);
 			break;
 		case Star :
-			subdivideStar();
+			DLFL::starSubdivide(obj,p.star_offset);
 			break;
 		case Generic1264 :
-			subdivide1264();
+			DLFL::createDual(obj,true);
+			DLFL::dual1264Subdivide(obj,p.dual1264_scale_factor);
+			DLFL::createDual(obj,true);
 			break;
 		case Honeycomb :
-			subdivideHoneycomb();
+			DLFL::honeycombSubdivide(obj);
 			break;
 		case VertexTrunc :
-			subdivideVertexCutting();
+			DLFL::vertexCuttingSubdivide(obj,p.vertex_cutting_offset);
 			break;
 		case DualGeneric1264 :
-			subdivideDual1264();
+			DLFL::dual1264Subdivide(obj,p.dual1264_scale_factor);
 			break;
 		case LinearVertexInsertion :
-			subdivideLinearVertexInsertion();
+			DLFL::subdivideAllFaces(obj,true);
 			break;
 		case CatmullClark :
-			subdivideCatmullClark();
+			DLFL::catmullClarkSubdivide(obj);
 			break;
 		case ModifiedStellate :
-			subStellate1();
+			DLFL::stellateSubdivide(obj);
 			break;
 		case DooSabin :
-			subdivideDooSabin();
+			DLFL::dooSabinSubdivide(obj,p.doo_sabin_check);
 			break;
 		case CornerCutting :
-				subdivideCornerCutting();
-				break;
+			DLFL::cornerCuttingSubdivide(obj,p.corner_cutting_alpha);
+			break;
 		case ModifiedCornerCutting :
-			subdivideModifiedCornerCutting();
+			DLFL::modifiedCornerCuttingSubdivide(obj,p.modified_corner_cutting_thickness);
 			break;
 		case Simplest :
-			subdivideSimplest();
+			DLFL::simplestSubdivide(obj);
 			break;
 		case Pentagonal :
-			subdividePentagonal();
+			DLFL::pentagonalSubdivide(obj,p.pentagonal_offset);
 			break;
 		case CubicPentagonal :
-			subdivideCubicPentagonal();
+			DLFL::pentagonalSubdivide(obj,p.pentagonal_offset);
+			DLFL::createDual(obj,true);
+			DLFL::createDual(obj,true);
 			break;
 		case DualPentagonal :
-			subdivideDualPentagonal();
+			DLFL::createDual(obj,true);
+			DLFL::pentagonalSubdivide(obj,p.pentagonal_offset);
+			DLFL::createDual(obj,true);
 			break;
 		case LoopStyle :
-			subdivideLoopStyle();
+			DLFL::loopStyleSubdivide(obj,p.loopLength_factor);
 			break;
 		case Loop :
-			subdivideLoop();
+			DLFL::loopSubdivide(obj);
 			break;
 		case Root4 :
-			subdivideRoot4();
+		case HexagonPreserving :
+			DLFL::root4Subdivide(obj,p.weight_factor,p.twist_factor);
 			break;
 		case DualLoop :
-			subdivideDualLoop();
-			break;
-		case GlobalCubicExtrude :
-			// cout << "NOT YET IMPLEMENTED!!!" << endl;
+			DLFL::createDual(obj,true);
+			DLFL::loopSubdivide(obj);
+			DLFL::createDual(obj,true);
 			break;
 		case CheckerBoard :
-			subdivideCheckerBoard();
-			break;
-		case DualGlobalCubicExtrude :
-			// cout << "NOT YET IMPLEMENTED!!!" << endl;
+			DLFL::checkerBoardRemeshing(obj,p.checkerboard_thickness);
 			break;
 		case DualCheckerBoard :
-			subdivideDualCheckerBoard();
+			DLFL::createDual(obj,true);
+			DLFL::checkerBoardRemeshing(obj,p.checkerboard_thickness);
+			DLFL::createDual(obj,true);
 			break;
 		case PentagonPreserving :
-			subdividePentagonPreserving();
+			DLFL::pentagonalSubdivide2(obj,p.pentagonal_scale);
 			break;
 		case DualPentagonPreserving :
-			subdivideDualPentagonPreserving();
-			break;
-		case HexagonPreserving :
-			subdivideRoot4();
+			DLFL::createDual(obj,true);
+			DLFL::pentagonalSubdivide2(obj,p.pentagonal_scale);
+			DLFL::createDual(obj,true);
 			break;
 		case DualHexagonPreserving :
-			subdivideDualHexagonPreserving();
+			DLFL::createDual(obj,true);
+			DLFL::root4Subdivide(obj,p.weight_factor,p.twist_factor);
+			DLFL::createDual(obj,true);
 			break;
 		case Fractal :
-			subdivideFractal();
+			DLFL::fractalSubdivide(obj,p.fractal_offset);
 			break;
 		case ModifiedDoubleStellate :
-			subStellate2();
+			DLFL::twostellateSubdivide(obj,p.substellate_height,p.substellate_curve);
 			break;
 		case Dome :
-			subdivideDome();
+			DLFL::domeSubdivide(obj,p.domeLength_factor,p.domeScale_factor);
 			break;
 		case DooSabinBC :
-			subdivideDooSabinBC();
+			DLFL::dooSabinSubdivideBC(obj,p.doo_sabin_check);
 			break;
 		case DooSabinBCNew :
-			subdivideDooSabinBCNew();
+			DLFL::dooSabinSubdivideBCNew(obj,p.dooSabinBCnewScale_factor,p.dooSabinBCnewLength_factor);
+			break;
+		default :
 			break;
 		}
-	setMode(mode);
-	redraw();
+}
+
+// The commands are the ones of the dlfl Python module
+QString MainWindow::remeshingCommand(RemeshingScheme scheme, const RemeshingParameters& p) {
+	QString check = p.doo_sabin_check ? QString("True") : QString("False");
+	switch ( scheme )
+		{
+		case Dual :
+			return QString("dual()");
+		case Root3 :
+			return QString("dual()\nsubdivide(\"honeycomb\")\ndual()");
+		case DualVertexTrunc :
+			return QString("subdivide(\"sqrt3\")");
+		case GlobalStellate :
+			return QString("subdivide(\"allfaces\",False)");
+		case Star :
+			return QString("subdivide(\"star\")");
+		case Generic1264 :
+			return QString("dual()\nsubdivide(\"dual-12.6.4\",%1)\ndual()").arg(p.dual1264_scale_factor);
+		case Honeycomb :
+			return QString("subdivide(\"honeycomb\")");
+		case VertexTrunc :
+			return QString("subdivide(\"vertex-cut\",%1)").arg(p.vertex_cutting_offset);
+		case DualGeneric1264 :
+			return QString("subdivide(\"dual-12.6.4\",%1)").arg(p.dual1264_scale_factor);
+		case LinearVertexInsertion :
+			return QString("subdivide(\"linear-vertex\",True)");
+		case CatmullClark :
+			return QString("subdivide(\"catmull-clark\")");
+		case ModifiedStellate :
+			return QString("subdivide(\"stellate\")");
+		case DooSabin :
+			return QString("subdivide(\"doo-sabin\",%1)").arg(check);
+		case CornerCutting :
+			return QString("subdivide(\"corner-cut\")");
+		case Simplest :
+			return QString("subdivide(\"simplest\")");
+		case Pentagonal :
+			return QString("subdivide(\"pentagon\",%1)").arg(p.pentagonal_offset);
+		case CubicPentagonal :
+			return QString("subdivide(\"pentagon\",%1)\ndual()\ndual()").arg(p.pentagonal_offset);
+		case DualPentagonal :
+			return QString("dual()\nsubdivide(\"pentagon\",%1)\ndual()").arg(p.pentagonal_offset);
+		case LoopStyle :
+			return QString("subdivide(\"loop-style\",%1)").arg(p.loopLength_factor);
+		case Loop :
+			return QString("subdivide(\"loop\")");
+		case Root4 :
+		case HexagonPreserving :
+			return QString("subdivide(\"root4\",%1,%2)").arg(p.weight_factor).arg(p.twist_factor);
+		case DualLoop :
+			return QString("dual()\nsubdivide(\"loop\")\ndual()");
+		case CheckerBoard :
+			return QString("subdivide(\"checker\",%1)").arg(p.checkerboard_thickness);
+		case DualCheckerBoard :
+			return QString("dual()\nsubdivide(\"checker\",%1)\ndual()").arg(p.checkerboard_thickness);
+		case PentagonPreserving :
+			return QString("subdivide(\"pentagon-preserve\",%1)").arg(p.pentagonal_scale);
+		case DualPentagonPreserving :
+			return QString("dual()\nsubdivide(\"pentagon-preserve\",%1)\ndual()").arg(p.pentagonal_scale);
+		case DualHexagonPreserving :
+			return QString("dual()\nsubdivide(\"root4\",%1,%2)\ndual()").arg(p.weight_factor).arg(p.twist_factor);
+		case Fractal :
+			return QString("subdivide(\"fractal\",%1)").arg(p.fractal_offset);
+		case ModifiedDoubleStellate :
+			return QString("subdivide(\"double-stellate\",%1,%2)").arg(p.substellate_height).arg(p.substellate_curve);
+		case Dome :
+			return QString("subdivide(\"dome\",%1,%2)").arg(p.domeLength_factor).arg(p.domeScale_factor);
+		case DooSabinBC :
+			return QString("subdivide(\"doo-sabin-bc\",%1)").arg(check);
+		case DooSabinBCNew :
+			return QString("subdivide(\"doo-sabin-bc-new\",%1,%2)").arg(p.dooSabinBCnewScale_factor).arg(p.dooSabinBCnewLength_factor);
+		default :
+			// No command for these
+			return QString();
+		}
 }
 
 void MainWindow::performExtrusion(){
+	if ( keepPreview(ExtrusionPreview) ) return;
 	if ( active->numSelectedFaces() >= 1 )
 		{
 			DLFLFacePtrArray sfptrarr = active->getSelectedFaces();
@@ -3951,37 +4136,7 @@ void MainWindow::performExtrusion(){
 				{
 					undoPush();
 					setModified(true);
-					vector<DLFLFacePtr>::iterator it;
-					for(it = sfptrarr.begin(); it != sfptrarr.end(); it++) {
-						switch (extrusionmode){
-							case DooSabinExtrude: DLFL::extrudeFaceDS(&object,*it,extrude_dist,num_extrusions,ds_ex_twist,extrude_scale);
-							break;
-							case CubicalExtrude: DLFL::extrudeFace(&object,*it,extrude_dist,num_extrusions,extrude_rot,extrude_scale);
-							break;
-							// case IcosahedralExtrude: DLFL::extrudeFaceIcosa(&object,*it,extrude_dist,num_extrusions, ds_ex_twist,extrude_scale);
-							case IcosahedralExtrude: 
-							// std::cout<< extrude_angle_icosa  << "\t" << num_extrusions  << "\t" << extrude_length1_icosa  << "\t" << extrude_length2_icosa << "\t" << extrude_length3_icosa <<"\n";
-							DLFL::extrudeFaceIcosa(&object, *it, extrude_angle_icosa, num_extrusions, extrude_length1_icosa,extrude_length2_icosa,extrude_length3_icosa);
-							// DLFL::extrudeFaceCubOcta(&object, *it, extrude_angle_icosa,num_extrusions, extrude_length1_icosa,extrude_length2_icosa,extrude_length3_icosa);
-							break;
-							// DLFLFacePtr extrudeFaceDodeca(DLFLObjectPtr obj, DLFLFacePtr fptr, double angle, int num, double ex_dist1, double ex_dist2, double ex_dist3, bool hexagonalize);
-							case DodecahedralExtrude: 
-							DLFL::extrudeFaceDodeca(&object,*it,extrude_angle,num_extrusions, extrude_length1,extrude_length2,extrude_length3, hexagonalize_dodeca_extrude);							
-							// case DodecahedralExtrude: DLFL::extrudeFaceDodeca(&object,*it,extrude_dist,num_extrusions, ds_ex_twist,extrude_scale, hexagonalize_dodeca_extrude);							
-							// DLFL::extrudeFaceSmallRhombiCubOcta(&object,*it,extrude_angle,num_extrusions, extrude_length1,extrude_length2,extrude_length3);
-							break;
-							case OctahedralExtrude: DLFL::extrudeDualFace(&object,*it,extrude_dist,num_extrusions, extrude_rot,extrude_scale, dual_mesh_edges_check);
-							break;
-							case StellateExtrude: DLFL::stellateFace(&object,*it,extrude_dist);							
-							break;
-							case DoubleStellateExtrude: DLFL::doubleStellateFace(&object,*it,extrude_dist);
-							break;
-							case DomeExtrude: DLFL::extrudeFaceDome(&object,*it,domeExtrudeLength_factor,domeExtrudeRotation_factor,domeExtrudeScale_factor);
-							break;
-							default: DLFL::extrudeFace(&object,*it,extrude_dist,num_extrusions,extrude_rot,extrude_scale);
-							break;
-						};
-					}
+					applyExtrusion(&object,sfptrarr,ExtrusionParameters(extrusionmode));
 					active->recomputePatches();
 					active->recomputeNormals();						
 				}
@@ -3990,6 +4145,63 @@ void MainWindow::performExtrusion(){
 		}
 }
 
+// All the faces are extruded in one go, see DLFL::extrudeFaces
+void MainWindow::applyExtrusion(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, const ExtrusionParameters& p){
+	switch (p.mode){
+		case DooSabinExtrude: DLFL::extrudeFacesDS(obj,fparray,p.extrude_dist,p.num_extrusions,p.ds_ex_twist,p.extrude_scale);
+		break;
+		case CubicalExtrude: DLFL::extrudeFaces(obj,fparray,p.extrude_dist,p.num_extrusions,p.extrude_rot,p.extrude_scale);
+		break;
+		// case IcosahedralExtrude: DLFL::extrudeFaceIcosa(obj,fptr,extrude_dist,num_extrusions, ds_ex_twist,extrude_scale);
+		case IcosahedralExtrude: 
+		// std::cout<< extrude_angle_icosa  << "\t" << num_extrusions  << "\t" << extrude_length1_icosa  << "\t" << extrude_length2_icosa << "\t" << extrude_length3_icosa <<"\n";
+		DLFL::extrudeFacesIcosa(obj, fparray, p.extrude_angle_icosa, p.num_extrusions, p.extrude_length1_icosa,p.extrude_length2_icosa,p.extrude_length3_icosa);
+		// DLFL::extrudeFaceCubOcta(obj, fptr, extrude_angle_icosa,num_extrusions, extrude_length1_icosa,extrude_length2_icosa,extrude_length3_icosa);
+		break;
+		// DLFLFacePtr extrudeFaceDodeca(DLFLObjectPtr obj, DLFLFacePtr fptr, double angle, int num, double ex_dist1, double ex_dist2, double ex_dist3, bool hexagonalize);
+		case DodecahedralExtrude: 
+		DLFL::extrudeFacesDodeca(obj,fparray,p.extrude_angle,p.num_extrusions, p.extrude_length1,p.extrude_length2,p.extrude_length3, p.hexagonalize_dodeca_extrude);							
+		// case DodecahedralExtrude: DLFL::extrudeFaceDodeca(obj,fptr,extrude_dist,num_extrusions, ds_ex_twist,extrude_scale, hexagonalize_dodeca_extrude);							
+		// DLFL::extrudeFaceSmallRhombiCubOcta(obj,fptr,extrude_angle,num_extrusions, extrude_length1,extrude_length2,extrude_length3);
+		break;
+		case OctahedralExtrude: DLFL::extrudeDualFaces(obj,fparray,p.extrude_dist,p.num_extrusions, p.extrude_rot,p.extrude_scale, p.dual_mesh_edges_check);
+		break;
+		case StellateExtrude: DLFL::stellateFaces(obj,fparray,p.extrude_dist);							
+		break;
+		case DoubleStellateExtrude:
+		for (uint i=0; i < fparray.size(); ++i) DLFL::doubleStellateFace(obj,fparray[i],p.extrude_dist);
+		break;
+		case DomeExtrude:
+		for (uint i=0; i < fparray.size(); ++i) DLFL::extrudeFaceDome(obj,fparray[i],p.domeExtrudeLength_factor,p.domeExtrudeRotation_factor,p.domeExtrudeScale_factor);
+		break;
+		default: DLFL::extrudeFaces(obj,fparray,p.extrude_dist,p.num_extrusions,p.extrude_rot,p.extrude_scale);
+		break;
+	};
+}
+
+MainWindow::ExtrusionParameters::ExtrusionParameters(ExtrusionMode m)
+	: mode(m), num_extrusions(MainWindow::num_extrusions), dual_mesh_edges_check(MainWindow::dual_mesh_edges_check),
+		hexagonalize_dodeca_extrude(MainWindow::hexagonalize_dodeca_extrude), extrude_dist(MainWindow::extrude_dist),
+		extrude_rot(MainWindow::extrude_rot), extrude_scale(MainWindow::extrude_scale), ds_ex_twist(MainWindow::ds_ex_twist),
+		extrude_angle(MainWindow::extrude_angle), extrude_length1(MainWindow::extrude_length1),
+		extrude_length2(MainWindow::extrude_length2), extrude_length3(MainWindow::extrude_length3),
+		extrude_angle_icosa(MainWindow::extrude_angle_icosa), extrude_length1_icosa(MainWindow::extrude_length1_icosa),
+		extrude_length2_icosa(MainWindow::extrude_length2_icosa), extrude_length3_icosa(MainWindow::extrude_length3_icosa),
+		domeExtrudeLength_factor(MainWindow::domeExtrudeLength_factor), domeExtrudeScale_factor(MainWindow::domeExtrudeScale_factor),
+		domeExtrudeRotation_factor(MainWindow::domeExtrudeRotation_factor) {
+}
+
+// The faces are given by their position in the face list, which a copy of
+// the object keeps. Used for the live preview
+void MainWindow::applyExtrusionToFaces(DLFLObjectPtr obj, ExtrusionParameters p, vector<uint> faces){
+	DLFLFacePtrArray fparray, sfptrarr;
+	obj->getFaces(fparray);
+	for (uint i=0; i < faces.size(); ++i)
+		if ( faces[i] < fparray.size() ) sfptrarr.push_back(fparray[faces[i]]);
+	fparray.clear();
+	applyExtrusion(obj,sfptrarr,p);
+}
+
 // Change the renderer for all viewports
 void MainWindow::setRenderer(DLFLRendererPtr rp) {
 	active->setRenderer(rp);
@@ -4209,6 +4421,7 @@ void MainWindow::setMode(Mode m) {
 
 void MainWindow::setExtrusionMode(ExtrusionMode m){
 	extrusionmode = m;
+	setPreviewKind(ExtrusionPreview);
 	QString s;
 	switch(m){
 		case DooSabinExtrude: s = "Doo Sabin";
@@ -4308,6 +4521,7 @@ void MainWindow::setSelectionMask(SelectionMask m){
 
 void MainWindow::setRemeshingScheme(RemeshingScheme scheme) {
 	remeshingscheme = scheme;
+	setPreviewKind(RemeshingPreview);
 	QString s;
 	
 	switch (remeshingscheme){		
@@ -4391,20 +4605,25 @@ void MainWindow::setRemeshingScheme(RemeshingScheme scheme) {
 
 // Read the DLFL object from a file
 void MainWindow::readObject(const char * filename, const char *mtlfilename) {
+	endPreview();
 	active->clearSelected();
+	crust_info.clear();
 	ifstream file, mtlfile;
 	file.open(filename);
 	mtlfile.open(mtlfilename);
 		
 	if ( strstr(filename,".dlfl") || strstr(filename,".DLFL") )
 		object.readDLFL(file, mtlfile);
-	else if ( strstr(filename,".obj") || strstr(filename,".OBJ") )
+	else if ( strstr(filename,".obj") || strstr(filename,".OBJ") ) {
 		object.readObject(file, mtlfile);
+		if ( mWeldOnImport ) object.weldVertices(weld_tolerance);
+	}
 	file.close();
 }
 
 // Read the DLFL object from a file
 void MainWindow::readObjectQFile(QString filename) {
+	endPreview();
 	active->clearSelected();
 	QFile file(filename);
 	file.open(QIODevice::ReadOnly);
@@ -4419,8 +4638,10 @@ void MainWindow::readObjectQFile(QString filename) {
 
 	if ( filename.indexOf(".dlfl") == filename.length()-4 || filename.indexOf(".dlfl") == filename.length()-4 )
 		object.readDLFL(filestring, mtlfile);
-	else if ( filename.indexOf(".OBJ") == filename.length()-4 || filename.indexOf(".obj") == filename.length()-4 )
+	else if ( filename.indexOf(".OBJ") == filename.length()-4 || filename.indexOf(".obj") == filename.length()-4 ) {
 		object.readObject(filestring, mtlfile);
+		if ( mWeldOnImport ) object.weldVertices(weld_tolerance);
+	}
 	file.close();
 
 #ifdef WITH_PYTHON
@@ -4491,10 +4712,10 @@ void MainWindow::writeLG3d( const char *filename, bool selected ) {
 }
 
 /* dave - lg3d export */
-void MainWindow::writeSTL( const char *filename) {
+void MainWindow::writeSTL( const char *filename, bool binary ) {
 	ofstream file;
-	file.open(filename);
-	object.writeSTL(file);
+	file.open(filename, binary ? ios::out | ios::binary : ios::out);
+	object.writeSTL(file, binary);
 	file.close();
 }
 
@@ -4547,6 +4768,10 @@ void MainWindow::openFile(void) {
 
 
 bool MainWindow::saveFile(bool with_normals, bool with_tex_coords) {
+#ifdef WITH_PYTHON
+	// The auto save timer keeps running while a script changes the object
+	if ( isScriptRunning() ) return false;
+#endif
 	if (curFile != "untitled"){
 		statusBar()->showMessage(tr("Saving File..."),3000);	
 		QString curFileTemp(curFile);
@@ -4768,20 +4993,17 @@ bool MainWindow::saveFileLG3dSelected( ) {
 /* dave - stl export */
 bool MainWindow::saveFileSTL( ) {
 	
-	//triangulate the mesh first - this isn't the best solution but will work for now.
-	// globalStellate();
-	//testing out a custom triangulate function
-	triangulate();
-	
+	// faces are triangulated by the exporter, the mesh itself is left alone
+	QString asciiFilter = tr("ASCII STL Files (*.stl)"), selectedFilter;
 	QString fileName = QFileDialog::getSaveFileName(this,
 																									tr("Export STL..."),
 																									mSaveDirectory+ "/" + curFile,
-																									tr("STL Files (*.stl);;All Files (*)"),
-																									0, QFileDialog::DontUseSheet);
+																									tr("Binary STL Files (*.stl)") + ";;" + asciiFilter + ";;" + tr("All Files (*)"),
+																									&selectedFilter, QFileDialog::DontUseSheet);
 	if (!fileName.isEmpty()){
 		QByteArray ba = fileName.toLatin1();
 		const char *filename = ba.data();
-		writeSTL(filename);
+		writeSTL(filename, selectedFilter != asciiFilter);
 		return true;
 	}
 	return false;
@@ -5242,6 +5464,7 @@ void MainWindow::retranslateUi() {
 	#ifdef WITH_VERSE
 	mVerseMenu->setTitle(tr("&Verse"));
 	#endif
+	mSessionMenu->setTitle(tr("&Session"));
 	mEditMenu->setTitle(tr("&Edit"));
 	mDisplayMenu->setTitle(tr("&Display"));
 	mRendererMenu->setTitle(tr("&Renderer"));
@@ -5292,6 +5515,12 @@ void MainWindow::retranslateUi() {
 	mPrintCVListAct->setStatusTip(tr("Print CV list to the console"));
 	mExitAct->setText(tr("E&xit"));
 	mExitAct->setStatusTip(tr("Exit the application"));
+	mHostSessionAct->setText(tr("&Host Session..."));
+	mHostSessionAct->setStatusTip(tr("Let other TopMod instances connect and edit this object together"));
+	mJoinSessionAct->setText(tr("&Join Session..."));
+	mJoinSessionAct->setStatusTip(tr("Connect to a session hosted by another TopMod instance, replaces the object"));
+	mLeaveSessionAct->setText(tr("&Leave Session"));
+	mLeaveSessionAct->setStatusTip(tr("Stop sharing the object"));
 
 
 	//quick command quicksilver like interface
@@ -5305,6 +5534,8 @@ void MainWindow::retranslateUi() {
 	mUndoAct->setText(tr("&Undo"));
 	mRedoAct->setText(tr("&Redo"));
 	mClearUndoListAct->setText(tr("&Clear Undo List"));
+	mLivePreviewAct->setText(tr("&Live Preview"));
+	mLivePreviewAct->setStatusTip(tr("Preview the current remeshing, extrusion or high genus tool while its parameters are changed"));
 	//View Menu Actions
 	mPerspViewAct->setText( tr("&Reset Camera"));
 	mZoomOutAct->setText( tr("Zoom Out"));
@@ -5332,6 +5563,10 @@ void MainWindow::retranslateUi() {
 	mShowFaceCentroidsAct->setText(tr("Show &Face Centroids"));
 	showHUDAct->setText(tr("Show &Heads Up Display"));
 	showHUDAct->setStatusTip(tr("Show the Heads Up Display"));
+	showProfilerAct->setText(tr("Show &Profiler"));
+	showProfilerAct->setStatusTip(tr("Show frame and operation timings"));
+	saveProfilerTraceAct->setText(tr("Save Profiler &Trace..."));
+	saveProfilerTraceAct->setStatusTip(tr("Save the recent timings as a trace file (chrome://tracing)"));
 	#ifdef GPU_OK
 	mUseGPUAct->setText(tr("&Use GPU Shading"));
 	mUseGPUAct->setStatusTip(tr("Use GPU Shading"));
@@ -5386,6 +5621,8 @@ void MainWindow::retranslateUi() {
 	planarizeAllFacesAct->setText(tr("Planarize All &Faces"));
 	makeObjectSphericalAct->setText(tr("Make &Object Spherical"));
 	mCleanup2gonsAct->setText(tr("Cleanup 2-gons"));
+	mWeldVerticesAct->setText(tr("Weld Vertices"));
+	mWeldVerticesAct->setStatusTip(tr("Merge coincident vertices and join up the edges at them"));
 	mCleanupWingedVerticesAct->setText(tr("Remove valence-2 vertices"));
 	mSplitValence2VerticesAct->setText(tr("Split valence-2 vertices"));
 	makeObjectSmoothAct->setText(tr("Make Object &Smooth"));
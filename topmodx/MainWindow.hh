@@ -67,6 +67,8 @@
 #endif
 
 #include "DLFLLighting.hh"
+#include "DLFLExecutor.hh"
+#include "DLFLSyncSession.hh"
 #include <DLFLObject.hh>
 #include <DLFLConvexHull.hh>
 
@@ -89,6 +91,7 @@
 #include <DLFLMeshSmooth.hh>
 #include <DLFLMultiConnect.hh>
 #include <DLFLSculpting.hh>
+#include <DLFLSimilarity.hh>
 #include <DLFLSubdiv.hh>
 
 typedef StringStream * StringStreamPtr;
@@ -255,6 +258,19 @@ class MainWindow : public QMainWindow {
 				DooSabinBC=113, 										/**< . */
 				DooSabinBCNew=114										/**< . */
 				};
+
+			/**
+			* Operations which can be shown as a live preview while their parameters are changed
+			*/
+			enum PreviewKind {
+				NoPreview,
+				RemeshingPreview,										/**< current remeshing scheme */
+				ExtrusionPreview,										/**< current extrusion mode on the selected faces */
+				WireframePreview,
+				Wireframe2Preview,
+				ColumnsPreview,
+				SpongePreview
+			};
 				
 				enum SpinBoxMode { 
 					One=1,														/**< the first spinbox in the current option panel will be controlled by the Y key. */
@@ -307,6 +323,9 @@ class MainWindow : public QMainWindow {
 	//!< Split valence 2 vertices
 	static double vertex_split_offset; //!< Half of distance between new vertices
 
+	//!< Weld vertices
+	static double weld_tolerance; //!< Vertices closer than this are merged
+
 
 	//!< Crust modeling
 	static double crust_thickness;              //!< Thickness of crust
@@ -365,6 +384,36 @@ class MainWindow : public QMainWindow {
 	static double dooSabinBCnewLength_factor; //!< Length factor for new Doo-Sabin remeshing scheme
 	static double loopLength_factor; //!< Length factor for Loop-style remeshing scheme
 
+	/**
+	* \brief copies of the parameters of the remeshing schemes
+	*
+	* Taken on the GUI thread when an operation is made, so it doesn't read the
+	* statics above on the worker thread while the spin boxes change them
+	*/
+	struct RemeshingParameters {
+		bool accurate_dual, doo_sabin_check;
+		double star_offset, fractal_offset, vertex_cutting_offset;
+		double corner_cutting_alpha, modified_corner_cutting_thickness, checkerboard_thickness;
+		double pentagonal_offset, pentagonal_scale, weight_factor, twist_factor;
+		double dual1264_scale_factor, loopLength_factor, substellate_height, substellate_curve;
+		double domeLength_factor, domeScale_factor, dooSabinBCnewScale_factor, dooSabinBCnewLength_factor;
+		RemeshingParameters();								//!< the current values
+	};
+
+	/**
+	* \brief copies of the parameters of an extrusion mode, see RemeshingParameters
+	*/
+	struct ExtrusionParameters {
+		ExtrusionMode mode;
+		int num_extrusions;
+		bool dual_mesh_edges_check, hexagonalize_dodeca_extrude;
+		double extrude_dist, extrude_rot, extrude_scale, ds_ex_twist;
+		double extrude_angle, extrude_length1, extrude_length2, extrude_length3;
+		double extrude_angle_icosa, extrude_length1_icosa, extrude_length2_icosa, extrude_length3_icosa;
+		double domeExtrudeLength_factor, domeExtrudeScale_factor, domeExtrudeRotation_factor;
+		ExtrusionParameters(ExtrusionMode m);				//!< the current values for the mode
+	};
+
 	//!< Face subdivision
 	static bool use_quads; //!< Flag indicating if face subdivision should use quads or triangles
 
@@ -427,6 +476,8 @@ protected :
 	GLWidget *active;															     	//!< Active viewport to handle events
 
 	DLFLObject object;                            //!< The DLFL object
+	DLFLSimilarityIndex similarityIndex;          //!< Index for select similar/by area/by color, rebuilt when object changes
+	CrustInfo crust_info;                         //!< Face pairs of the last crust, for punching holes in crust modeling mode
 	//TMPatchObject *patchObject;										//!< the patch object
 	Mode mode;																		//!< Current operating mode
 	ExtrusionMode extrusionmode;														//!< Current operating mode
@@ -441,6 +492,38 @@ protected :
 	int undolimit;                                //!< Limit for undo
 	bool useUndo;            											//!< Flag to indicate if undo will be used
 
+	const char *mOperationName;                   //!< Profiler name of the operation being timed
+	double mOperationStart;                       //!< Profiler time it started, -1 if none is being timed
+	long mOperationAllocs;                        //!< Allocation count when it started
+	void beginOperation();                        //!< Start timing the operation which called undoPush
+
+	DLFLExecutor *mExecutor;                      //!< Runs long operations on a copy of the object in the background
+	QProgressDialog *mExecutorProgress;           //!< Progress of the operation, with a cancel button
+	QTimer *mExecutorTimer;                       //!< Polls the progress of the operation
+	QString mExecutorCommand;                     //!< Command to echo once the operation is done
+	uint mExecutorStamp;                          //!< object.changeCount() when the operation was started
+	void runOperation(DLFLOperation *op, const QString& name, const QString& cmd = QString()); //!< Run op with mExecutor, takes over op
+
+	DLFLExecutor *mPreviewExecutor;               //!< Runs the live preview on a copy of the object
+	QTimer *mPreviewTimer;                        //!< Waits for the parameters to settle before a preview is run
+	DLFLObject mPreviewBase;                      //!< The object as it was before the shown preview
+	vector<uint> mPreviewFaces;                   //!< Positions in the face list of the faces an extrusion is previewed on
+	PreviewKind mPreviewKind;                     //!< Operation of the current tool which can be previewed
+	PreviewKind mPreviewShownKind;                //!< Operation of the shown preview, NoPreview if none is shown
+	uint mPreviewGeneration;                      //!< Bumped by every parameter change
+	uint mPreviewRunGeneration;                   //!< Generation of the running preview
+	uint mPreviewShownGeneration;                 //!< Generation of the shown preview
+	uint mPreviewStamp;                           //!< object.changeCount() when the running preview was started
+	bool mPreviewPending;                         //!< Start another preview once the running preview or operation has stopped
+	DLFLOperation *previewOperation();            //!< Operation of the current tool, NULL if there is nothing to preview
+	bool keepPreview(PreviewKind kind);           //!< Keep the preview of kind if it is up to date, otherwise drop it
+	void endPreview();                            //!< Forget the preview, leaving the object as it is
+
+	DLFLSyncSession *mSyncSession;                //!< Shares the object with other TopMod instances
+	QTimer *mSyncTimer;                           //!< Exchanges the changes of the session
+
+	MultiConnectCache mMultiFaceHandleCache;      //!< Offsets and hull of the last convex hull multi-face handle
+
 	void initialize(int x, int y, int w, int h, DLFLRendererPtr rp);	//!< Initialize the viewports, etc.
 
 	// brianb
@@ -520,6 +603,11 @@ public :
 	void setRemeshingScheme(RemeshingScheme scheme);		//!< switch the current remeshing scheme
 	void setSelectionMask(SelectionMask m);							//!< set the current selection mask (verts, edges, faces, multiple?)
 	void setToolOptions(QWidget *optionsWidget);				//!< set the current tool option widget to be displayed in mToolOptionsDockWidget
+	void setPreviewKind(PreviewKind kind);							//!< set the operation of the current tool which can be previewed
+	static void applyRemeshing(DLFLObjectPtr obj, RemeshingScheme scheme, RemeshingParameters p);	//!< remesh with the given parameters of the scheme
+	static QString remeshingCommand(RemeshingScheme scheme, const RemeshingParameters& p);		//!< the script command doing the same as applyRemeshing
+	static void applyExtrusion(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, const ExtrusionParameters& p);	//!< extrude the faces with the given parameters
+	static void applyExtrusionToFaces(DLFLObjectPtr obj, ExtrusionParameters p, vector<uint> faces); //!< extrude the faces at the given positions in the face list
 	void loadFile(QString fileName);										//!< load an OBJ or a DLFL file
 	
 	/**
@@ -530,8 +618,17 @@ public :
 #ifdef WITH_PYTHON
 	DLFLScriptEditor *mScriptEditor;							//!< ScriptEditor Object by Stuart
 	QDockWidget *mScriptEditorDockWidget;					//!< docked script editor window for Python Scripting interface by Stuart
+	QList<QAction*> mScriptDisabledActions;				//!< actions switched off while a script runs, see setScriptRunning
 #endif
 
+	bool isScriptRunning() const {								//!< a script is changing the object on its own thread
+#ifdef WITH_PYTHON
+		return mScriptEditor->isRunning();
+#else
+		return false;
+#endif
+	};
+
 #ifdef WITH_VERSE
 	VerseTopMod *mVerseDialog;										//!< for a possible future implementation of the Verse protocol http://verse.blender.org
 	QDockWidget *mVerseDialogDockWidget;					//!< for a possible future implementation of the Verse protocol http://verse.blender.org
@@ -586,6 +683,7 @@ private:
 	QString mSaveDirectory;
 	bool mCommandCompleterIndexToggle;
 	bool mSingleClickExtrude;
+	bool mWeldOnImport;
 
 
 	void createActions();													//!< create all MainWindow actions for menu's and icons, also create operating mode actions in subclasses
@@ -623,6 +721,7 @@ private:
 #ifdef WITH_VERSE
 	QMenu *mVerseMenu;
 #endif
+	QMenu *mSessionMenu;
 
 	QMenu *mRemeshingMenu;
 	QMenu *mToolsMenu;
@@ -645,6 +744,9 @@ private:
 	QAction *printEdgeListAct;
 	QAction *mPrintCVListAct;
 	QAction *mExitAct;
+	QAction *mHostSessionAct;								//!< let other TopMod instances edit the object together with this one
+	QAction *mJoinSessionAct;
+	QAction *mLeaveSessionAct;
 			
 	QAction *mFullscreenAct;
 	QAction *mPerformRemeshingAct;
@@ -660,6 +762,7 @@ private:
 	QAction *mUndoAct;											//!< pop the previous model state off the undo stack
 	QAction *mRedoAct;											//!< push the model back onto the undo stack
 	QAction *mClearUndoListAct;							//!< clear the undo list to free up memory
+	QAction *mLivePreviewAct;								//!< re-run the current tool in the background whenever its parameters change
 
 	//view switching actions
 	QAction *mTopViewAct;										//!< switch to top view
@@ -685,6 +788,8 @@ private:
 	QAction *mShowNormalsAct;
 	QAction *showGridAct;
 	QAction *showHUDAct;
+	QAction *showProfilerAct;
+	QAction *saveProfilerTraceAct;
 	QAction *showCoordinateAxesAct;
 	#ifdef GPU_OK
 	QAction *mUseGPUAct;
@@ -717,6 +822,7 @@ private:
 	QAction *planarizeAllFacesAct;
 	QAction *makeObjectSphericalAct;
 	QAction *mCleanup2gonsAct;
+	QAction *mWeldVerticesAct;
 	QAction *mCleanupWingedVerticesAct;
 	QAction *mSplitValence2VerticesAct;
 	QAction *makeObjectSmoothAct;
@@ -914,6 +1020,11 @@ public slots:
 	void setIncrementalSave(int value);
 	void setCommandCompleterIndexToggle(int value);
 	void setSingleClickExtrude(int value);
+	void setWeldOnImport(int value);
+	void setWeldTolerance(double value);
+	void setSmoothNormals(int value);
+	void setCreaseAngle(double value);
+	void setSessionBandwidth(double value);
 	void setIncrementalSaveMax(double value);
 	void setSaveDirectory(QString s);
 	void checkSaveDirectory();
@@ -1148,6 +1259,21 @@ public slots:
 	void clearUndoList();      // Erase all elements on Undo list
 	void clearRedoList();      // Erase all elements on Redo list
 	void undoPush();         // Put current object onto undo list
+	void endOperation();     // Record the time of the operation started by undoPush
+	void operationFinished(); // Swap in the result of the operation run by mExecutor
+	void updateOperationProgress();
+	void cancelOperation();
+	void toggleLivePreview(bool on);
+	void schedulePreview();   // Preview the current tool once its parameters have settled
+	void startPreview();
+	void previewFinished();   // Show the result of the preview run by mPreviewExecutor
+	void commitPreview();     // Keep the shown preview, the object before it goes on the undo list
+	void discardPreview();    // Go back to the object before the shown preview
+	void saveProfilerTrace(); // Write the profiler records to a trace file
+	void hostSession();
+	void joinSession();
+	void leaveSession();
+	void updateSession();     // Send the local changes of the session and apply the others'
 	void undo();                           // Undo last operation
 	void redo();              // Redo previously undone operation
 
@@ -1184,6 +1310,8 @@ public slots:
 		active->recomputePatches();
 		active->recomputeNormals();
 	};
+	// A script started or stopped changing the object on its own thread
+	void setScriptRunning(bool running);
 #endif
 
 	// void recomputeNormals();
@@ -1205,43 +1333,10 @@ public slots:
 	void performRemeshing(); //!< Generic method for all remeshing schemes
 	void performExtrusion(); //!< Generic method for all extrusion schemes on multiple faces
 	// void getExtrudeMultiple(); //!< are we in multi select mode or not?
-	void subdivideCatmullClark();
-	void subdivideDooSabin();
-	void subdivideHoneycomb();
-	void subdivideRoot4();
-	void subdivideCornerCutting();
-	void subdivideModifiedCornerCutting();
-	void subdivideLinearVertexInsertion();
-	void subdivideSimplest();
-	void subdivideVertexCutting();
-	void subdividePentagonal();
-	void subdivideCubicPentagonal();
-	void subdivideDualPentagonal();
-	void subdividePentagonPreserving();
-	void subdivideDualPentagonPreserving();
-	void subdivideDualHexagonPreserving();
-	void subdivideRoot3();
-	void subdivideLoop();
-	void subdivideDualLoop();
-	void subdivide1264();
-	void subdivideDual1264();
-	void subdivideCheckerBoard();
-	void subdivideDualCheckerBoard();
-	void subdivideStar();
-	void subdivideSqrt3();
-	void subdivideFractal();
-	void subStellate1();
-	void subStellate2();
-	void subdivideDome();
-	void subdivideDooSabinBC();
-	void subdivideDooSabinBCNew();
-	void subdivideLoopStyle();
-	void globalStellate();
-	void triangulate();
 	void splitValence2Vertices();
 	void cleanupWingedVertices();
 	void cleanup2gons();
-	void createDual();
+	void weldVertices();
 	void crustModeling1();
 	void crustModeling2();
 	void crustModeling3();
@@ -1298,7 +1393,7 @@ public slots:
 	bool saveFileSTL( );
 	void writePatchOBJ(const char *filename);
 	void writeLG3d(const char *filename, bool selected = false);
-	void writeSTL(const char *filename);	
+	void writeSTL(const char *filename, bool binary = true);	
 
 	//primitive slot functions finally work
 	void loadCube();
@@ -38,6 +38,8 @@
 
 #include "MainWindow.hh"
 
+#include <set>
+
 void MainWindow::load_texture() {
 	QString fileName = QFileDialog::getOpenFileName(this,
 		tr("Open File..."),
@@ -52,7 +54,8 @@ void MainWindow::load_texture() {
 		if (texfile != NULL){
 			textured->setTexture(texfile);
 			texturedlit->setTexture(texfile);
-			// getActive()->valid(0); // To ensure new texture is loaded into OpenGL
+			// The image is decoded in the background, show it once it is ready
+			TextureCache::instance().notifyWhenLoaded(fileName,this,SLOT(redraw()));
 			redraw();
 		}
 		// readObject(filename);
@@ -193,6 +196,32 @@ void MainWindow::changeDomeExtrudeRotation(double value)
 void MainWindow::setSingleClickExtrude(int value){
 	mSingleClickExtrude = (bool)value;
 }
+
+void MainWindow::setWeldOnImport(int value){
+	mWeldOnImport = (bool)value;
+}
+
+void MainWindow::setWeldTolerance(double value){
+	MainWindow::weld_tolerance = value;
+}
+
+void MainWindow::setSmoothNormals(int value){
+	object.setNormalMode(value ? DLFLNormals::Smooth : DLFLNormals::Faceted);
+	active->recomputeNormals();
+	redraw();
+}
+
+void MainWindow::setCreaseAngle(double value){
+	object.setCreaseAngle(value);
+	if ( object.normalMode() == DLFLNormals::Smooth ) {
+		active->recomputeNormals();
+		redraw();
+	}
+}
+
+void MainWindow::setSessionBandwidth(double value){
+	mSyncSession->setBandwidth((int)(value * 1024));
+}
 // Selection Menu.
 void MainWindow::select_vertex() {
 	setMode(MainWindow::SelectVertex);
@@ -848,7 +877,7 @@ void MainWindow::createMultiFaceHandle(void) // Create multi-face handle between
 	}
 	switch ( MainWindow::mfh_algo )	{
 		case ConvexHull :
-		DLFL::multiConnectFaces(&object,sel_faces,MainWindow::mfh_scale_factor,MainWindow::mfh_extrude_dist,MainWindow::mfh_use_max_offsets);
+		DLFL::multiConnectFaces(&object,sel_faces,MainWindow::mfh_scale_factor,MainWindow::mfh_extrude_dist,MainWindow::mfh_use_max_offsets,&mMultiFaceHandleCache);
 		break;
 		case ClosestEdge :
 		DLFL::multiConnectFaces(&object,sel_faces);
@@ -876,34 +905,20 @@ void MainWindow::multiConnectMidpoints(void)
 void MainWindow::multiConnectCrust(void)
 {
 	// Multi-connect after creating crust
-	undoPush();
-	DLFL::multiConnectCrust(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	redraw();
+	runOperation(makeOperation(DLFL::multiConnectCrust, 0.5), tr("Multi-Connect Crust"));
 }
 
 void MainWindow::modifiedMultiConnectCrust(void)
 {
 	// Modified multi-connect after creating crust
-	undoPush();
-	DLFL::modifiedMultiConnectCrust(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	redraw();
+	runOperation(makeOperation(DLFL::modifiedMultiConnectCrust, 0.5), tr("Modified Multi-Connect Crust"));
 }
 
 void MainWindow::createSponge(void)
 {
-	undoPush();
-	DLFL::createSponge(&object,MainWindow::sponge_thickness,
-		MainWindow::sponge_collapse_threshold);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	redraw();
+	if ( keepPreview(SpongePreview) ) return;
+	runOperation(makeOperation(DLFL::createSponge, MainWindow::sponge_thickness,
+														 MainWindow::sponge_collapse_threshold), tr("Sponge"));
 }
 
 void MainWindow::planarizeFaces(void)                  // Planarize all faces
@@ -933,490 +948,355 @@ void MainWindow::smoothMesh(void)                          // Smooth the mesh
 	redraw();
 }
 
-void MainWindow::subdivideCatmullClark(void)     // Catmull-Clark subdivision
-{
-	undoPush();
-	DLFL::catmullClarkSubdivide(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "subdivide(\"catmull-clark\")");
-	emit echoCommand( cmd );
-	// redraw();
-}
-
-void MainWindow::subdivideDooSabin(void)             // Doo-Sabin subdivision
-{
-	undoPush();
-	
-	// QProgressDialog *progress = new QProgressDialog("Performing Doo Sabin Remeshing...", "Cancel", 0, 1);
-	// progress->setMinimumDuration(2000);
-	// progress->setWindowModality(Qt::WindowModal);
-	
-	// DLFLObjectPtr t = object;
-	// active->setRenderingEnabled(false);
-	
-	// if (!DLFL::dooSabinSubdivide(&object, doo_sabin_check/* , progress*/) ){
-		// active->recomputePatches();
-		// active->recomputeNormals();
-		// undo();
-		// MainWindow::clearSelected();
-		// active->setRenderingEnabled(true);
-	// }
-	// else {
-		// object = t;
-		// delete t;
-		// active->setRenderingEnabled(true);
-		DLFL::dooSabinSubdivide(&object, doo_sabin_check/* , progress*/);
-		active->recomputePatches();
-		active->recomputeNormals();
-		MainWindow::clearSelected();
-		QString cmd( "subdivide(\"doo-sabin\",");
-		QString check("False");
-		if( doo_sabin_check )
-			check = QString("True");
-		cmd += check + QString(")");
-		emit echoCommand( cmd );
-	// }
-	
-}
-
-void MainWindow::subdivideHoneycomb(void)            // Honeycomb subdivision
-{
-	undoPush();
-	DLFL::honeycombSubdivide(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd("subdivide(\"honeycomb\")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideRoot4(void)                   // Root-4 subdivision
-{
-	undoPush();
-	DLFL::root4Subdivide( &object, MainWindow::weight_factor,MainWindow::twist_factor);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "subdivide(\"root4\",");
-	cmd += QString().setNum(MainWindow::weight_factor) + QString(",");
-	cmd += QString().setNum(MainWindow::twist_factor) + QString(")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideCornerCutting(void)   // Corner-cutting subdivision
-{
-	undoPush();
-	DLFL::cornerCuttingSubdivide(&object, MainWindow::corner_cutting_alpha);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd("subdivide(\"corner-cut\")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideModifiedCornerCutting(void)   // Modified Corner-cutting subdivision
-{
-	undoPush();
-	DLFL::modifiedCornerCuttingSubdivide(&object,MainWindow::modified_corner_cutting_thickness);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	// QString cmd("subdivide(\"modified-corner-cut\")");
-	// emit echoCommand( cmd );
-}
-
-
-void MainWindow::subdivideLinearVertexInsertion(void) // Bi-linear Vertex-insertion remeshing
-{
-	undoPush();
-	DLFL::subdivideAllFaces(&object,true);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd("subdivide(\"linear-vertex\",True)");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideSimplest(void)        // Corner-cutting subdivision
-{
-	undoPush();
-	DLFL::simplestSubdivide(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd("subdivide(\"simplest\")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideVertexCutting(void)   // Vertex-cutting subdivision
-{
-	undoPush();
-	DLFL::vertexCuttingSubdivide(&object,MainWindow::vertex_cutting_offset);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("subdivide(\"vertex-cut\"," )
-		+ QString().setNum(MainWindow::vertex_cutting_offset)
-		+ QString(")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdividePentagonal(void)          // Pentagonal subdivision
-{
-	undoPush();
-	DLFL::pentagonalSubdivide(&object,MainWindow::pentagonal_offset);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "subdivide(\"pentagon\",");
-	cmd += QString().setNum(MainWindow::pentagonal_offset) + QString(")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideCubicPentagonal(void) // Cubic Pentagonal remeshing scheme
-{
-// Implemented as Pentagonal + Dual + Dual
-	undoPush();
-	DLFL::pentagonalSubdivide(&object,MainWindow::pentagonal_offset);
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "subdivide(\"pentagon\",");
-	cmd += QString().setNum(MainWindow::pentagonal_offset) + QString(")");
-	cmd += QString("\ndual()\ndual()");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideDualPentagonal(void) // Dual-Pentagonal subdivision
-{
-// Implemented as Dual + Pentagonal + Dual
-	undoPush();
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::pentagonalSubdivide(&object,MainWindow::pentagonal_offset);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "dual()\nsubdivide(\"pentagon\",");
-	cmd += QString().setNum(MainWindow::pentagonal_offset) + QString(")");
-	cmd += QString("\ndual()");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdividePentagonPreserving(void) // Pentagon preserving remeshing
-{
-	undoPush();
-	DLFL::pentagonalSubdivide2(&object,MainWindow::pentagonal_scale);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "subdivide(\"pentagon-preserve\",");
-	cmd += QString().setNum(MainWindow::pentagonal_scale) + QString(")");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideDualPentagonPreserving(void) // Dual Pentagon preserving remeshing
-{
-// Implemented as Dual + Pentagonal + Dual
-	undoPush();
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::pentagonalSubdivide2(&object,MainWindow::pentagonal_scale);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "dual()\nsubdivide(\"pentagon-preserve\",");
-	cmd += QString().setNum(MainWindow::pentagonal_scale) + QString(")");
-	cmd += QString("\ndual()");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideDualHexagonPreserving(void) // Dual Hexagon Preserving remeshing
-{
-// Implemented as Dual + Root4 + Dual
-	undoPush();
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::root4Subdivide(&object,MainWindow::weight_factor,MainWindow::twist_factor);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd( "dual()\nsubdivide(\"root4\",");
-	cmd += QString().setNum(MainWindow::weight_factor) + QString(",");
-	cmd += QString().setNum(MainWindow::twist_factor) + QString(")");
-	cmd += QString("\ndual()");
-	emit echoCommand( cmd );
-}
-
-void MainWindow::subdivideRoot3(void)                     // Root-3 remeshing
+// Run a long operation on a copy of the object in the background, see DLFLExecutor.
+// The result replaces the object in operationFinished. The progress dialog is
+// window modal so the object can't be edited while the operation runs, and only
+// shows up if the operation takes a while
+void MainWindow::runOperation(DLFLOperation *op, const QString& name, const QString& cmd)
 {
-// Implemented as Dual + Honeycomb + Dual
-	undoPush();
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::honeycombSubdivide(&object);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
+	if ( isScriptRunning() ) {
+		delete op;
+		return;
+	}
+	if ( mExecutor->isBusy() ) {
+		delete op;
+		statusBar()->showMessage(tr("%1 is still running").arg(mExecutor->name()), 2000);
+		return;
+	}
+	// The operation works on what is shown
+	commitPreview();
+	mExecutorCommand = cmd;
+	mExecutorStamp = object.changeCount();
+	mExecutor->execute(op, object, name);
 
-	QString cmd = QString("dual()\n");
-	cmd += QString("subdivide(\"honeycomb\")\n");
-	cmd += QString("dual()");
-	emit echoCommand( cmd );
+	mExecutorProgress->setLabelText(name + tr("..."));
+	mExecutorProgress->setRange(0,1000);
+	mExecutorProgress->setValue(0);
+	mExecutorTimer->start(100);
 }
 
-void MainWindow::subdivideLoop(void)                      // Loop subdivision
+void MainWindow::updateOperationProgress(void)
 {
-	undoPush();
-	DLFL::loopSubdivide(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd("subdivide(\"loop\")\n");
-	emit echoCommand( cmd );
+	const DLFLProgress& p = mExecutor->progress();
+	long total = p.getTotal();
+	if ( total <= 0 ) return;
+	// Kept below the maximum, the operation may have stages which don't report
+	long value = (long)(1000.0 * p.getDone() / total);
+	if ( value > 999 ) value = 999;
+	mExecutorProgress->setLabelText(mExecutor->name() + QString(" (%1)").arg(p.getStage()));
+	mExecutorProgress->setValue(value);
 }
 
-void MainWindow::subdivideDualLoop(void)          // Dual of Loop subdivision
+void MainWindow::cancelOperation(void)
 {
-// Implemented as Dual + Loop + Dual
-	undoPush();
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::loopSubdivide(&object);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("dual()\n");
-	cmd += QString("subdivide(\"loop\")\n");
-	cmd += QString("dual()");
-	emit echoCommand( cmd );
+	mExecutor->cancel();
+	statusBar()->showMessage(tr("Cancelling %1...").arg(mExecutor->name()));
 }
 
-void MainWindow::subdivide1264(void)                      // 12-6-4 remeshing
+void MainWindow::operationFinished(void)
 {
-// Implemented as Dual + Dual 12-6-4 + Dual
-	undoPush();
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::dual1264Subdivide(&object,MainWindow::dual1264_scale_factor);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
+	mExecutorTimer->stop();
+	mExecutorProgress->reset();
 
-	QString cmd = QString("dual()\ndual()\n");
-	cmd += QString("subdivide(\"dual-12.6.4\",")
-		+ QString().setNum(MainWindow::dual1264_scale_factor) 
-		+ QString(")\n");
-	cmd += QString("dual()");
-	emit echoCommand(cmd);
+	if ( mExecutor->wasCancelled() ) {
+		statusBar()->showMessage(tr("%1 cancelled").arg(mExecutor->name()), 2000);
+	} else if ( isScriptRunning() ) {
+		statusBar()->showMessage(tr("%1 discarded, a script is changing the object").arg(mExecutor->name()), 4000);
+	} else if ( object.changeCount() != mExecutorStamp ) {
+		// Edited before the progress dialog came up. Keep the edit
+		statusBar()->showMessage(tr("%1 discarded, the object was changed while it ran").arg(mExecutor->name()), 4000);
+	} else {
+		undoPush();
+		setModified(true);
+		object.swap(mExecutor->result());
+		active->recomputePatches();
+		active->recomputeNormals();
+		// Clear selection lists to avoid dangling pointers
+		MainWindow::clearSelected();
+		crust_info.clear();
+		if ( !mExecutorCommand.isEmpty() )
+			emit echoCommand( mExecutorCommand );
+		redraw();
+	}
+	// Frees the old elements, which are in the executor's object now
+	mExecutor->release();
+	if ( mPreviewPending ) {
+		mPreviewPending = false;
+		schedulePreview();
+	}
 }
 
-void MainWindow::subdivideDual1264(void) // Dual of 12-6-4 remeshing - Bei & Cansin
+// Live preview. With mLivePreviewAct checked, every parameter change of the
+// current tool re-runs it with mPreviewExecutor, once the parameters have not
+// changed for a moment. A change while it runs cancels it, and results of runs
+// which are out of date are thrown away. The result is swapped into the object
+// to be shown, and the object as it was is kept in mPreviewBase. Performing
+// the tool keeps an up to date preview instead of running it again, any other
+// operation keeps the preview too (see undoPush), and undo goes back to mPreviewBase
+void MainWindow::toggleLivePreview(bool on)
 {
-	undoPush();
-	DLFL::dual1264Subdivide(&object,MainWindow::dual1264_scale_factor);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd("subdivide(\"dual-12.6.4\",");
-	cmd += QString().setNum(MainWindow::dual1264_scale_factor);
-	cmd += QString(")");
-	emit echoCommand(cmd);
+	if ( on ) schedulePreview();
+	else discardPreview();
 }
 
-void MainWindow::subdivideCheckerBoard(void)       // Checker board remeshing
+void MainWindow::setPreviewKind(PreviewKind kind)
 {
-	undoPush();
-	DLFL::checkerBoardRemeshing(&object,MainWindow::checkerboard_thickness);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd("subdivide(\"checker\",");
-	cmd += QString().setNum(MainWindow::checkerboard_thickness);
-	cmd += QString(")");
-	emit echoCommand(cmd);
+	mPreviewKind = kind;
+	schedulePreview();
 }
 
-void MainWindow::subdivideDualCheckerBoard(void) // Dual Checker board remeshing
+void MainWindow::schedulePreview(void)
 {
-// Implemented as Dual + Checker board + Dual
-	undoPush();
-	setModified(true);
-	DLFL::createDual(&object,true); // Use accurate method
-	DLFL::checkerBoardRemeshing(&object,MainWindow::checkerboard_thickness);
-	DLFL::createDual(&object,true); // Use accurate method
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd("dual()\nsubdivide(\"checker\",");
-	cmd += QString().setNum(MainWindow::checkerboard_thickness);
-	cmd += QString(")\ndual()");
-	emit echoCommand(cmd);
+	if ( !mLivePreviewAct->isChecked() || mPreviewKind == NoPreview ) return;
+	++mPreviewGeneration;
+	// Restarting the timer waits for the parameters to settle
+	mPreviewTimer->start();
 }
 
-void MainWindow::subdivideStar(void)               // Star subdivision - Doug
+void MainWindow::startPreview(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::starSubdivide(&object,MainWindow::star_offset);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
+	if ( mPreviewKind == NoPreview || isScriptRunning() ) return;
+	if ( mExecutor->isBusy() ) {
+		// Operations started by the user go first, operationFinished starts it again
+		mPreviewPending = true;
+		return;
+	}
+	if ( mPreviewExecutor->isBusy() ) {
+		// Out of date, start again once it has stopped
+		mPreviewExecutor->cancel();
+		mPreviewPending = true;
+		return;
+	}
+	mPreviewPending = false;
 
-	QString cmd = QString("subdivide(\"star\")");
-	emit echoCommand( cmd );
+	if ( mPreviewKind == ExtrusionPreview && mPreviewShownKind == NoPreview ) {
+		// The selected faces, by their position in the face list
+		DLFLFacePtrArray sfptrarr = active->getSelectedFaces();
+		set<DLFLFacePtr> selected(sfptrarr.begin(), sfptrarr.end());
+		DLFLFacePtrArray fparray;
+		object.getFaces(fparray);
+		mPreviewFaces.clear();
+		for (uint i=0; i < fparray.size(); ++i)
+			if ( selected.count(fparray[i]) ) mPreviewFaces.push_back(i);
+	}
+	DLFLOperation *op = previewOperation();
+	if ( op == NULL ) return;
+
+	mPreviewRunGeneration = mPreviewGeneration;
+	mPreviewStamp = object.changeCount();
+	mPreviewExecutor->execute(op, (mPreviewShownKind == NoPreview) ? object : mPreviewBase, tr("Preview"));
+	statusBar()->showMessage(tr("Updating preview..."));
+}
+
+// The parameters are copied into the operation here, see RemeshingParameters
+DLFLOperation *MainWindow::previewOperation(void)
+{
+	switch ( mPreviewKind ) {
+	case RemeshingPreview :
+		return makeOperation(MainWindow::applyRemeshing, remeshingscheme, RemeshingParameters());
+	case ExtrusionPreview :
+		if ( mPreviewFaces.empty() ) return NULL;
+		return makeOperation(MainWindow::applyExtrusionToFaces, ExtrusionParameters(extrusionmode), mPreviewFaces);
+	case WireframePreview :
+		return makeOperation(DLFL::makeWireframe, MainWindow::wireframe_thickness, MainWindow::wireframe_split);
+	case Wireframe2Preview :
+		return makeOperation(DLFL::makeWireframe2, MainWindow::wireframe2_thickness,
+												 MainWindow::wireframe2_width, MainWindow::wireframe_split);
+	case ColumnsPreview :
+		return makeOperation(DLFL::makeWireframeWithColumns, MainWindow::column_thickness, MainWindow::column_segments);
+	case SpongePreview :
+		return makeOperation(DLFL::createSponge, MainWindow::sponge_thickness, MainWindow::sponge_collapse_threshold);
+	default :
+		return NULL;
+	}
 }
 
-void MainWindow::subdivideSqrt3(void)           // sqrt(3) subdivision - Doug
+void MainWindow::previewFinished(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::sqrt3Subdivide(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("subdivide(\"sqrt3\")");
-	emit echoCommand( cmd );
+	bool current = !mPreviewExecutor->wasCancelled() && mPreviewRunGeneration == mPreviewGeneration && !isScriptRunning();
+	if ( current && object.changeCount() != mPreviewStamp ) {
+		// Edited while it ran (eg. Smooth Mesh), keep the edit and preview the edited object
+		current = false;
+		mPreviewPending = true;
+	}
+	if ( current ) {
+		if ( mPreviewShownKind == NoPreview ) {
+			// Keep the object as it was
+			mPreviewBase.reset();
+			mPreviewBase.swap(object);
+		}
+		object.swap(mPreviewExecutor->result());
+		mPreviewShownKind = mPreviewKind;
+		mPreviewShownGeneration = mPreviewRunGeneration;
+		active->recomputePatches();
+		active->recomputeNormals();
+		// Clear selection lists to avoid dangling pointers
+		MainWindow::clearSelected();
+		crust_info.clear();
+		redraw();
+		statusBar()->showMessage(tr("Preview, perform the operation to keep it"));
+	}
+	// Frees the preview shown before, if any
+	mPreviewExecutor->release();
+	if ( mPreviewPending ) startPreview();
 }
 
-void MainWindow::subdivideFractal(void)                     // fractal - Doug
+void MainWindow::commitPreview(void)
 {
+	if ( mPreviewShownKind == NoPreview ) return;
+	// Cleared first, undoPush commits a shown preview
+	mPreviewShownKind = NoPreview;
+	object.swap(mPreviewBase);
 	undoPush();
+	object.swap(mPreviewBase);
 	setModified(true);
-	DLFL::fractalSubdivide(&object,MainWindow::fractal_offset);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd("subdivide(\"fractal\",");
-	cmd += QString().setNum(MainWindow::fractal_offset);
-	cmd += QString(")");
-	emit echoCommand(cmd);
+	endPreview();
 }
 
-void MainWindow::subStellate1(void)            // stellate subdivision - Eric
+void MainWindow::discardPreview(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::stellateSubdivide(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("subdivide(\"stellate\")");
-	emit echoCommand( cmd );
+	if ( mPreviewShownKind != NoPreview ) {
+		object.swap(mPreviewBase);
+		active->recomputePatches();
+		active->recomputeNormals();
+		MainWindow::clearSelected();
+		crust_info.clear();
+		if ( mPreviewShownKind == ExtrusionPreview ) {
+			// Select the faces again
+			DLFLFacePtrArray fparray;
+			object.getFaces(fparray);
+			for (uint i=0; i < mPreviewFaces.size(); ++i)
+				if ( mPreviewFaces[i] < fparray.size() )
+					active->setSelectedFace(num_sel_faces++, fparray[mPreviewFaces[i]]);
+		}
+		redraw();
+	}
+	endPreview();
 }
 
-void MainWindow::subStellate2(void)            // stellate subdivision - Eric
+void MainWindow::endPreview(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::twostellateSubdivide(&object,MainWindow::substellate_height, MainWindow::substellate_curve);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("subdivide(\"double-stellate\",");
-	cmd += QString().setNum(MainWindow::substellate_height) + QString(",");
-	cmd += QString().setNum(MainWindow::substellate_curve) + QString(")");
-	emit echoCommand( cmd );
+	++mPreviewGeneration;
+	mPreviewTimer->stop();
+	mPreviewPending = false;
+	if ( mPreviewExecutor->isBusy() ) mPreviewExecutor->cancel();
+	mPreviewShownKind = NoPreview;
+	mPreviewBase.reset();
+	mPreviewFaces.clear();
 }
 
-void MainWindow::subdivideDome(void)                          // Bei & Cansin
+// Called by the buttons which perform a tool
+bool MainWindow::keepPreview(PreviewKind kind)
 {
-	undoPush();
-	setModified(true);
-	DLFL::domeSubdivide(&object,MainWindow::domeLength_factor, MainWindow::domeScale_factor);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("subdivide(\"dome\",");
-	cmd += QString().setNum(MainWindow::substellate_height) + QString(",");
-	cmd += QString().setNum(MainWindow::substellate_curve) + QString(")");
-	emit echoCommand( cmd );
+	if ( mPreviewShownKind == kind && mPreviewShownGeneration == mPreviewGeneration ) {
+		commitPreview();
+		redraw();
+		statusBar()->clearMessage();
+		return true;
+	}
+	// Perform it on the object as it was
+	discardPreview();
+	return false;
 }
 
-void MainWindow::subdivideDooSabinBC(void) // Doo-Sabin(BC) subdivision - Bei & Cansin
+// Sessions. The object is shared with other TopMod instances through
+// mSyncSession, see DLFLSyncSession. Changes are exchanged by updateSession
+// every tick of mSyncTimer, except while something else has the object
+void MainWindow::hostSession(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::dooSabinSubdivideBC(&object,MainWindow::doo_sabin_check);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString check("False");
-	if(MainWindow::doo_sabin_check)
-		check = QString("True");
-	QString cmd = QString("subdivide(\"doo-sabin-bc\",");
-	cmd += check + QString(")");
-	emit echoCommand( cmd );
+	bool ok;
+	int port = QInputDialog::getInteger(this, tr("Host Session"), tr("Port:"),
+																			DLFLSyncSession::DefaultPort, 1024, 65535, 1, &ok);
+	if ( !ok ) return;
+	if ( mSyncSession->host(port) ) mSyncTimer->start();
 }
 
-void MainWindow::subdivideDooSabinBCNew(void) // Doo-Sabin(BCNew) Bei & Cansin
+void MainWindow::joinSession(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::dooSabinSubdivideBCNew(&object,MainWindow::dooSabinBCnewScale_factor,
-		MainWindow::dooSabinBCnewLength_factor);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd = QString("subdivide(\"doo-sabin-bc-new\",");
-	cmd += QString().setNum(MainWindow::dooSabinBCnewScale_factor) + QString(",");
-	cmd += QString().setNum(MainWindow::dooSabinBCnewLength_factor) + QString(")");
-	emit echoCommand( cmd );
+	bool ok;
+	QString text = QInputDialog::getText(this, tr("Join Session"), tr("Host (address:port):"), QLineEdit::Normal,
+																			 QString("localhost:%1").arg(DLFLSyncSession::DefaultPort), &ok);
+	if ( !ok || text.isEmpty() ) return;
+	QString address = text.section(':',0,0);
+	int port = text.section(':',1,1).toInt();
+	if ( port <= 0 ) port = DLFLSyncSession::DefaultPort;
+	// The object is replaced by the session's
+	endPreview();
+	mSyncSession->join(address, port);
+	mSyncTimer->start();
 }
 
-void MainWindow::subdivideLoopStyle(void)     // Loop-style subdivision - Bei
+void MainWindow::leaveSession(void)
 {
-	undoPush();
-	setModified(true);
-	DLFL::loopStyleSubdivide(&object,MainWindow::loopLength_factor);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-	QString cmd = QString("subdivide(\"loop-style\",");
-	cmd += QString().setNum(MainWindow::loopLength_factor) + QString(")");
-	emit echoCommand( cmd );
+	mSyncTimer->stop();
+	mSyncSession->leave();
+	statusBar()->showMessage(tr("Left the session"), 2000);
 }
 
-void MainWindow::globalStellate(void)
+void MainWindow::updateSession(void)
 {
-	// Does not use length parameter for now. Uses subdivideFace method with triangles
-	undoPush();
-	setModified(true);
-	DLFL::subdivideAllFaces(&object,false);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	QString cmd = QString("subdivide(\"allfaces\",False)");
-	emit echoCommand( cmd );
+	if ( !mSyncSession->isActive() ) {
+		mSyncTimer->stop();
+		return;
+	}
+	// An operation or the preview works on a copy and swaps it in, a script
+	// changes the object from its own thread
+	if ( mExecutor->isBusy() || mPreviewShownKind != NoPreview || isScriptRunning() ) return;
+	DLFLVertexPtrArray moved;
+	// Vertices are only moved, not rebuilt, under a vertex being dragged
+	DLFLSync::Result result = mSyncSession->update(&object, moved, !is_editing);
+	if ( result == DLFLSync::Rebuilt ) {
+		// Clear selection lists to avoid dangling pointers
+		MainWindow::clearSelected();
+		crust_info.clear();
+		active->recomputePatches();
+		active->recomputeNormals();
+		redraw();
+	} else if ( result == DLFLSync::Moved ) {
+		object.updateNormals(moved);
+		if ( !is_editing ) active->recomputeLighting();
+		redraw();
+	}
 }
 
-void MainWindow::triangulate(void)
-{
-	undoPush();
-	setModified(true);
-	DLFL::triangulateAllFaces(&object);
-	active->recomputePatches();
-	active->recomputeNormals();
-	MainWindow::clearSelected();
-
-	// QString cmd = QString("subdivide(\"triangulate\",False)");
-	// emit echoCommand( cmd );
-}
+#ifdef WITH_PYTHON
+// Only drawing waits for the object lock of the script editor, so while a script
+// changes the object on its own thread nothing else in the main window may touch
+// it. The viewport, menus, tool bars and tool options are switched off, and so is
+// every action outside the script editor, which also takes care of the shortcuts.
+// Operations and previews still running throw their results away
+void MainWindow::setScriptRunning(bool running)
+{
+	if ( running ) {
+		// Before the script thread starts, the preview must not be swapped in later on
+		endPreview();
+		QList<QAction*> actions = findChildren<QAction*>();
+		for (int i=0; i < actions.size(); ++i) {
+			QAction *action = actions[i];
+			QWidget *owner = qobject_cast<QWidget*>(action->parent());
+			if ( action == mShowScriptEditorAct || !action->isEnabled() ) continue;
+			if ( owner && (owner == mScriptEditorDockWidget || mScriptEditorDockWidget->isAncestorOf(owner)) ) continue;
+			action->setEnabled(false);
+			mScriptDisabledActions.append(action);
+		}
+	} else {
+		for (int i=0; i < mScriptDisabledActions.size(); ++i)
+			mScriptDisabledActions[i]->setEnabled(true);
+		mScriptDisabledActions.clear();
+	}
+	active->setEnabled(!running);
+	menuBar()->setEnabled(!running);
+	mToolOptionsDockWidget->setEnabled(!running);
+	QList<QToolBar*> toolbars = findChildren<QToolBar*>();
+	for (int i=0; i < toolbars.size(); ++i)
+		toolbars[i]->setEnabled(!running);
+	if ( !running ) {
+		// Parameters may have changed meanwhile
+		schedulePreview();
+		statusBar()->clearMessage();
+	} else statusBar()->showMessage(tr("Running script..."));
+}
+#endif
 
 void MainWindow::splitValence2Vertices(void)      // Split Valence 2 vertices
 {
@@ -1440,28 +1320,27 @@ void MainWindow::cleanup2gons(void)      // cleanup 2-gons
 	redraw();
 }
 
-void MainWindow::cleanupWingedVertices(void)     // Remove valence 2 vertices
+void MainWindow::weldVertices(void)      // Merge coincident vertices
 {
 	undoPush();
 	setModified(true);
-	DLFL::cleanupWingedVertices(&object);
+	uint n = object.weldVertices(MainWindow::weld_tolerance);
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
 	redraw();
+	statusBar()->showMessage(tr("%1 vertices welded").arg(n), 2000);
 }
 
-void MainWindow::createDual(void)                       // Create dual object
+void MainWindow::cleanupWingedVertices(void)     // Remove valence 2 vertices
 {
 	undoPush();
 	setModified(true);
-	DLFL::createDual(&object,MainWindow::accurate_dual);
+	DLFL::cleanupWingedVertices(&object);
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
-
-	QString cmd = QString("dual()");
-	emit echoCommand( cmd );
+	redraw();
 }
 
 void MainWindow::createCrust(bool use_scaling)        // Create a crust
@@ -1469,9 +1348,9 @@ void MainWindow::createCrust(bool use_scaling)        // Create a crust
 	undoPush();
 	setModified(true);
 	if ( use_scaling ) 
-		DLFL::createCrustWithScaling(&object,MainWindow::crust_scale_factor);
+		DLFL::createCrustWithScaling(&object,crust_info,MainWindow::crust_scale_factor);
 	else 
-		DLFL::createCrust(&object,MainWindow::crust_thickness);
+		DLFL::createCrust(&object,crust_info,MainWindow::crust_thickness);
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
@@ -1490,9 +1369,9 @@ void MainWindow::createCrust2(bool use_scaling) {
 	undoPush();
 	setModified(true);
 	if ( use_scaling ) 
-		DLFL::createCrustWithScaling(&object,MainWindow::crust_scale_factor);
+		DLFL::createCrustWithScaling(&object,crust_info,MainWindow::crust_scale_factor);
 	else 
-		DLFL::createCrust(&object,MainWindow::crust_thickness);
+		DLFL::createCrust(&object,crust_info,MainWindow::crust_thickness);
 	active->recomputePatches();
 	active->recomputeNormals();
 	if ( active->numSelectedFaces() >= 1 ) {
@@ -1503,7 +1382,7 @@ void MainWindow::createCrust2(bool use_scaling) {
 				facelist += QString().setNum((*it)->getID()) + QString(",");
 			}
 			facelist += QString("]");
-			DLFL::punchHoles(&object);
+			DLFL::punchHoles(&object,crust_info);
 		}
 	}
 	active->recomputePatches();
@@ -1520,6 +1399,7 @@ void MainWindow::createCrust2(bool use_scaling) {
 
 void MainWindow::makeWireframe(void)                    // Create a wireframe
 {
+	if ( keepPreview(WireframePreview) ) return;
 	undoPush();
 	setModified(true);
 	DLFL::makeWireframe(&object,MainWindow::wireframe_thickness,MainWindow::wireframe_split);
@@ -1530,6 +1410,7 @@ void MainWindow::makeWireframe(void)                    // Create a wireframe
 }
 
 void MainWindow::makeWireframe2() {// Create a wireframe // dave {
+	if ( keepPreview(Wireframe2Preview) ) return;
 	// vector<DLFLFacePtr>::iterator it;
 	undoPush();
 	setModified(true);
@@ -1554,6 +1435,7 @@ void MainWindow::makeWireframe2() {// Create a wireframe // dave {
 
 void MainWindow::makeWireframeWithColumns(void) // Create a wireframe using columns
 {
+	if ( keepPreview(ColumnsPreview) ) return;
 	undoPush();
 	setModified(true);
 	DLFL::makeWireframeWithColumns(&object,MainWindow::column_thickness, MainWindow::column_segments);
@@ -1742,6 +1624,7 @@ void MainWindow::deleteSelected(){
 				undoPush();
 				setModified(true);
 				vector<DLFLEdgePtr>::iterator eit;
+				DLFLBatchScope batch(&object);
 				for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
 					DLFL::deleteEdge( &object, *eit, true);
 					// DLFL::deleteEdge( &object, septr, MainWindow::delete_edge_cleanup);					
@@ -1759,14 +1642,19 @@ void MainWindow::deleteSelected(){
 			if ( svptrarr[0] ) {
 				undoPush();
 				setModified(true);
+				// Gather the edges first, deleting them can remove selected vertices
+				// which have become point-spheres
+				DLFLEdgePtrArray vedges;
+				set<DLFLEdgePtr> seen;
 				for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++){
 					(*vit)->getEdges(septrarr);
 					vector<DLFLEdgePtr>::iterator eit;
 					for(eit = septrarr.begin(); eit != septrarr.end(); eit++)
-						DLFL::deleteEdge( &object, *eit, true);
-						// active->recomputePatches();
-						// active->recomputeNormals();						
-					}
+						if ( seen.insert(*eit).second ) vedges.push_back(*eit);
+				}
+				DLFLBatchScope batch(&object);
+				for(eit = vedges.begin(); eit != vedges.end(); eit++)
+					DLFL::deleteEdge( &object, *eit, true);
 			}			
 			active->clearSelectedVertices();
 			active->recomputePatches();
@@ -1818,12 +1706,15 @@ void MainWindow::collapseSelectedEdges(){
 		undoPush();
 		setModified(true);
 		vector<DLFLEdgePtr>::iterator eit;
+		object.beginBatch();
 		for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-			if (*eit){
+			// Skip edges removed by the cleanup of an earlier collapse. Nothing is
+			// freed before endBatch, so the pointer can still be looked at
+			if (*eit && object.findEdge((*eit)->getID()) == *eit)
 				DLFL::collapseEdge( &object, *eit, MainWindow::delete_edge_cleanup);
-				active->recomputeNormals();						
-			}
 		}
+		object.endBatch();
+		active->recomputeNormals();
 		active->recomputePatches();
 	}			
 	active->clearSelectedEdges();
@@ -1831,250 +1722,77 @@ void MainWindow::collapseSelectedEdges(){
 }
 
 void MainWindow::selectEdgesFromFaces(){
-	DLFLEdgePtrArray septrarr;
-	DLFLFacePtrArray sfptrarr;
-	vector<DLFLFacePtr>::iterator fit;
-	vector<DLFLEdgePtr>::iterator eit;
-	//loop through selected faces, get corresponding edges, select them
-	sfptrarr = active->getSelectedFaces();
-	if ( sfptrarr.size() > 0 && sfptrarr[0] ) {
-		for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++){
-			(*fit)->getEdges(septrarr);
-			vector<DLFLEdgePtr>::iterator eit;
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-				if (!active->isSelected(*eit)){
-					active->setSelectedEdge(num_sel_edges,*eit);
-					num_sel_edges++;
-				}
-			}
-		}
-		active->recomputePatches();
-		active->recomputeNormals();						
-	}			
+	//select the edges adjacent to the selected faces
+	object.selectEdgesFromFaces();
+	num_sel_edges = active->numSelectedEdges();
 	setMode(MainWindow::SelectEdge);
 	active->clearSelectedFaces();
-	redraw();		
+	redraw();
 }
 
 void MainWindow::selectEdgesFromVertices(){
-	DLFLEdgePtrArray septrarr;
-	DLFLVertexPtrArray svptrarr;
-	vector<DLFLVertexPtr>::iterator vit;
-	vector<DLFLEdgePtr>::iterator eit;
-	//loop through selected vertices, get corresponding edges, select them
-	svptrarr = active->getSelectedVertices();
-	if ( svptrarr.size() > 0 && svptrarr[0] ) {
-		for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++){
-			(*vit)->getEdges(septrarr);
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-				if (!active->isSelected(*eit)){
-					active->setSelectedEdge(num_sel_edges,*eit);
-					num_sel_edges++;
-				}
-			}
-		}
-		active->recomputePatches();
-		active->recomputeNormals();						
-	}			
+	//select the edges adjacent to the selected vertices
+	object.selectEdgesFromVertices();
+	num_sel_edges = active->numSelectedEdges();
 	setMode(MainWindow::SelectEdge);
 	active->clearSelectedVertices();
-	redraw();	
+	redraw();
 }
 
 void MainWindow::selectFacesFromEdges(){
-	DLFLEdgePtrArray septrarr;
-	vector<DLFLEdgePtr>::iterator eit;
-	DLFLFacePtr fptr1, fptr2;
-	//loop through selected faces, get corresponding vertices, select them
-	septrarr = active->getSelectedEdges();
-	if ( septrarr.size() > 0 && septrarr[0] ) {
-		for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-			(*eit)->getFacePointers(fptr1,fptr2);
-			if (!active->isSelected(fptr1)){
-				active->setSelectedFace(num_sel_faces,fptr1);
-				num_sel_faces++;
-			}
-			if (!active->isSelected(fptr2)){
-				active->setSelectedFace(num_sel_faces,fptr2);
-				num_sel_faces++;
-			}
-		}
-		active->recomputePatches();
-		active->recomputeNormals();						
-	}			
-	setMode(MainWindow::SelectFace);	
+	//select the faces adjacent to the selected edges
+	object.selectFacesFromEdges();
+	num_sel_faces = active->numSelectedFaces();
+	setMode(MainWindow::SelectFace);
 	active->clearSelectedEdges();
-	redraw();	
+	redraw();
 }
 
 void MainWindow::selectFacesFromVertices(){
-	DLFLVertexPtrArray svptrarr;
-	vector<DLFLVertexPtr>::iterator vit;
-	DLFLFacePtrArray sfptrarr;
-	vector<DLFLFacePtr>::iterator fit;
-	//loop through selected faces, get corresponding edges, select them
-	svptrarr = active->getSelectedVertices();
-	if ( svptrarr.size() > 0 && svptrarr[0] ) {
-		for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++){
-			(*vit)->getFaces(sfptrarr);
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++){
-				if (!active->isSelected(*fit)){
-					active->setSelectedFace(num_sel_faces,*fit);
-					num_sel_faces++;
-				}
-			}
-		}
-		active->recomputePatches();
-		active->recomputeNormals();						
-	}			
+	//select the faces adjacent to the selected vertices
+	object.selectFacesFromVertices();
+	num_sel_faces = active->numSelectedFaces();
 	setMode(MainWindow::SelectFace);
 	active->clearSelectedVertices();
-	redraw();			
+	redraw();
 }
 
 void MainWindow::selectVerticesFromFaces(){
-	DLFLFacePtrArray sfptrarr;
-	vector<DLFLFacePtr>::iterator fit;
-	DLFLFaceVertexPtrArray sfvptrarr;
-	vector<DLFLFaceVertexPtr>::iterator fvit;
-	DLFLVertexPtr vptr;
-	//loop through selected faces, get corresponding vertices, select them
-	sfptrarr = active->getSelectedFaces();
-	if ( sfptrarr.size() > 0 && sfptrarr[0] ) {
-		for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++){
-			(*fit)->getCorners(sfvptrarr);
-			for(fvit = sfvptrarr.begin(); fvit != sfvptrarr.end(); fvit++){
-				vptr = (*fvit)->getVertexPtr();
-				if (!active->isSelected(vptr)){
-					active->setSelectedVertex(num_sel_verts,vptr);
-					num_sel_verts++;
-				}
-			}
-		}
-		active->recomputePatches();
-		active->recomputeNormals();						
-	}			
+	//select the vertices adjacent to the selected faces
+	object.selectVerticesFromFaces();
+	num_sel_verts = active->numSelectedVertices();
 	setMode(MainWindow::SelectVertex);
 	active->clearSelectedFaces();
-	redraw();	
+	redraw();
 }
 
-void MainWindow::selectVerticesFromEdges(){	
-	DLFLEdgePtrArray septrarr;
-	vector<DLFLEdgePtr>::iterator eit;
-	DLFLVertexPtr vptr1,vptr2;
-	//loop through selected faces, get corresponding vertices, select them
-	septrarr = active->getSelectedEdges();
-	// std::cout<< septrarr[0] << " \t\t" << septrarr.size() <<"\n";
-	if ( septrarr.size() > 0 && septrarr[0]) {
-		for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-			(*eit)->getVertexPointers(vptr1,vptr2);
-			if (!active->isSelected(vptr1)){
-				active->setSelectedVertex(num_sel_verts,vptr1);
-				num_sel_verts++;
-			}
-			if (!active->isSelected(vptr2)){
-				active->setSelectedVertex(num_sel_verts,vptr2);
-				num_sel_verts++;
-			}
-		}
-		active->recomputePatches();
-		active->recomputeNormals();						
-	}			
+void MainWindow::selectVerticesFromEdges(){
+	//select the vertices adjacent to the selected edges
+	object.selectVerticesFromEdges();
+	num_sel_verts = active->numSelectedVertices();
 	setMode(MainWindow::SelectVertex);
 	active->clearSelectedEdges();
-	redraw();	
+	redraw();
 }
 
-
 void MainWindow::growSelection(){
-	DLFLEdgePtrArray septrarr;
-	DLFLVertexPtrArray svptrarr;
-	DLFLFaceVertexPtrArray sfvptrarr;
-	DLFLFacePtrArray sfptrarr;
-	vector<DLFLVertexPtr>::iterator vit;
-	vector<DLFLEdgePtr>::iterator eit;
-	vector<DLFLFacePtr>::iterator fit;
-	vector<DLFLFaceVertexPtr>::iterator fvit;
-	
-	DLFLVertexPtr vptr1,vptr2;
-	DLFLFacePtr fptr1,fptr2;
-	DLFLEdgePtrArray eptrarray;
-	vector<DLFLEdgePtr>::iterator eit2;
-	
 	switch (selectionmask){
 		case MaskVertices:
-		//loop through selected vertices, get corresponding edges
-		svptrarr = active->getSelectedVertices();
-		if ( svptrarr.size() > 0 && svptrarr[0] ) {
-			for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++){
-				(*vit)->getEdges(septrarr);
-				//loop through edges, select all vertices connected to these edges
-				for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-					DLFLVertexPtr vp1, vp2;
-					//get the two vertices for each edge, select them if they aren't already selected
-					(*eit)->getVertexPointers(vp1,vp2);
-					if (!active->isSelected(vp1)){
-						active->setSelectedVertex(num_sel_verts,vp1);
-						num_sel_verts++;
-					}
-					if (!active->isSelected(vp2)){
-						active->setSelectedVertex(num_sel_verts,vp2);
-						num_sel_verts++;
-					}
-				}
-			}
-		}			
+		//select all vertices connected to the selected vertices by an edge
+		object.growSelectedVertices();
+		num_sel_verts = active->numSelectedVertices();
 		redraw();
 		break;
 		case MaskEdges:
-		//loop through selected edges, get vertices, then get those edges
-		septrarr = active->getSelectedEdges();
-		if ( septrarr.size() > 0 && septrarr[0]) {
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-				//get the 2 vertices for the current edge
-				(*eit)->getVertexPointers(vptr1,vptr2);
-				//get the edges for vertex 1
-				vptr1->getEdges(eptrarray);
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2)){
-						active->setSelectedEdge(num_sel_edges,*eit2);
-						num_sel_edges++;
-					}					
-				}
-				//get edges for vertex 2
-				vptr2->getEdges(eptrarray);
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2)){
-						active->setSelectedEdge(num_sel_edges,*eit2);
-						num_sel_edges++;
-					}					
-				}
-			}
-		}			
+		//select all edges sharing a vertex with the selected edges
+		object.growSelectedEdges();
+		num_sel_edges = active->numSelectedEdges();
 		redraw();
 		break;
 		case MaskFaces:
-		//loop through selected faces
-		sfptrarr = active->getSelectedFaces();
-		if ( sfptrarr.size() > 0 && sfptrarr[0] ) {
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++){
-				//get the edges for the current face
-				(*fit)->getEdges(eptrarray);
-				for(eit = eptrarray.begin(); eit != eptrarray.end(); eit++){
-					//get the 2 faces for the current edge, select them if they aren't already selected
-					(*eit)->getFacePointers(fptr1,fptr2);
-					if (!active->isSelected(fptr1)){
-						active->setSelectedFace(num_sel_faces,fptr1);
-						num_sel_faces++;
-					}
-					if (!active->isSelected(fptr2)){
-						active->setSelectedFace(num_sel_faces,fptr2);
-						num_sel_faces++;
-					}
-				}
-			}
-		}
+		//select all faces sharing an edge with the selected faces
+		object.growSelectedFaces();
+		num_sel_faces = active->numSelectedFaces();
 		redraw();
 		break;
 		case MaskCorners:
@@ -2088,105 +1806,22 @@ void MainWindow::growSelection(){
 }
 
 void MainWindow::shrinkSelection(){
-	DLFLEdgePtrArray septrarr;
-	DLFLVertexPtrArray svptrarr;
-	DLFLFaceVertexPtrArray sfvptrarr;
-	DLFLFacePtrArray sfptrarr;
-	vector<DLFLVertexPtr>::iterator vit;
-	vector<DLFLEdgePtr>::iterator eit;
-	vector<DLFLFacePtr>::iterator fit;
-	vector<DLFLFaceVertexPtr>::iterator fvit;
-	int i = 0;
-	
-	DLFLVertexPtr vptr1,vptr2;
-	DLFLFacePtr fptr1,fptr2;
-	DLFLEdgePtrArray eptrarray;
-	vector<DLFLEdgePtr>::iterator eit2;
-	
 	switch (selectionmask){
 		case MaskVertices:
-		//loop through selected vertices, get corresponding edges
-		svptrarr = active->getSelectedVertices();
-		if ( svptrarr.size() > 0 && svptrarr[0] ) {
-			bool deselectvertices[svptrarr.size()];
-			for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++,i++){
-				deselectvertices[i] = false;
-				(*vit)->getEdges(septrarr);
-				//loop through edges, select all vertices connected to these edges
-				for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-					DLFLVertexPtr vp1, vp2;
-					//get the two vertices for each edge, select them if they aren't already selected
-					(*eit)->getVertexPointers(vp1,vp2);
-					if (!active->isSelected(vp1) || !active->isSelected(vp2))
-						deselectvertices[i] = true;
-				}
-			}
-			//loop back through verts, now deselect the flagged ones
-			i = 0;
-			for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++, i++){
-				//if it's flagged, deselect it
-				if (deselectvertices[i])
-					active->clearSelectedVertex(*vit);
-			}
-		}			
+		//deselect vertices connected to an unselected vertex
+		object.shrinkSelectedVertices();
+		num_sel_verts = active->numSelectedVertices();
 		redraw();
 		break;
 		case MaskEdges:
-		//loop through selected edges, get vertices, then get those edges
-		septrarr = active->getSelectedEdges();
-		if ( septrarr.size() > 0 && septrarr[0]) {
-			bool deselectedges[septrarr.size()];
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++,i++){
-				//get the 2 vertices for the current edge
-				(*eit)->getVertexPointers(vptr1,vptr2);
-				//get the edges for vertex 1
-				vptr1->getEdges(eptrarray);
-				deselectedges[i] = false;
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2))
-						deselectedges[i] = true;
-				}
-				//get edges for vertex 2
-				vptr2->getEdges(eptrarray);
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2))
-						deselectedges[i] = true;
-				}
-			}
-			//loop back through edges, now deselect the flagged ones
-			i = 0;
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++,i++){
-				//if it's flagged, deselect it
-				if (deselectedges[i])
-					active->clearSelectedEdge(*eit);
-			}
-		}			
+		//deselect edges sharing a vertex with an unselected edge
+		object.shrinkSelectedEdges();
+		num_sel_edges = active->numSelectedEdges();
 		redraw();		break;
 		case MaskFaces:
-		//loop through selected faces
-		sfptrarr = active->getSelectedFaces();
-		if ( sfptrarr.size() > 0 && sfptrarr[0] ) {
-			bool deselectfaces[sfptrarr.size()];
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++, i++){
-				//get the edges for the current face
-				(*fit)->getEdges(eptrarray);
-				//by default don't deselect this face
-				deselectfaces[i] = false;
-				for(eit = eptrarray.begin(); eit != eptrarray.end(); eit++){
-					//get the 2 faces for the current edge, check if both of them are selected, flag the current face
-					(*eit)->getFacePointers(fptr1,fptr2);
-					if (!active->isSelected(fptr1) || !active->isSelected(fptr2))
-						deselectfaces[i] = true;
-				}
-			}
-			//loop back through faces, now deselect the flagged ones
-			i = 0;
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++,i++){
-				//if it's flagged, deselect it
-				if (deselectfaces[i])
-					active->clearSelectedFace(*fit);
-			}
-		}
+		//deselect faces sharing an edge with an unselected face
+		object.shrinkSelectedFaces();
+		num_sel_faces = active->numSelectedFaces();
 		redraw();
 		break;
 		case MaskCorners:
@@ -610,6 +610,7 @@ QDoubleSpinBox *RemeshingMode::createDoubleSpinBox(QGridLayout *layout, QLabel *
 	spinbox->setMaximumSize(75,25);
 	layout->addWidget(label,row,col);
   layout->addWidget(spinbox,row,col+1);
+	connect(spinbox, SIGNAL(valueChanged(double)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 
 	return spinbox;
 }
@@ -623,6 +624,7 @@ void RemeshingMode::setupDual(){
 	
 	dualFasterCheckBox = new QCheckBox(tr("Use Faster Method"));					
 	connect(dualFasterCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent),SLOT(toggleAccurateDualFlag(int)) );
+	connect(dualFasterCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 	mDualLayout->addWidget(dualFasterCheckBox,0,0);
 	//create crust button
 	dualCreateButton = new QPushButton(tr("Create Dual"), this);
@@ -910,6 +912,7 @@ void RemeshingMode::setupFourConversion(){
 	mDooSabinLayout->addWidget(dooSabinCheckBox,0,0);
 	//connect the checkbox
 	connect(dooSabinCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent),SLOT(toggleDooSabinEdgeFlag(int)) );
+	connect(dooSabinCheckBox, SIGNAL(stateChanged(int)), ((MainWindow*)mParent), SLOT(schedulePreview()));
 	dooSabinCreateButton = new QPushButton(tr("Perform Remeshing"), this);
 	connect(dooSabinCreateButton, SIGNAL(clicked()), ((MainWindow*)mParent),SLOT(performRemeshing()) );
 	mDooSabinLayout->addWidget(dooSabinCreateButton,1,0);
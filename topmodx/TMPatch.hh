@@ -43,10 +43,12 @@ typedef vector<TMPatch> TMPatchArray;
 typedef TMPatch* TMPatchPtr;
 typedef vector<TMPatchPtr> TMPatchPtrArray;
 
-// This stuff is to map the patches to the face vertices by index
+// This stuff is to map the patches to the face vertices
+// Compares the pointers directly, getID() writes the ID and so is not safe for
+// lookups from several threads at once
 struct compare { 
   bool operator()( DLFLFaceVertexPtr a, DLFLFaceVertexPtr b ) const { 
-		return ( a->getID() < b->getID() );
+		return ( a < b );
 	}
 };
   
@@ -86,6 +88,7 @@ protected :
     if ( patchsize > 0 ) {
 			glctrlpts = new GLdouble[patchsize*patchsize*3];
 			glctrlptcolors = new GLdouble[patchsize*patchsize*4];
+			for (int i=0; i < patchsize*patchsize*4; ++i) glctrlptcolors[i] = 0.0;
 		}
   }
 
@@ -165,6 +168,12 @@ public :
 		}
   }
 
+  int size(void) const { return patchsize; }
+
+  // Control points and colors in the layout used by glMap2d : (v*patchsize+u)*3 and (v*patchsize+u)*4
+  const GLdouble * getGLControlPoints(void) const { return glctrlpts; }
+  const GLdouble * getGLControlPointColors(void) const { return glctrlptcolors; }
+
   const Vector3d& getControlPoint(int i, int j) const
   {
     // Return the control point at the specified location
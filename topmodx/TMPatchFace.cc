@@ -56,7 +56,7 @@ void TMPatchFace::resizePatches(int psize) {
 }
      
 // Create the patches using face information
-void TMPatchFace::createPatches(TMPatchMap &patchMap) {
+void TMPatchFace::createPatches(void) {
   if ( dlflface == NULL ) return;
 
   // patcharray will be resized here
@@ -69,66 +69,64 @@ void TMPatchFace::createPatches(TMPatchMap &patchMap) {
   Vector3d nface = dlflface->getAuxNormal();
 	// std::cout << vface << " " << nface << "\n";
 
-  // Get the corners of the face as an array
+  // Walk the corners of the face starting from the head, same order as getCorners
   // A patch will be created for each corner
-  DLFLFaceVertexPtrArray corners;
-  int size;
-  dlflface->getCorners(corners);
-  size = corners.size();
+  int size = patcharray.size();
+  DLFLFaceVertexPtr corner = dlflface->firstVertex();
 
   Vector3d cp[4][4]; // Grid of control points
   Vector3d cn[4][4]; // Grid of control normals used to modify the control points
 
-  for (int i=0; i < size; ++i) {
-    cp[0][0] = corners[i]->vertex->getAuxCoords();
-    cn[0][0] = corners[i]->vertex->getAuxNormal();
+  for (int i=0; i < size; ++i, corner = corner->next()) {
+    cp[0][0] = corner->vertex->getAuxCoords();
+    cn[0][0] = corner->vertex->getAuxNormal();
 
-    cp[1][0] = corners[i]->vnext()->getDS2Coord(0);
+    cp[1][0] = corner->vnext()->getDS2Coord(0);
     cn[1][0] = cn[0][0];
 
-    cp[1][1] = corners[i]->getDS2Coord(0);
+    cp[1][1] = corner->getDS2Coord(0);
     cn[1][1] = cn[0][0];
 
-    cp[0][1] = corners[i]->vprev()->getDS2Coord(0);
+    cp[0][1] = corner->vprev()->getDS2Coord(0);
     cn[0][1] = cn[0][0];
 
 
-    cp[3][0] = corners[i]->getEdgePtr()->getAuxCoords();
-    cn[3][0] = corners[i]->getEdgePtr()->getAuxNormal();
+    cp[3][0] = corner->getEdgePtr()->getAuxCoords();
+    cn[3][0] = corner->getEdgePtr()->getAuxNormal();
 
-    cp[3][1] = corners[i]->next()->getDS2Coord(3);
+    cp[3][1] = corner->next()->getDS2Coord(3);
     cn[3][1] = cn[3][0];
 
-    cp[2][1] = corners[i]->getDS2Coord(1);
+    cp[2][1] = corner->getDS2Coord(1);
     cn[2][1] = cn[3][0];
 
-    cp[2][0] = corners[i]->vnext()->getDS2Coord(3);
+    cp[2][0] = corner->vnext()->getDS2Coord(3);
     cn[2][0] = cn[3][0];
               
 
     cp[3][3] = vface;
     cn[3][3] = nface;
 
-    cp[2][3] = corners[i]->prev()->getDS2Coord(2);
+    cp[2][3] = corner->prev()->getDS2Coord(2);
     cn[2][3] = cn[3][3];
 
-    cp[2][2] = corners[i]->getDS2Coord(2);
+    cp[2][2] = corner->getDS2Coord(2);
     cn[2][2] = cn[3][3];
 
-    cp[3][2] = corners[i]->next()->getDS2Coord(2);
+    cp[3][2] = corner->next()->getDS2Coord(2);
     cn[3][2] = cn[3][3];
 
 
-    cp[0][3] = corners[i]->prev()->getEdgePtr()->getAuxCoords();
-    cn[0][3] = corners[i]->prev()->getEdgePtr()->getAuxNormal();
+    cp[0][3] = corner->prev()->getEdgePtr()->getAuxCoords();
+    cn[0][3] = corner->prev()->getEdgePtr()->getAuxNormal();
 
-    cp[0][2] = corners[i]->vprev()->getDS2Coord(1);
+    cp[0][2] = corner->vprev()->getDS2Coord(1);
     cn[0][2] = cn[0][3];
 
-    cp[1][2] = corners[i]->getDS2Coord(3);
+    cp[1][2] = corner->getDS2Coord(3);
     cn[1][2] = cn[0][3];
 
-    cp[1][3] = corners[i]->prev()->getDS2Coord(1);
+    cp[1][3] = corner->prev()->getDS2Coord(1);
     cn[1][3] = cn[0][3];
 
 
@@ -186,31 +184,30 @@ void TMPatchFace::createPatches(TMPatchMap &patchMap) {
     cn[2][2] = normalized(6*cn[3][3]+cn[0][3]+cn[3][0]);
               
     patcharray[i].calculatePatchPoints(cp,cn);
-		setPatchPtr(patchMap, &(patcharray[i]), corners[i] );
   }
 
   // Make adjustment to face point for quadrilaterals
   if ( size == 4 ) {
-    TMPatchPtr pptr1, pptr2;
-    pptr1 = getPatchPtr(patchMap,corners[0]);
-    pptr2 = getPatchPtr(patchMap,corners[2]);
-
-		if( pptr1 == NULL || pptr2 == NULL )
-			return;
-
     Vector3d p00,p01,p10,p11,ip;
-    p00 = pptr1->getControlPoint(3,2); p01 = pptr2->getControlPoint(3,2);
-    p10 = pptr1->getControlPoint(2,3); p11 = pptr2->getControlPoint(2,3);
+    p00 = patcharray[0].getControlPoint(3,2); p01 = patcharray[2].getControlPoint(3,2);
+    p10 = patcharray[0].getControlPoint(2,3); p11 = patcharray[2].getControlPoint(2,3);
     ip = intersectCoplanarLines(p00,p01,p10,p11);
 
     for (int i=0; i < size; ++i) {
-      pptr1 = getPatchPtr(patchMap,corners[i]);
-      pptr1->setControlPoint(3,3,ip);
-      pptr1->updateGLPointArray();
+      patcharray[i].setControlPoint(3,3,ip);
+      patcharray[i].updateGLPointArray();
     }
   }
 }
 
+// Map each corner of the face to its patch
+void TMPatchFace::registerPatches(TMPatchMap &patchMap) {
+  if ( dlflface == NULL ) return;
+  DLFLFaceVertexPtr corner = dlflface->firstVertex();
+  for (uint i=0; i < patcharray.size(); ++i, corner = corner->next())
+    setPatchPtr(patchMap, &(patcharray[i]), corner);
+}
+
 // Adjust the edge points for each patch in the face
 void TMPatchFace::adjustEdgePoints(TMPatchMap &patchMap) {
   if ( dlflface == NULL ) return;
@@ -80,12 +80,26 @@ public :
     resizePatchArray();
   }
      
-  // Create the patches using face information
-  void createPatches(TMPatchMap &patchMap);
+  DLFLFacePtr getDLFLFace(void) const { return dlflface; }
+
+  // Create the patches using face information. Only touches this face's
+  // patches, so different faces can be processed in parallel
+  void createPatches(void);
+
+  // Map each corner of the face to its patch
+  void registerPatches(TMPatchMap &patchMap);
+
+  // Copy the control points of all patches into their GL arrays
+  void updateGLPointArrays(void) {
+    for (uint i=0; i < patcharray.size(); ++i) patcharray[i].updateGLPointArray();
+  }
 
   // Adjust the edge points for each patch in the face
   void adjustEdgePoints(TMPatchMap &patchMap);
               
+  int numPatches(void) const { return patcharray.size(); }
+  const TMPatch& getPatch(int i) const { return patcharray[i]; }
+
   // Compute lighting for the patches in this face
   void computeLighting(LightPtr lightptr) {
     DLFLMaterialPtr matl;
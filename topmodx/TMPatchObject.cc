@@ -33,85 +33,102 @@
 
 #include "TMPatchObject.hh"
 
+void TMPatchObject::fillArrays( DLFLObjectPtr obj ) {
+  // assign() keeps the capacity from the previous update
+  face_array.assign(obj->beginFace(),obj->endFace());
+  edge_array.assign(obj->beginEdge(),obj->endEdge());
+  vertex_array.assign(obj->beginVertex(),obj->endVertex());
+}
+
 void TMPatchObject::updateForPatches( DLFLObjectPtr obj ) {
-  DLFLFacePtrList face_list = obj->getFaceList( );
-  DLFLEdgePtrList edge_list = obj->getEdgeList( );
-  DLFLVertexPtrList vertex_list = obj->getVertexList( );
+  fillArrays(obj);
+  int numfaces = face_array.size(), numedges = edge_array.size(), numvertices = vertex_array.size();
 
-  // Update information stored at each face, vertex, edge and corner for patch rendering
+  // Update information stored at each face, vertex, edge and corner for patch rendering.
+  // Each pass only writes to the element itself and corners it owns, so the
+  // elements of a pass can be processed in any order
 
   // Compute doo-sabin coordinates for each face and store them in the auxcoord field of the corner
   // Update the auxcoord field of the face
-  Vector3dArray coords;
-  DLFLFacePtrList::iterator ffirst=face_list.begin(), flast=face_list.end();
-  DLFLFacePtr fp;
-  DLFLFaceVertexPtrArray corners;
-  int valence;
-       
-  while ( ffirst != flast ) {
-    fp = *ffirst; ++ffirst;
-    fp->getCornersAndCoords(corners,coords);
-    valence = coords.size();
-
-    if ( valence > 0 ) {
-      // Compute Doo-Sabin coordinates - Level 1
-      DLFL::computeDooSabinCoords(coords);
-      for (int i=0; i < valence; ++i) 
-				corners[i]->setAuxCoords(coords[i]);
+  #pragma omp parallel
+  {
+    Vector3dArray coords, scratch;
+    DLFLFaceVertexPtrArray corners;
+    #pragma omp for schedule(dynamic,64)
+    for (int f=0; f < numfaces; ++f) {
+      DLFLFacePtr fp = face_array[f];
+      fp->getCornersAndCoords(corners,coords);
+      int valence = coords.size();
 
-      // Compute Doo-Sabin coordinates - Level 2
-      DLFL::computeDooSabinCoords(coords);
-      for (int i=0; i < valence; ++i) 
-				corners[i]->setDS2Coord2(coords[i]);
-
-      // Compute the patch point and patch normal
-      Vector3d pp, pn;
-      DLFL::computeCentroidAndNormal(coords,pp,pn);
-      fp->setAuxCoords(pp); fp->setAuxNormal(pn);
+      if ( valence > 0 ) {
+        // Compute Doo-Sabin coordinates - Level 1
+        DLFL::computeDooSabinCoords(coords,scratch);
+        for (int i=0; i < valence; ++i) 
+          corners[i]->setAuxCoords(coords[i]);
+
+        // Compute Doo-Sabin coordinates - Level 2
+        DLFL::computeDooSabinCoords(coords,scratch);
+        for (int i=0; i < valence; ++i) 
+          corners[i]->setDS2Coord2(coords[i]);
+
+        // Compute the patch point and patch normal
+        Vector3d pp, pn;
+        DLFL::computeCentroidAndNormal(coords,pp,pn);
+        fp->setAuxCoords(pp); fp->setAuxNormal(pn);
+      }
     }
   }
 
   // Compute patch point and normal for all edges
-  DLFLEdgePtrList::iterator efirst=edge_list.begin(), elast=edge_list.end();
-  DLFLEdgePtr ep;
-  while ( efirst != elast ) {
-    ep = *efirst; ++efirst;
-
-    Vector3dArray p;
-    ep->getEFCornersAuxCoords(p);
+  #pragma omp parallel
+  {
+    Vector3dArray p, scratch;
+    DLFLFaceVertexPtrArray fvp;
+    #pragma omp for schedule(dynamic,256)
+    for (int e=0; e < numedges; ++e) {
+      DLFLEdgePtr ep = edge_array[e];
+      ep->getEFCornersAuxCoords(p);
             
-    // Compute Doo-Sabin coordinates - Level 2
-    DLFL::computeDooSabinCoords(p);
+      // Compute Doo-Sabin coordinates - Level 2
+      DLFL::computeDooSabinCoords(p,scratch);
 
-    Vector3d pp,pn;
-    computeCentroidAndNormal(p,pp,pn);
-    ep->setAuxCoords(pp); ep->setAuxNormal(pn);
+      Vector3d pp,pn;
+      computeCentroidAndNormal(p,pp,pn);
+      ep->setAuxCoords(pp); ep->setAuxNormal(pn);
 
-    DLFLFaceVertexPtrArray fvp;
-    ep->getEFCorners(fvp);
-    fvp[0]->setDS2Coord3(p[0]); fvp[1]->setDS2Coord1(p[1]);
-    fvp[2]->setDS2Coord3(p[2]); fvp[3]->setDS2Coord1(p[3]);
+      ep->getEFCorners(fvp);
+      fvp[0]->setDS2Coord3(p[0]); fvp[1]->setDS2Coord1(p[1]);
+      fvp[2]->setDS2Coord3(p[2]); fvp[3]->setDS2Coord1(p[3]);
+    }
   }
 
   // Compute patch point and normal for all vertices
-  DLFLVertexPtrList::iterator vfirst=vertex_list.begin(), vlast=vertex_list.end();
-  DLFLVertexPtr vp;
-  while ( vfirst != vlast ) {
-    vp = *vfirst; ++vfirst;
-    Vector3dArray p;
-    vp->getOrderedCornerAuxCoords(p);
-
-    // Compute Doo-Sabin coordinates - Level 2
-    DLFL::computeDooSabinCoords(p);
-
-    Vector3d pp,pn;
-    DLFL::computeCentroidAndNormal(p,pp,pn);
-    vp->setAuxCoords(pp); vp->setAuxNormal(-pn); // Reverse the normal since the rotation order around the vertex is clockwise
+  // The corners around each vertex come from the adjacency cache, which stays
+  // valid while vertices are only moved. It has to be brought up to date here,
+  // before the threads start
+  DLFLAdjacency& adj = obj->adjacency();
+  adj.buildOrdered();
+  #pragma omp parallel
+  {
+    Vector3dArray p, scratch;
+    #pragma omp for schedule(dynamic,256)
+    for (int v=0; v < numvertices; ++v) {
+      DLFLVertexPtr vp = adj.vertex(v);
+      uint first = adj.orderedBegin(v), last = adj.orderedEnd(v);
+      p.clear();
+      for (uint k=first; k < last; ++k)
+        p.push_back(adj.orderedCorner(k)->getAuxCoords());
+
+      // Compute Doo-Sabin coordinates - Level 2
+      DLFL::computeDooSabinCoords(p,scratch);
+
+      Vector3d pp,pn;
+      DLFL::computeCentroidAndNormal(p,pp,pn);
+      vp->setAuxCoords(pp); vp->setAuxNormal(-pn); // Reverse the normal since the rotation order around the vertex is clockwise
             
-    DLFLFaceVertexPtrArray fvp;
-    vp->getOrderedCorners(fvp);
-    for (int i=0; i < fvp.size(); ++i) 
-      fvp[i]->setDS2Coord0(p[i]);
+      for (uint k=first; k < last; ++k) 
+        adj.orderedCorner(k)->setDS2Coord0(p[k-first]);
+    }
   }
 }
 
@@ -131,39 +148,71 @@ void TMPatchObject::destroyPatches() {
 		delete pfp;
 	}
 	patch_list.clear();
+	patch_array.clear();
+}
+
+bool TMPatchObject::sameTopology( ) {
+	int numfaces = face_array.size();
+	bool same = ( (int)patch_array.size() == numfaces );
+	corner_scratch.clear();
+	for (int f=0; f < numfaces; ++f) {
+		DLFLFacePtr fp = face_array[f];
+		if ( same && patch_array[f]->getDLFLFace() != fp ) same = false;
+		DLFLFaceVertexPtr head = fp->firstVertex(), fvp = head;
+		if ( !head ) continue;
+		do {
+			corner_scratch.push_back(fvp);
+			fvp = fvp->next();
+		} while ( fvp != head );
+	}
+	same = same && ( corner_scratch == patch_corners );
+	patch_corners.swap(corner_scratch);
+	return same;
 }
 
 // Build the list of patch faces
+// If the faces and their corners are the ones the patches were built for, the
+// existing patch faces and the patch map are reused and only the control points
+// are recomputed
 void TMPatchObject::createPatches( DLFLObjectPtr obj ) {
-  destroyPatches();
-	destroyPatchMap( patchMap );
-  DLFLFacePtrList face_list = obj->getFaceList( );
-	DLFLFacePtrList::iterator ffirst = face_list.begin(), flast = face_list.end();
-	DLFLFacePtr fp = NULL;
-	TMPatchFacePtr pfp = NULL;
+	fillArrays(obj);
 
-	while ( ffirst != flast ) {
-		fp = (*ffirst); ++ffirst;
-		pfp = new TMPatchFace(patchsize);
-		pfp->setDLFLFace(fp); 
-		pfp->createPatches(patchMap);
-		patch_list.push_back(pfp);
+	bool reuse = sameTopology();
+	if ( !reuse ) {
+		destroyPatches();
+		destroyPatchMap( patchMap );
+		patch_array.reserve(face_array.size());
+		for (uint f=0; f < face_array.size(); ++f) {
+			TMPatchFacePtr pfp = new TMPatchFace(patchsize);
+			pfp->setDLFLFace(face_array[f]);
+			patch_list.push_back(pfp);
+			patch_array.push_back(pfp);
+		}
 	}
 
+	int numpatchfaces = patch_array.size();
+	#pragma omp parallel for schedule(dynamic,64)
+	for (int f=0; f < numpatchfaces; ++f)
+		patch_array[f]->createPatches();
+
+	if ( !reuse )
+		for (int f=0; f < numpatchfaces; ++f)
+			patch_array[f]->registerPatches(patchMap);
+
 	// Adjust the edge points for all patches
-	DLFLEdgePtrList edge_list = obj->getEdgeList();
-	DLFLEdgePtrList::iterator efirst = edge_list.begin(), elast = edge_list.end();
-	DLFLEdgePtr ep = NULL;
-	DLFLFaceVertexPtr fvp1,fvp2;
-	TMPatchPtr pp1, pp2;
-	Vector3d p00,p01,p10,p11,ip;
-	while ( efirst != elast ) {
-		ep = (*efirst); ++efirst;
-		ep->getCorners(fvp1,fvp2);
+	// Only control points (3,0) and (0,3) are written here and each belongs to one edge.
+	// The GL arrays are refreshed once at the end
+	int numedges = edge_array.size();
+	#pragma omp parallel for schedule(dynamic,256)
+	for (int e=0; e < numedges; ++e) {
+		DLFLFaceVertexPtr fvp1,fvp2;
+		TMPatchPtr pp1, pp2;
+		Vector3d p00,p01,p10,p11,ip;
+		edge_array[e]->getCorners(fvp1,fvp2);
 		pp1 = getPatchPtr(patchMap,fvp1); pp2 = getPatchPtr(patchMap,fvp2);
 
 		if( pp1 == NULL || pp2 == NULL )
-			return;
+			continue;
 
 		p00 = pp1->getControlPoint(2,0); 
 		p01 = pp2->getControlPoint(2,0);
@@ -172,35 +221,40 @@ void TMPatchObject::createPatches( DLFLObjectPtr obj ) {
 		ip = intersectCoplanarLines(p00,p01,p10,p11);
 
 		pp1->setControlPoint(3,0,ip); pp2->setControlPoint(3,0,ip);
-		pp1->updateGLPointArray(); pp2->updateGLPointArray();
 
 		pp1 = getPatchPtr(patchMap,fvp1->next()); pp2 = getPatchPtr(patchMap,fvp2->next());
 		pp1->setControlPoint(0,3,ip); pp2->setControlPoint(0,3,ip);
-		pp1->updateGLPointArray(); pp2->updateGLPointArray();
 	}
 
 	// Adjust the vertex points for 4-valence vertices
-	DLFLVertexPtrList vertex_list = obj->getVertexList( );
-	DLFLVertexPtrList::iterator vfirst = vertex_list.begin(), vlast = vertex_list.end();
-	DLFLVertexPtr vp = NULL;
-	while ( vfirst != vlast ) {
-		vp = (*vfirst); ++vfirst;
-		if ( vp->valence() == 4 ) {
-			DLFLFaceVertexPtrArray vcorners;
-			vp->getOrderedCorners(vcorners);
-			pp1 = getPatchPtr(patchMap,vcorners[0]); pp2 = getPatchPtr(patchMap,vcorners[2]);
-
-			p00 = pp1->getControlPoint(1,0); p01 = pp2->getControlPoint(1,0);
-			p10 = pp1->getControlPoint(0,1); p11 = pp2->getControlPoint(0,1);
-			ip = intersectCoplanarLines(p00,p01,p10,p11);
+	int numvertices = vertex_array.size();
+	#pragma omp parallel
+	{
+		DLFLFaceVertexPtrArray vcorners;
+		#pragma omp for schedule(dynamic,256)
+		for (int v=0; v < numvertices; ++v) {
+			DLFLVertexPtr vp = vertex_array[v];
+			if ( vp->valence() == 4 ) {
+				TMPatchPtr pp1, pp2;
+				Vector3d p00,p01,p10,p11,ip;
+				vp->getOrderedCorners(vcorners);
+				pp1 = getPatchPtr(patchMap,vcorners[0]); pp2 = getPatchPtr(patchMap,vcorners[2]);
+
+				p00 = pp1->getControlPoint(1,0); p01 = pp2->getControlPoint(1,0);
+				p10 = pp1->getControlPoint(0,1); p11 = pp2->getControlPoint(0,1);
+				ip = intersectCoplanarLines(p00,p01,p10,p11);
 				
-			for( int i = 0; i < 4; ++i ) {
-				pp1 = getPatchPtr(patchMap,vcorners[i]);
-				pp1->setControlPoint(0,0,ip);
-				pp1->updateGLPointArray();
+				for( int i = 0; i < 4; ++i ) {
+					pp1 = getPatchPtr(patchMap,vcorners[i]);
+					pp1->setControlPoint(0,0,ip);
+				}
 			}
 		}
 	}
+
+	#pragma omp parallel for schedule(dynamic,64)
+	for (int f=0; f < numpatchfaces; ++f)
+		patch_array[f]->updateGLPointArrays();
                  
 	/*
 		TMPatchFacePtrList::iterator pfirst = patch_list.begin(), plast = patch_list.end();
@@ -216,8 +270,233 @@ void TMPatchObject::setPatchSize( int size, DLFLObjectPtr obj ){
     patchsize = size;
     if( !obj ) { obj = mObj; }
     if( !obj ) { return; }
+    destroyPatches(); // force new patch faces with the new size
     createPatches( obj );
+    tessellate();
+  }
+}
+
+void TMPatchObject::setResolution( int res ) {
+  if ( res < 1 ) res = 1;
+  if ( res != resolution ) {
+    resolution = res;
+    tessellate();
+  }
+}
+
+// Bernstein basis of degree n-1 sampled at res+1 equally spaced parameters.
+// basis[s*n+i] is the weight of control point i at parameter s/res
+static void computeBernsteinBasis( int n, int res, vector<double>& basis ) {
+  basis.resize((res+1)*n);
+  vector<double> binom(n,1.0);
+  for (int i=1; i < n-1; ++i)
+    binom[i] = binom[i-1] * double(n-i) / double(i);
+  for (int s=0; s <= res; ++s) {
+    double t = double(s) / double(res), omt = 1.0 - t;
+    for (int i=0; i < n; ++i) {
+      double w = binom[i];
+      for (int k=0; k < i; ++k) w *= t;
+      for (int k=0; k < n-1-i; ++k) w *= omt;
+      basis[s*n+i] = w;
+    }
+  }
+}
+
+// Evaluate one patch with comps components per control point at (res+1)^2 grid points.
+// ctrl is laid out as in glMap2d, (v*n+u)*comps. Evaluation is separable : first along v
+// into scratch, then along u into out. scratch must hold (res+1)*n*comps values
+static void evaluatePatch( const GLdouble * ctrl, int n, int comps, const double * basis, int res,
+                           double * scratch, GLfloat * out ) {
+  for (int b=0; b <= res; ++b) {
+    const double * bv = basis + b*n;
+    double * q = scratch + b*n*comps;
+    for (int k=0; k < n*comps; ++k) q[k] = 0.0;
+    for (int j=0; j < n; ++j) {
+      const double w = bv[j];
+      const GLdouble * row = ctrl + j*n*comps;
+      for (int k=0; k < n*comps; ++k) q[k] += w * row[k];
+    }
+  }
+  for (int b=0; b <= res; ++b) {
+    const double * q = scratch + b*n*comps;
+    for (int a=0; a <= res; ++a) {
+      const double * bu = basis + a*n;
+      GLfloat * o = out + (b*(res+1)+a)*comps;
+      for (int c=0; c < comps; ++c) {
+        double sum = 0.0;
+        for (int i=0; i < n; ++i) sum += bu[i] * q[i*comps+c];
+        o[c] = sum;
+      }
+    }
+  }
+}
+
+void TMPatchObject::tessellate( ) {
+  tesspatches.clear();
+  TMPatchFacePtrList::const_iterator first = patch_list.begin(), last = patch_list.end();
+  while ( first != last ) {
+    for (int i=0; i < (*first)->numPatches(); ++i)
+      tesspatches.push_back(&(*first)->getPatch(i));
+    ++first;
+  }
+
+  int numverts = tesspatches.size() * (resolution+1) * (resolution+1);
+  tesspoints.resize(numverts*3);
+  tesscolors.resize(numverts*4);
+  buildTessellationIndices();
+  evaluatePatches(true,true);
+}
+
+void TMPatchObject::buildTessellationIndices( ) {
+  int numpatches = tesspatches.size();
+  int r = resolution, stride = resolution+1;
+  // Wireframe shows every step-th iso line, about 6 per direction like the old glEvalMesh2 outline
+  int step = ( r >= 6 ) ? r/6 : 1;
+  int isolines = r/step + ( r%step ? 2 : 1 );
+
+  fillcount = numpatches * r * r * 6;
+  outlinecount = numpatches * isolines * r * 4;
+  boundarycount = numpatches * r * 4;
+  faceboundarycount = numpatches * r * 2;
+  outlineoffset = fillcount;
+  boundaryoffset = outlineoffset + outlinecount;
+  faceboundaryoffset = boundaryoffset + boundarycount;
+  tessindices.resize(faceboundaryoffset + faceboundarycount);
+
+  #pragma omp parallel for schedule(static)
+  for (int p=0; p < numpatches; ++p) {
+    GLuint base = p * stride * stride;
+    // Same triangle winding as the quad strips of glEvalMesh2(GL_FILL,...)
+    GLuint * f = &tessindices[p * r * r * 6];
+    for (int b=0; b < r; ++b)
+      for (int a=0; a < r; ++a) {
+        GLuint v00 = base + b*stride + a, v10 = v00 + 1, v01 = v00 + stride, v11 = v01 + 1;
+        *f++ = v00; *f++ = v10; *f++ = v01;
+        *f++ = v01; *f++ = v10; *f++ = v11;
+      }
+
+    GLuint * o = &tessindices[outlineoffset + p * isolines * r * 4];
+    for (int iso=0; iso < isolines; ++iso) {
+      int k = ( iso*step < r ) ? iso*step : r;
+      for (int t=0; t < r; ++t) {
+        *o++ = base + k*stride + t; *o++ = base + k*stride + t + 1;  // v = k/r
+        *o++ = base + t*stride + k; *o++ = base + (t+1)*stride + k;  // u = k/r
+      }
+    }
+
+    GLuint * e = &tessindices[boundaryoffset + p * r * 4];
+    GLuint * fb = &tessindices[faceboundaryoffset + p * r * 2];
+    for (int t=0; t < r; ++t) {
+      *e++ = base + t; *e++ = base + t + 1;                          // v = 0
+      *e++ = base + t*stride + r; *e++ = base + (t+1)*stride + r;    // u = 1
+      *fb++ = base + t; *fb++ = base + t + 1;                        // v = 0
+    }
+  }
+  indicesdirty = true;
+}
+
+void TMPatchObject::evaluatePatches( bool points, bool colors ) {
+  int numpatches = tesspatches.size();
+  if ( numpatches == 0 || (!points && !colors) ) return;
+  if ( tesspoints.size() != (size_t)numpatches * (resolution+1) * (resolution+1) * 3 ) return;
+
+  int n = tesspatches[0]->size(), stride = resolution+1;
+  vector<double> basis;
+  computeBernsteinBasis(n,resolution,basis);
+
+  #pragma omp parallel
+  {
+    vector<double> scratch, localbasis;
+    #pragma omp for schedule(static)
+    for (int p=0; p < numpatches; ++p) {
+      const TMPatch * patch = tesspatches[p];
+      int ps = patch->size();
+      const double * pb = &basis[0];
+      if ( ps != n ) {
+        computeBernsteinBasis(ps,resolution,localbasis);
+        pb = &localbasis[0];
+      }
+      scratch.resize(stride*ps*4);
+      if ( points )
+        evaluatePatch(patch->getGLControlPoints(),ps,3,pb,resolution,&scratch[0],&tesspoints[p*stride*stride*3]);
+      if ( colors )
+        evaluatePatch(patch->getGLControlPointColors(),ps,4,pb,resolution,&scratch[0],&tesscolors[p*stride*stride*4]);
+    }
+  }
+  if ( points ) pointsdirty = true;
+  if ( colors ) colorsdirty = true;
+}
+
+void TMPatchObject::uploadTessellation( ) {
+#ifdef TM_PATCH_USE_VBO
+  if ( !usebuffers ) return;
+  if ( !pointbuffer ) {
+    pointbuffer = new QGLBuffer(QGLBuffer::VertexBuffer);
+    colorbuffer = new QGLBuffer(QGLBuffer::VertexBuffer);
+    indexbuffer = new QGLBuffer(QGLBuffer::IndexBuffer);
+    if ( !pointbuffer->create() || !colorbuffer->create() || !indexbuffer->create() ) {
+      // No buffer object support, draw from the client side arrays instead
+      destroyBuffers(); usebuffers = false;
+      return;
+    }
+    colorbuffer->setUsagePattern(QGLBuffer::DynamicDraw);
+    pointsdirty = colorsdirty = indicesdirty = true;
+  }
+  if ( pointsdirty ) {
+    pointbuffer->bind();
+    pointbuffer->allocate(tesspoints.empty() ? NULL : &tesspoints[0], tesspoints.size()*sizeof(GLfloat));
+    pointbuffer->release();
+  }
+  if ( colorsdirty ) {
+    colorbuffer->bind();
+    colorbuffer->allocate(tesscolors.empty() ? NULL : &tesscolors[0], tesscolors.size()*sizeof(GLfloat));
+    colorbuffer->release();
+  }
+  if ( indicesdirty ) {
+    indexbuffer->bind();
+    indexbuffer->allocate(tessindices.empty() ? NULL : &tessindices[0], tessindices.size()*sizeof(GLuint));
+    indexbuffer->release();
+  }
+  pointsdirty = colorsdirty = indicesdirty = false;
+#endif
+}
+
+void TMPatchObject::destroyBuffers( ) {
+#ifdef TM_PATCH_USE_VBO
+  delete pointbuffer; pointbuffer = NULL;
+  delete colorbuffer; colorbuffer = NULL;
+  delete indexbuffer; indexbuffer = NULL;
+#endif
+}
+
+void TMPatchObject::drawTessellation( GLenum mode, int offset, int count, bool colored ) {
+  if ( count <= 0 || tesspoints.empty() ) return;
+  uploadTessellation();
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  if ( colored ) glEnableClientState(GL_COLOR_ARRAY);
+#ifdef TM_PATCH_USE_VBO
+  if ( pointbuffer ) {
+    pointbuffer->bind();
+    glVertexPointer(3,GL_FLOAT,0,0);
+    pointbuffer->release();
+    if ( colored ) {
+      colorbuffer->bind();
+      glColorPointer(4,GL_FLOAT,0,0);
+      colorbuffer->release();
+    }
+    indexbuffer->bind();
+    glDrawElements(mode,count,GL_UNSIGNED_INT,(const GLvoid*)(offset*sizeof(GLuint)));
+    indexbuffer->release();
+  } else
+#endif
+  {
+    glVertexPointer(3,GL_FLOAT,0,&tesspoints[0]);
+    if ( colored ) glColorPointer(4,GL_FLOAT,0,&tesscolors[0]);
+    glDrawElements(mode,count,GL_UNSIGNED_INT,&tessindices[offset]);
   }
+  if ( colored ) glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 /* stuart - bezier export */
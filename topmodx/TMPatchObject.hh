@@ -31,8 +31,15 @@
 
 #include "TMPatchFace.hh"
 
+#include <QtGlobal>
+#if QT_VERSION >= 0x040700
+#include <QGLBuffer>
+#define TM_PATCH_USE_VBO
+#endif
+
 class TMPatchObject;
 typedef TMPatchObject* TMPatchObjectPtr;
+typedef vector<const TMPatch*> TMPatchConstPtrArray;
 
 class TMPatchObject {
 protected :
@@ -42,13 +49,49 @@ protected :
   TMPatchFacePtrList::iterator it;
   int patchsize;				 // Size of each patch
 
+  // Index arrays over the object and the patch faces, kept between updates
+  // so the passes in updateForPatches/createPatches can run in parallel
+  // without reallocating
+  DLFLFacePtrArray face_array;
+  DLFLEdgePtrArray edge_array;
+  DLFLVertexPtrArray vertex_array;
+  TMPatchFacePtrArray patch_array;        // Same order as patch_list and face_array
+  DLFLFaceVertexPtrArray patch_corners;   // Corners the patches were built for
+  DLFLFaceVertexPtrArray corner_scratch;
+
+  // Tessellation cache. All patches are evaluated on the CPU into one shared
+  // vertex/color array whenever the patches change, and drawn with glDrawElements.
+  // Each patch occupies (resolution+1)^2 consecutive vertices, row major in v.
+  int resolution;                          // Number of steps along each patch direction
+  TMPatchConstPtrArray tesspatches;        // Patches in the order they are tessellated
+  vector<GLfloat> tesspoints;              // 3 floats per tessellated vertex
+  vector<GLfloat> tesscolors;              // 4 floats per tessellated vertex
+  vector<GLuint> tessindices;              // Fill, outline, patch boundary and face boundary indices
+  int fillcount, outlineoffset, outlinecount;
+  int boundaryoffset, boundarycount, faceboundaryoffset, faceboundarycount;
+  bool pointsdirty, colorsdirty, indicesdirty; // Cache has changed since the last upload
+
+#ifdef TM_PATCH_USE_VBO
+  QGLBuffer *pointbuffer, *colorbuffer, *indexbuffer;
+  bool usebuffers;                         // False if buffer objects are not supported
+#endif
+
 public :
 
   // Default constructor
-  TMPatchObject( uint id ) : uid(id), patch_list(), patchsize(4) { }
+  TMPatchObject( uint id )
+    : uid(id), patch_list(), patchsize(4), resolution(12),
+      fillcount(0), outlineoffset(0), outlinecount(0),
+      boundaryoffset(0), boundarycount(0), faceboundaryoffset(0), faceboundarycount(0),
+      pointsdirty(true), colorsdirty(true), indicesdirty(true),
+#ifdef TM_PATCH_USE_VBO
+      pointbuffer(NULL), colorbuffer(NULL), indexbuffer(NULL), usebuffers(true),
+#endif
+      mObj(NULL) { }
 
   uint id( ) { return uid; };
   int size( ) { return patchsize; };
+  int getResolution( ) const { return resolution; };
   const TMPatchFacePtrList& list( ) { return patch_list; };
   void for_each( void (TMPatchFace::*func)(void));
 
@@ -66,7 +109,7 @@ private :
        
 public :     
   // Destructor
-  ~TMPatchObject() { destroyPatches(); destroyPatchMap(patchMap); }
+  ~TMPatchObject() { destroyBuffers(); destroyPatches(); destroyPatchMap(patchMap); }
 
 protected :
   DLFLObjectPtr mObj; // the last obj created from
@@ -77,27 +120,53 @@ protected :
   void destroyPatches();
   // Build the list of patch faces
   void createPatches( DLFLObjectPtr obj );
+  // Fill the index arrays from the object
+  void fillArrays( DLFLObjectPtr obj );
+  // True if face_array has the same faces and corners the patches were built for
+  bool sameTopology( );
+
+  // Evaluate every patch into the tessellation cache
+  void tessellate( );
+  // Rebuild the index arrays for the current patch count and resolution
+  void buildTessellationIndices( );
+  // Evaluate points and/or colors of all patches at the current resolution
+  void evaluatePatches( bool points, bool colors );
+  // Copy the cache into buffer objects if it has changed
+  void uploadTessellation( );
+  void destroyBuffers( );
+  // Draw a range of the index array
+  void drawTessellation( GLenum mode, int offset, int count, bool colored );
 
 public :
 
   // Set the patch size
   void setPatchSize(int size, DLFLObjectPtr obj = NULL );
 
+  // Set the number of tessellation steps along each patch direction
+  void setResolution( int res );
+
   void updateForPatches( DLFLObjectPtr obj );
 
   // Update the patches
   void updatePatches( DLFLObjectPtr obj = NULL ) {
     if( !obj ) { obj = mObj; }
     if( !obj ) { return; } // never set an obj to update
+    mObj = obj;
     updateForPatches(obj);
     createPatches(obj);
+    tessellate();
+  }
+
+  // Re-evaluate the tessellated colors after the patch lighting has changed
+  void updatePatchColors( ) {
+    evaluatePatches(false,true);
   }
 
   // Render the patches
   void renderPatches(void) {
     glPushMatrix();
     transform();
-    for_each(&TMPatchFace::render);
+    drawTessellation(GL_TRIANGLES,0,fillcount,true);
     glPopMatrix();
   }
 
@@ -105,8 +174,7 @@ public :
   void renderWireframePatches(void) {
     glPushMatrix();
     transform();
-    //for_each(face_list.begin(), face_list.end(), outline);
-    for_each(&TMPatchFace::outline);
+    drawTessellation(GL_LINES,outlineoffset,outlinecount,false);
     glPopMatrix();
   }
 
@@ -122,16 +190,14 @@ public :
   void renderPatchBoundaries(void) {
     glPushMatrix();
     transform();
-    //for_each(patch_list.begin(), patch_list.end(), tmpf_patch_boundary);
-    for_each(&TMPatchFace::patch_boundary);
+    drawTessellation(GL_LINES,boundaryoffset,boundarycount,false);
     glPopMatrix();
   }
 
   void renderPatchFaceBoundaries(void) {
     glPushMatrix();
     transform();
-    //for_each(patch_list.begin(), patch_list.end(), tmpf_face_boundary);
-    for_each(&TMPatchFace::face_boundary);
+    drawTessellation(GL_LINES,faceboundaryoffset,faceboundarycount,false);
     glPopMatrix();
   }
 
@@ -143,16 +209,16 @@ public :
     glPopMatrix();
   }
 
-  // Compute lighting for patches and the base object
+  // Compute lighting for the patches. Lighting for the base object
+  // is computed by ::computeLighting in DLFLLighting
   void computeLighting(DLFLObjectPtr obj, LightPtr lightptr) {
-    cout << "TMPatchObject::computeLighting" << endl;
-    computeLighting(obj,lightptr);
     TMPatchFacePtrList::iterator first = patch_list.begin(), last = patch_list.end();
     TMPatchFacePtr pfp = NULL;
     while ( first != last ) {
       pfp = (*first); ++first;
       pfp->computeLighting(lightptr);
     }
+    updatePatchColors();
   }
 
   /* stuart - bezier export */
@@ -166,6 +232,7 @@ public :
   }
 
 	void transform( ) {
+		if( !mObj ) return;
 		double mat[16];
 		mObj->tr.fillArrayColumnMajor(mat);
 		glMultMatrixd(mat);		
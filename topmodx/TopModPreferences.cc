@@ -127,6 +127,7 @@ void TopModPreferences::saveSettings(){
 	mSettings->setValue("VertexThickness", mVertexThickness);
 	mSettings->setValue("SelectedVertexThickness", mSelectedVertexThickness);
 	mSettings->setValue("SelectedEdgeThickness", mSelectedEdgeThickness);
+	mSettings->setValue("PatchResolution", mPatchResolution);
 	mSettings->endGroup();
 
 	mSettings->beginGroup("Camera");
@@ -151,6 +152,11 @@ void TopModPreferences::saveSettings(){
 	mSettings->setValue("toolOptionsPos", ((MainWindow*)mParent)->mToolOptionsDockWidget->pos());
 	mSettings->setValue("CommandCompleterIndex", mCommandCompleterIndexToggle->checkState());
 	mSettings->setValue("SingleClickExtrude", mSingleClickExtrudeCheckBox->checkState());
+	mSettings->setValue("WeldOnImport", mWeldOnImportCheckBox->checkState());
+	mSettings->setValue("WeldTolerance", mWeldToleranceSpinBox->value());
+	mSettings->setValue("SmoothNormals", mSmoothNormalsCheckBox->checkState());
+	mSettings->setValue("CreaseAngle", mCreaseAngleSpinBox->value());
+	mSettings->setValue("SessionBandwidth", mSessionBandwidthSpinBox->value());
 	
 	#ifdef WITH_PYTHON
 	mSettings->setValue("scriptEditorPos", ((MainWindow*)mParent)->mScriptEditorDockWidget->pos());
@@ -216,6 +222,8 @@ void TopModPreferences::readSettings(){
 	mNormalLength = mSettings->value("NormalLength", mNormalLengthDefault).toDouble();
 	mFaceCentroidThicknessDefault = 5.0;
 	mFaceCentroidThickness = mSettings->value("FaceCentroidThickness", mFaceCentroidThicknessDefault).toDouble();
+	mPatchResolutionDefault = 12;
+	mPatchResolution = mSettings->value("PatchResolution", mPatchResolutionDefault).toDouble();
 	mSettings->endGroup();
 	
 	mSettings->beginGroup("Camera");
@@ -254,6 +262,17 @@ void TopModPreferences::readSettings(){
 
 	mSingleClickExtrudeDefault = false;
 	mSingleClickExtrude = mSettings->value("SingleClickExtrude", mSingleClickExtrudeDefault).toBool();
+
+	mWeldOnImportDefault = false;
+	mWeldOnImport = mSettings->value("WeldOnImport", mWeldOnImportDefault).toBool();
+	mWeldToleranceDefault = 0.00001;
+	mWeldTolerance = mSettings->value("WeldTolerance", mWeldToleranceDefault).toDouble();
+	mSmoothNormalsDefault = false;
+	mSmoothNormals = mSettings->value("SmoothNormals", mSmoothNormalsDefault).toBool();
+	mCreaseAngleDefault = 0.0;
+	mCreaseAngle = mSettings->value("CreaseAngle", mCreaseAngleDefault).toDouble();
+	mSessionBandwidthDefault = 1024.0;
+	mSessionBandwidth = mSettings->value("SessionBandwidth", mSessionBandwidthDefault).toDouble();
 	
 	#ifdef WITH_PYTHON
 	QSize scriptEditorSize = mSettings->value("scriptEditorSize", QSize(500,300)).toSize();
@@ -297,6 +316,7 @@ void TopModPreferences::readSettings(){
 	((MainWindow*)mParent)->getActive()->setVertexThickness(mVertexThickness);	
 	((MainWindow*)mParent)->getActive()->setSelectedVertexThickness(mSelectedVertexThickness);	
 	((MainWindow*)mParent)->getActive()->setSelectedEdgeThickness(mSelectedEdgeThickness);
+	((MainWindow*)mParent)->getActive()->setPatchResolution(mPatchResolution);
 	
 	((MainWindow*)mParent)->getActive()->setNearPlane(mCameraNearPlane);
 	((MainWindow*)mParent)->getActive()->setFarPlane(mCameraFarPlane);
@@ -309,6 +329,11 @@ void TopModPreferences::readSettings(){
 	((MainWindow*)mParent)->setIncrementalSaveMax(mIncrementalSaveMax);
 	((MainWindow*)mParent)->setCommandCompleterIndexToggle(mCommandCompleterIndex);
 	((MainWindow*)mParent)->setSingleClickExtrude(mSingleClickExtrude);
+	((MainWindow*)mParent)->setWeldOnImport(mWeldOnImport);
+	((MainWindow*)mParent)->setWeldTolerance(mWeldTolerance);
+	((MainWindow*)mParent)->setCreaseAngle(mCreaseAngle);
+	((MainWindow*)mParent)->setSmoothNormals(mSmoothNormals);
+	((MainWindow*)mParent)->setSessionBandwidth(mSessionBandwidth);
 
 }
 
@@ -402,6 +427,9 @@ void TopModPreferences::loadDefaults(){
 	mFaceCentroidThickness = mFaceCentroidThicknessDefault;
 	mFaceCentroidThicknessSpinBox->setValue(mFaceCentroidThickness);	
 
+	mPatchResolution = mPatchResolutionDefault;
+	mPatchResolutionSpinBox->setValue(mPatchResolution);
+
 	mVertexThickness = mVertexThicknessDefault;
 	mVertexThicknessSpinBox->setValue(mVertexThickness);	
 	
@@ -443,6 +471,21 @@ void TopModPreferences::loadDefaults(){
 
 	mSingleClickExtrude = mSingleClickExtrudeDefault;
 	((MainWindow*)mParent)->setSingleClickExtrude(mSingleClickExtrude);
+
+	mWeldOnImport = mWeldOnImportDefault;
+	((MainWindow*)mParent)->setWeldOnImport(mWeldOnImport);
+
+	mWeldTolerance = mWeldToleranceDefault;
+	((MainWindow*)mParent)->setWeldTolerance(mWeldTolerance);
+
+	mCreaseAngle = mCreaseAngleDefault;
+	((MainWindow*)mParent)->setCreaseAngle(mCreaseAngle);
+
+	mSmoothNormals = mSmoothNormalsDefault;
+	((MainWindow*)mParent)->setSmoothNormals(mSmoothNormals);
+
+	mSessionBandwidth = mSessionBandwidthDefault;
+	((MainWindow*)mParent)->setSessionBandwidth(mSessionBandwidth);
 	
 }
 
@@ -514,8 +557,32 @@ void TopModPreferences::setupMain(){
 	mSingleClickExtrudeCheckBox->setChecked(mSingleClickExtrude);
 	connect(mSingleClickExtrudeCheckBox, SIGNAL(stateChanged(int)),((MainWindow*)mParent), SLOT(setSingleClickExtrude(int)));
 	mMainLayout->addWidget(mSingleClickExtrudeCheckBox,10,0);
+
+	//merge coincident vertices of imported OBJ files
+	mWeldOnImportCheckBox  = new QCheckBox(tr("Weld Vertices on OBJ Import"), this);
+	mWeldOnImportCheckBox->setChecked(mWeldOnImport);
+	connect(mWeldOnImportCheckBox, SIGNAL(stateChanged(int)),((MainWindow*)mParent), SLOT(setWeldOnImport(int)));
+	mMainLayout->addWidget(mWeldOnImportCheckBox,11,0);
+
+	//distance below which vertices are welded, also used by Weld Vertices
+	mWeldToleranceSpinBox = addSpinBoxPreference(mWeldToleranceLabel, tr("Weld Tolerance:"), 0.0, 1.0, 0.00001, mWeldTolerance, 6, mMainLayout, 12, 0);
+	connect(mWeldToleranceSpinBox, SIGNAL(valueChanged(double)),((MainWindow*)mParent), SLOT(setWeldTolerance(double)));
+
+	//area weighted vertex normals instead of the average of the corner normals
+	mSmoothNormalsCheckBox  = new QCheckBox(tr("Smooth Normals"), this);
+	mSmoothNormalsCheckBox->setChecked(mSmoothNormals);
+	connect(mSmoothNormalsCheckBox, SIGNAL(stateChanged(int)),((MainWindow*)mParent), SLOT(setSmoothNormals(int)));
+	mMainLayout->addWidget(mSmoothNormalsCheckBox,13,0);
+
+	//smooth normals are split across edges sharper than this, 0 for no creases
+	mCreaseAngleSpinBox = addSpinBoxPreference(mCreaseAngleLabel, tr("Crease Angle:"), 0.0, 180.0, 1.0, mCreaseAngle, 1, mMainLayout, 14, 0);
+	connect(mCreaseAngleSpinBox, SIGNAL(valueChanged(double)),((MainWindow*)mParent), SLOT(setCreaseAngle(double)));
+
+	//upload limit for each connection of a session (File > Session), 0 for none
+	mSessionBandwidthSpinBox = addSpinBoxPreference(mSessionBandwidthLabel, tr("Session Bandwidth (KB/s):"), 0.0, 1048576.0, 64.0, mSessionBandwidth, 0, mMainLayout, 15, 0);
+	connect(mSessionBandwidthSpinBox, SIGNAL(valueChanged(double)),((MainWindow*)mParent), SLOT(setSessionBandwidth(double)));
 	
-	mMainLayout->setRowStretch(11,2);
+	mMainLayout->setRowStretch(16,2);
 	mMainLayout->setColumnStretch(4,2);
 	
 	mMainTab->setLayout(mMainLayout);
@@ -635,6 +702,9 @@ void TopModPreferences::setupColors(){
 	//SelectedEdge thickness
 	mFaceCentroidThicknessSpinBox = addSpinBoxPreference(mFaceCentroidThicknessLabel, tr("Face Centroid Thickness:"), 0.1, 15.0, 0.5, mFaceCentroidThickness, 1, mColorsLayout, 8, 2);
 	connect(mFaceCentroidThicknessSpinBox, SIGNAL(valueChanged(double)),((MainWindow*)mParent)->getActive(), SLOT(setFaceCentroidThickness(double)));
+	//patch tessellation resolution
+	mPatchResolutionSpinBox = addSpinBoxPreference(mPatchResolutionLabel, tr("Patch Resolution:"), 1, 64, 1, mPatchResolution, 0, mColorsLayout, 9, 2);
+	connect(mPatchResolutionSpinBox, SIGNAL(valueChanged(double)),((MainWindow*)mParent)->getActive(), SLOT(setPatchResolution(double)));
 
 	//reset button
 	mResetColorsButton = new QPushButton(tr("Reset"));
@@ -157,6 +157,11 @@ private:
 	QLabel *mFaceCentroidThicknessLabel;
 	QDoubleSpinBox *mFaceCentroidThicknessSpinBox;
 
+	//patch tessellation resolution
+	double mPatchResolution,mPatchResolutionDefault;
+	QLabel *mPatchResolutionLabel;
+	QDoubleSpinBox *mPatchResolutionSpinBox;
+
 	//selected vertex thickness
 	double mSelectedVertexThickness,mSelectedVertexThicknessDefault;
 	QLabel *mSelectedVertexThicknessLabel;
@@ -231,6 +236,21 @@ private:
 
 	QCheckBox *mSingleClickExtrudeCheckBox;
 	bool mSingleClickExtrude, mSingleClickExtrudeDefault;
+
+	QCheckBox *mWeldOnImportCheckBox;
+	bool mWeldOnImport, mWeldOnImportDefault;
+	QDoubleSpinBox *mWeldToleranceSpinBox;
+	QLabel *mWeldToleranceLabel;
+	double mWeldTolerance, mWeldToleranceDefault;
+
+	QCheckBox *mSmoothNormalsCheckBox;
+	bool mSmoothNormals, mSmoothNormalsDefault;
+	QDoubleSpinBox *mCreaseAngleSpinBox;
+	QLabel *mCreaseAngleLabel;
+	double mCreaseAngle, mCreaseAngleDefault;
+	QDoubleSpinBox *mSessionBandwidthSpinBox;
+	QLabel *mSessionBandwidthLabel;
+	double mSessionBandwidth, mSessionBandwidthDefault;
 	
 public:
 	TopModPreferences(QSettings *settings, StyleSheetEditor *sse, QShortcutManager *sm, QWidget *parent = 0 );
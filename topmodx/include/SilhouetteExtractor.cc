@@ -0,0 +1,166 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#include "SilhouetteExtractor.hh"
+
+#include <cmath>
+
+SilhouetteExtractor& SilhouetteExtractor::instance( ) {
+  static SilhouetteExtractor extractor;
+  return extractor;
+}
+
+void SilhouetteExtractor::build(DLFLObjectPtr obj) {
+  object = obj; stamp = obj->changeCount(); seeded = false;
+
+  int n = obj->num_edges();
+  mx.resize(n); my.resize(n); mz.resize(n);
+  n1x.resize(n); n1y.resize(n); n1z.resize(n);
+  n2x.resize(n); n2y.resize(n); n2z.resize(n);
+  margin.resize(n); state.assign(n,0);
+  lines.resize(6*n);
+
+  DLFLEdgePtrList::iterator first = obj->beginEdge(), last = obj->endEdge();
+  DLFLVertexPtr vp1, vp2;
+  DLFLFacePtr fp1, fp2;
+  for (int i=0; first != last; ++first, ++i) {
+    DLFLEdgePtr ep = (*first);
+    ep->getVertexPointers(vp1,vp2);
+    ep->getFacePointers(fp1,fp2);
+    const Vector3d& p1 = vp1->coords;
+    const Vector3d& p2 = vp2->coords;
+    Vector3d nv1 = normalized(fp1->normal), nv2 = normalized(fp2->normal);
+    mx[i] = 0.5*(p1[0]+p2[0]); my[i] = 0.5*(p1[1]+p2[1]); mz[i] = 0.5*(p1[2]+p2[2]);
+    n1x[i] = nv1[0]; n1y[i] = nv1[1]; n1z[i] = nv1[2];
+    n2x[i] = nv2[0]; n2y[i] = nv2[1]; n2z[i] = nv2[2];
+    GLfloat *l = &lines[6*i];
+    l[0] = p1[0]; l[1] = p1[1]; l[2] = p1[2];
+    l[3] = p2[0]; l[4] = p2[1]; l[5] = p2[2];
+  }
+}
+
+void SilhouetteExtractor::fullPass(const Vector3d& eye, bool directional) {
+  int n = state.size();
+  const float ex = eye[0], ey = eye[1], ez = eye[2];
+  const float w = directional ? 0.0f : 1.0f;
+
+  // Signed distance of the eye from both face planes, taken through the edge
+  // midpoint. A sign change means one face is front and the other back facing
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static) if(n > 20000)
+#endif
+  for (int i=0; i < n; ++i) {
+    float dx = ex - w*mx[i], dy = ey - w*my[i], dz = ez - w*mz[i];
+    float s1 = n1x[i]*dx + n1y[i]*dy + n1z[i]*dz;
+    float s2 = n2x[i]*dx + n2y[i]*dy + n2z[i]*dz;
+    state[i] = ( (s1 > 0.0f) != (s2 > 0.0f) );
+    margin[i] = std::min(std::fabs(s1),std::fabs(s2));
+  }
+
+  indices.clear(); band.clear(); fixed.clear();
+  for (int i=0; i < n; ++i)
+    if ( state[i] ) { indices.push_back(2*i); indices.push_back(2*i+1); }
+
+  // Moving the eye by d changes each distance by at most d, so an edge can
+  // only flip once the eye has moved further than its margin
+  seeded = !directional;
+  if ( !seeded ) return;
+  seedEye = eye;
+  if ( n > 0 ) {
+    Vector3d center(0.0,0.0,0.0);
+    for (int i=0; i < n; ++i) center += Vector3d(mx[i],my[i],mz[i]);
+    center /= n;
+    radius = 0.05 * norm(eye - center);
+  }
+  for (int i=0; i < n; ++i) {
+    if ( margin[i] <= radius ) band.push_back(i);
+    else if ( state[i] ) fixed.push_back(i);
+  }
+}
+
+void SilhouetteExtractor::bandPass(const Vector3d& eye) {
+  const float ex = eye[0], ey = eye[1], ez = eye[2];
+  int nb = band.size();
+  for (int j=0; j < nb; ++j) {
+    GLuint i = band[j];
+    float dx = ex - mx[i], dy = ey - my[i], dz = ez - mz[i];
+    float s1 = n1x[i]*dx + n1y[i]*dy + n1z[i]*dz;
+    float s2 = n2x[i]*dx + n2y[i]*dy + n2z[i]*dz;
+    state[i] = ( (s1 > 0.0f) != (s2 > 0.0f) );
+  }
+
+  indices.clear();
+  for (uint j=0; j < fixed.size(); ++j) {
+    indices.push_back(2*fixed[j]); indices.push_back(2*fixed[j]+1);
+  }
+  for (int j=0; j < nb; ++j)
+    if ( state[band[j]] ) { indices.push_back(2*band[j]); indices.push_back(2*band[j]+1); }
+}
+
+void SilhouetteExtractor::update(DLFLObjectPtr obj, const Vector3d& eye, bool directional) {
+  if ( obj != object || obj->changeCount() != stamp ) build(obj);
+  if ( !directional && seeded && norm(eye - seedEye) <= radius ) bandPass(eye);
+  else fullPass(eye,directional);
+}
+
+void SilhouetteExtractor::render(DLFLObjectPtr obj, double width) {
+  // Eye in world space from the modelview, then into object space. An
+  // orthographic projection has no eye point, only a direction
+  GLdouble mv[16], proj[16];
+  glGetDoublev(GL_MODELVIEW_MATRIX,mv);
+  glGetDoublev(GL_PROJECTION_MATRIX,proj);
+  bool directional = ( proj[11] == 0.0 );
+
+  Matrix4x4 view(Vector4d(mv[0],mv[4],mv[8],mv[12]), Vector4d(mv[1],mv[5],mv[9],mv[13]),
+                 Vector4d(mv[2],mv[6],mv[10],mv[14]), Vector4d(mv[3],mv[7],mv[11],mv[15]));
+  Vector4d e = inverse(view) * Vector4d(0.0,0.0,directional ? 1.0 : 0.0,directional ? 0.0 : 1.0);
+  Transformation invtr(obj->tr);
+  invtr.invert();
+  Vector3d eye = invtr.applyTo(Vector3d(e[0],e[1],e[2]));
+  if ( directional ) {
+    eye -= invtr.applyTo(Vector3d(0.0,0.0,0.0));
+    normalize(eye);
+  }
+
+  update(obj,eye,directional);
+  if ( indices.empty() ) return;
+
+  double mat[16];
+  obj->tr.fillArrayColumnMajor(mat);
+  glPushMatrix();
+  glMultMatrixd(mat);
+  glLineWidth(width);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3,GL_FLOAT,0,&lines[0]);
+  glDrawElements(GL_LINES,indices.size(),GL_UNSIGNED_INT,&indices[0]);
+  glPopClientAttrib();
+  glLineWidth(1.0);
+  glPopMatrix();
+}
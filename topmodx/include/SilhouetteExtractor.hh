@@ -0,0 +1,106 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifndef _SILHOUETTE_EXTRACTOR_HH_
+#define _SILHOUETTE_EXTRACTOR_HH_
+
+/*
+  SilhouetteExtractor
+  Finds the edges of a DLFL object where the two adjacent faces turn from
+  front to back facing, so silhouettes can be drawn without sending every edge.
+  Edge midpoints and face normals are kept in flat per-component arrays and
+  tested in one branch free pass. After such a pass the edges whose facing
+  could flip within a given eye distance are remembered, and later eye points
+  that stay inside that distance only retest those edges.
+  Rebuilt when the object changes (see DLFLObject::touch()).
+*/
+
+#include <vector>
+#include <DLFLObject.hh>
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+using namespace DLFL;
+
+class SilhouetteExtractor {
+
+protected :
+
+  DLFLObjectPtr object;                   // Object the arrays were built for
+  uint stamp;                             // Its change count at that time
+
+  // Per edge data, one array per component
+  std::vector<float> mx, my, mz;          // Edge midpoint
+  std::vector<float> n1x, n1y, n1z;       // Unit normal of the first face
+  std::vector<float> n2x, n2y, n2z;       // Unit normal of the second face
+  std::vector<float> margin;              // Eye distance to the nearer face plane
+  std::vector<unsigned char> state;       // 1 for silhouette edges
+  std::vector<GLfloat> lines;             // Edge end points, 6 per edge
+
+  // Result of the last full pass, used to seed the following ones
+  Vector3d seedEye;
+  double radius;                          // Eye may move this far before a full pass
+  bool seeded;
+  std::vector<GLuint> band;               // Edges which may flip within radius
+  std::vector<GLuint> fixed;              // Silhouette edges which can't
+
+  std::vector<GLuint> indices;            // Line indices of the current silhouette
+
+  SilhouetteExtractor( ) : object(NULL), stamp(0), radius(0.0), seeded(false) { }
+
+  void build(DLFLObjectPtr obj);
+
+  // Test every edge. For a directional eye (orthographic views) eye is the
+  // direction towards the viewer, otherwise the eye point
+  void fullPass(const Vector3d& eye, bool directional);
+
+  // Retest only the band left by the last full pass
+  void bandPass(const Vector3d& eye);
+
+public :
+
+  // The extractor shared by all renderers
+  static SilhouetteExtractor& instance( );
+
+  // Bring the silhouette of obj up to date for an eye given in object space
+  void update(DLFLObjectPtr obj, const Vector3d& eye, bool directional = false);
+
+  // Silhouette edges as pairs of indices into lineCoords(), valid after update()
+  const std::vector<GLuint>& lineIndices( ) const { return indices; }
+  const std::vector<GLfloat>& lineCoords( ) const { return lines; }
+
+  // Extract the silhouette for the current modelview and projection and draw it
+  void render(DLFLObjectPtr obj, double width);
+};
+
+#endif /* #ifndef _SILHOUETTE_EXTRACTOR_HH_ */
@@ -0,0 +1,187 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#include "TextureCache.hh"
+
+#include <QFileInfo>
+#ifndef QT_NO_CONCURRENT
+#include <QtConcurrentRun>
+#endif
+
+TextureCache& TextureCache::instance( ) {
+  static TextureCache cache;
+  return cache;
+}
+
+TextureCache::~TextureCache( ) {
+  // The GL contexts are gone by now, so only the decoded data is freed
+  QHash<QString,Entry*>::iterator it;
+  for (it = entries.begin(); it != entries.end(); ++it) {
+#ifndef QT_NO_CONCURRENT
+    it.value()->future.waitForFinished();
+    delete it.value()->watcher;
+#endif
+    delete it.value();
+  }
+}
+
+QString TextureCache::key(const QString& filename) {
+  return QFileInfo(filename).absoluteFilePath();
+}
+
+QImage TextureCache::decode(const QString& filename) {
+  return QImage(filename);
+}
+
+void TextureCache::load(const QString& filename, Entry *entry) {
+  entry->modified = QFileInfo(filename).lastModified();
+  entry->image = QImage();
+  entry->pending = true;
+  entry->failed = false;
+#ifndef QT_NO_CONCURRENT
+  entry->future = QtConcurrent::run(TextureCache::decode,filename);
+  entry->watcher->setFuture(entry->future);
+#else
+  entry->image = decode(filename);
+  finish(entry);
+#endif
+}
+
+void TextureCache::finish(Entry *entry) {
+  if ( !entry->pending ) return;
+#ifndef QT_NO_CONCURRENT
+  if ( !entry->future.isFinished() ) return;
+  entry->image = entry->future.result();
+  entry->future = QFuture<QImage>();
+#endif
+  entry->pending = false;
+  entry->failed = entry->image.isNull();
+}
+
+void TextureCache::request(const QString& filename) {
+  QString k = key(filename);
+  Entry *entry = entries.value(k,NULL);
+  if ( entry ) {
+    if ( entry->modified == QFileInfo(filename).lastModified() && !entry->failed ) return;
+    // The file changed, drop the old texture
+    if ( entry->id ) stale.append(qMakePair(entry->context,entry->id));
+#ifndef QT_NO_CONCURRENT
+    entry->future.waitForFinished();
+#endif
+  } else {
+    entry = new Entry;
+#ifndef QT_NO_CONCURRENT
+    entry->watcher = new QFutureWatcher<QImage>();
+#endif
+    entries.insert(k,entry);
+  }
+  entry->id = 0; entry->context = NULL;
+  load(k,entry);
+}
+
+void TextureCache::notifyWhenLoaded(const QString& filename, QObject *receiver, const char *slot) {
+#ifndef QT_NO_CONCURRENT
+  Entry *entry = entries.value(key(filename),NULL);
+  if ( entry && entry->pending ) {
+    // Avoid calling the slot twice when the same receiver asks again
+    QObject::disconnect(entry->watcher,SIGNAL(finished()),receiver,slot);
+    QObject::connect(entry->watcher,SIGNAL(finished()),receiver,slot);
+  }
+#endif
+}
+
+bool TextureCache::failed(const QString& filename) {
+  Entry *entry = entries.value(key(filename),NULL);
+  if ( entry == NULL ) return true;
+  finish(entry);
+  return entry->failed;
+}
+
+void TextureCache::upload(Entry *entry) {
+  int width = entry->image.width(), height = entry->image.height();
+  int depth = entry->image.depth()/8;
+  GLenum format;
+  switch ( depth ) {
+  case 1 : format = GL_LUMINANCE; break;
+  case 2 : format = GL_LUMINANCE_ALPHA; break;
+  case 3 : format = GL_RGB; break;
+  case 4 : format = GL_RGBA; break;
+  default : entry->failed = true; return;
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glGenTextures(1,&entry->id);
+  glBindTexture(GL_TEXTURE_2D, entry->id);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+#ifdef GL_GENERATE_MIPMAP
+  // Let the driver build the mipmaps (OpenGL 1.4)
+  glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+  glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, entry->image.bits());
+#else
+  gluBuild2DMipmaps(GL_TEXTURE_2D, format, width, height, format, GL_UNSIGNED_BYTE, entry->image.bits());
+#endif
+  entry->context = QGLContext::currentContext();
+
+  // The image is not needed any more, it is decoded again if another context wants it
+  entry->image = QImage();
+}
+
+GLuint TextureCache::texture(const QString& filename) {
+  const QGLContext *context = QGLContext::currentContext();
+
+  // Delete replaced textures belonging to this context
+  for (int i=0; i < stale.size(); ) {
+    if ( stale[i].first == context ) {
+      glDeleteTextures(1,&stale[i].second);
+      stale.removeAt(i);
+    } else ++i;
+  }
+
+  QString k = key(filename);
+  Entry *entry = entries.value(k,NULL);
+  if ( entry == NULL ) return 0;
+  finish(entry);
+  if ( entry->pending || entry->failed ) return 0;
+
+  if ( entry->id && entry->context == context ) return entry->id;
+
+  if ( entry->image.isNull() ) {
+    // Uploaded for another context and the image has been released
+    if ( entry->id ) stale.append(qMakePair(entry->context,entry->id));
+    entry->id = 0; entry->context = NULL;
+    load(k,entry);
+    finish(entry);
+    if ( entry->pending ) return 0;
+  }
+  upload(entry);
+  return entry->id;
+}
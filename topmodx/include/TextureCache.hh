@@ -0,0 +1,117 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifndef _TEXTURE_CACHE_HH_
+#define _TEXTURE_CACHE_HH_
+
+/*
+  TextureCache
+  Textures used by the textured renderers, shared between them.
+  Image files are decoded on a worker thread, uploaded to OpenGL once
+  (with mipmaps) and kept until the file changes on disk. Entries are keyed
+  by the absolute file path and checked against the modification time,
+  so asking for the same file again costs nothing.
+*/
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QDateTime>
+#include <QImage>
+#include <QGLContext>
+#ifndef QT_NO_CONCURRENT
+#include <QFuture>
+#include <QFutureWatcher>
+#endif
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <OpenGL/glu.h>
+#else
+#include <GL/gl.h>
+#include <GL/glu.h>
+#endif
+
+class TextureCache {
+
+protected :
+
+  struct Entry {
+    QDateTime modified;                   // Modification time of the file when it was read
+    QImage image;                         // Decoded image, released once uploaded
+    GLuint id;                            // OpenGL texture, 0 if not uploaded
+    const QGLContext *context;            // Context the texture belongs to
+    bool pending;                         // Still being decoded
+    bool failed;                          // File could not be read
+#ifndef QT_NO_CONCURRENT
+    QFuture<QImage> future;
+    QFutureWatcher<QImage> *watcher;      // Tells interested parties when decoding is done
+#endif
+  };
+
+  QHash<QString,Entry*> entries;
+  QList< QPair<const QGLContext*,GLuint> > stale; // Textures to delete once their context is current
+
+  TextureCache( ) { }
+  ~TextureCache( );
+
+  static QString key(const QString& filename);
+  static QImage decode(const QString& filename);
+
+  // (Re)start decoding the file of an entry
+  void load(const QString& filename, Entry *entry);
+
+  // Pick up the decoded image if the worker is done
+  void finish(Entry *entry);
+
+  // Upload the decoded image into a new texture for the current context
+  void upload(Entry *entry);
+
+public :
+
+  // The cache shared by all renderers
+  static TextureCache& instance( );
+
+  // Start loading a texture unless the same version of the file is already cached
+  void request(const QString& filename);
+
+  // Call the given slot of receiver once the texture has been decoded.
+  // If it already has the slot is not called
+  void notifyWhenLoaded(const QString& filename, QObject *receiver, const char *slot);
+
+  // True if the file was never requested or could not be read
+  bool failed(const QString& filename);
+
+  // Texture for the file in the current OpenGL context, uploading it if necessary.
+  // Returns 0 while the file is still being decoded. Must be called with a current context
+  GLuint texture(const QString& filename);
+};
+
+#endif /* #ifndef _TEXTURE_CACHE_HH_ */
@@ -84,8 +84,10 @@ public :
     glEnable(GL_CULL_FACE);
     setCulling();
     glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    if ( texture_id ) {
+      glEnable(GL_TEXTURE_2D);
+      glBindTexture(GL_TEXTURE_2D, texture_id);
+    }
     gr->render( object );
     //object->renderFacesT();
     glDisable(GL_TEXTURE_2D);
@@ -35,10 +35,9 @@
   Renders with face-vertex normals, without material colors or fave-vertex colors.
   Renders with texture, specified through an OpenGL texture ID
 */
-#include <QFile>
 #include <QString>
-#include <QImage>
 #include "../DLFLRenderer.hh"
+#include "TextureCache.hh"
 
 class TexturedRenderer;
 typedef TexturedRenderer * TexturedRendererPtr;
@@ -47,95 +46,58 @@ class TexturedRenderer : public DLFLRenderer {
 
 protected :
 
-  QImage * image;       // QImage pointer containing image data
-  int width, height, depth;        // Width, height and color depth
-  GLuint texture_id;
-
-  // Read the image from the given file
-  void readTexture(const char *imagefile) {
-    QString filename(imagefile);
-    if ( 	filename.indexOf(".jpg",filename.length()-5) == filename.length()-4 ||
-					filename.indexOf(".jpeg",filename.length()-5) == filename.length()-4 ||
-					filename.indexOf(".JPG",filename.length()-5) == filename.length()-4 ||
-					filename.indexOf(".JPEG",filename.length()-5) == filename.length()-4 ||
-					filename.indexOf(".png",filename.length()-5) == filename.length()-4 ||			  
-					filename.indexOf(".PNG",filename.length()-5) == filename.length()-4 )
-      image = new QImage(imagefile);
-		// std::cout << image->height() << "\n";
-    if ( !image->isNull() )	{
-      width = image->width(); 
-      height = image->height(); 
-      depth = image->depth()/8;
-			// glTexture();
-    }
-  }
-
-  void glTexture(void) {
-		// std::cout << image->bits() << "\n";
-	
-    // Do a glTexImage2D using the texture image data
-    if ( image && !image->isNull() ) {
-			// std::cout<<"depth  = " <<  depth << "\n";
-      if ( depth == 1 )
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, image->bits());
-      else if ( depth == 2 )
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, width, height, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, image->bits());
-      else if ( depth== 3 )
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image->bits());
-      else if ( depth == 4 )
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,	GL_RGBA, GL_UNSIGNED_BYTE, image->bits());
-    }
-  }
+  QString texfile;      // Image file used as texture, the image itself lives in the TextureCache
+  GLuint texture_id;    // Texture for the current frame, 0 while the image is still loading
 
 public :
 
   /* Default constructor */
   TexturedRenderer()
-    : DLFLRenderer(), image(NULL), width(0), height(0), depth(0), texture_id(0) { 
+    : DLFLRenderer(), texfile(), texture_id(0) { 
 		
   }
 	
   TexturedRenderer(QColor wc, double wt, QColor sc, double st, QColor vc, double vt, QColor fc, double ft, QColor nc, double nt)
-    : DLFLRenderer(wc, wt, sc, st, vc, vt, fc, ft, nc, nt) {
+    : DLFLRenderer(wc, wt, sc, st, vc, vt, fc, ft, nc, nt), texfile(), texture_id(0) {
 
   }
 
   /* Copy constructor */
   TexturedRenderer(const TexturedRenderer& tr)
-    : DLFLRenderer(tr), width(tr.width), height(tr.height), depth(tr.depth), texture_id(tr.texture_id) { 
-    image = new QImage(tr.image->bits(),tr.width,tr.height,tr.image->format());
-    //(*image) = tr.image->copy();
+    : DLFLRenderer(tr), texfile(tr.texfile), texture_id(tr.texture_id) { 
   }
 
   /* Construct using given image file as texture */
   TexturedRenderer(const char * filename)
-    : DLFLRenderer(), image(NULL), width(0), height(0), depth(0), texture_id(0) {
-    readTexture(filename);
+    : DLFLRenderer(), texfile(), texture_id(0) {
+    setTexture(filename);
   }
 
   /* Assignment operator */
   TexturedRenderer& operator = (const TexturedRenderer& tr) {
     DLFLRenderer::operator = (tr);
-    delete image;
-    image = new QImage(tr.image->bits(),tr.width,tr.height,tr.image->format());
-    width = tr.width; height = tr.height; depth = tr.depth;
+    texfile = tr.texfile;
     texture_id = tr.texture_id;
     return (*this);
   }
 
   /* Destructor */
   virtual ~TexturedRenderer() {
-    delete image;
   }
 
-  /* Associate a texture with this renderer */
+  /* Associate a texture with this renderer. The file is read in the background */
   void setTexture(const char * filename) {
-    delete image; image = NULL;
-    readTexture(filename);
+    texfile = QString(filename);
+    texture_id = 0;
+    if ( !texfile.isEmpty() ) TextureCache::instance().request(texfile);
+  }
+
+  const QString& getTexture(void) const {
+    return texfile;
   }
 
   bool isValid(void) {
-    return ( (image != NULL) && (!image->isNull()) && (depth > 0) );
+    return ( !texfile.isEmpty() && !TextureCache::instance().failed(texfile) );
   }
 
   /*
@@ -144,21 +106,15 @@ public :
     has been setup in the draw() method
   */
   virtual void initialize(void) {
+    texture_id = 0;
     if ( isValid() ) {
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-      glGenTextures(1,&texture_id);
-      glBindTexture(GL_TEXTURE_2D, texture_id);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+      // Uploads the image the first time only
+      texture_id = TextureCache::instance().texture(texfile);
       glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-      glTexture();
     }
   }
 
-  /* Implement render function. Doesn't render if texture_id is negative */
+  /* Implement render function. Doesn't render without a texture file, renders untextured while it is loading */
   virtual int render(DLFLObjectPtr object) {
     if ( isValid() == false ) return -1;
 
@@ -174,8 +130,10 @@ public :
     setCulling();
     glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
     glColor3f(1.0,1.0,1.0);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    if ( texture_id ) {
+      glEnable(GL_TEXTURE_2D);
+      glBindTexture(GL_TEXTURE_2D, texture_id);
+    }
     //object->plainRenderT();
     gr->render( object );
     glDisable(GL_TEXTURE_2D);
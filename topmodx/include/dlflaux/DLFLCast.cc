@@ -95,25 +95,17 @@ namespace DLFL {
       */
     }
 
-    DLFLVertexPtrList::iterator vl_first, vl_last;
     DLFLVertexPtr vertexptr;
-    DLFLFaceVertexPtrArray fvparray;
     Vector3dArray p_array, n_array; // Arrays of point and normals for each face adjacent to a vertex
     int num_faces;
-  
-    vl_first = obj->beginVertex();
-    vl_last = obj->endVertex();
 
-    /* Loop through all vertices */
-    while ( vl_first != vl_last ) {
-      vertexptr = (*vl_first); ++vl_first;
+    /* The faces around each vertex come from the adjacency cache */
+    DLFLAdjacency& adj = obj->adjacency();
 
-      /*
-	Get all the corners for this vertex
-      */
-      fvparray.clear(); // The local array must be cleared before calling getFaceVertices
-      vertexptr->getFaceVertices(fvparray);
-      num_faces = fvparray.size();
+    /* Loop through all vertices */
+    for (uint v=0; v < adj.numVertices(); ++v) {
+      vertexptr = adj.vertex(v);
+      num_faces = adj.valence(v);
        
       /*
 	Go through the array of face-vertices and find the normal and centroid
@@ -126,7 +118,7 @@ namespace DLFL {
       //p_array.resize(num_faces,Vector3d(0)); n_array.resize(num_faces,Vector3d(0));
       p_array.resize(num_faces,Vector3d()); n_array.resize(num_faces,Vector3d());
       for (int i=0; i <num_faces; ++i) {
-	DLFLFacePtr fp = fvparray[i]->getFacePtr();
+	DLFLFacePtr fp = adj.face(adj.ringBegin(v)+i);
 
 	// Get the normal and centroid for this face (which we calculated above)
 	// and store them in our local arrays
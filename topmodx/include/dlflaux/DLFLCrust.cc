@@ -55,45 +55,38 @@ namespace DLFL {
     for normal averaging.
   */
 
-  void createCrust(const DLFLObjectPtr obj, double thickness, bool uniform) {
+  void createCrust(const DLFLObjectPtr obj, CrustInfo& crust, double thickness, bool uniform) {
     if ( !isNonZero(thickness) ) return;
 
     // Clear the arrays used to store crust modeling information
-    crustfp1.clear(); crustfp2.clear();
+    crust.clear();
 
     // Resize the arrays to appropriate size
-    crust_num_old_faces = obj->num_faces();
-    crustfp1.resize(crust_num_old_faces,NULL);
-    crustfp2.resize(crust_num_old_faces,NULL);
+    crust.num_old_faces = obj->num_faces();
+    crust.fp1.resize(crust.num_old_faces,NULL);
+    crust.fp2.resize(crust.num_old_faces,NULL);
   
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream,mtlstream, true);
-
     int num_old_verts = obj->num_vertices();
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream,mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    DLFLFacePtrArray newfaces;
+    obj->appendCopy(*obj,true,NULL,&newfaces);
 
     // Fill the arrays storing information for crust modeling
     // Since we are traversing the faces, also compute and store
     // the normals at corners of each face for use later
-    DLFLFacePtrList::iterator fl_first, fl_last;
+    DLFLFacePtrList::iterator fl_first;
     DLFLFacePtr fp;
     int num_faces = 0;
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( num_faces < crust_num_old_faces ) {
+    fl_first = obj->beginFace();
+    while ( num_faces < crust.num_old_faces ) {
       fp = *fl_first;
-      crustfp1[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
+      crust.fp1[num_faces] = fp; fp->storeNormals();
       ++fl_first; ++num_faces;
     }
-    num_faces = 0; 
-    while ( fl_first != fl_last ) {
-      fp = *fl_first;
-      crustfp2[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
-      ++fl_first; ++num_faces;
+    for (num_faces=0; num_faces < crust.num_old_faces; ++num_faces) {
+      fp = newfaces[num_faces];
+      crust.fp2[num_faces] = fp; fp->storeNormals();
     }
 
     // If thickness is negative move the old vertices outward
@@ -152,7 +145,7 @@ namespace DLFL {
       }
     }
     // Find and store the min. id for the face list
-    crust_min_face_id = (obj->firstFace())->getID();
+    crust.min_face_id = (obj->firstFace())->getID();
   }
 
   /*
@@ -162,23 +155,17 @@ namespace DLFL {
     w.r.t centroid of object.
   */
 
-  void createCrustWithScaling(DLFLObjectPtr obj, double scale_factor) {
+  void createCrustWithScaling(DLFLObjectPtr obj, CrustInfo& crust, double scale_factor) {
     if ( !isNonZero(scale_factor) ) return;
   
     // Clear the arrays used to store crust modeling information
-    crustfp1.clear(); crustfp2.clear();
+    crust.clear();
 
     // Resize the arrays to appropriate size
-    crust_num_old_faces = obj->num_faces();
-    crustfp1.resize(crust_num_old_faces,NULL);
-    crustfp2.resize(crust_num_old_faces,NULL);
+    crust.num_old_faces = obj->num_faces();
+    crust.fp1.resize(crust.num_old_faces,NULL);
+    crust.fp2.resize(crust.num_old_faces,NULL);
   
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream, mtlstream, true);
-
     int num_old_verts = 0;
     Vector3d objcen;
     // We need to find the centroid of the object
@@ -191,24 +178,23 @@ namespace DLFL {
     }
     objcen /= num_old_verts;
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream, mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    DLFLFacePtrArray newfaces;
+    obj->appendCopy(*obj,true,NULL,&newfaces);
 
     // Fill the arrays storing information for crust modeling
-    DLFLFacePtrList::iterator fl_first, fl_last;
+    DLFLFacePtrList::iterator fl_first;
     DLFLFacePtr fp;
     int num_faces = 0;
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( num_faces < crust_num_old_faces ) {
+    fl_first = obj->beginFace();
+    while ( num_faces < crust.num_old_faces ) {
       fp = *fl_first;
-      crustfp1[num_faces] = fp; fp->makeUnique();
+      crust.fp1[num_faces] = fp;
       ++fl_first; ++num_faces;
     }
-    num_faces = 0; 
-    while ( fl_first != fl_last ) {
-      fp = *fl_first;
-      crustfp2[num_faces] = fp; fp->makeUnique();
-      ++fl_first; ++num_faces;
+    for (num_faces=0; num_faces < crust.num_old_faces; ++num_faces) {
+      fp = newfaces[num_faces];
+      crust.fp2[num_faces] = fp;
     }
 
     // Clamp the scale factor to lie between -1 and 1. If negative use inverse of scale factor
@@ -242,21 +228,20 @@ namespace DLFL {
     }
 
     // Find and store the min. id for the face list
-    crust_min_face_id = (obj->firstFace())->getID();
+    crust.min_face_id = (obj->firstFace())->getID();
   }
 
-  void cmMakeHole(DLFLObjectPtr obj, DLFLFacePtr fp, bool cleanup) {
-    int index = fp->getID() - crust_min_face_id;
+  void cmMakeHole(DLFLObjectPtr obj, CrustInfo& crust, DLFLFacePtr fp, bool cleanup) {
+    int index = crust.index(fp);
     DLFLFacePtr fp1,fp2;
     DLFLFaceVertexPtr fvp1,fvp2;
     DLFLEdgePtrArray eparray1, eparray2;
   
-    if ( index > crust_num_old_faces ) index -= crust_num_old_faces;
-    if ( index >= crustfp1.size() ) {
-      cout << "Index out of range " << index << endl;
+    if ( index < 0 ) {
+      cout << "Face " << fp->getID() << " is not part of the crust" << endl;
       return; // This refers to one of the newly created faces
     }
-    fp1 = crustfp1[index]; fp2 = crustfp2[index];
+    fp1 = crust.fp1[index]; fp2 = crust.fp2[index];
     if ( fp1 != NULL && fp2 != NULL ) {
       fvp1 = fp1->firstVertex(); fvp2 = fp2->firstVertex();
       //fvp2 = fp2->findClosest(fvp1->vertex->coords);
@@ -266,7 +251,7 @@ namespace DLFL {
 				fp1->getEdges(eparray1); fp2->getEdges(eparray2);
       }
       connectFaces(obj,fvp1,fvp2);
-      crustfp1[index] = crustfp2[index] = NULL; // These face pointers are no longer valid
+      crust.fp1[index] = crust.fp2[index] = NULL; // These face pointers are no longer valid
 
       // Do the cleanup if required
       if ( cleanup ) {
@@ -274,6 +259,7 @@ namespace DLFL {
 				int num_edges = eparray1.size();
 				DLFLEdgePtr ep1, ep2;
 				DLFLFacePtr fp11,fp12,fp21,fp22;
+				DLFLBatchScope batch(obj);
 				for (int i=0; i < num_edges; ++i) {
 				  ep1 = eparray1[i]; ep2 = eparray2[num_edges-i-1];
 				  ep1->getFacePointers(fp11,fp12); ep2->getFacePointers(fp21,fp22);
@@ -299,48 +285,41 @@ namespace DLFL {
 		
 	}
 
-  void createCrustForWireframe(DLFLObjectPtr obj, double thickness) {
+  void createCrustForWireframe(DLFLObjectPtr obj, CrustInfo& crust, double thickness) {
 	
 		bool uniform = true;
 		
     if ( !isNonZero(thickness) ) return;
 
     // Clear the arrays used to store crust modeling information
-    crustfp1.clear(); crustfp2.clear();
+    crust.clear();
 
     // Resize the arrays to appropriate size
-    crust_num_old_faces = obj->num_faces();
-    crustfp1.resize(crust_num_old_faces,NULL);
-    crustfp2.resize(crust_num_old_faces,NULL);
+    crust.num_old_faces = obj->num_faces();
+    crust.fp1.resize(crust.num_old_faces,NULL);
+    crust.fp2.resize(crust.num_old_faces,NULL);
   
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream,mtlstream, true);
-
     int num_old_verts = obj->num_vertices();
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream, mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    DLFLFacePtrArray newfaces;
+    obj->appendCopy(*obj,true,NULL,&newfaces);
 
     // Fill the arrays storing information for crust modeling
     // Since we are traversing the faces, also compute and store
     // the normals at corners of each face for use later
-    DLFLFacePtrList::iterator fl_first, fl_last;
+    DLFLFacePtrList::iterator fl_first;
     DLFLFacePtr fp;
     int num_faces = 0;
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( num_faces < crust_num_old_faces ) {
+    fl_first = obj->beginFace();
+    while ( num_faces < crust.num_old_faces ) {
       fp = *fl_first;
-      crustfp1[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
+      crust.fp1[num_faces] = fp; fp->storeNormals();
       ++fl_first; ++num_faces;
     }
-    num_faces = 0; 
-    while ( fl_first != fl_last ) {
-      fp = *fl_first;
-      crustfp2[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
-      ++fl_first; ++num_faces;
+    for (num_faces=0; num_faces < crust.num_old_faces; ++num_faces) {
+      fp = newfaces[num_faces];
+      crust.fp2[num_faces] = fp; fp->storeNormals();
     }
 
     // If thickness is negative move the old vertices outward
@@ -485,48 +464,41 @@ namespace DLFL {
     }
 
     // Find and store the min. id for the face list
-    crust_min_face_id = (obj->firstFace())->getID();
+    crust.min_face_id = (obj->firstFace())->getID();
   }
 
-  void createCrustForWireframe2(DLFLObjectPtr obj, double scale_factor) {
+  void createCrustForWireframe2(DLFLObjectPtr obj, CrustInfo& crust, double scale_factor) {
     if ( !isNonZero(scale_factor) ) return;
 
     // Clear the arrays used to store crust modeling information
-    crustfp1.clear(); crustfp2.clear();
+    crust.clear();
 
     // Resize the arrays to appropriate size
-    crust_num_old_faces = obj->num_faces();
-    crustfp1.resize(crust_num_old_faces,NULL);
-    crustfp2.resize(crust_num_old_faces,NULL);
+    crust.num_old_faces = obj->num_faces();
+    crust.fp1.resize(crust.num_old_faces,NULL);
+    crust.fp2.resize(crust.num_old_faces,NULL);
   
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream,mtlstream, true);
-
     int num_old_verts = obj->num_vertices();
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream,mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    DLFLFacePtrArray newfaces;
+    obj->appendCopy(*obj,true,NULL,&newfaces);
 
     // Fill the arrays storing information for crust modeling
     // Since we are traversing the faces, also compute and store
     // the normals at corners of each face for use later
-    DLFLFacePtrList::iterator fl_first, fl_last;
+    DLFLFacePtrList::iterator fl_first;
     DLFLFacePtr fp;
     int num_faces = 0;
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( num_faces < crust_num_old_faces ) {
+    fl_first = obj->beginFace();
+    while ( num_faces < crust.num_old_faces ) {
       fp = *fl_first;
-      crustfp1[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
+      crust.fp1[num_faces] = fp; fp->storeNormals();
       ++fl_first; ++num_faces;
     }
-    num_faces = 0; 
-    while ( fl_first != fl_last ) {
-      fp = *fl_first;
-      crustfp2[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
-      ++fl_first; ++num_faces;
+    for (num_faces=0; num_faces < crust.num_old_faces; ++num_faces) {
+      fp = newfaces[num_faces];
+      crust.fp2[num_faces] = fp; fp->storeNormals();
     }
 
     // If scale_factor is negative move the old vertices outward
@@ -642,7 +614,7 @@ namespace DLFL {
     }
 
     // Find and store the min. id for the face list
-    crust_min_face_id = (obj->firstFace())->getID();
+    crust.min_face_id = (obj->firstFace())->getID();
   }
 
   void createWireframeWithSegments(DLFLObjectPtr obj, double thickness, int numSides) {
@@ -670,13 +642,9 @@ namespace DLFL {
 
     bool match,jointCreated,vertListSizeMatch,allFacesMatched;
     float dist1, dist, tolerence = 0.0001;
-    StringStream dlflstream;
-    StringStream mtlstream;
-
-    obj->writeDLFL(dlflstream,mtlstream,false);
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream,mtlstream, true);
+    // Number all the edges consecutively, min_edge_id below relies on it
+    obj->makeUnique();
 
     num_original_edges = obj->num_edges();
     edge_connect_normals.reserve(2*num_original_edges);
@@ -1055,7 +1023,7 @@ namespace DLFL {
     edge_connect_fparray.clear();
   }
 
-  void tagMatchingFaces(DLFLObjectPtr obj, DLFLFacePtr fptr) {
+  void tagMatchingFaces(DLFLObjectPtr obj, const CrustInfo& crust, DLFLFacePtr fptr) {
     DLFLFacePtrList::iterator fl_first=obj->beginFace(), fl_last = obj->endFace();
     DLFLFacePtr fp;
     int facevalence = fptr->size();
@@ -1065,8 +1033,8 @@ namespace DLFL {
     // Look at only the outer crust
     while ( fl_first != fl_last ) {
       fp = (*fl_first); ++fl_first; ++count;
-      index = fp->getID() - crust_min_face_id;
-      if ( index < crustfp1.size() ) {
+      index = fp->getID() - crust.min_face_id;
+      if ( index >= 0 && index < crust.num_old_faces ) {
 	if ( fp->size() == facevalence ) fp->setType(FTHole);
       }
       else {
@@ -1135,7 +1103,7 @@ namespace DLFL {
 		}
 	}
 
-  void punchHoles( DLFLObjectPtr obj ) {
+  void punchHoles( DLFLObjectPtr obj, CrustInfo& crust ) {
     // Go through list of faces and punch holes through faces that have type
     // flag set to FTHole
     // Assumes that the crust has already been created.
@@ -1153,7 +1121,7 @@ namespace DLFL {
     while ( fl_first != fl_last ) {
       fp = (*fl_first); ++fl_first;
       fp->resetType();
-      cmMakeHole(obj, fp,true);
+      cmMakeHole(obj,crust,fp,true);
     }
   }
 
@@ -1167,10 +1135,11 @@ namespace DLFL {
     if ( split ) splitValence2Vertices(obj,-1.0);
   
     // Create a crust with specified thickness
-    createCrustForWireframe(obj,crust_thickness);
+    CrustInfo crust;
+    createCrustForWireframe(obj,crust,crust_thickness);
 
     // Punch holes to get the wireframe
-    punchHoles(obj);
+    punchHoles(obj,crust);
   }
 
   void makeWireframe2(DLFLObjectPtr obj, double crust_thickness, double crust_width, bool split) {
@@ -1183,10 +1152,11 @@ namespace DLFL {
     if ( split ) splitValence2Vertices(obj,-1.0);
   
     // Create a crust with specified thickness
-    createCrustForWireframe(obj,crust_thickness);
+    CrustInfo crust;
+    createCrustForWireframe(obj,crust,crust_thickness);
 
     // Punch holes to get the wireframe
-    punchHoles(obj);
+    punchHoles(obj,crust);
   }
 
   void makeWireframeWithColumns(DLFLObjectPtr obj, double wireframe_thickness, int wireframe_segments) {
@@ -33,15 +33,33 @@
 
 namespace DLFL {
 
-  static DLFLFacePtrArray crustfp1;
-  static DLFLFacePtrArray crustfp2;
-  static int crust_num_old_faces;
-  static int crust_min_face_id;
+  // Crust modeling state. The createCrust functions fill it in, cmMakeHole and
+  // punchHoles use it to find the matching faces of the outer and inner surface.
+  // Kept by the caller, so crusts on different objects don't share anything
+  struct CrustInfo {
+    DLFLFacePtrArray fp1;   // Faces of the original surface
+    DLFLFacePtrArray fp2;   // Matching faces of the duplicated surface
+    int num_old_faces;      // Number of faces before the crust was made
+    int min_face_id;        // ID of the first face, face IDs are consecutive after that
 
-  static DLFLVertexPtrArray crustvp1;
-  static DLFLVertexPtrArray crustvp2;
-  static int crust_min_vert_id;
-  static int crust_num_old_verts;
+    CrustInfo()
+      : fp1(), fp2(), num_old_faces(0), min_face_id(0)
+    {}
+
+    void clear() {
+      fp1.clear(); fp2.clear(); num_old_faces = 0; min_face_id = 0;
+    }
+
+    // Index of the face pair containing the given face, -1 if the face is not
+    // one of the crust faces (eg. one created by punching a hole)
+    int index(DLFLFacePtr fp) const {
+      int i = fp->getID() - min_face_id;
+      if ( i >= num_old_faces ) i -= num_old_faces;
+      if ( i < 0 || i >= (int)fp1.size() ) return -1;
+      if ( fp1[i] != fp && fp2[i] != fp ) return -1;
+      return i;
+    }
+  };
 
   /*
     Create a crust for this object.
@@ -52,7 +70,7 @@ namespace DLFL {
     which means thickness at vertices will be adjusted to account
     for normal averaging.
   */
-  void createCrust(const DLFLObjectPtr obj, double thickness, bool uniform = true);
+  void createCrust(const DLFLObjectPtr obj, CrustInfo& crust, double thickness, bool uniform = true);
 
   /*
     Create a crust for this object.
@@ -60,18 +78,18 @@ namespace DLFL {
     duplicating the existing surface and scaling the inner or outer surface
     w.r.t centroid of object.
   */
-  void createCrustWithScaling(DLFLObjectPtr obj, double scale_factor = 0.9 );
-  void cmMakeHole(DLFLObjectPtr obj, DLFLFacePtr fp, bool cleanup = true );
-  void createCrustForWireframe(DLFLObjectPtr obj, double thickness = 0.1 );
-  void createCrustForWireframe2(DLFLObjectPtr obj, double scale_factor = 0.1 );
+  void createCrustWithScaling(DLFLObjectPtr obj, CrustInfo& crust, double scale_factor = 0.9 );
+  void cmMakeHole(DLFLObjectPtr obj, CrustInfo& crust, DLFLFacePtr fp, bool cleanup = true );
+  void createCrustForWireframe(DLFLObjectPtr obj, CrustInfo& crust, double thickness = 0.1 );
+  void createCrustForWireframe2(DLFLObjectPtr obj, CrustInfo& crust, double scale_factor = 0.1 );
   void createWireframeWithSegments(DLFLObjectPtr obj, double thickness = 0.1, int numSides = 4);
-	void tagMatchingFaces(DLFLObjectPtr obj, DLFLFacePtr fptr);
+	void tagMatchingFaces(DLFLObjectPtr obj, const CrustInfo& crust, DLFLFacePtr fptr);
 	void selectMatchingFaces(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray);
 	void selectMatchingEdges(DLFLObjectPtr obj, DLFLEdgePtr eptr, DLFLEdgePtrArray &eparray);
 	void selectMatchingVertices(DLFLObjectPtr obj, DLFLVertexPtr vptr, DLFLVertexPtrArray &vparray);
 	void selectFacesByArea(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta = 0.1);
 	void selectFacesByColor(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta = 0.0);
-  void punchHoles(DLFLObjectPtr obj);
+  void punchHoles(DLFLObjectPtr obj, CrustInfo& crust);
   void makeWireframe(DLFLObjectPtr obj, double crust_thickness = 0.1, bool split = true );
   void makeWireframe2(DLFLObjectPtr obj, double crust_thickness = 0.1, double crust_width = 0.1, bool split = true );
   void makeWireframeWithColumns(DLFLObjectPtr obj, double wireframe_thickness, int wireframe_segments);
@@ -34,6 +34,7 @@
 #include "DLFLDual.hh"
 #include "DLFLSubdiv.hh"
 #include <DLFLCore.hh>
+#include <DLFLProgress.hh>
 
 namespace DLFL {
 
@@ -79,12 +80,15 @@ namespace DLFL {
       StringStream rw,mw;
 			obj->writeMTL(mw);
 
+      DLFLProgress::begin("Dual",obj->num_faces()+obj->num_vertices());
+
       // Traverse all faces, find centroid and output to stream
-      // Also call makeUnique to ensure face ids are consecutive
+      // Also call makeFacesUnique to ensure face ids are consecutive
+      obj->makeFacesUnique();
       fl_first = obj->beginFace(); fl_last = obj->endFace();
       while( fl_first != fl_last ) {
+				if ( !DLFLProgress::step() ) return;
 				fp = (*fl_first); ++fl_first;
-				fp->makeUnique();
 				cen = fp->geomCentroid();	   
 				rw << "v " << cen[0] << " " << cen[1] << " " << cen[2] << endl;
       }
@@ -100,6 +104,7 @@ namespace DLFL {
 
       vl_first = obj->beginVertex(); vl_last = obj->endVertex();
       while ( vl_first != vl_last ) {
+	if ( !DLFLProgress::step() ) return;
 	vp = (*vl_first); ++vl_first;
 	// Get the face vertices pointing to this vertex in an array
 	vp->getFaceVertices(fvparray);
@@ -50,35 +50,36 @@ namespace DLFL {
 
 		// First compute the coordinates of the vertices of the new points and store
 		// them in an array
-		DLFLFaceVertexPtr head;
-		head = fptr->front();
-		if ( head ) {
-			Vector3d ndir = normalized(dir);//p-p-0o9i
-			Vector3dArray newverts;
+		Vector3dArray newverts;
+		if ( duplicateFaceCoords(fptr,dir,offset,rot,sf,newverts) )
+			endface = duplicateFace(obj,fptr,newverts);
+		return endface;
+	}
+
+	bool duplicateFaceCoords(DLFLFacePtr fptr, const Vector3d& dir, double offset, double rot, double sf, Vector3dArray& newverts) {
+		// Coordinates of the corners of the given face offset, scaled and rotated
+		// Only reads the face, so it can be called for many faces at once.
+		DLFLFaceVertexPtr head = fptr->front();
+		newverts.clear();
+		if ( !head ) return false;
 
-			fptr->getVertexCoords(newverts);
+		Vector3d ndir = normalized(dir);
+		fptr->getVertexCoords(newverts);
 
-			// Scale the new vertices about their centroid if scale factor is not 1.0 or 0.0
-			sf = Abs(sf);
-			if ( isNonZero(sf) && ( Abs(sf-1.0) > ZERO ) ) 
-				scale(newverts,sf);
+		// Scale the new vertices about their centroid if scale factor is not 1.0 or 0.0
+		sf = Abs(sf);
+		if ( isNonZero(sf) && ( Abs(sf-1.0) > ZERO ) ) 
+			scale(newverts,sf);
        
-			// Rotate the new vertices if rotation is not 0.0
-			if ( isNonZero(rot) ) 
-				rotate(newverts,ndir,rot*M_PI/180.0);
+		// Rotate the new vertices if rotation is not 0.0
+		if ( isNonZero(rot) ) 
+			rotate(newverts,ndir,rot*M_PI/180.0);
        
-			// Translate the new vertices by given amount along given direction
-			if ( Abs(offset) > ZERO ) {
-				translate(newverts,ndir,offset);
-			}
-
-			obj->createFace(newverts,fptr->material());
-
-			// Get pointer to the first newly created face (second from last)
-			DLFLFacePtrList::reverse_iterator rfirst = obj->rbeginFace();
-			++rfirst; endface = (*rfirst);
+		// Translate the new vertices by given amount along given direction
+		if ( Abs(offset) > ZERO ) {
+			translate(newverts,ndir,offset);
 		}
-		return endface;
+		return true;
 	}
 
 	DLFLFacePtr duplicateFacePlanarOffset(DLFLObjectPtr obj, DLFLFacePtr fptr, double offset, double rot, double thickness, bool fractionalthickness) {
@@ -89,6 +90,104 @@ namespace DLFL {
 		return duplicateFacePlanarOffset(obj,fptr,dir,offset,rot,thickness,fractionalthickness);
 	}
 
+	bool planarOffsetCoords(DLFLFacePtr fptr, double thickness, bool fractionalthickness, Vector3dArray& newverts) {
+		// Coordinates of the corners of the given face offset in the plane of the face
+		// along the angular bisectors by the specified thickness.
+		// Only reads the face, so it can be called for many faces at once.
+		DLFLFaceVertexPtr head = fptr->front();
+		newverts.clear();
+		if ( !head ) return false;
+		fptr->getVertexCoords(newverts);
+
+		// Offset the corners by thickness using the edge vectors to determine direction
+		// If boolean flag is set thickness is assumed to be a fraction of edge length.
+		// Traverse the face and the coordinate array simultaneously and adjust coordinates
+		int i=0;//, numverts=newverts.size();
+		Vector3d pvec, nvec, ovec;
+		DLFLFaceVertexPtr fvp = head;
+
+		// Put if statement outside of loop for speed
+		if ( fractionalthickness ) {
+			// Thickness is relative to edge lengths, use fractions of edge vectors
+			do {
+				fvp->getEdgeVectors(pvec,nvec); // Edge vectors originating at fvp
+
+				// If fvp is a winged corner we need to find the new coordinates differently
+				if ( fvp->isWingedCorner() ) {
+					// Find the next non-winged corner. It can be concave or convex
+					DLFLFaceVertexPtr nwfvp = fvp->nextNonWingedCorner();
+					if ( nwfvp == NULL ) {
+						// This situation should not occur
+						cout << "Something went wrong somewhere..." << endl;
+						return false;
+					}
+
+					// Find the normal at this non-winged corner.
+					// Normal will be adjusted for concave corners
+					Vector3d nwfvpn = nwfvp->computeNormal();
+
+					// Use this normal to find a vector starting at fvp
+					// and pointing into the face and perpendicular to
+					// the two edges coincident at fvp
+					// This will be the offset vector direction
+					ovec = nwfvpn % nvec; normalize(ovec);
+					ovec *= thickness;
+				} else {
+					// Compute the offset vector using the edge vectors
+					ovec = thickness*(pvec + nvec);
+
+					// If this corner is a concave corner, flip the offset vector
+					if ( fvp->isConcaveCorner() ) ovec = -ovec;
+				}
+
+				// Adjust the coordinates of the new vertex using the offset vector
+				newverts[i] += ovec;
+				fvp = fvp->next(); i++;
+			} while ( fvp != head );
+		} else {
+			// Thichness is absolute, use the normalized edge vectors
+			do {
+				fvp->getEdgeVectors(pvec,nvec); // Edge vectors originating at fvp
+
+				normalize(pvec); normalize(nvec);
+
+				// If fvp is a winged corner we need to find the new coordinates differently
+				if ( fvp->isWingedCorner() ) {
+					// Find the next non-winged corner. It can be concave or convex
+					DLFLFaceVertexPtr nwfvp = fvp->nextNonWingedCorner();
+					if ( nwfvp == NULL ) {
+						// This situation should not occur
+						cout << "Something went wrong somewhere..." << endl;
+						return false;
+					}
+
+					// Find the normal at this non-winged corner.
+					// Normal will be adjusted for concave corners
+					Vector3d nwfvpn = nwfvp->computeNormal();
+
+					// Use this normal to find a vector starting at fvp
+					// and pointing into the face and perpendicular to
+					// the two edges coincident at fvp
+					// This will be the offset vector direction
+					ovec = nwfvpn % nvec;
+					ovec *= thickness;
+				} else {
+					// Compute the offset vector using the edge vectors
+					ovec = thickness*(pvec + nvec);
+
+					// If this corner is a concave corner, flip the offset vector
+					if ( fvp->isConcaveCorner() ) 
+						ovec = -ovec;
+				}
+
+				// Adjust the coordinates of the new vertex using the offset vector
+				newverts[i] += ovec;
+				fvp = fvp->next(); i++;
+			} while ( fvp != head );
+		}
+		return true;
+	}
+
 	DLFLFacePtr duplicateFacePlanarOffset(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3d& dir, double offset, double rot, double thickness, bool fractionalthickness) {
 		// Duplicate given face, offsetting (along normal), and rotating if necessary
 		// Offset the vertices in the plane of the face along
@@ -98,100 +197,9 @@ namespace DLFL {
 
 		// First compute the coordinates of the vertices of the new points and store
 		// them in an array
-		DLFLFaceVertexPtr head,fvp;
-		head = fptr->front();
-		if ( head ) {
+		Vector3dArray newverts;
+		if ( planarOffsetCoords(fptr,thickness,fractionalthickness,newverts) ) {
 			Vector3d ndir = normalized(dir);
-			Vector3dArray newverts;
-
-			fptr->getVertexCoords(newverts);
-
-			// Offset the corners by thickness using the edge vectors to determine direction
-			// If boolean flag is set thickness is assumed to be a fraction of edge length.
-			// Traverse the face and the coordinate array simultaneously and adjust coordinates
-			int i=0;//, numverts=newverts.size();
-			Vector3d pvec, nvec, ovec;
-			fvp = head;
-
-			// Put if statement outside of loop for speed
-			if ( fractionalthickness ) {
-				// Thickness is relative to edge lengths, use fractions of edge vectors
-				do {
-					fvp->getEdgeVectors(pvec,nvec); // Edge vectors originating at fvp
-
-					// If fvp is a winged corner we need to find the new coordinates differently
-					if ( fvp->isWingedCorner() ) {
-						// Find the next non-winged corner. It can be concave or convex
-						DLFLFaceVertexPtr nwfvp = fvp->nextNonWingedCorner();
-						if ( nwfvp == NULL ) {
-							// This situation should not occur
-							cout << "Something went wrong somewhere..." << endl;
-							return NULL;
-						}
-
-						// Find the normal at this non-winged corner.
-						// Normal will be adjusted for concave corners
-						Vector3d nwfvpn = nwfvp->computeNormal();
-
-						// Use this normal to find a vector starting at fvp
-						// and pointing into the face and perpendicular to
-						// the two edges coincident at fvp
-						// This will be the offset vector direction
-						ovec = nwfvpn % nvec; normalize(ovec);
-						ovec *= thickness;
-					} else {
-						// Compute the offset vector using the edge vectors
-						ovec = thickness*(pvec + nvec);
-
-						// If this corner is a concave corner, flip the offset vector
-						if ( fvp->isConcaveCorner() ) ovec = -ovec;
-					}
-
-					// Adjust the coordinates of the new vertex using the offset vector
-					newverts[i] += ovec;
-					fvp = fvp->next(); i++;
-				} while ( fvp != head );
-			} else {
-				// Thichness is absolute, use the normalized edge vectors
-				do {
-					fvp->getEdgeVectors(pvec,nvec); // Edge vectors originating at fvp
-
-					normalize(pvec); normalize(nvec);
-
-					// If fvp is a winged corner we need to find the new coordinates differently
-					if ( fvp->isWingedCorner() ) {
-						// Find the next non-winged corner. It can be concave or convex
-						DLFLFaceVertexPtr nwfvp = fvp->nextNonWingedCorner();
-						if ( nwfvp == NULL ) {
-							// This situation should not occur
-							cout << "Something went wrong somewhere..." << endl;
-							return NULL;
-						}
-
-						// Find the normal at this non-winged corner.
-						// Normal will be adjusted for concave corners
-						Vector3d nwfvpn = nwfvp->computeNormal();
-
-						// Use this normal to find a vector starting at fvp
-						// and pointing into the face and perpendicular to
-						// the two edges coincident at fvp
-						// This will be the offset vector direction
-						ovec = nwfvpn % nvec;
-						ovec *= thickness;
-					} else {
-						// Compute the offset vector using the edge vectors
-						ovec = thickness*(pvec + nvec);
-
-						// If this corner is a concave corner, flip the offset vector
-						if ( fvp->isConcaveCorner() ) 
-							ovec = -ovec;
-					}
-
-					// Adjust the coordinates of the new vertex using the offset vector
-					newverts[i] += ovec;
-					fvp = fvp->next(); i++;
-				} while ( fvp != head );
-			}
 
 			// Rotate the new vertices if rotation is not 0.0
 			if ( isNonZero(rot) ) 
@@ -202,15 +210,31 @@ namespace DLFL {
 				translate(newverts,ndir,offset);
 			}
 
-			obj->createFace(newverts,fptr->material());
-
-			// Get pointer to the first newly created face (second from last)
-			DLFLFacePtrList::reverse_iterator rfirst = obj->rbeginFace();
-			++rfirst; endface = (*rfirst);
+			endface = duplicateFace(obj,fptr,newverts);
 		}
 		return endface;
 	}
 
+	DLFLFacePtr duplicateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3dArray& newverts) {
+		// Duplicate given face with the given coordinates for its corners
+		obj->createFace(newverts,fptr->material());
+
+		// Get pointer to the first newly created face (second from last)
+		DLFLFacePtrList::reverse_iterator rfirst = obj->rbeginFace();
+		++rfirst;
+		return (*rfirst);
+	}
+
+	DLFLFacePtr extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3dArray& newverts) {
+		// Extrude the given face to a face with the given coordinates for its corners
+		DLFLFacePtr endface = duplicateFace(obj,fptr,newverts);
+
+		// The last face will be the one facing the old face
+		DLFLFacePtr nfp = obj->lastFace();
+		connectFaces(obj,fptr->firstVertex(),nfp->firstVertex());
+		return endface;
+	}
+
 	DLFLFacePtr extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d) {
 		// Extrude the given face along its normal for a given distance
 		Vector3d dir = fptr->computeNormal();
@@ -357,57 +381,52 @@ namespace DLFL {
 
 		// First compute the coordinates of the vertices of the new points and store
 		// them in an array
-		DLFLFaceVertexPtr head;
-		head = fptr->front();
-		if ( head ) {
-			Vector3d ndir = normalized(dir);
-			Vector3dArray oldverts,newverts;
+		Vector3dArray newverts;
+		if ( extrudeFaceDSCoords(fptr,d,dir,twist,sf,newverts) )
+			endface = extrudeFace(obj,fptr,newverts);
+		return endface;
+	}
 
-			fptr->getVertexCoords(oldverts);
-			uint numverts = oldverts.size();           // No. of vertices in original face
+	bool extrudeFaceDSCoords(DLFLFacePtr fptr, double d, const Vector3d& dir, double twist, double sf, Vector3dArray& newverts) {
+		// Coordinates of the corners of the new face of a Doo-Sabin extrusion
+		// Only reads the face, so it can be called for many faces at once.
+		DLFLFaceVertexPtr head = fptr->front();
+		newverts.clear();
+		if ( !head ) return false;
 
-			// New vertices will be computed using the twist factor
-			newverts.resize(numverts,d*ndir);
-			for (int i=0; i < numverts-1; ++i) {
-				newverts[i] += (1.0-twist)*oldverts[i] + twist*oldverts[i+1];
-			}
-			newverts[numverts-1] += (1.0-twist)*oldverts[numverts-1] + twist*oldverts[0];
-
-			double coef;
-			Vector3d p;
-			for (int i=0; i < numverts; ++i) {
-				p.reset();
-				for (int j=0; j < numverts; ++j) {
-					if ( i == j ) 
-						coef = 0.25 + 5.0/(4.0*numverts);
-					else 
-						coef = ( 3.0 + 2.0*cos(2.0*(i-j)*M_PI/numverts) ) / (4.0*numverts);
-					p += coef*newverts[j];
-				}
-				oldverts[i] = p;
-			}
+		Vector3d ndir = normalized(dir);
+		Vector3dArray oldverts,twistverts;
 
-			// Scale the new vertices about their centroid if scale factor is not 1.0 or 0.0
-			sf = Abs(sf);
-			if ( isNonZero(sf) && ( Abs(sf-1.0) > ZERO ) ) 
-				scale(oldverts,sf);
-       
-			obj->createFace(oldverts,fptr->material());
-
-			// Get pointer to the first newly created face (second from last)
-			DLFLFacePtrList::reverse_iterator rfirst = obj->rbeginFace();
-			++rfirst; endface = (*rfirst);
+		fptr->getVertexCoords(oldverts);
+		uint numverts = oldverts.size();           // No. of vertices in original face
 
-			// Get the pointer to the second newly inserted face
-			DLFLFacePtr nfp = obj->lastFace();
-       
-			// The last face will be the one facing the old face
-			// Find the first face-vertices in the 2 faces to be connected
-			DLFLFaceVertexPtr fvp1, fvp2;
-			fvp1 = fptr->firstVertex(); fvp2 = nfp->firstVertex();
-			connectFaces(obj,fvp1,fvp2);
+		// New vertices will be computed using the twist factor
+		twistverts.resize(numverts,d*ndir);
+		for (int i=0; i < numverts-1; ++i) {
+			twistverts[i] += (1.0-twist)*oldverts[i] + twist*oldverts[i+1];
 		}
-		return endface;
+		twistverts[numverts-1] += (1.0-twist)*oldverts[numverts-1] + twist*oldverts[0];
+
+		double coef;
+		Vector3d p;
+		newverts.resize(numverts);
+		for (int i=0; i < numverts; ++i) {
+			p.reset();
+			for (int j=0; j < numverts; ++j) {
+				if ( i == j ) 
+					coef = 0.25 + 5.0/(4.0*numverts);
+				else 
+					coef = ( 3.0 + 2.0*cos(2.0*(i-j)*M_PI/numverts) ) / (4.0*numverts);
+				p += coef*twistverts[j];
+			}
+			newverts[i] = p;
+		}
+
+		// Scale the new vertices about their centroid if scale factor is not 1.0 or 0.0
+		sf = Abs(sf);
+		if ( isNonZero(sf) && ( Abs(sf-1.0) > ZERO ) ) 
+			scale(newverts,sf);
+		return true;
 	}
 
 	DLFLFacePtr extrudeFaceDS(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, int num, double twist, double sf) {
@@ -440,60 +459,72 @@ namespace DLFL {
 
 		// First compute the coordinates of the vertices of the new points and store
 		// them in an array
-		DLFLFaceVertexPtr head;
-		head = fptr->front();
-		if ( head ) {
-			Vector3d ndir = normalized(dir);
-			Vector3dArray newverts;
+		Vector3dArray newverts;
+		if ( dualFaceCoords(fptr,d,dir,rot,sf,newverts) )
+			endface = extrudeDualFace(obj,fptr,newverts,mesh);
+		return endface;
+	}
 
-			// If mesh flag is true, edges in the original face will be deleted.
-			// Store those edges in a temporary array
-			DLFLEdgePtrArray ep_arr;
-			if ( mesh ) fptr->getEdges(ep_arr);
+	bool dualFaceCoords(DLFLFacePtr fptr, double d, const Vector3d& dir, double rot, double sf, Vector3dArray& newverts) {
+		// Coordinates of the corners of the new face of a dual extrusion
+		// Only reads the face, so it can be called for many faces at once.
+		DLFLFaceVertexPtr head = fptr->front();
+		newverts.clear();
+		if ( !head ) return false;
 
-			// New face will contain the midpoints of edges of old face, appropriately transformed
-			DLFLFaceVertexPtr current = head;
+		Vector3d ndir = normalized(dir);
+
+		// New face will contain the midpoints of edges of old face, appropriately transformed
+		DLFLFaceVertexPtr current = head;
+		newverts.push_back(current->getEdgePtr()->getMidPoint() + d*ndir);
+		current = current->next();
+		while ( current != head ) {
 			newverts.push_back(current->getEdgePtr()->getMidPoint() + d*ndir);
 			current = current->next();
-			while ( current != head ) {
-				newverts.push_back(current->getEdgePtr()->getMidPoint() + d*ndir);
-				current = current->next();
-			}
+		}
 
-			// Scale the new vertices about their centroid if scale factor is not 1.0 or 0.0
-			sf = Abs(sf);
-			if ( isNonZero(sf) && ( Abs(sf-1.0) > ZERO ) ) 
-				scale(newverts,sf);
+		// Scale the new vertices about their centroid if scale factor is not 1.0 or 0.0
+		sf = Abs(sf);
+		if ( isNonZero(sf) && ( Abs(sf-1.0) > ZERO ) ) 
+			scale(newverts,sf);
        
-			// Rotate the new vertices if rotation is not 0.0
-			if ( isNonZero(rot) ) 
-				rotate(newverts,ndir,rot*M_PI/180.0);
+		// Rotate the new vertices if rotation is not 0.0
+		if ( isNonZero(rot) ) 
+			rotate(newverts,ndir,rot*M_PI/180.0);
+		return true;
+	}
 
-			// Create the new face(s)
-			obj->createFace(newverts,fptr->material());
+	DLFLFacePtr extrudeDualFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3dArray& newverts, bool mesh) {
+		// Dual extrusion of the given face to a face with the given coordinates for its corners
+		// If mesh flag is true, edges in the original face will be deleted.
+		// Store those edges in a temporary array
+		DLFLEdgePtrArray ep_arr;
+		if ( mesh ) fptr->getEdges(ep_arr);
 
-			// Get pointers to the newly created faces
-			DLFLFacePtrList::reverse_iterator rfirst = obj->rbeginFace();
-			DLFLFacePtr nfp = (*rfirst);
-			++rfirst;
-			endface = (*rfirst);
+		// Create the new face(s)
+		obj->createFace(newverts,fptr->material());
 
-			// The last face (nfp) will be the one facing the old face
-			// Find the first face-vertices in the 2 faces to be connected
-			DLFLFaceVertexPtr fvp1, fvp2;
-			fvp1 = fptr->firstVertex(); fvp2 = nfp->firstVertex();
-			dualConnectFaces(obj,fvp1,fvp2);
+		// Get pointers to the newly created faces
+		DLFLFacePtrList::reverse_iterator rfirst = obj->rbeginFace();
+		DLFLFacePtr nfp = (*rfirst);
+		++rfirst;
+		DLFLFacePtr endface = (*rfirst);
 
-			// If the mesh flag is true delete the edges in the original face
-			if ( mesh ) {
-				DLFLEdgePtrArray::iterator el_first, el_last;
-				DLFLEdgePtr ep;
+		// The last face (nfp) will be the one facing the old face
+		// Find the first face-vertices in the 2 faces to be connected
+		DLFLFaceVertexPtr fvp1, fvp2;
+		fvp1 = fptr->firstVertex(); fvp2 = nfp->firstVertex();
+		dualConnectFaces(obj,fvp1,fvp2);
 
-				el_first = ep_arr.begin(); el_last = ep_arr.end();
-				while ( el_first != el_last ) {
-					ep = (*el_first); ++el_first;
-					deleteEdge(obj, ep,true); 
-				}
+		// If the mesh flag is true delete the edges in the original face
+		if ( mesh ) {
+			DLFLEdgePtrArray::iterator el_first, el_last;
+			DLFLEdgePtr ep;
+
+			el_first = ep_arr.begin(); el_last = ep_arr.end();
+			while ( el_first != el_last ) {
+				ep = (*el_first); ++el_first;
+				deleteEdge(obj, ep,true); 
 			}
 		}
 		return endface;
@@ -515,6 +546,10 @@ namespace DLFL {
 	}
 
 	void stellateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir) {
+		stellateFace(obj,fptr,fptr->geomCentroid()+d*dir);
+	}
+
+	void stellateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3d& tip) {
 		// Stellation is like extrusion but creates a cone instead of a cylinder
 		DLFLMaterialPtr matl = fptr->material();
 		DLFLEdgePtr lastedge;
@@ -524,7 +559,7 @@ namespace DLFL {
 		bool done;
 
 		// Create the point sphere which will be the tip of the cone
-		fvp1 = obj->createPointSphere(fptr->geomCentroid()+d*dir,matl);
+		fvp1 = obj->createPointSphere(tip,matl);
 	   
 		fvp2 = fptr->firstVertex();
 
@@ -580,6 +615,120 @@ namespace DLFL {
 		vp->coords += dir * d;
 	}
     
+	//--- Extrusion of many faces ---//
+
+	// Extruding or stellating a face moves none of the existing vertices, and leaves the
+	// corners and edges of the other faces alone, so the new corners for the first
+	// extrusion of every face are found in one parallel pass. The faces are then
+	// extruded in the given order in one batch, which gives the same mesh as extruding
+	// them one after the other. Further extrusions of a face start from its end face.
+
+	void extrudeFaces(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d, int num, double rot, double sf) {
+		int num_faces = fparray.size();
+		if ( num < 1 || num_faces == 0 ) return;
+		vector<Vector3dArray> newverts(num_faces);
+		vector<char> valid(num_faces);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+		for (int i=0; i < num_faces; ++i) {
+			Vector3d dir = fparray[i]->computeNormal();
+			normalize(dir);
+			valid[i] = duplicateFaceCoords(fparray[i],dir,d,rot,sf,newverts[i]);
+		}
+
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < num_faces; ++i) {
+			if ( !valid[i] ) continue;
+			DLFLFacePtr exface = extrudeFace(obj,fparray[i],newverts[i]);
+			if ( num > 1 ) extrudeFace(obj,exface,d,num-1,rot,sf);
+		}
+	}
+
+	void extrudeFacesDS(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d, int num, double twist, double sf) {
+		int num_faces = fparray.size();
+		if ( num < 1 || num_faces == 0 ) return;
+		vector<Vector3dArray> newverts(num_faces);
+		vector<char> valid(num_faces);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+		for (int i=0; i < num_faces; ++i) {
+			Vector3d dir = fparray[i]->computeNormal();
+			normalize(dir);
+			valid[i] = extrudeFaceDSCoords(fparray[i],d,dir,twist,sf,newverts[i]);
+		}
+
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < num_faces; ++i) {
+			if ( !valid[i] ) continue;
+			DLFLFacePtr exface = extrudeFace(obj,fparray[i],newverts[i]);
+			if ( num > 1 ) extrudeFaceDS(obj,exface,d,num-1,twist,sf);
+		}
+	}
+
+	void extrudeDualFaces(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d, int num, double rot, double sf, bool mesh) {
+		int num_faces = fparray.size();
+		if ( num < 1 || num_faces == 0 ) return;
+		DLFLBatchScope batch(obj);
+		if ( mesh ) {
+			// Deleting the edges of a face merges its neighbours with the new
+			// faces around it, so each face has to be looked at in its turn
+			for (int i=0; i < num_faces; ++i)
+				extrudeDualFace(obj,fparray[i],d,num,rot,sf,mesh);
+			return;
+		}
+
+		vector<Vector3dArray> newverts(num_faces);
+		vector<char> valid(num_faces);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+		for (int i=0; i < num_faces; ++i) {
+			Vector3d dir = fparray[i]->computeNormal();
+			normalize(dir);
+			valid[i] = dualFaceCoords(fparray[i],d,dir,rot,sf,newverts[i]);
+		}
+
+		for (int i=0; i < num_faces; ++i) {
+			if ( !valid[i] ) continue;
+			DLFLFacePtr exface = extrudeDualFace(obj,fparray[i],newverts[i],false);
+			if ( num > 1 ) extrudeDualFace(obj,exface,d,num-1,rot,sf,false);
+		}
+	}
+
+	void stellateFaces(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d) {
+		int num_faces = fparray.size();
+		if ( num_faces == 0 ) return;
+		Vector3dArray tips(num_faces);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+		for (int i=0; i < num_faces; ++i) {
+			Vector3d dir = fparray[i]->computeNormal();
+			normalize(dir);
+			tips[i] = fparray[i]->geomCentroid()+d*dir;
+		}
+
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < num_faces; ++i)
+			stellateFace(obj,fparray[i],tips[i]);
+	}
+
+	// The dodecahedral and icosahedral extrusions move the vertices they have
+	// just created, so their geometry can't be found up front. They only share the batch
+	void extrudeFacesDodeca(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double angle, int num, double ex_dist1, double ex_dist2, double ex_dist3, bool hexagonalize) {
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < fparray.size(); ++i)
+			extrudeFaceDodeca(obj,fparray[i],angle,num,ex_dist1,ex_dist2,ex_dist3,hexagonalize);
+	}
+
+	void extrudeFacesIcosa(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double angle, int num, double ex_dist1, double ex_dist2, double ex_dist3) {
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < fparray.size(); ++i)
+			extrudeFaceIcosa(obj,fparray[i],angle,num,ex_dist1,ex_dist2,ex_dist3);
+	}
+
 	//--- Additions by Eric ---//
 	DLFLFacePtr extrudeFaceDodeca(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, int num, double rot, double sf, bool hexagonalize) {
 		// Dodecahedral extrusion
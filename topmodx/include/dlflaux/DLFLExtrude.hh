@@ -40,6 +40,19 @@ namespace DLFL {
   DLFLFacePtr duplicateFacePlanarOffset(DLFLObjectPtr obj, DLFLFacePtr fptr, double offset, double rot, double thickness, bool fractionalthickness);
   DLFLFacePtr duplicateFacePlanarOffset(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3d& dir, double offset, double rot, double thickness, bool fractionalthickness);
 
+  // Duplicate a face using precomputed coordinates for the corners of the new face
+  DLFLFacePtr duplicateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3dArray& newverts);
+
+  // Corners of a face offset in its plane, as used by duplicateFacePlanarOffset.
+  // Doesn't change the object. Returns false if the face is empty or degenerate
+  bool planarOffsetCoords(DLFLFacePtr fptr, double thickness, bool fractionalthickness, Vector3dArray& newverts);
+
+  // Corners of the new face made by duplicateFace, extrudeFaceDS and extrudeDualFace.
+  // Don't change the object. Return false if the face is empty
+  bool duplicateFaceCoords(DLFLFacePtr fptr, const Vector3d& dir, double offset, double rot, double sf, Vector3dArray& newverts);
+  bool extrudeFaceDSCoords(DLFLFacePtr fptr, double d, const Vector3d& dir, double twist, double sf, Vector3dArray& newverts);
+  bool dualFaceCoords(DLFLFacePtr fptr, double d, const Vector3d& dir, double rot, double sf, Vector3dArray& newverts);
+
   /* API
   uint extrudeFace(DLFLObjectPtr obj, uint faceID, double d, int num, double rot, double sf = 1.0);
   uint extrudeFaceDS(DLFLObjectPtr obj, uint faceID, double d, int num, double twist = 0.0, double sf = 1.0);
@@ -58,6 +71,8 @@ namespace DLFL {
   DLFLFacePtr extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, int num);
   DLFLFacePtr extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, double rot, double sf = 1.0);
   DLFLFacePtr extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, int num, double rot, double sf = 1.0);
+  // Extrude a face to precomputed corner coordinates (one per corner, in face order)
+  DLFLFacePtr extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3dArray& newverts);
 
   DLFLFacePtr extrudeFacePlanarOffset(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, double rot, double thickness, bool fractionalthickness);
   DLFLFacePtr extrudeFacePlanarOffset(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, double rot, double thickness, bool fractionalthickness);
@@ -71,9 +86,13 @@ namespace DLFL {
   DLFLFacePtr extrudeDualFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, int num, double rot=0.0, double sf=1.0, bool mesh=false);
   DLFLFacePtr extrudeDualFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, double rot=0.0, double sf=1.0, bool mesh=false);
   DLFLFacePtr extrudeDualFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir, int num, double rot=0.0, double sf=1.0, bool mesh=false);
+  // Dual extrusion to precomputed corner coordinates (see dualFaceCoords)
+  DLFLFacePtr extrudeDualFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3dArray& newverts, bool mesh);
     
   void stellateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d);
   void stellateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d, const Vector3d& dir);
+  // Stellate a face with the tip of the cone at the given point
+  void stellateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, const Vector3d& tip);
 
   void doubleStellateFace(DLFLObjectPtr obj, DLFLFacePtr fptr, double d);
 
@@ -102,6 +121,16 @@ namespace DLFL {
 
   void extrudeFace(DLFLObjectPtr obj, DLFLFacePtr fptr);
 
+  // Extrude all the given faces, in order, in one batch. The result is the same as
+  // calling the single face version for each face, but the new corners are found
+  // for all faces at once where the extrusion allows it
+  void extrudeFaces(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d, int num, double rot=0.0, double sf=1.0);
+  void extrudeFacesDS(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d, int num, double twist=0.0, double sf=1.0);
+  void extrudeDualFaces(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d, int num, double rot=0.0, double sf=1.0, bool mesh=false);
+  void stellateFaces(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double d);
+  void extrudeFacesDodeca(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double angle, int num, double ex_dist1, double ex_dist2, double ex_dist3, bool hexagonalize);
+  void extrudeFacesIcosa(DLFLObjectPtr obj, const DLFLFacePtrArray& fparray, double angle, int num, double ex_dist1, double ex_dist2, double ex_dist3);
+
 	void extrudeFaceDome(DLFLObjectPtr obj, DLFLFacePtr fptr, double length, double rot=0.0, double sf=1.0);
 
 } // end namespace DLFL
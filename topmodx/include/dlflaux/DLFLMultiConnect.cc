@@ -37,15 +37,16 @@
 #include <DLFLCore.hh>
 #include <DLFLCoreExt.hh>
 #include <DLFLObject.hh>
+#include <DLFLProgress.hh>
 #include "DLFLConvexHull.hh"
 #include "DLFLConnect.hh"
 #include "DLFLCrust.hh"
 #include "DLFLExtrude.hh"
 
+#include <set>
+
 namespace DLFL {
 
-	DLFLEdgePtr HalfEdgePair::last_connected1 = NULL;
-	DLFLEdgePtr HalfEdgePair::last_connected2 = NULL;
 
 	void tripleConnectFaces( DLFLObjectPtr obj, DLFLFacePtr fp1, DLFLFacePtr fp2, DLFLFacePtr fp3){ 
 		// Connect 3 faces. Connects closest edges between each pair of faces
@@ -197,9 +198,7 @@ namespace DLFL {
 
 			// Remove all HalfEdgePairs from heparray which contain any of the
 			// two edges in hep
-		HalfEdgePair::last_connected1 = hep.ep1;
-		HalfEdgePair::last_connected2 = hep.ep2;
-		heparray.erase(remove_if(heparray.begin(), heparray.end(), contains_connected),heparray.end());
+		heparray.erase(remove_if(heparray.begin(), heparray.end(), ContainsConnected(hep.ep1,hep.ep2)),heparray.end());
 	}
 }
 
@@ -218,8 +217,8 @@ void multiConnectFaces(DLFLObjectPtr obj, DLFLFacePtrArray fp) {
 	}
 	cen_cen /= num_faces;
 
-	DLFLEdgePtrList cedges; // Use linked list, not array, to simplify erase operations
-	DLFLFacePtrList cfaces; // Faces for candidate edges (we need half-edges to connect)
+	DLFLEdgePtrArray cedges;
+	DLFLFacePtrArray cfaces; // Faces for candidate edges (we need half-edges to connect)
 
 		//--- NOTE ---//
 		// In the list of faces, the other face for the edge is stored, instead of the
@@ -241,103 +240,119 @@ void multiConnectFaces(DLFLObjectPtr obj, DLFLFacePtrArray fp) {
 		}
 	}
 
-		// cedges now contains all the candidate edges
+		// cedges now contains all the candidate edges. Find the face of the
+		// half-edge to be connected for each of them, and its centroid
+	int num_cedges = cedges.size();
+	DLFLFacePtrArray cofaces(num_cedges);
+	Vector3dArray cocen(num_cedges);
+	for (int i=0; i < num_cedges; ++i) {
+		cofaces[i] = cedges[i]->getOtherFacePointer(cfaces[i]);
+		cocen[i] = cofaces[i]->geomCentroid();
+	}
 
 		/*
 	Find all possible connections among the candidate edges
 		Add them to an array of HalfEdgePairs to sort and make
 		connections later. Valid connections are all those between
-		half-edges in different faces
+		half-edges in different faces. Each candidate edge is paired
+		with the ones after it, in a row of its own so the rows can be
+		worked out in parallel and joined in the same order
 		*/
 
-		HalfEdgePairArray heparray;
-	DLFLEdgePtr eptr;
-	DLFLFacePtr fptr;
-	DLFLFacePtrList::iterator fpfirst;
-	DLFLEdgePtrList::iterator epfirst, eplast;
 	double cosangle = cos(5.0*M_PI/180.0); // Tolerance for parallel planes check
 	double min_planarity = cosangle;
-	while ( !cedges.empty() ) {
-		eptr = cedges.front(); cedges.pop_front();
-		fptr = cfaces.front(); cfaces.pop_front();
-
-			// Go through remaining edges. Find edge which is closest
-			// but is not in the same face as ep
-		epfirst = cedges.begin(); eplast = cedges.end();
-		fpfirst = cfaces.begin();
-		DLFLEdgePtr temp_ep;
-		DLFLFacePtr temp_fp, ofp, temp_ofp;
-		while ( epfirst != eplast ) {
-			temp_ep = (*epfirst); temp_fp = (*fpfirst);
-			ofp = eptr->getOtherFacePointer(fptr);
-			temp_ofp = temp_ep->getOtherFacePointer(temp_fp);
-			if ( ofp != temp_ofp ) { // Different faces
-				HalfEdgePair hep(eptr,temp_ep,fptr,temp_fp);
+	vector<HalfEdgePairArray> heprows(num_cedges);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,16)
+#endif
+	for (int i=0; i < num_cedges; ++i) {
+		for (int j=i+1; j < num_cedges; ++j) {
+			if ( cofaces[i] == cofaces[j] ) continue; // Same face
+			HalfEdgePair hep(cedges[i],cedges[j],cfaces[i],cfaces[j]);
 		// Check if plane formed by the two half-edges will be parallel
 		// to the plane formed by the centroid's of the two faces and
 		// the overall centroid calculated above. Also check for planarity
 		// If planarity is less than a specified value, discard the pair
-			Vector3d fpcen, temp_fpcen;
 			Vector3d n; // Normal to above mentioned plane
-			fpcen = ofp->geomCentroid(); temp_fpcen = temp_ofp->geomCentroid();
-			n = normalized( (fpcen-cen_cen)%(temp_fpcen-cen_cen) );
+			n = normalized( (cocen[i]-cen_cen)%(cocen[j]-cen_cen) );
 
 			if ( isNonZero(normsqr(n)) &&
 				(hep.planarity > min_planarity) &&
-			(Abs(n*hep.normal) < cosangle) ) {
+				(Abs(n*hep.normal) < cosangle) ) {
 			// Add this half-edge pair to the array
-				heparray.push_back(hep);
-			} else {
-			// For debug
+				heprows[i].push_back(hep);
 			}
 		}
-		++epfirst; ++fpfirst;
 	}
-}
+
+	HalfEdgePairArray heparray;
+	size_t num_pairs = 0;
+	for (int i=0; i < num_cedges; ++i) num_pairs += heprows[i].size();
+	heparray.reserve(num_pairs);
+	for (int i=0; i < num_cedges; ++i) {
+		heparray.insert(heparray.end(),heprows[i].begin(),heprows[i].end());
+		HalfEdgePairArray().swap(heprows[i]);
+	}
 
 		// Sort heparray according to distance. Use STL stable_sort algorithm
-stable_sort(heparray.begin(), heparray.end(), greater_than);
+	stable_sort(heparray.begin(), heparray.end(), greater_than);
 
 		// Before inserting the new edges, keep count of old edges.
 		// Newly inserted edges will then be checked for redundant ones
 		// and cleaned up if necessary
-int num_old_edges = obj->num_edges();
+	int num_old_edges = obj->num_edges();
 
 		// Go through heparray and start making connections. Once a connection is
-		// made, remove all other HalfEdgePairs which contain already connected edges
+		// made, all other HalfEdgePairs which contain already connected edges
+		// are skipped
 		// NOTE: Traversal is from the end of the array.
-HalfEdgePair hep;
-while ( !heparray.empty() ) {
-	hep = heparray.back(); heparray.pop_back();
+	set<DLFLEdgePtr> connected;
+	for (int i=(int)heparray.size()-1; i >= 0; --i) {
+		const HalfEdgePair& hep = heparray[i];
+		if ( connected.count(hep.ep1) || connected.count(hep.ep2) ) continue;
+
 			// Make connection
+		connectEdges(obj,
+			hep.ep1,(hep.ep1)->getOtherFacePointer(hep.fp1),
+			hep.ep2,(hep.ep2)->getOtherFacePointer(hep.fp2));
+		connected.insert(hep.ep1); connected.insert(hep.ep2);
+	}
 
-	connectEdges(obj,
-		hep.ep1,(hep.ep1)->getOtherFacePointer(hep.fp1),
-		hep.ep2,(hep.ep2)->getOtherFacePointer(hep.fp2));
+		// Go through newly inserted edges and cleanup ones which are redundant
+	DLFLEdgePtrList::iterator el_first, el_last;
+	DLFLEdgePtr newep;
+	DLFLEdgePtrList newedges;
 
-			// Remove all HalfEdgePairs from heparray which contain any of the
-			// two edges in hep
-	HalfEdgePair::last_connected1 = hep.ep1;
-	HalfEdgePair::last_connected2 = hep.ep2;
-	heparray.erase(remove_if(heparray.begin(), heparray.end(), contains_connected),heparray.end());
+	el_first = obj->beginEdge(); el_last = obj->endEdge();
+	advance(el_first,num_old_edges);
+	while ( el_first != el_last ) {
+		newep = (*el_first); ++el_first;
+		newedges.push_back(newep);
+	}
+	edgeCleanup( obj, newedges);
 }
 
-		// Go through newly inserted edges and cleanup ones which are redundant
-DLFLEdgePtrList::iterator el_first, el_last;
-DLFLEdgePtr newep;
-DLFLEdgePtrList newedges;
-
-el_first = obj->beginEdge(); el_last = obj->endEdge();
-advance(el_first,num_old_edges);
-while ( el_first != el_last ) {
-	newep = (*el_first); ++el_first;
-	newedges.push_back(newep);
-}
-edgeCleanup( obj, newedges);
+	// Cell of the grid used to look for coincident points
+struct PointCell {
+	long long x, y, z;
+	PointCell( const Vector3d& p, double size )
+		: x((long long)floor(p[0]/size)), y((long long)floor(p[1]/size)), z((long long)floor(p[2]/size)) { }
+	PointCell( long long a, long long b, long long c ) : x(a), y(b), z(c) { }
+	size_t hash( ) const {
+		return (size_t)(x*73856093LL ^ y*19349663LL ^ z*83492791LL);
+	}
+};
+
+	// Are the two arrays of points exactly the same?
+static bool samePoints( const Vector3dArray& p1, const Vector3dArray& p2 ) {
+	if ( p1.size() != p2.size() ) return false;
+	for (int i=0; i < (int)p1.size(); ++i)
+		if ( p1[i][0] != p2[i][0] || p1[i][1] != p2[i][1] || p1[i][2] != p2[i][2] ) return false;
+	return true;
 }
 
 void multiConnectFaces(DLFLObjectPtr obj, DLFLFacePtrArray fparray, double scale_factor,
-double extrude_dist, bool use_max_offsets) {
+double extrude_dist, bool use_max_offsets, MultiConnectCache *cache) {
 		// Connect multiple faces using convex hull method
 		// scale specifies scale factor for vertices before convex hull is created
 		// extrude specified distance faces should be extruded before convex hull is created
@@ -345,20 +360,55 @@ double extrude_dist, bool use_max_offsets) {
 		// First get vertices from all selected faces.
 		// If two vertices are geometrically concident, only one of them is used for convex hull
 	Vector3dArray vertices;
-	Vector3dArray face_vertices;
-	Vector3d p1,p2,facenormal,extrudevec;
+	vector<Vector3dArray> face_vertices;
+	Vector3d p1,facenormal,extrudevec;
 	DLFLFacePtr fp;
 	int num_sel_faces = fparray.size();
+	int num_corners = 0;
 	DoubleArray max_extrude_distances;
 
+	if ( num_sel_faces == 0 ) return;
+
+	face_vertices.resize(num_sel_faces);
+	for (int i=0; i < num_sel_faces; ++i) {
+		fparray[i]->getVertexCoords(face_vertices[i]);
+		num_corners += face_vertices[i].size();
+	}
+
 	max_extrude_distances.resize(num_sel_faces,extrude_dist);
 
-	if ( use_max_offsets ) 
-		findMaxOffsets(fparray,max_extrude_distances);
+	if ( use_max_offsets ) {
+		if ( cache ) {
+				// The offsets only depend on the coordinates of the faces
+			Vector3dArray facepoints;
+			vector<int> facesizes(num_sel_faces);
+			facepoints.reserve(num_corners);
+			for (int i=0; i < num_sel_faces; ++i) {
+				facepoints.insert(facepoints.end(),face_vertices[i].begin(),face_vertices[i].end());
+				facesizes[i] = face_vertices[i].size();
+			}
+			if ( !cache->offsetsvalid || cache->facesizes != facesizes || !samePoints(cache->facepoints,facepoints) ) {
+				findMaxOffsets(fparray,cache->maxoffsets);
+				cache->facepoints.swap(facepoints); cache->facesizes.swap(facesizes);
+				cache->offsetsvalid = true;
+			}
+			max_extrude_distances = cache->maxoffsets;
+		} else findMaxOffsets(fparray,max_extrude_distances);
+	}
+
+		// Points which were added go into a grid of cells as large as the
+		// distance below which two points are coincident, so a point only
+		// has to be checked against the ones in the 27 cells around it
+	double maxdist = 1.0e-4;
+	double cellsize = sqrt(maxdist);
+	size_t tablesize = 1;
+	while ( tablesize < 2*(size_t)num_corners ) tablesize <<= 1;
+	vector<int> bucket(tablesize,-1), chain;
+	chain.reserve(num_corners);
+	vertices.reserve(num_corners);
 
 	for (int i=0; i < num_sel_faces; ++i) {
 		fp = fparray[i];
-		fp->getVertexCoords(face_vertices);
 		facenormal = fp->computeNormal();
 		extrudevec = max_extrude_distances[i] * facenormal;
 
@@ -366,52 +416,79 @@ double extrude_dist, bool use_max_offsets) {
 			// maxdist is the square of max distance between 2 points for them to be
 			// considered coincident.
 			// Also extrude the points if extrude_dist is non-zero
-		double maxdist = 1.0e-4;
-		for (int j=0; j < (int)face_vertices.size(); ++j) {
-			p1 = face_vertices[j];
+		for (int j=0; j < (int)face_vertices[i].size(); ++j) {
+			p1 = face_vertices[i][j];
 			bool addp1 = true;
-			for (int k=0; k < (int)vertices.size(); ++k) {
-				p2 = vertices[k];
-				if ( normsqr(p1-p2) < maxdist ) {
-					addp1 = false;
-					break;
-				}
-			}
+			PointCell c(p1,cellsize);
+			for (int dx=-1; dx <= 1 && addp1; ++dx)
+				for (int dy=-1; dy <= 1 && addp1; ++dy)
+					for (int dz=-1; dz <= 1 && addp1; ++dz) {
+						PointCell nc(c.x+dx,c.y+dy,c.z+dz);
+						for (int k = bucket[nc.hash() & (tablesize-1)]; k >= 0; k = chain[k])
+							if ( normsqr(p1-vertices[k]) < maxdist ) {
+								addp1 = false;
+								break;
+							}
+					}
 			if ( addp1 == true ) {
 				if ( isNonZero(extrude_dist) ) p1 += extrudevec;
+				size_t h = PointCell(p1,cellsize).hash() & (tablesize-1);
+				chain.push_back(bucket[h]); bucket[h] = vertices.size();
 				vertices.push_back(p1);
 			}
 		}
 	}
 
+		// Find convex hull of the points. Scaling the points about their centroid
+		// scales the hull, so it is found for the points as they are and scaled
+		// afterwards. A hull found for the same points before is used again
+	DLFLConvexHull convexhull;
+	if ( cache ) {
+		if ( !cache->hullvalid || !samePoints(cache->hullpoints,vertices) ) {
+			cache->hull.createHull(vertices);
+				// Do edge cleanup on convex hull to remove redundant edges
+			edgeCleanup(&cache->hull);
+			cache->hullpoints = vertices;
+			cache->hullvalid = true;
+		}
+		convexhull.appendCopy(cache->hull);
+	} else {
+		convexhull.createHull(vertices);
+			// Do edge cleanup on convex hull to remove redundant edges
+		edgeCleanup(&convexhull);
+	}
+
 		// Scale the points for convex hull with centroid as origin using given scale factor
 		// Scaling is done only if scale_factor is non-zero and not equal to 1
+	Vector3d origin = centroid(vertices);
 	scale_factor = Abs(scale_factor);
-	if ( isNonZero(scale_factor) && isNonZero(scale_factor-1.0) )
-		scale(vertices,scale_factor);
-
-		// Find convex hull of the transformed points
-	DLFLConvexHull convexhull;
-	convexhull.createHull(vertices);
-		// Do edge cleanup on convex hull to remove redundant edges
-	edgeCleanup(&convexhull);
+	if ( isNonZero(scale_factor) && isNonZero(scale_factor-1.0) ) {
+		DLFLVertexPtrList::iterator vf = convexhull.beginVertex(), vl = convexhull.endVertex();
+		for (; vf != vl; ++vf) {
+			Vector3d& p = (*vf)->coords;
+			p -= origin; p *= scale_factor; p += origin;
+		}
+	}
 
 		// If convex hull is interior to the original object, it has to be reversed before
 		// making further connections. This can be tested by checking normals of original faces
 		// If the normals point towards the centroid of the convex hull, no reversal is needed.
 		// Only one face needs to be checked
 	Vector3d v1 = fparray[0]->normalCentroid();
-	Vector3d v2 = fparray[0]->geomCentroid() - centroid(vertices); normalize(v2);
+	Vector3d v2 = fparray[0]->geomCentroid() - origin; normalize(v2);
 	if ( v1*v2 > 0.0 ) convexhull.reverse();
 
 		// Go through selected faces and faces of convex hull and find matching ones
 		// to make connections. A match is when a selected face and a face in the convex hull
 		// are parallel to each other AND are facing each other.
 	DLFLFacePtrArray chfparray, fp1array, fp2array;
-	DLFLFacePtr sfp, chfp;
-	Vector3d sfpn, chfpn;
+	DLFLFacePtr chfp;
+	Vector3dArray sfpn(num_sel_faces);
+	Vector3d chfpn;
 
 	fp1array.reserve(num_sel_faces); fp2array.reserve(num_sel_faces);
+	for (int j=0; j < num_sel_faces; ++j)
+		sfpn[j] = fparray[j]->computeNormal();
 
 	convexhull.getFaces(chfparray);
 	int num_ch_faces = chfparray.size();
@@ -420,12 +497,10 @@ double extrude_dist, bool use_max_offsets) {
 		chfp = chfparray[i];
 		chfpn = chfp->computeNormal();
 		for (int j=0; j < num_sel_faces; ++j) {
-			sfp = fparray[j];
-			sfpn = sfp->computeNormal();
 	// Dot product should be -1
-			if ( !isNonZero(1.0 + chfpn*sfpn) ) {
+			if ( !isNonZero(1.0 + chfpn*sfpn[j]) ) {
 		// Matching faces found
-				fp1array.push_back(sfp); fp2array.push_back(chfp);
+				fp1array.push_back(fparray[j]); fp2array.push_back(chfp);
 				break;
 			}
 		}
@@ -621,17 +696,20 @@ void findMaxOffsets( DLFLFacePtrArray fparray, DoubleArray& maxoffsets) {
 		// plane
 
 		// Each face will have a variable number of Planes
-		int numfaces = fparray.size();
+	int numfaces = fparray.size();
 	PlaneArrayArray allfaceplanes;
+	vector<Vector3dArray> allfacepoints;
 	allfaceplanes.resize(numfaces);
+	allfacepoints.resize(numfaces);
 
 	DLFLEdgePtrArray edges;
 	Vector3d facenormal;
 	for (int i=0; i < numfaces; ++i) {
 		int numedges;
-		PlaneArray faceplanes;
+		PlaneArray& faceplanes = allfaceplanes[i];
 
 		fparray[i]->getEdges(edges); facenormal = fparray[i]->computeNormal();
+		fparray[i]->getVertexCoords(allfacepoints[i]);
 		numedges = edges.size();
 
 		faceplanes.resize(numedges);
@@ -644,33 +722,33 @@ void findMaxOffsets( DLFLFacePtrArray fparray, DoubleArray& maxoffsets) {
 			faceplanes[j].origin = origin;
 			faceplanes[j].normal = normal;
 		}
-		allfaceplanes[i] = faceplanes;
 	}
 
 		// Now we have computed Planes for all faces
 		// Go through each face, find distance of each point in face
 		// from Planes of other faces. Find the minimum of these
-		// distances
+		// distances. Each face only writes its own offset, so the
+		// faces are done in parallel
 	maxoffsets.clear();
 	maxoffsets.resize(numfaces);
-	Vector3d facepoint;
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,1)
+#endif
 	for (int i=0; i < numfaces; ++i) {
-		facenormal = fparray[i]->normal; // Normal would have been computed in previous loop
+		Vector3d normal = fparray[i]->normal; // Normal would have been computed in previous loop
+		const Vector3dArray& facepoints = allfacepoints[i];
 
 		double mindist = 1.0e3;
 		for (int j=0; j < numfaces; ++j) {
 			if ( i != j ) {
-				PlaneArray faceplanes = allfaceplanes[j];
-				Vector3dArray facepoints;
-				fparray[i]->getVertexCoords(facepoints);
+				PlaneArray& faceplanes = allfaceplanes[j];
 				for (int k=0; k < (int)faceplanes.size(); ++k) {
-					Plane plane = faceplanes[k];
+					Plane& plane = faceplanes[k];
 					for (int m=0; m < (int)facepoints.size(); ++m) {
-						facepoint = facepoints[m];
 						double t = 0.0;
 
 				// Find intersection of ray (centroid,facenormal) with plane
-						if ( plane.intersect(facepoint,facenormal,t) ) {
+						if ( plane.intersect(facepoints[m],normal,t) ) {
 							if ( Abs(t) < Abs(mindist) ) mindist = t;
 						}
 					}
@@ -767,6 +845,22 @@ void multiConnectMidpoints( DLFLObjectPtr obj ) {
 	}
 }
 
+	// Corners of the given faces scaled about their centroids, where a zero length
+	// extrusion with the same scale factor would put them. Only reads the faces
+static void scaledFaceCoords( const DLFLFacePtrArray& fparray, double scale_factor, vector<Vector3dArray>& coords ) {
+	int num_faces = fparray.size();
+	coords.resize(num_faces);
+	double sf = Abs(scale_factor);
+	bool scaled = isNonZero(sf) && ( Abs(sf-1.0) > ZERO );
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+	for (int i=0; i < num_faces; ++i) {
+		fparray[i]->getVertexCoords(coords[i]);
+		if ( scaled ) scale(coords[i],sf);
+	}
+}
+
 void multiConnectCrust( DLFLObjectPtr obj, double scale_factor) {
 		// Scale surface by given scale factor to form crust.
 		// Then subdivide outer faces using zero-length extrusions
@@ -780,20 +874,25 @@ void multiConnectCrust( DLFLObjectPtr obj, double scale_factor) {
 	else if ( scale_factor > 1.0 ) scale_factor = 1.0;
 
 		// First create scaled crust.
-	createCrustWithScaling(obj,scale_factor);
+	CrustInfo crust;
+	createCrustWithScaling(obj,crust,scale_factor);
 
 		// The crust-modeling arrays would have been filled now.
 		// Go through those arrays and punch holes after doing zero-length extrusion
-		// crustfp1 contains old faces, crustfp2 contains new faces from inner shell
-	int num_holes = crustfp1.size();
+		// crust.fp1 contains old faces, crust.fp2 contains new faces from inner shell
+	int num_holes = crust.fp1.size();
 	DLFLFacePtr fp1, exfp1, fp2;
 	DLFLFaceVertexPtr fvp1, fvp2;
-	Vector3d vec; // For dummy direction vector
+	vector<Vector3dArray> exverts;
+	scaledFaceCoords(crust.fp1,scale_factor,exverts);
+	DLFLProgress::begin("Multi-connect",num_holes);
+	DLFLBatchScope batch(obj);
 	for (int i=0; i < num_holes; ++i) {
-		fp1 = crustfp1[i]; fp2 = crustfp2[i];
+		if ( !DLFLProgress::step() ) return;
+		fp1 = crust.fp1[i]; fp2 = crust.fp2[i];
 
 			// Do zero length extrusion with scaling for fp1
-		exfp1 = extrudeFace(obj,fp1,0.0,vec,0.0,scale_factor);
+		exfp1 = extrudeFace(obj,fp1,exverts[i]);
 
 			// Connect the end face of the extrusion and the inner face in the crust
 		fvp1 = exfp1->firstVertex(); fvp2 = fp2->firstVertex();
@@ -818,69 +917,86 @@ void modifiedMultiConnectCrust(DLFLObjectPtr obj, double scale_factor) {
 	int count = 0;
 
 		// First create scaled crust.
-	createCrustWithScaling(obj,scale_factor);
+	CrustInfo crust;
+	createCrustWithScaling(obj,crust,scale_factor);
 
 		// The crust-modeling arrays would have been filled now.
 		// Do zero length extrusions of the faces in the outer shell
-		// crustfp1 contains old faces, crustfp2 contains new faces from inner shell
-		// Replace the crustfp1 array to contain the extruded end faces
+		// crust.fp1 contains old faces, crust.fp2 contains new faces from inner shell
+		// Replace the crust.fp1 array to contain the extruded end faces
 		// Don't punch holes yet
-	int num_holes = crustfp1.size();
+	int num_holes = crust.fp1.size();
 	DLFLFacePtr fp1, exfp1, fp2;
-	Vector3d vec; // For dummy direction vector
-	for (int i=0; i < num_holes; ++i) {
-		fp1 = crustfp1[i]; fp2 = crustfp2[i];
-
-			// Do zero length extrusion with scaling for fp1
-		exfp1 = extrudeFace(obj,fp1,0.0,vec,0.0,scale_factor);
-
-			// Replace fp1 with exfp1 in crustfp1
-		crustfp1[i] = exfp1;
+	vector<Vector3dArray> exverts;
+	scaledFaceCoords(crust.fp1,scale_factor,exverts);
+		// Holes are visited twice, old edges and vertices once
+	DLFLProgress::begin("Multi-connect",2*num_holes+num_old_edges+num_old_verts);
+	{
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < num_holes; ++i) {
+			if ( !DLFLProgress::step() ) return;
+			fp1 = crust.fp1[i]; fp2 = crust.fp2[i];
+
+				// Do zero length extrusion with scaling for fp1
+			exfp1 = extrudeFace(obj,fp1,exverts[i]);
+
+				// Replace fp1 with exfp1 in crust.fp1
+			crust.fp1[i] = exfp1;
+		}
 	}
 
-		// Trisect all the old edges (before creating crust and extruding)
-		// Set type of new points
 	DLFLEdgePtrList::iterator efirst, elast;
 	DLFLEdgePtr ep;
-	count = 0;
-	efirst = obj->beginEdge(); elast = obj->endEdge();
-	while ( count < num_old_edges ) {
-		ep = (*efirst); ++efirst; ++count;
-		trisectEdge(obj,ep,scale_factor,true,true);
-	}
-
-		// Go through all the old vertices (before crust, extrude and trisect)
-		// For each vertex, go through the face-vertex list. For each face-vertex
-		// in that list, connect the previous and next face-vertices with an edge
-		// After doing that, find edges which do not connect to the points created
-		// by trisection and delete them
 	DLFLVertexPtrList::iterator vfirst, vlast;
 	DLFLVertexPtr vp, ovp;
 	DLFLFaceVertexPtrArray fvparray;
 	DLFLFaceVertexPtr fvp;
 	DLFLEdgePtrArray eparray;
-	count = 0;
-	vfirst = obj->beginVertex(); vlast = obj->endVertex();
-	while ( count < num_old_verts ) {
-		vp = (*vfirst); ++vfirst; ++count;
-		vp->getFaceVertices(fvparray);
-		for (int i=0; i < (int)fvparray.size(); ++i) {
-			fvp = fvparray[i];
-			insertEdgeCoFacial(obj,fvp->prev(),fvp->next());
+	{
+			// Edges and faces replaced below are only freed at the end of the batch.
+			// None of the old vertices are removed, so the vertex list can still be walked
+		DLFLBatchScope batch(obj);
+			// Trisect all the old edges (before creating crust and extruding)
+			// Set type of new points
+		count = 0;
+		efirst = obj->beginEdge(); elast = obj->endEdge();
+		while ( count < num_old_edges ) {
+			if ( !DLFLProgress::step() ) return;
+			ep = (*efirst); ++efirst; ++count;
+			trisectEdge(obj,ep,scale_factor,true,true);
 		}
-		vp->getEdges(eparray);
-		for (int i=0; i < (int)eparray.size(); ++i) {
-			ep = eparray[i];
-			ovp = ep->getOtherVertexPointer(vp);
-			if ( ovp->getType() != VTNewPoint ) deleteEdge(obj,ep);
-			else ovp->resetType(); // Reset the type to allow proper recursive operation
+
+			// Go through all the old vertices (before crust, extrude and trisect)
+			// For each vertex, go through the face-vertex list. For each face-vertex
+			// in that list, connect the previous and next face-vertices with an edge
+			// After doing that, find edges which do not connect to the points created
+			// by trisection and delete them
+		count = 0;
+		vfirst = obj->beginVertex(); vlast = obj->endVertex();
+		while ( count < num_old_verts ) {
+			if ( !DLFLProgress::step() ) return;
+			vp = (*vfirst); ++vfirst; ++count;
+			vp->getFaceVertices(fvparray);
+			for (int i=0; i < (int)fvparray.size(); ++i) {
+				fvp = fvparray[i];
+				insertEdgeCoFacial(obj,fvp->prev(),fvp->next());
+			}
+			vp->getEdges(eparray);
+			for (int i=0; i < (int)eparray.size(); ++i) {
+				ep = eparray[i];
+				ovp = ep->getOtherVertexPointer(vp);
+				if ( ovp->getType() != VTNewPoint ) deleteEdge(obj,ep);
+				else ovp->resetType(); // Reset the type to allow proper recursive operation
+			}
 		}
 	}
 
 		// Punch the holes now
 	DLFLFaceVertexPtr fvp1, fvp2;
+	DLFLBatchScope batch(obj);
 	for (int i=0; i < num_holes; ++i) {
-		fp1 = crustfp1[i]; fp2 = crustfp2[i];
+		if ( !DLFLProgress::step() ) return;
+		fp1 = crust.fp1[i]; fp2 = crust.fp2[i];
 		fvp1 = fp1->firstVertex(); fvp2 = fp2->firstVertex();
 		connectFaces(obj,fvp1,fvp2,1);
 	}
@@ -902,6 +1018,9 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 	int num_old_edges = obj->num_edges();
 	int count;
 
+		// Old faces and edges are visited twice, old vertices once
+	DLFLProgress::begin("Sponge",2*num_old_faces+2*num_old_edges+num_old_verts);
+
 		// Reserve and create num_old_edges entries in the 2 temporary edge lists
 	eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
 
@@ -912,106 +1031,138 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 	eistart = (obj->firstEdge())->getID();
 	fistart = (obj->firstFace())->getID();
 
-	DLFLFacePtrList::iterator fl_first, fl_last;
-	DLFLFacePtr fp, newfp1, newfp2;
-	fl_first = obj->beginFace(); fl_last = obj->endFace();
-	num_faces = 0;
-	while ( fl_first != fl_last && num_faces < num_old_faces ) {
-		fp = (*fl_first); ++fl_first; ++num_faces;
-
-			// Create face for inner shell
-		duplicateFacePlanarOffset(obj,fp,-thickness,0.0,thickness,fractional_thickness);
-
-			// Get the two newly inserted faces
-		DLFLFacePtrList::reverse_iterator temp = obj->rbeginFace();
-		newfp1 = (*temp); ++temp; newfp2 = (*temp);
-
-			// With respect to the outer shell, newfp1 faces inwards and newfp2 faces outwards
-			// When creating the inner shell we want to reverse the surface
-			// The edge connections will be made keeping this in mind
-
-			// Set type of OUTER face so we can use the type to
-			// determine which face to use for edge connects
-		newfp2->setType(FTNew);
+		// Compute the corners of the inner and outer shell faces for all the old faces
+		// first. Nothing below moves the old vertices, so this only reads the mesh
+		// and can be done for the faces in parallel.
+		// outerverts are offset in the plane of the face, innerverts are also
+		// moved inwards along the face normal
+	DLFLFacePtrArray oldfaces(num_old_faces);
+	copy(obj->beginFace(),obj->endFace(),oldfaces.begin());
+	vector<Vector3dArray> outerverts(num_old_faces), innerverts(num_old_faces);
+	vector<char> offsetok(num_old_faces,0);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+	for (int i=0; i < num_old_faces; ++i) {
+		if ( !planarOffsetCoords(oldfaces[i],thickness,fractional_thickness,outerverts[i]) ) continue;
+		Vector3d ndir = normalized(oldfaces[i]->computeNormal());
+		innerverts[i] = outerverts[i];
+		if ( Abs(thickness) > ZERO ) translate(innerverts[i],ndir,-thickness);
+		offsetok[i] = 1;
+	}
 
-			// Store edges which are to be connected in the temporary array
-			// using the adjusted edge ID of corresponding edge in original mesh.
-			// newfp2 (the OUTER face) will be used for edge connections
-		DLFLEdgePtrArray eparray1, eparray2;
-		DLFLEdgePtr ep1, ep2;
+	DLFLFacePtr fp, newfp1, newfp2;
+	{
+		// Faces removed while extruding are only freed at the end of the batch
+		DLFLBatchScope batch(obj);
+		for (num_faces=0; num_faces < num_old_faces; ++num_faces) {
+			if ( !DLFLProgress::step() ) return;
+			fp = oldfaces[num_faces];
+			if ( !offsetok[num_faces] ) continue;
+
+				// Create face for inner shell
+			duplicateFace(obj,fp,innerverts[num_faces]);
+
+				// Get the two newly inserted faces
+			DLFLFacePtrList::reverse_iterator temp = obj->rbeginFace();
+			newfp1 = (*temp); ++temp; newfp2 = (*temp);
+
+				// With respect to the outer shell, newfp1 faces inwards and newfp2 faces outwards
+				// When creating the inner shell we want to reverse the surface
+				// The edge connections will be made keeping this in mind
+
+				// Set type of OUTER face so we can use the type to
+				// determine which face to use for edge connects
+			newfp2->setType(FTNew);
+
+				// Store edges which are to be connected in the temporary array
+				// using the adjusted edge ID of corresponding edge in original mesh.
+				// newfp2 (the OUTER face) will be used for edge connections
+			DLFLEdgePtrArray eparray1, eparray2;
+			DLFLEdgePtr ep1, ep2;
+
+			fp->getEdges(eparray1); newfp2->getEdges(eparray2);
+
+				// Both fp and newfp2 MUST be of the same size. We wont check for that
+			for (int i=0; i < (int)eparray1.size(); ++i) {
+				ep1 = eparray1[i]; ep2 = eparray2[i];
+
+				edgeindex = ep1->getID() - eistart;
+				if ( eplist1[edgeindex] == NULL ) eplist1[edgeindex] = ep2;
+				else                              eplist2[edgeindex] = ep2;
+			}
 
-		fp->getEdges(eparray1); newfp2->getEdges(eparray2);
+				// Store faces which are to be connected in the temporary array
+				// using the adjusted face ID of the face in the original mesh.
+				// newfp1 (the INNER face) will be used for face connections
+				// fplist1 will be used, since the other matching faces will only
+				// be created later on and there is no possibility of conflict
+			fplist1[fp->getID() - fistart] = newfp1;
 
-			// Both fp and newfp2 MUST be of the same size. We wont check for that
-		for (int i=0; i < (int)eparray1.size(); ++i) {
-			ep1 = eparray1[i]; ep2 = eparray2[i];
+				// Create the face for the outer shell
+				// We use extrude now so we can easily insert the support edges later
+			newfp2 = extrudeFace(obj,fp,outerverts[num_faces]);
 
-			edgeindex = ep1->getID() - eistart;
-			if ( eplist1[edgeindex] == NULL ) eplist1[edgeindex] = ep2;
-			else                              eplist2[edgeindex] = ep2;
+				// newfp2 is used for make the face connection with the inner shell
+				// Store newfp2 in fplist2
+			fplist2[fp->getID() - fistart] = newfp2;
 		}
-
-			// Store faces which are to be connected in the temporary array
-			// using the adjusted face ID of the face in the original mesh.
-			// newfp1 (the INNER face) will be used for face connections
-			// fplist1 will be used, since the other matching faces will only
-			// be created later on and there is no possibility of conflict
-		fplist1[fp->getID() - fistart] = newfp1;
-
-			// Create the face for the outer shell
-			// We use extrude now so we can easily insert the support edges later
-		newfp2 = extrudeFacePlanarOffset(obj,fp,0.0,0.0,thickness,fractional_thickness);
-
-			// newfp2 is used for make the face connection with the inner shell
-			// Store newfp2 in fplist2
-		fplist2[fp->getID() - fistart] = newfp2;
 	}
 
 
-		// Trisect all the old edges (before creating inner shell and extruding)
-		// Set type of new points
 	count = 0;
 	DLFLEdgePtrList::iterator el_first, el_last;
 	DLFLEdgePtr ep;
-	el_first = obj->beginEdge(); el_last = obj->endEdge();
-	if ( fractional_thickness ) {
-		while ( count < num_old_edges ) {
-			ep = (*el_first); ++el_first; ++count;
-			trisectEdge(obj,ep,thickness*ep->length(),false,true);
-		}
-	} else {
-		while ( count < num_old_edges ) {
-			ep = (*el_first); ++el_first; ++count;
-			trisectEdge(obj,ep,thickness,false,true);
-		}
-	}
-
-		// Create the support edges on the outer surface
-		// Go through all the old vertices (before crust, extrude and trisect)
-		// For each vertex, go through the face-vertex list. For each face-vertex
-		// in that list, connect the previous and next face-vertices with an edge
-		// After doing that, find edges which do not connect to the points created
-		// by trisection and delete them
 	DLFLVertexPtrList::iterator vfirst, vlast;
 	DLFLVertexPtr vp, ovp;
 	DLFLFaceVertexPtrArray fvparray;
 	DLFLFaceVertexPtr fvp;
 	DLFLEdgePtrArray eparray;
-	count = 0;
-	vfirst = obj->beginVertex(); vlast = obj->endVertex();
-	while ( count < num_old_verts ) {
-		vp = (*vfirst); ++vfirst; ++count;
-		vp->getFaceVertices(fvparray);
-		for (int i=0; i < (int)fvparray.size(); ++i) {
-			fvp = fvparray[i];
-			insertEdgeCoFacial(obj,fvp->prev(),fvp->next());
+
+	{
+			// Edges and faces replaced below are only freed at the end of the batch.
+			// None of the old vertices are removed, so the vertex list can still be walked
+		DLFLBatchScope batch(obj);
+			// Trisect all the old edges (before creating inner shell and extruding)
+			// Set type of new points
+		el_first = obj->beginEdge(); el_last = obj->endEdge();
+		if ( fractional_thickness ) {
+			while ( count < num_old_edges ) {
+				if ( !DLFLProgress::step() ) return;
+				ep = (*el_first); ++el_first; ++count;
+				trisectEdge(obj,ep,thickness*ep->length(),false,true);
+			}
+		} else {
+			while ( count < num_old_edges ) {
+				if ( !DLFLProgress::step() ) return;
+				ep = (*el_first); ++el_first; ++count;
+				trisectEdge(obj,ep,thickness,false,true);
+			}
 		}
-		vp->getEdges(eparray);
-		for (int i=0; i < (int)eparray.size(); ++i) {
-			ep = eparray[i];
-			ovp = ep->getOtherVertexPointer(vp);
-			if ( ovp->getType() != VTNewPoint ) deleteEdge(obj,ep);
-			else ovp->resetType(); // Reset the type to allow proper recursive operation
+
+			// Create the support edges on the outer surface
+			// Go through all the old vertices (before crust, extrude and trisect)
+			// For each vertex, go through the face-vertex list. For each face-vertex
+			// in that list, connect the previous and next face-vertices with an edge
+			// After doing that, find edges which do not connect to the points created
+			// by trisection and delete them
+		count = 0;
+		vfirst = obj->beginVertex(); vlast = obj->endVertex();
+		while ( count < num_old_verts ) {
+			if ( !DLFLProgress::step() ) return;
+			vp = (*vfirst); ++vfirst; ++count;
+			vp->getFaceVertices(fvparray);
+			for (int i=0; i < (int)fvparray.size(); ++i) {
+				fvp = fvparray[i];
+				insertEdgeCoFacial(obj,fvp->prev(),fvp->next());
+			}
+			vp->getEdges(eparray);
+			for (int i=0; i < (int)eparray.size(); ++i) {
+				ep = eparray[i];
+				ovp = ep->getOtherVertexPointer(vp);
+				if ( ovp->getType() != VTNewPoint ) deleteEdge(obj,ep);
+				else ovp->resetType(); // Reset the type to allow proper recursive operation
+			}
 		}
 	}
 
@@ -1022,24 +1173,28 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 		// Go through eplist1 and eplist2 and connect corresponding half-edges
 		// The correct half-edge is determined by the type tag which was set previously
 	DLFLFacePtr fp1, fp2, tfp1, tfp2;
-	for (int i=0; i < num_old_edges; ++i) {
-		if ( eplist1[i] != NULL && eplist2[i] != NULL ) {
-	// Find the faces adjacent to the edges which are of type FTNew
-	// These will be the inner faces
-			eplist1[i]->getFacePointers(tfp1,tfp2);
-			if ( tfp1->getType() == FTNew ) fp1 = tfp1;
-			else if ( tfp2->getType() == FTNew ) fp1 = tfp2;
-			else cout << i << " : " << "Face not found for half-edge!" << endl;
-
-			eplist2[i]->getFacePointers(tfp1,tfp2);
-			if ( tfp1->getType() == FTNew ) fp2 = tfp1;
-			else if ( tfp2->getType() == FTNew ) fp2 = tfp2;
-			else cout << i << " : " << "Face not found for half-edge!" << endl;
-
-			connectEdges(obj,eplist1[i],fp1,eplist2[i],fp2);
-		} else {
-			cout << "NULL pointers found! i = " << i << " "
-				<< eplist1[i] << " -- " << eplist2[i] << endl;
+	{
+		DLFLBatchScope batch(obj);
+		for (int i=0; i < num_old_edges; ++i) {
+			if ( !DLFLProgress::step() ) return;
+			if ( eplist1[i] != NULL && eplist2[i] != NULL ) {
+		// Find the faces adjacent to the edges which are of type FTNew
+		// These will be the inner faces
+				eplist1[i]->getFacePointers(tfp1,tfp2);
+				if ( tfp1->getType() == FTNew ) fp1 = tfp1;
+				else if ( tfp2->getType() == FTNew ) fp1 = tfp2;
+				else cout << i << " : " << "Face not found for half-edge!" << endl;
+
+				eplist2[i]->getFacePointers(tfp1,tfp2);
+				if ( tfp1->getType() == FTNew ) fp2 = tfp1;
+				else if ( tfp2->getType() == FTNew ) fp2 = tfp2;
+				else cout << i << " : " << "Face not found for half-edge!" << endl;
+
+				connectEdges(obj,eplist1[i],fp1,eplist2[i],fp2);
+			} else {
+				cout << "NULL pointers found! i = " << i << " "
+					<< eplist1[i] << " -- " << eplist2[i] << endl;
+			}
 		}
 	}
 
@@ -1058,12 +1213,19 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 	DLFLEdgePtrList colledges;
 	el_first = obj->beginEdge(); el_last = obj->endEdge();
 	advance(el_first,num_edges); // Advance to start of edges inserted above
-	while ( el_first != el_last ) {
-		ep = (*el_first); ++el_first;
+
+		// The tests only read the mesh, so all the new edges are checked in parallel
+	DLFLEdgePtrArray newedges(el_first,el_last);
+	int num_new_edges = newedges.size();
+	vector<char> collapse(num_new_edges,0);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+	for (int k=0; k < num_new_edges; ++k) {
+		DLFLEdgePtr ep = newedges[k];
 
 		if ( ep->length() < collapse_threshold_length ) {
-			ep->setType(ETCollapse);
-			colledges.push_back(ep);
+			collapse[k] = 1;
 		} else {
 	// Check if this edge is a part of a self-intersection
 	// Find all edges at the two ends of this edge and check every pair
@@ -1081,8 +1243,7 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 						if ( tep2 != ep && tep2 != tep1 ) {
 		// Check if tep1 and tep2 intersect
 							if ( checkIntersection(tep1,tep2) ) {
-								ep->setType(ETCollapse);
-								colledges.push_back(ep);
+								collapse[k] = 1;
 								i = eparr1.size(); // To make sure we break out of outer loop also
 								break;
 							}
@@ -1092,23 +1253,33 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 			}
 		}
 	}
-
-		// Go through list of edges to be collapsed and collapse them
-		// DON'T do cleanup when collapsing. The edges which form 2-gons or self-loops
-		// will also be collapsed in this loop
-	el_first = colledges.begin(); el_last = colledges.end();
-	while ( el_first != el_last ) {
-		ep = (*el_first); ++el_first;
-		collapseEdge(obj,ep,false);
+	for (int k=0; k < num_new_edges; ++k) {
+		if ( collapse[k] ) {
+			newedges[k]->setType(ETCollapse);
+			colledges.push_back(newedges[k]);
+		}
 	}
 
-		// Make the face connections between the outer shell and the inner shell
 	DLFLFaceVertexPtr fvp1, fvp2;
-	for (int i=0; i < num_old_faces; ++i) {
-		fp1 = fplist1[i]; fp2 = fplist2[i];
-		if ( fp1 != NULL && fp2 != NULL ) {
-			fvp1 = fp1->firstVertex(); fvp2 = fp2->firstVertex();
-			connectFaces(obj,fvp1,fvp2,1);
+	{
+		DLFLBatchScope batch(obj);
+			// Go through list of edges to be collapsed and collapse them
+			// DON'T do cleanup when collapsing. The edges which form 2-gons or self-loops
+			// will also be collapsed in this loop
+		el_first = colledges.begin(); el_last = colledges.end();
+		while ( el_first != el_last ) {
+			ep = (*el_first); ++el_first;
+			collapseEdge(obj,ep,false);
+		}
+
+			// Make the face connections between the outer shell and the inner shell
+		for (int i=0; i < num_old_faces; ++i) {
+			if ( !DLFLProgress::step() ) return;
+			fp1 = fplist1[i]; fp2 = fplist2[i];
+			if ( fp1 != NULL && fp2 != NULL ) {
+				fvp1 = fp1->firstVertex(); fvp2 = fp2->firstVertex();
+				connectFaces(obj,fvp1,fvp2,1);
+			}
 		}
 	}
 
@@ -1129,13 +1300,4 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
     return false;
   }
 
-  bool contains_connected(const HalfEdgePair& hep)
-  {
-    if ( hep.ep1 == HalfEdgePair::last_connected1 ||
-         hep.ep1 == HalfEdgePair::last_connected2 ||
-         hep.ep2 == HalfEdgePair::last_connected1 ||
-         hep.ep2 == HalfEdgePair::last_connected2 ) return true;
-    return false;
-  }
-
 } // end namespace
@@ -30,6 +30,7 @@
 #define _DLFLMULTI_CONNECT_H_
 
 #include <DLFLObject.hh>
+#include "DLFLConvexHull.hh"
 
 namespace DLFL {
 
@@ -42,9 +43,6 @@ namespace DLFL {
     // according to priority for connection.
   public :
 
-    // Pointers to edges which were most recently connected
-    static DLFLEdgePtr last_connected1, last_connected2; 
-
     DLFLEdgePtr ep1, ep2; // Edges to be connected
     DLFLFacePtr fp1, fp2; // Faces which define the half-edges to be connected
     // These faces define the half-edges that will remain valid even after
@@ -144,20 +142,6 @@ namespace DLFL {
       return false;
     }
 */
-    // Checks to see if given HalfEdgePair contains an edge which
-    // was most recently connected. Uses the stored static variables
-    // to do the comparison. Assumes variables have been set.
-    friend bool contains_connected(const HalfEdgePair& hep);
-/*
-    friend bool contains_connected(const HalfEdgePair& hep) {
-      if ( hep.ep1 == HalfEdgePair::last_connected1 ||
-	   hep.ep1 == HalfEdgePair::last_connected2 ||
-	   hep.ep2 == HalfEdgePair::last_connected1 ||
-	   hep.ep2 == HalfEdgePair::last_connected2 ) return true;
-      return false;
-    }
-*/
-
     void print(void) const {
       if ( ep1 && ep2 )
 	cout << "{" << ep1->getID() << "," << (ep1->getOtherFacePointer(fp1))->getID() << "}"
@@ -167,6 +151,22 @@ namespace DLFL {
     }
   };
 
+  // Checks to see if given HalfEdgePair contains one of the two edges which
+  // were most recently connected. For use with remove_if
+  struct ContainsConnected {
+    DLFLEdgePtr last_connected1, last_connected2;
+
+    ContainsConnected(DLFLEdgePtr ep1, DLFLEdgePtr ep2)
+      : last_connected1(ep1), last_connected2(ep2)
+    {}
+
+    bool operator () (const HalfEdgePair& hep) const {
+      if ( hep.ep1 == last_connected1 || hep.ep1 == last_connected2 ||
+           hep.ep2 == last_connected1 || hep.ep2 == last_connected2 ) return true;
+      return false;
+    }
+  };
+
   typedef vector<HalfEdgePair> HalfEdgePairArray;
   typedef list<HalfEdgePair> HalfEdgePairList;
 
@@ -207,9 +207,37 @@ namespace DLFL {
   typedef vector<Plane> PlaneArray;
   typedef vector<PlaneArray> PlaneArrayArray;
 
+  // What the convex hull multiConnectFaces worked out in its last call, so it
+  // isn't done again while the scale factor and extrude distance are tuned on
+  // the same faces. The maximum offsets are kept for faces with the same
+  // coordinates. The hull is kept for the same points before scaling, which
+  // covers any change of the scale factor, and of the extrude distance when
+  // the maximum offsets are used
+  struct MultiConnectCache {
+    Vector3dArray facepoints;   // Corners of the faces the offsets were found for
+    vector<int> facesizes;
+    DoubleArray maxoffsets;
+    bool offsetsvalid;
+
+    Vector3dArray hullpoints;   // Points the hull was built from
+    DLFLConvexHull hull;        // Hull after edge cleanup, not scaled or reversed
+    bool hullvalid;
+
+    MultiConnectCache()
+      : facepoints(), facesizes(), maxoffsets(), offsetsvalid(false),
+        hullpoints(), hull(), hullvalid(false)
+    {}
+
+    void clear() {
+      facepoints.clear(); facesizes.clear(); maxoffsets.clear(); offsetsvalid = false;
+      hullpoints.clear(); hull.reset(); hullvalid = false;
+    }
+  };
+
   void tripleConnectFaces( DLFLObjectPtr obj, DLFLFacePtr fp1, DLFLFacePtr fp2, DLFLFacePtr fp3);
   void multiConnectFaces( DLFLObjectPtr obj, DLFLFacePtrArray fp);
-  void multiConnectFaces( DLFLObjectPtr obj, DLFLFacePtrArray fparray, double scale_factor, double extrude_dist, bool use_max_offsets=false);
+  void multiConnectFaces( DLFLObjectPtr obj, DLFLFacePtrArray fparray, double scale_factor, double extrude_dist, bool use_max_offsets=false,
+                          MultiConnectCache *cache=NULL);
   void multiConnectFaces( DLFLObjectPtr obj, DLFLFacePtrArray fparray, double min_factor, bool make_connections=true);
   void findMaxOffsets( DLFLFacePtrArray fparray, DoubleArray& maxoffsets);
   void multiConnectMidpoints( DLFLObjectPtr obj );
@@ -219,7 +247,6 @@ namespace DLFL {
 
   bool less_than(const HalfEdgePair& hep1, const HalfEdgePair& hep2);
   bool greater_than(const HalfEdgePair& hep1, const HalfEdgePair& hep2);
-  bool contains_connected(const HalfEdgePair& hep);
 
 } // end namespace
 
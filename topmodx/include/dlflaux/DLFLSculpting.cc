@@ -122,10 +122,9 @@ namespace DLFL {
 
 		DLFLVertexPtrArray cverts;
 
-		if (convexhull==NULL) convexhull=new DLFLConvexHull();
-
-		convexhull->createHull(ovarray);
-		convexhull->getVertices(cverts);
+		DLFLConvexHull convexhull;
+		convexhull.createHull(ovarray);
+		convexhull.getVertices(cverts);
 		float fmax=9999999, fmin = -9999999;
 		Vector3d cvmin(fmax,fmax,fmax),cvmax(fmin,fmin,fmin);
 		for(int i=0;i<ovarray.size();i++){
@@ -246,10 +245,11 @@ namespace DLFL {
 		edgestodel.clear();
 	}
 
-	void visitVertex(DLFLObjectPtr obj, DLFLVertexPtr vp,DLFLEdgePtr from,Vector3d normal,Vector3d P0){
+	void visitVertex(DLFLObjectPtr obj, CutContext& cut, DLFLVertexPtr vp,DLFLEdgePtr from,Vector3d normal,Vector3d P0){
 
 		if (vp->isvisited) return;
 		vp->isvisited = 1;
+		cut.visitedverts.push_back(vp);
 		Vector3d p1 = vp->getCoords();
 		float d1 = normal*(p1 - P0);
 		//if (d1<0) return;
@@ -264,6 +264,7 @@ namespace DLFL {
 				if (ep==from) continue;
 				if (ep->isvisited) continue;
 				ep->isvisited = 1;
+				cut.visitededges.push_back(ep);
 				DLFLVertexPtr evp1,evp2,vp2;
 			 	ep->getVertexPointers(evp1,evp2);
 				vp2 = (vp==evp1)?evp2:evp1;
@@ -273,21 +274,21 @@ namespace DLFL {
 				//if both vertices of the edge are on (+) side
 				if ((d1>0)&&(d2>0)){
 					//ep->istodel = 1;
-					edges2del[e2dsize++] = ep;
-					visitVertex(obj, vp2, ep, normal, P0);
+					cut.edges2del.push_back(ep);
+					visitVertex(obj, cut, vp2, ep, normal, P0);
 				}
 
 				//if (ep->istodel) continue;
 				//if one end is - one end is +
 				if ( ((d1*d2)<0) || ((d1>0)&&(d2==0)) || ((d1==0)&&(d2>0)) ){
-					int id = getCutIndex(ep);
+					int id = getCutIndex(cut,ep);
 					DLFLVertexPtr vnew = subdivideEdge(obj, ep);
 					if (d1>0){
 						//vnew->getEdgeTo(vp)->istodel = 1;
-						edges2del[e2dsize++] = vnew->getEdgeTo(vp);
+						cut.edges2del.push_back(vnew->getEdgeTo(vp));
 						if (id!=-1){
-							sedges[id] = vnew->getEdgeTo(vp2);
-							sverts[id] = vnew;
+							cut.setCutEdge(id, vnew->getEdgeTo(vp2));
+							cut.sverts[id] = vnew;
 						}
 
 					}else{
@@ -302,41 +303,50 @@ namespace DLFL {
 					vnew->setCoords(pnew + ne*t);
 					DLFLFaceVertexPtrArray fvlist;
 					vnew->getFaceVertices(fvlist);	
-					newcorners[ncsize++] = fvlist.at(0);
-					newcorners[ncsize++] = fvlist.at(1);
+					cut.newcorners.push_back(fvlist.at(0));
+					cut.newcorners.push_back(fvlist.at(1));
 				}
 		  }
 		}
 	}
 	
 	void localCut(DLFLObjectPtr obj, DLFLVertexPtr vp,Vector3d normal,Vector3d P0){
+		CutContext cut;
+		localCut(obj,cut,vp,normal,P0);
+	}
 
-		if(!vp) return;
-		DLFLVertexPtrArray verts;
-		DLFLEdgePtrArray edges;
-		obj->getVertices(verts);
-		obj->getEdges(edges);
+	void localCut(DLFLObjectPtr obj, CutContext& cut, DLFLVertexPtr vp,Vector3d normal,Vector3d P0){
 
-		for(int i=0;i<verts.size();i++)
-			verts.at(i)->isvisited=0;
-		
-		for(int i=0;i<edges.size();i++)
-			edges.at(i)->isvisited=0;
+		if(!vp) return;
+		if (!cut.flagsclear){
+			DLFLVertexPtrList::iterator vf = obj->beginVertex(), vl = obj->endVertex();
+			for(; vf != vl; ++vf) (*vf)->isvisited=0;
+			DLFLEdgePtrList::iterator ef = obj->beginEdge(), el = obj->endEdge();
+			for(; ef != el; ++ef) (*ef)->isvisited=0;
+		}
 
-		int size = obj->num_edges();
-		newcorners = new DLFLFaceVertexPtr[size];
-		edges2del  = new DLFLEdgePtr[size];
-		e2dsize=0;
-		ncsize=0;
-		visitVertex(obj, vp,0,normal,P0);
+		cut.newcorners.clear();
+		cut.edges2del.clear();
+		cut.visitedverts.clear(); cut.visitededges.clear();
+		visitVertex(obj, cut, vp,0,normal,P0);
+
+		// Only what this cut reached was flagged, so the next cut in the same
+		// context doesn't have to clear the whole object again
+		for(int i=0;i<cut.visitedverts.size();i++)
+			cut.visitedverts[i]->isvisited=0;
+		for(int i=0;i<cut.visitededges.size();i++)
+			cut.visitededges[i]->isvisited=0;
+		cut.flagsclear = true;
+		int ncsize = cut.newcorners.size();
+		int e2dsize = cut.edges2del.size();
 
 	//connect new corners
 		DLFLFaceVertexPtr cp1,cp2;
 		for(int i =0; i<ncsize;i++){
-			cp1 = newcorners[i];
+			cp1 = cut.newcorners[i];
 			for(int j =0; j<ncsize;j++){
 				if (i==j) continue;
-				cp2 = newcorners[j];
+				cp2 = cut.newcorners[j];
 				if ( cp1->getFacePtr() == cp2->getFacePtr() ){
 					insertEdge(obj, cp1,cp2);
 					continue;
@@ -346,15 +356,15 @@ namespace DLFL {
 
 	//delete edges
 		for(int i=0;i<e2dsize;i++){
-			// printf("edge %d: %x\n",i,edges2del[i]);
-			edges2del[i]->isdummy=0;
+			// printf("edge %d: %x\n",i,cut.edges2del[i]);
+			cut.edges2del[i]->isdummy=0;
 		}
 
 		for(int i=0;i<e2dsize;i++){
-			DLFLEdgePtr ep = edges2del[i];
+			DLFLEdgePtr ep = cut.edges2del[i];
 
 			for(int j=i+1;j<e2dsize;j++){
-				if (ep==edges2del[j]) {
+				if (ep==cut.edges2del[j]) {
 					// printf("ayni egde %d = %d = %x\n",i,j,ep);
 					ep->isdummy=1;
 				}
@@ -362,7 +372,7 @@ namespace DLFL {
 		}
 
 		for(int i=0;i<e2dsize;i++){
-			deleteEdge(obj, edges2del[i]);
+			deleteEdge(obj, cut.edges2del[i]);
 		}
 
 	}
@@ -401,474 +411,225 @@ namespace DLFL {
 	// 
 	// }
 
-	void performCutting( DLFLObjectPtr obj, int type,float offsetE,float offsetV,bool global,bool selected) {
-
-		// if (type==204){
-		// 	// truncateEdges(offsetE);
-		// 	return;
-		// }
-		// global = false;
-
-		DLFLEdgePtrArray edges;
-		DLFLVertexPtrArray verts;
-		DLFLFacePtrArray faces;
-
-		cutcount = 0;
-		int vcount = 0;
-		int num=0;
-
-		Vector3d * locs, * norms;
-		obj->getEdges(edges);
-		obj->getVertices(verts);
-		obj->getFaces(faces);
-		int esize 	= edges.size();
-		int vsize		= verts.size();
-		int fsize 	= faces.size();
-		int totalsize 	= esize+vsize+fsize;
-		locs   		= new Vector3d[totalsize];
-		norms  		= new Vector3d[totalsize];
-		sverts 		= new DLFLVertexPtr[totalsize];
-		sedges 		= new DLFLEdgePtr[esize];
-
-		//this loops through all edges??? why?
-		for(int i=0;i<esize;i++){
-			sverts[cutcount]=0;
-
-			DLFLEdgePtr e = edges.at(i);
-			if ( ((selected)&&(!e->ismarked)) || (type==201) ) continue;
-
-			DLFLVertexPtr v1,v2,v;
-			e->getVertexPointers(v1,v2);
-
-			int vnum=0;
-			Vector3d * vlocs = new Vector3d[v1->valence() + v2->valence()];
-
-			for(int j=0;j<2;j++){
-				v =(j)?v2:v1;
-				DLFLEdgePtrArray vedges;
-				v->getEdges(vedges);
-				for(int k=0;k<vedges.size();k++){
-					DLFLEdgePtr ve = vedges.at(k);
-					if (ve==e) continue;
-					DLFLVertexPtr ev1,ev2;
-					ve->getVertexPointers(ev1,ev2);
-					if (ev2==v){
-						ev2 = ev1;
-						ev1 = v;  
-					}
-					vlocs[vnum++] = (ev2->getCoords() - ev1->getCoords())*offsetE + ev1->getCoords();
-				}
-			}
-
-			//calculate the normal and position 
-			Vector3d vecp,vec,n(0,0,0),nprev,norm(0,0,0),mid(0,0,0);
-			for(int j=0;j<vnum;j++)
-				mid = mid + vlocs[j];
-			mid = mid / ((float)vnum);
-
-			for(int j=0;j<vnum;j++){
-				vec = (mid - vlocs[j]);
-				if (j==0){
-					vecp = vec;
-					continue;
-				}
-				n = n + vecp % vec;
-			}
-
-			DLFLFacePtr f1,f2;
-			e->getFacePointers(f1,f2);
-			norms[cutcount] = normalized(f1->computeNormal()+f2->computeNormal());
-			locs[cutcount] = mid;
-			sverts[cutcount] = v1;
-			sedges[cutcount] = e;
-			cutcount++;
+	// Normals as DLFLFaceVertex::updateNormal, DLFLFace::computeNormal and
+	// DLFLVertex::computeNormal compute them, but without storing anything in the
+	// mesh so the cutting planes can be worked out in parallel
+	static Vector3d cornerNormal( DLFLFaceVertexPtr fvp ) {
+		if ( fvp->isWingedCorner() ) {
+			DLFLFaceVertexPtr nwfvp = fvp->closestNonWingedCorner();
+			if ( nwfvp ) fvp = nwfvp;
 		}
+		Vector3d pos = fvp->getVertexCoords();
+		Vector3d nvec = fvp->next()->getVertexCoords() - pos;
+		Vector3d pvec = fvp->prev()->getVertexCoords() - pos;
+		Vector3d n = nvec % pvec;
+		normalize(n);
+		if ( fvp->isConcaveCorner() ) n = -n;
+		return n;
+	}
 
-		//loop through all vertices
-		for(int i = 0; i<vsize;i++){
-			sverts[cutcount]=0;
-
-			DLFLVertexPtr vp = verts.at(i);
-			if ( ((selected)&&(!vp->ismarked))||(type==200) ) continue;
+	static Vector3d faceNormal( DLFLFacePtr fp ) {
+		Vector3d n;
+		DLFLFaceVertexPtr head = fp->front(), fvp = head;
+		if ( !head ) return n;
+		int num = 0;
+		do {
+			n += cornerNormal(fvp); ++num;
+			fvp = fvp->next();
+		} while ( fvp != head );
+		n /= num; normalize(n);
+		return n;
+	}
 
-			DLFLEdgePtrArray vedges;
-			vp->getEdges(vedges);
+	static Vector3d vertexNormal( DLFLVertexPtr vp ) {
+		Vector3d n;
+		int num = 0;
+		DLFLFaceVertexPtrList::const_iterator first = vp->beginFaceVertex(), last = vp->endFaceVertex();
+		for(; first != last; ++first, ++num)
+			n += cornerNormal(*first);
+		n /= num;
+		return n;
+	}
 
-			int vnum=0;
-			Vector3d * vlocs = new Vector3d[vp->valence()];
+	// Point offset from v along the edge ve
+	static inline Vector3d offsetAlong( DLFLEdgePtr ve, DLFLVertexPtr v, float offset ) {
+		DLFLVertexPtr ev1,ev2;
+		ve->getVertexPointers(ev1,ev2);
+		if (ev2==v){
+			ev2 = ev1;
+			ev1 = v;  
+		}
+		return (ev2->getCoords() - ev1->getCoords())*offset + ev1->getCoords();
+	}
 
-			for(int k=0;k<vedges.size();k++){
+	// Cutting plane of an edge: through the average of the points offset along the
+	// other edges at both ends, normal to the average of the two face normals
+	static void edgeCutPlane( CutContext& cut, int i, DLFLEdgePtr e, float offsetE ) {
+		DLFLVertexPtr v1,v2,v;
+		e->getVertexPointers(v1,v2);
 
-				DLFLEdgePtr ve = vedges.at(k);
-				DLFLVertexPtr ev1,ev2;
-				ve->getVertexPointers(ev1,ev2);
-				if (ev2==vp){
-					ev2 = ev1;
-					ev1 = vp;  
-				}
-				vlocs[vnum++] = (ev2->getCoords() - ev1->getCoords())*offsetV + ev1->getCoords();
+		int vnum=0;
+		Vector3d mid(0,0,0);
+		for(int j=0;j<2;j++){
+			v =(j)?v2:v1;
+			DLFLFaceVertexPtrList::const_iterator first = v->beginFaceVertex(), last = v->endFaceVertex();
+			for(; first != last; ++first){
+				DLFLEdgePtr ve = (*first)->getEdgePtr();
+				if (ve==e) continue;
+				mid += offsetAlong(ve,v,offsetE); vnum++;
 			}
-
-			//calculate the normal and position for bevelling
-			Vector3d vecp,vec,n(0,0,0),nprev,norm(0,0,0),mid(0,0,0);
-			for(int j=0;j<vnum;j++)
-				mid = mid + vlocs[j];
-			mid = mid / ((float)vnum);
-
-			norms[cutcount] = vp->computeNormal();
-			locs[cutcount] = mid;
-			sverts[cutcount] = vp;
-			cutcount++;
 		}
+		mid /= ((float)vnum);
 
-		//cut by face mode
-		if (type==203) {
-			//loop through all faces
-			for(int i = 0; i<fsize;i++){
-				sverts[cutcount]=0;
-
-				DLFLFacePtr fp = faces.at(i);
-				if ( ((selected)&&(!fp->ismarked))) continue;
-
-				DLFLVertexPtrArray fverts;
-				DLFLFaceVertexPtrArray fcorners;
-				DLFLVertexPtr v;
-				int vnum=0;
-				fp->getCorners(fcorners);
-
-				for(int j=0;j<fcorners.size();j++){
-					DLFLFaceVertexPtr fv = fcorners.at(j);
-					fverts.push_back(fv->getVertexPtr());
-				}
+		DLFLFacePtr f1,f2;
+		e->getFacePointers(f1,f2);
+		cut.norms[i] = normalized(faceNormal(f1)+faceNormal(f2));
+		cut.locs[i] = mid;
+		cut.sverts[i] = v1;
+		cut.sedges[i] = e;
+	}
 
-				Vector3d * vlocs = new Vector3d[fverts.size()*10];
-
-				for(int j=0;j<fverts.size();j++){
-					v = fverts.at(j);
-					DLFLEdgePtrArray vedges;
-					v->getEdges(vedges);
-
-					for(int k=0;k<vedges.size();k++){
-						DLFLEdgePtr ve = vedges.at(k);
-						DLFLFacePtr ef1,ef2;
-						ve->getFacePointers(ef1,ef2);
-						if ((ef1==fp )||(ef2==fp)) continue;
-						DLFLVertexPtr ev1,ev2;
-						ve->getVertexPointers(ev1,ev2);
-						if (ev2==v){
-							ev2 = ev1;
-							ev1 = v;  
-						}
-						vlocs[vnum++] = (ev2->getCoords() - ev1->getCoords())*offsetV + ev1->getCoords();
-					}
-				}
+	// Cutting plane of a vertex: through the average of the points offset along
+	// its edges, normal to the vertex normal
+	static void vertexCutPlane( CutContext& cut, int i, DLFLVertexPtr vp, float offsetV ) {
+		int vnum=0;
+		Vector3d mid(0,0,0);
+		DLFLFaceVertexPtrList::const_iterator first = vp->beginFaceVertex(), last = vp->endFaceVertex();
+		for(; first != last; ++first){
+			mid += offsetAlong((*first)->getEdgePtr(),vp,offsetV); vnum++;
+		}
+		mid /= ((float)vnum);
 
+		cut.norms[i] = vertexNormal(vp);
+		cut.locs[i] = mid;
+		cut.sverts[i] = vp;
+	}
 
-			//calculate the normal and position for beveling
-				Vector3d vecp,vec,n(0,0,0),nprev,norm(0,0,0),mid(0,0,0);
-				for(int j=0;j<vnum;j++)
-					mid = mid + vlocs[j];
-				mid = mid / ((float)vnum);
-
-				norms[cutcount] = fp->computeNormal();
-				locs[cutcount] = mid;
-				float dmax = -999;
-				DLFLVertexPtr vp,svp;
-				for(int j=0;j<fverts.size();j++){
-					DLFLVertexPtr vp = fverts.at(j);
-					float d = norms[cutcount]*(vp->getCoords() - mid);
-				// printf("d:%f\n",d);
-					if (d>dmax){
-						dmax = d;
-						svp = vp;
-					}
-				}
-				sverts[cutcount] = svp;
-				cutcount++;
+	// Cutting plane of a face: through the average of the points offset along the
+	// edges leaving the face, normal to the face normal. The cut starts from the
+	// face vertex furthest along the normal
+	static void faceCutPlane( CutContext& cut, int i, DLFLFacePtr fp, float offsetV ) {
+		int vnum=0;
+		Vector3d mid(0,0,0);
+		DLFLFaceVertexPtr head = fp->front(), fvp = head;
+		if ( !head ) return;
+		do {
+			DLFLVertexPtr v = fvp->getVertexPtr();
+			DLFLFaceVertexPtrList::const_iterator first = v->beginFaceVertex(), last = v->endFaceVertex();
+			for(; first != last; ++first){
+				DLFLEdgePtr ve = (*first)->getEdgePtr();
+				DLFLFacePtr ef1,ef2;
+				ve->getFacePointers(ef1,ef2);
+				if ((ef1==fp)||(ef2==fp)) continue;
+				mid += offsetAlong(ve,v,offsetV); vnum++;
 			}
-			}//end if type == 203
+			fvp = fvp->next();
+		} while ( fvp != head );
+		mid /= ((float)vnum);
 
-			for(int i = 0; i<cutcount;i++){
-				if (global)
-					peelByPlane(obj,norms[i],locs[i]);	
-				else	localCut(obj, sverts[i],norms[i],locs[i]);
+		Vector3d n = faceNormal(fp);
+		cut.norms[i] = n;
+		cut.locs[i] = mid;
+		float dmax = -999;
+		DLFLVertexPtr svp = NULL;
+		fvp = head;
+		do {
+			DLFLVertexPtr vp = fvp->getVertexPtr();
+			float d = n*(vp->getCoords() - mid);
+			if (d>dmax){
+				dmax = d;
+				svp = vp;
 			}
+			fvp = fvp->next();
+		} while ( fvp != head );
+		cut.sverts[i] = svp;
+	}
 
-			delete [] norms;
-			delete [] locs;
-			delete [] sverts;
-			delete [] sedges;
-	}//end performCutting Function
-
-	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
-
-				// bool global = false;
-
-				vector<DLFLVertexPtr>::iterator vit;
-				vector<DLFLEdgePtr>::iterator eit,eit2;
-				vector<DLFLFacePtr>::iterator fit,fit2;
-				DLFLFacePtrArray sfptrarr = obj->sel_fptr_array;
-
-				DLFLEdgePtrArray edges;
-				DLFLVertexPtrArray verts;
-				DLFLFacePtrArray faces;
-
-				cutcount = 0;
-				int vcount = 0;
-				int num=0;
-
-				Vector3d * locs, * norms;
-				obj->getEdges(edges);
-				obj->getVertices(verts);
-				obj->getFaces(faces);
-				int esize 	= edges.size();
-				int vsize		= verts.size();
-				int fsize 	= faces.size();
-				int totalsize 	= esize+vsize+fsize;
-				locs   		= new Vector3d[totalsize];
-				norms  		= new Vector3d[totalsize];
-				sverts 		= new DLFLVertexPtr[totalsize];
-				sedges 		= new DLFLEdgePtr[esize];
-
-
-			//loop through all faces
-				for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++, cutcount++){
-			// std::cout << "in side selected face loop!\n";
-					sverts[cutcount]=0;
-
-					DLFLVertexPtrArray fverts;
-					DLFLFaceVertexPtrArray fcorners;
-					DLFLVertexPtr v;
-					int vnum=0;
-					(*fit)->getCorners(fcorners);
-
-					for(int j=0;j<fcorners.size();j++){
-						DLFLFaceVertexPtr fv = fcorners.at(j);
-						fverts.push_back(fv->getVertexPtr());
-					}
-
-					Vector3d * vlocs = new Vector3d[fverts.size()*10];
-
-					for(int j=0;j<fverts.size();j++){
-						v = fverts.at(j);
-						DLFLEdgePtrArray vedges;
-						v->getEdges(vedges);
-
-						for(int k=0;k<vedges.size();k++){
-							DLFLEdgePtr ve = vedges.at(k);
-							DLFLFacePtr ef1,ef2;
-							ve->getFacePointers(ef1,ef2);
-							if ((ef1==(*fit) )||(ef2==(*fit))) continue;
-							DLFLVertexPtr ev1,ev2;
-							ve->getVertexPointers(ev1,ev2);
-							if (ev2==v){
-								ev2 = ev1;
-								ev1 = v;  
-							}
-							vlocs[vnum++] = (ev2->getCoords() - ev1->getCoords())*offsetV + ev1->getCoords();
-						}
-					}
-
-			//calculate the normal and position for beveling
-					Vector3d vecp,vec,n(0,0,0),nprev,norm(0,0,0),mid(0,0,0);
-					for(int j=0;j<vnum;j++)
-						mid = mid + vlocs[j];
-					mid = mid / ((float)vnum);
-
-					norms[cutcount] = (*fit)->computeNormal();
-					locs[cutcount] = mid;
-					float dmax = -999;
-					DLFLVertexPtr vp,svp;
-					for(int j=0;j<fverts.size();j++){
-						DLFLVertexPtr vp = fverts.at(j);
-						float d = norms[cutcount]*(vp->getCoords() - mid);
-				// printf("d:%f\n",d);
-						if (d>dmax){
-							dmax = d;
-							svp = vp;
-						}
-					}
-					sverts[cutcount] = svp;
-				}
-
-				for(int i = 0; i<cutcount;i++){
-					if (global)
-						peelByPlane(obj,norms[i],locs[i]);	
-					else	localCut(obj, sverts[i],norms[i],locs[i]);
-				}
+	// Geometry phase: work out the cutting planes for the given edges, vertices and
+	// faces, in that order. Nothing in the mesh is changed, so this runs in parallel
+	static void computeCutPlanes( CutContext& cut, const DLFLEdgePtrArray& edges, const DLFLVertexPtrArray& verts,
+																const DLFLFacePtrArray& faces, float offsetE, float offsetV ) {
+		int esize = edges.size(), vsize = verts.size(), fsize = faces.size();
+		int n = esize+vsize+fsize;
+		cut.resize(n);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+		for(int i=0;i<n;i++){
+			if (i<esize) edgeCutPlane(cut,i,edges[i],offsetE);
+			else if (i<esize+vsize) vertexCutPlane(cut,i,verts[i-esize],offsetV);
+			else faceCutPlane(cut,i,faces[i-esize-vsize],offsetV);
+		}
+		cut.cutcount = n;
+		cut.indexEdges();
+	}
 
-				delete [] norms;
-				delete [] locs;
-				delete [] sverts;
-				delete [] sedges;
-	}//end cutselectedFaces Function
+	// Topology phase: make the cuts one after another
+	static void applyCuts( DLFLObjectPtr obj, CutContext& cut, bool global ) {
+		for(int i = 0; i<cut.cutcount;i++){
+			if (global)
+				peelByPlane(obj,cut.norms[i],cut.locs[i]);	
+			else	localCut(obj, cut, cut.sverts[i],cut.norms[i],cut.locs[i]);
+		}
+	}
 
-	void cutSelectedEdges( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+	void performCutting( DLFLObjectPtr obj, int type,float offsetE,float offsetV,bool global,bool selected) {
 
-		// bool global = false;
-		vector<DLFLVertexPtr>::iterator vit;
-		vector<DLFLEdgePtr>::iterator eit,eit2;
-		DLFLEdgePtrArray septrarr = obj->sel_eptr_array;
+		// if (type==204){
+		// 	// truncateEdges(offsetE);
+		// 	return;
+		// }
+		// global = false;
 
 		DLFLEdgePtrArray edges;
 		DLFLVertexPtrArray verts;
 		DLFLFacePtrArray faces;
 
-		cutcount = 0;
-		int vcount = 0;
-		int num=0;
-
-		Vector3d * locs, * norms;
-		obj->getEdges(edges);
-		obj->getVertices(verts);
-		obj->getFaces(faces);
-		int esize 	= edges.size();
-		int vsize		= verts.size();
-		int fsize 	= faces.size();
-		int totalsize 	= esize+vsize+fsize;
-		locs   		= new Vector3d[totalsize];
-		norms  		= new Vector3d[totalsize];
-		sverts 		= new DLFLVertexPtr[totalsize];
-		sedges 		= new DLFLEdgePtr[esize];
-
-		//this loops through all edges??? why?
-		for(eit = septrarr.begin(); eit != septrarr.end(); eit++, cutcount++){
-		sverts[cutcount]=0;
-
-		DLFLVertexPtr vp1,vp2,v;
-		(*eit)->getVertexPointers(vp1,vp2);
-
-		int vnum=0;
-		Vector3d * vlocs = new Vector3d[vp1->valence() + vp2->valence()];
-
-		for(int j=0;j<2;j++){
-		v =(j)?vp2:vp1;
-		DLFLEdgePtrArray vedges;
-		v->getEdges(vedges);
-
-		for(eit2 = vedges.begin(); eit2 != vedges.end(); eit2++){
-			if ( (*eit2) == (*eit) ) continue;
-			DLFLVertexPtr ev1,ev2;
-			(*eit2)->getVertexPointers(ev1,ev2);
-			if (ev2==v){
-				ev2 = ev1;
-				ev1 = v;  
-			}
-			vlocs[vnum++] = (ev2->getCoords() - ev1->getCoords())*offsetE + ev1->getCoords();
-		}
-		}
-
-		//calculate the normal and position 
-		Vector3d vecp,vec,n(0,0,0),nprev,norm(0,0,0),mid(0,0,0);
-		for(int j=0;j<vnum;j++)
-		mid += vlocs[j];
-		mid /= ((float)vnum);
-
-		for(int j=0;j<vnum;j++){
-		vec = (mid - vlocs[j]);
-		if (j==0){
-			vecp = vec;
-			continue;
-		}
-		n = n + vecp % vec;
+		//edges are cut in every mode but by vertex
+		if (type!=201){
+			edges.reserve(obj->num_edges());
+			DLFLEdgePtrList::iterator first = obj->beginEdge(), last = obj->endEdge();
+			for(; first != last; ++first)
+				if ( !selected || (*first)->ismarked ) edges.push_back(*first);
 		}
 
-		DLFLFacePtr f1,f2;
-		(*eit)->getFacePointers(f1,f2);
-		norms[cutcount] = normalized(f1->computeNormal()+f2->computeNormal());
-		locs[cutcount] = mid;
-		sverts[cutcount] = vp1;
-		sedges[cutcount] = (*eit);
-		// cutcount++;
+		//vertices in every mode but by edge
+		if (type!=200){
+			verts.reserve(obj->num_vertices());
+			DLFLVertexPtrList::iterator first = obj->beginVertex(), last = obj->endVertex();
+			for(; first != last; ++first)
+				if ( !selected || (*first)->ismarked ) verts.push_back(*first);
 		}
 
-
-		for(int i = 0; i<cutcount;i++){
-		if (global)
-		peelByPlane(obj,norms[i],locs[i]);	
-		else	localCut(obj, sverts[i],norms[i],locs[i]);
+		//cut by face mode
+		if (type==203){
+			faces.reserve(obj->num_faces());
+			DLFLFacePtrList::iterator first = obj->beginFace(), last = obj->endFace();
+			for(; first != last; ++first)
+				if ( !selected || (*first)->ismarked ) faces.push_back(*first);
 		}
 
-		delete [] norms;
-		delete [] locs;
-		delete [] sverts;
-		delete [] sedges;
+		CutContext cut;
+		computeCutPlanes(cut,edges,verts,faces,offsetE,offsetV);
+		applyCuts(obj,cut,global);
 	}//end performCutting Function
 
-	void cutSelectedVertices( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
-
-		// bool global = false;
-		vector<DLFLVertexPtr>::iterator vit;
-		vector<DLFLEdgePtr>::iterator eit;
-		DLFLVertexPtrArray svptrarr = obj->sel_vptr_array;
-
-		DLFLEdgePtrArray edges;
-		DLFLVertexPtrArray verts;
-		DLFLFacePtrArray faces;
-
-		cutcount = 0;
-		int vcount = 0;
-		int num=0;
-
-		Vector3d * locs, * norms;
-		obj->getEdges(edges);
-		obj->getVertices(verts);
-		obj->getFaces(faces);
-		int esize 	= edges.size();
-		int vsize		= verts.size();
-		int fsize 	= faces.size();
-		int totalsize 	= esize+vsize+fsize;
-		locs   		= new Vector3d[totalsize];
-		norms  		= new Vector3d[totalsize];
-		sverts 		= new DLFLVertexPtr[totalsize];
-		sedges 		= new DLFLEdgePtr[esize];
-
-		//loop through all selected vertices
-		cutcount = 0;
-		for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++, cutcount++){
-			sverts[cutcount]=0;
-
-			DLFLEdgePtrArray vedges;
-			(*vit)->getEdges(vedges);
-
-			int vnum=0;
-			Vector3d * vlocs = new Vector3d[(*vit)->valence()];
-
-		//loop through the edges for the current vertex
-			for(eit = vedges.begin(); eit != vedges.end(); eit++){
-		// DLFLEdgePtr ep = vedges.at(k);
-				DLFLVertexPtr vp1,vp2;
-				(*eit)->getVertexPointers(vp1,vp2);
-		//swap the vertex pointers if necessary
-				if (vp2== (*vit)){
-					vp2 = vp1;
-					vp1 = (*vit);  
-				}
-				vlocs[vnum++] = (vp2->getCoords() - vp1->getCoords())*offsetV + vp1->getCoords();
-			}
-
-		//calculate the normal and position for bevelling
-			Vector3d vecp,vec,n(0,0,0),nprev,norm(0,0,0),mid(0,0,0);
-			for(int j=0;j<vnum;j++)
-				mid += vlocs[j];
-			mid /= ((float)vnum);
-
-			norms[cutcount] = (*vit)->computeNormal();
-			locs[cutcount] = mid;
-			sverts[cutcount] = (*vit);
-		}
+	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+		CutContext cut;
+		computeCutPlanes(cut,DLFLEdgePtrArray(),DLFLVertexPtrArray(),obj->sel_fptr_array,offsetE,offsetV);
+		applyCuts(obj,cut,global);
+	}//end cutselectedFaces Function
 
-		for(int i = 0; i<cutcount;i++){
-			if (global)
-				peelByPlane(obj,norms[i],locs[i]);	
-			else	
-				localCut(obj, sverts[i],norms[i],locs[i]);
-		}
+	void cutSelectedEdges( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+		CutContext cut;
+		computeCutPlanes(cut,obj->sel_eptr_array,DLFLVertexPtrArray(),DLFLFacePtrArray(),offsetE,offsetV);
+		applyCuts(obj,cut,global);
+	}//end cutSelectedEdges Function
 
-		delete [] norms;
-		delete [] locs;
-		delete [] sverts;
-		delete [] sedges;
+	void cutSelectedVertices( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+		CutContext cut;
+		computeCutPlanes(cut,DLFLEdgePtrArray(),obj->sel_vptr_array,DLFLFacePtrArray(),offsetE,offsetV);
+		applyCuts(obj,cut,global);
 	}//end cutSelectedVertices Function
 
 	int isMarked(DLFLVertexPtr vp){
@@ -930,15 +691,15 @@ namespace DLFL {
 		}
 	}
 
-	int getCutIndex(DLFLVertexPtr vp){
-		for(int i=0;i<cutcount;i++)
-			if (sverts[i]==vp) return i;
+	int getCutIndex(const CutContext& cut, DLFLVertexPtr vp){
+		for(int i=0;i<cut.cutcount;i++)
+			if (cut.sverts[i]==vp) return i;
 		return -1;
 	}
 
-	int getCutIndex(DLFLEdgePtr ep){
-		for(int i=0;i<cutcount;i++)
-			if (sedges[i]==ep) return i;
-		return -1;
+	int getCutIndex(const CutContext& cut, DLFLEdgePtr ep){
+		__gnu_cxx::hash_map<DLFLEdgePtr,int,PtrHash>::const_iterator it = cut.edgeindex.find(ep);
+		if (it == cut.edgeindex.end()) return -1;
+		return it->second;
 	}
 } // end namespace
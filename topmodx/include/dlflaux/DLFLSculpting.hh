@@ -33,20 +33,49 @@
 
 namespace DLFL {
 
-  static int s = 0;
-  static DLFLConvexHull * convexhull = NULL;
+  // Scratch state for the local cuts made by one cutting operation.
+  // Created by the caller, so cuts on different objects can run at the same time
+  // State shared by the cuts of one cutting operation. The cutting planes are worked
+  // out first (sverts, sedges, locs, norms), then the cuts are made one by one
+  struct CutContext {
+    DLFLVertexPtrArray sverts;         // Vertex each cut starts from
+    DLFLEdgePtrArray sedges;           // Edge each cut was made for (edge cuts only)
+    Vector3dArray locs;                // Point on each cutting plane
+    Vector3dArray norms;               // Normal of each cutting plane
+    int cutcount;                      // Number of cuts
+    DLFLFaceVertexPtrArray newcorners; // Corners created by the current local cut
+    DLFLEdgePtrArray edges2del;        // Edges to delete after the current local cut
+    DLFLVertexPtrArray visitedverts;   // Elements flagged isvisited by the current local cut
+    DLFLEdgePtrArray visitededges;
+    bool flagsclear;                   // isvisited is known to be 0 on the whole object
+    __gnu_cxx::hash_map<DLFLEdgePtr,int,PtrHash> edgeindex; // sedges -> first cut using it
+
+    CutContext()
+      : sverts(), sedges(), locs(), norms(), cutcount(0), newcorners(), edges2del(),
+	visitedverts(), visitededges(), flagsclear(false), edgeindex()
+    {}
+
+    void resize(int n) {
+      sverts.assign(n,NULL); sedges.assign(n,NULL); locs.resize(n); norms.resize(n);
+      cutcount = 0; flagsclear = false; edgeindex.clear();
+    }
+
+    // Build edgeindex, once sedges and cutcount are final
+    void indexEdges() {
+      edgeindex.clear();
+      for (int i=0; i < cutcount; ++i)
+	if ( sedges[i] ) edgeindex.insert(std::make_pair(sedges[i],i));
+    }
+
+    // Replace the edge of a cut, keeping edgeindex current
+    void setCutEdge(int i, DLFLEdgePtr ep) {
+      __gnu_cxx::hash_map<DLFLEdgePtr,int,PtrHash>::iterator it = edgeindex.find(sedges[i]);
+      if ( it != edgeindex.end() && it->second == i ) edgeindex.erase(it);
+      sedges[i] = ep;
+      if ( ep ) edgeindex.insert(std::make_pair(ep,i));
+    }
+  };
 
-  //new changes; these needs to be declared outside the function for local-cut
-  static DLFLVertexPtr * sverts;
-  static DLFLEdgePtr * sedges;
-  static int cutcount;
-	static DLFLFaceVertexPtr * newcorners;
-	static DLFLEdgePtr * edges2del;
-	// DLFLVertexPtr * sverts;
-	// DLFLEdgePtr * sedges;
-	// int cutcount;
-	static int e2dsize, ncsize;
-	
   void createConvexHull( DLFLObjectPtr obj );
 
   void createDualConvexHull( DLFLObjectPtr obj );
@@ -54,6 +83,7 @@ namespace DLFL {
 
   void peelByPlane( DLFLObjectPtr obj, Vector3d normal,Vector3d P0);
 	void localCut(DLFLObjectPtr obj, DLFLVertexPtr vp,Vector3d normal,Vector3d P0);
+	void localCut(DLFLObjectPtr obj, CutContext& cut, DLFLVertexPtr vp,Vector3d normal,Vector3d P0);
 		
   void performCutting( DLFLObjectPtr obj, int type,float offsetE,float offsetV,bool global,bool selected) ;
 	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false);
@@ -62,7 +92,7 @@ namespace DLFL {
 	
 	int isMarked(DLFLVertexPtr vp);
 	void autoMarkEdges(DLFLObjectPtr obj);
-	int getCutIndex(DLFLVertexPtr vp);
-	int getCutIndex(DLFLEdgePtr ep);
+	int getCutIndex(const CutContext& cut, DLFLVertexPtr vp);
+	int getCutIndex(const CutContext& cut, DLFLEdgePtr ep);
 	
 } // end namespace
@@ -0,0 +1,194 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/*
+  Index for the select similar tools
+*/
+#include "DLFLSimilarity.hh"
+
+#include <algorithm>
+#include <climits>
+
+namespace DLFL {
+
+  void DLFLSimilarityIndex::sync(DLFLObjectPtr obj) {
+    if ( obj != object || obj->changeCount() != stamp ) {
+      invalidate();
+      object = obj; stamp = obj->changeCount();
+    }
+  }
+
+  void DLFLSimilarityIndex::buildFaces( ) {
+    object->getFaces(faces);
+    int n = faces.size();
+    sizes.resize(n);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i < n; ++i)
+      sizes[i] = UintKey(faces[i]->size(),i);
+    sort(sizes.begin(),sizes.end());
+    faceValid = true;
+  }
+
+  void DLFLSimilarityIndex::buildAreas( ) {
+    if ( !faceValid ) buildFaces();
+    int n = faces.size();
+    areas.resize(n);
+    // getArea() only updates the centroid of its own face
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i < n; ++i)
+      areas[i] = FloatKey(faces[i]->getArea(),i);
+    sort(areas.begin(),areas.end());
+    areaValid = true;
+  }
+
+  pair<uint,uint> DLFLSimilarityIndex::edgeValences(DLFLEdgePtr eptr) {
+    DLFLVertexPtr vp1, vp2;
+    eptr->getVertexPointers(vp1,vp2);
+    uint v1 = vp1->numEdges(), v2 = vp2->numEdges();
+    return ( v1 < v2 ) ? pair<uint,uint>(v1,v2) : pair<uint,uint>(v2,v1);
+  }
+
+  void DLFLSimilarityIndex::buildEdges( ) {
+    object->getEdges(edges);
+    int n = edges.size();
+    edgekeys.resize(n);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i < n; ++i)
+      edgekeys[i] = EdgeKey(edgeValences(edges[i]),i);
+    sort(edgekeys.begin(),edgekeys.end());
+    edgeValid = true;
+  }
+
+  void DLFLSimilarityIndex::buildVertices( ) {
+    object->getVertices(vertices);
+    int n = vertices.size();
+    valences.resize(n);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i=0; i < n; ++i)
+      valences[i] = UintKey(vertices[i]->numEdges(),i);
+    sort(valences.begin(),valences.end());
+    vertexValid = true;
+  }
+
+  void DLFLSimilarityIndex::matchingFaces(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray) {
+    fparray.clear();
+    sync(obj);
+    if ( !faceValid ) buildFaces();
+
+    uint key = fptr->size();
+    vector<UintKey>::iterator first, last;
+    first = lower_bound(sizes.begin(),sizes.end(),UintKey(key,0));
+    last = upper_bound(first,sizes.end(),UintKey(key,UINT_MAX));
+    fparray.reserve(last-first);
+    while ( first != last ) {
+      fparray.push_back(faces[first->second]); ++first;
+    }
+  }
+
+  void DLFLSimilarityIndex::matchingEdges(DLFLObjectPtr obj, DLFLEdgePtr eptr, DLFLEdgePtrArray &eparray) {
+    eparray.clear();
+    sync(obj);
+    if ( !edgeValid ) buildEdges();
+
+    pair<uint,uint> key = edgeValences(eptr);
+    vector<EdgeKey>::iterator first, last;
+    first = lower_bound(edgekeys.begin(),edgekeys.end(),EdgeKey(key,0));
+    last = upper_bound(first,edgekeys.end(),EdgeKey(key,UINT_MAX));
+    eparray.reserve(last-first);
+    while ( first != last ) {
+      eparray.push_back(edges[first->second]); ++first;
+    }
+  }
+
+  void DLFLSimilarityIndex::matchingVertices(DLFLObjectPtr obj, DLFLVertexPtr vptr, DLFLVertexPtrArray &vparray) {
+    vparray.clear();
+    sync(obj);
+    if ( !vertexValid ) buildVertices();
+
+    uint key = vptr->numEdges();
+    vector<UintKey>::iterator first, last;
+    first = lower_bound(valences.begin(),valences.end(),UintKey(key,0));
+    last = upper_bound(first,valences.end(),UintKey(key,UINT_MAX));
+    vparray.reserve(last-first);
+    while ( first != last ) {
+      vparray.push_back(vertices[first->second]); ++first;
+    }
+  }
+
+  void DLFLSimilarityIndex::facesByArea(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta) {
+    fparray.clear();
+    sync(obj);
+    if ( !areaValid ) buildAreas();
+
+    float area = fptr->getArea();
+    vector<FloatKey>::iterator first, last;
+    first = lower_bound(areas.begin(),areas.end(),FloatKey(area-delta,0));
+    last = upper_bound(first,areas.end(),FloatKey(area+delta,UINT_MAX));
+
+    // Put the matches back into list order
+    vector<uint> matches;
+    matches.reserve(last-first);
+    while ( first != last ) {
+      matches.push_back(first->second); ++first;
+    }
+    sort(matches.begin(),matches.end());
+    fparray.reserve(matches.size());
+    for (uint i=0; i < matches.size(); ++i)
+      fparray.push_back(faces[matches[i]]);
+  }
+
+  void DLFLSimilarityIndex::facesByColor(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta) {
+    fparray.clear();
+    DLFLMaterialPtr matl = fptr->material();
+    if ( matl == NULL ) return;
+
+    // Walk the face list so the result comes out in list order. A face of another
+    // material only matches if delta is positive and its color is close enough
+    DLFLFacePtrList::iterator first = obj->beginFace(), last = obj->endFace();
+    while ( first != last ) {
+      DLFLFacePtr fp = (*first); ++first;
+      DLFLMaterialPtr mp = fp->material();
+      if ( mp == matl ||
+           ( delta > 0.0 && mp != NULL &&
+             fabs(mp->color.r - matl->color.r) <= delta &&
+             fabs(mp->color.g - matl->color.g) <= delta &&
+             fabs(mp->color.b - matl->color.b) <= delta ) )
+        fparray.push_back(fp);
+    }
+  }
+
+} // end namespace
@@ -0,0 +1,110 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+#ifndef _DLFLSIMILARITY_H_
+#define _DLFLSIMILARITY_H_
+
+#include <DLFLObject.hh>
+
+namespace DLFL {
+
+  /*
+    Index used by the select similar / select by area / select by color tools.
+    Per element descriptors (face valence and area, edge end valences, vertex
+    valence) are computed once and kept in sorted order, so a query is a binary
+    search plus the size of the result instead of a pass over the whole mesh.
+    The index is rebuilt lazily when the object's change count moves on (see
+    DLFLObject::touch()), so repeated clicks on an unchanged mesh reuse it.
+    Results come out in the same order as the object's element lists.
+  */
+  class DLFLSimilarityIndex {
+  public :
+
+    DLFLSimilarityIndex( )
+      : object(NULL), stamp(0), faceValid(false), areaValid(false), edgeValid(false), vertexValid(false) { };
+
+    // Drop everything. Must be called if the object is destroyed without being touched
+    void invalidate( ) {
+      object = NULL; faceValid = areaValid = edgeValid = vertexValid = false;
+      faces.clear(); sizes.clear(); areas.clear();
+      edges.clear(); edgekeys.clear();
+      vertices.clear(); valences.clear();
+    };
+
+    // Faces with the same number of corners as fptr
+    void matchingFaces(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray);
+
+    // Edges whose end points have the same valences as those of eptr
+    void matchingEdges(DLFLObjectPtr obj, DLFLEdgePtr eptr, DLFLEdgePtrArray &eparray);
+
+    // Vertices with the same valence as vptr
+    void matchingVertices(DLFLObjectPtr obj, DLFLVertexPtr vptr, DLFLVertexPtrArray &vparray);
+
+    // Faces whose area is within delta of the area of fptr
+    void facesByArea(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta = 0.1);
+
+    // Faces using the material of fptr. With a positive delta (the color tolerance
+    // preference) faces of other materials are included too, as long as their color
+    // differs by at most delta in each component. Needs no index; one pass over the faces
+    void facesByColor(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta = 0.0);
+
+  protected :
+
+    typedef pair<uint,uint> UintKey;        // (descriptor,index)
+    typedef pair<float,uint> FloatKey;
+    typedef pair<pair<uint,uint>,uint> EdgeKey; // ((lower valence,higher valence),index)
+
+    DLFLObjectPtr object;                  // Object the index was built for
+    uint stamp;                            // Change count of object when it was built
+    bool faceValid, areaValid, edgeValid, vertexValid;
+
+    DLFLFacePtrArray faces;                // Faces in list order
+    vector<UintKey> sizes;                 // Number of corners of each face, sorted
+    vector<FloatKey> areas;                // Area of each face, sorted
+
+    DLFLEdgePtrArray edges;                // Edges in list order
+    vector<EdgeKey> edgekeys;              // End point valences of each edge, sorted
+
+    DLFLVertexPtrArray vertices;           // Vertices in list order
+    vector<UintKey> valences;              // Valence of each vertex, sorted
+
+    // Throw away the index if it was built for another object or an older version of it
+    void sync(DLFLObjectPtr obj);
+
+    void buildFaces( );
+    void buildAreas( );
+    void buildEdges( );
+    void buildVertices( );
+
+    static pair<uint,uint> edgeValences(DLFLEdgePtr eptr);
+  };
+
+} // end namespace
+
+#endif // _DLFLSIMILARITY_H_
@@ -35,6 +35,7 @@
 #include "DLFLSubdiv.hh"
 #include <DLFLCore.hh>
 #include <DLFLCoreExt.hh>
+#include <DLFLProgress.hh>
 #include "DLFLExtrude.hh"
 #include "DLFLConnect.hh"
 
@@ -50,8 +51,11 @@ namespace DLFL {
     Vector3d p1,p2,p1p1,p1n2,p2p1,p2n2;
     Vector3d newpt;
     int num_old_edges = 0;
+    // Old edges are visited twice, old vertices twice
+    DLFLProgress::begin("Loop",2*obj->num_edges()+2*obj->num_vertices());
     efirst = obj->beginEdge(); elast = obj->endEdge();
     while ( efirst != elast ) {
+      if ( !DLFLProgress::step() ) return;
       ep = (*efirst); ++efirst; ++num_old_edges;
       ep->getFaceVertexPointers(fvp1,fvp2);
       fvp1p1 = fvp1->prev(); fvp1n2 = (fvp1->next())->next();
@@ -64,22 +68,23 @@ namespace DLFL {
     }
 
     // For every vertex compute the new point coordinates and adjust the coordinate
+    // The topology hasn't changed yet, so the one-rings come from the adjacency cache
     DLFLVertexPtrList::iterator vfirst, vlast;
     DLFLVertexPtr vp;
     DLFLFaceVertexPtrArray fvparray;
     Vector3d op, p;
     int valence, num_old_verts=0;
     double beta;
-    vfirst = obj->beginVertex(); vlast = obj->endVertex();
-    while ( vfirst != vlast ) {
-      vp = (*vfirst); ++vfirst; ++num_old_verts;
-      vp->getFaceVertices(fvparray);
-      valence = fvparray.size();
+    DLFLAdjacency& adj = obj->adjacency();
+    for (uint v=0; v < adj.numVertices(); ++v) {
+      if ( !DLFLProgress::step() ) return;
+      vp = adj.vertex(v); ++num_old_verts;
+      valence = adj.valence(v);
       if ( valence > 0 ) {
 				p = vp->coords;
 				op.reset();
-				for (int i=0; i < valence; ++i)
-					op += (fvparray[i]->next())->getVertexCoords();
+				for (uint k=adj.ringBegin(v); k < adj.ringEnd(v); ++k)
+					op += (adj.corner(k)->next())->getVertexCoords();
 	
 				beta = ( 0.625 - sqr( 0.375 + 0.25 * cos( 2.0*M_PI/double(valence) ) ) ) / double(valence);
 	
@@ -91,6 +96,7 @@ namespace DLFL {
     int count=0;
     efirst = obj->beginEdge(); elast = obj->endEdge();
     while ( efirst != elast && count < num_old_edges ) {
+      if ( !DLFLProgress::step() ) return;
       ep = (*efirst); ++efirst; ++count;
       newpt = ep->getAuxCoords(); ep->resetAuxCoords();
       vp = subdivideEdge(obj,ep); vp->coords = newpt;
@@ -102,6 +108,7 @@ namespace DLFL {
     vfirst = obj->beginVertex(); vlast = obj->endVertex();
     count = 0;
     while ( vfirst != vlast && count < num_old_verts ) {
+      if ( !DLFLProgress::step() ) return;
       vp = (*vfirst); ++vfirst; ++count;
       vp->getFaceVertices(fvparray);
       for (int i=0; i < fvparray.size(); ++i)
@@ -219,10 +226,12 @@ namespace DLFL {
     DLFLEdgePtrList::iterator el_last = obj->endEdge();
     DLFLEdgePtr ep = NULL;
     int num_edges = 0; 
+    obj->beginBatch();
     while ( el_first != el_last && num_edges < num_old_edges ) {
       ep = (*el_first); ++el_first; ++num_edges;
       deleteEdge(obj,ep,true);
     }
+    obj->endBatch();
   }
 
   void vertexCuttingSubdivide(DLFLObjectPtr obj,double offset) {
@@ -405,14 +414,15 @@ namespace DLFL {
     // fields of each entity (vertex, edge, face)
   
     // Go through each face and compute the centroid and store it in the aux-coords field
-    // Do the makeUnique also to make sure Face IDs are consecutive
+    // Do the makeFacesUnique first to make sure Face IDs are consecutive
     Vector3d cen;
     num_faces = 0;
+    obj->makeFacesUnique();
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     while ( fl_first != fl_last ) {
       fp = (*fl_first); ++fl_first; ++num_faces;
       cen = fp->geomCentroid();
-      fp->setAuxCoords(cen); fp->makeUnique();
+      fp->setAuxCoords(cen);
     }
 	
     // Subdivide all the edges into 3 equal parts.
@@ -503,6 +513,9 @@ namespace DLFL {
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
+    // Every old face is visited twice, every old edge twice and every old vertex once
+    DLFLProgress::begin("Honeycomb",num_old_faces*2+num_old_edges*2+num_old_verts);
+
     // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
     obj->makeEdgesUnique();
   
@@ -518,6 +531,7 @@ namespace DLFL {
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     num_faces = 0;
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
+      if ( !DLFLProgress::step() ) return;
       fp = (*fl_first);
 
       fp->getVertexCoords(vertex_coords);
@@ -581,29 +595,36 @@ namespace DLFL {
 
     // Go through the face_list,obj->num_edges and vertex_list and 
     // destroy all the old faces, edges and vertices
-    num_faces = 0; 
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last && num_faces < num_old_faces ) {
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      obj->removeFace(fp); delete fp;
-    }
+    {
+      DLFLBatchScope batch(obj);
+      num_faces = 0; 
+      fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last && num_faces < num_old_faces ) {
+        if ( !DLFLProgress::step() ) return;
+        fp = (*fl_first); ++fl_first; ++num_faces;
+        obj->eraseFace(fp);
+      }
 
-    num_edges = 0; 
-    el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last && num_edges < num_old_edges ) {
-      ep = (*el_first); ++el_first; ++num_edges;
-      obj->removeEdge(ep); delete ep;
-    }
+      num_edges = 0; 
+      el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last && num_edges < num_old_edges ) {
+        if ( !DLFLProgress::step() ) return;
+        ep = (*el_first); ++el_first; ++num_edges;
+        obj->eraseEdge(ep);
+      }
 
-    num_verts = 0; 
-    vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last && num_verts < num_old_verts ) {
-      vp = (*vl_first); ++vl_first; ++num_verts;
-      obj->removeVertex(vp); delete vp;
+      num_verts = 0; 
+      vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last && num_verts < num_old_verts ) {
+        if ( !DLFLProgress::step() ) return;
+        vp = (*vl_first); ++vl_first; ++num_verts;
+        obj->eraseVertex(vp);
+      }
     }
   
     // Go through fvplist1 and fvplist2 and insert edges between corresponding face-vertices
     for (int i=0; i < num_old_edges; ++i) {
+      if ( !DLFLProgress::step() ) return;
       if ( fvplist1[i] != NULL && fvplist2[i] != NULL )
 				insertEdge(obj,fvplist1[i],fvplist2[i]);
       else
@@ -612,7 +633,7 @@ namespace DLFL {
     }
   }
 
-  bool dooSabinSubdivide(DLFLObjectPtr obj,bool check/*, QProgressDialog *progress*/) {		
+  bool dooSabinSubdivide(DLFLObjectPtr obj,bool check) {
     // Regular Doo-Sabin subdivision scheme
 
     // Go through list of faces and create new inner faces for each face
@@ -629,18 +650,13 @@ namespace DLFL {
     int num_old_faces, num_old_edges, num_old_verts;
     int num_faces, num_edges, num_verts;
     int eistart, edgeindex;
-  	// int progressvalue = 0; // progress bar test dave
 	
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-		//testing qprogressbar - need to figure out a way to do this without putting qt
-		//into the dlfl libraries
-		// if (progress) {
-		// 	progress->setMaximum(num_old_faces*2+num_old_edges*2+num_old_verts);
-		// 	progress->setValue(progressvalue);
-		// }
+    // Every old face is visited twice, every old edge twice and every old vertex once
+    DLFLProgress::begin("Doo-Sabin",num_old_faces*2+num_old_edges*2+num_old_verts);
 
     // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
     obj->makeEdgesUnique();
@@ -653,13 +669,7 @@ namespace DLFL {
 
     fl_first = obj->beginFace(); fl_last = obj->endFace(); num_faces = 0;
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
-			// //update progress bar status - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
+      if ( !DLFLProgress::step() ) return false;
       fp = (*fl_first);
 
       fp->getVertexCoords(vertex_coords);
@@ -717,61 +727,38 @@ namespace DLFL {
 
     // Go through the face_list,obj->num_edges and vertex_list 
     // and destroy all the old faces, edges and vertices
-    num_faces = 0; 
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last && num_faces < num_old_faces ) {
-			//progress bar stuff - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      obj->removeFace(fp); delete fp;
-    }
+    {
+      DLFLBatchScope batch(obj);
+      num_faces = 0; 
+      fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last && num_faces < num_old_faces ) {
+        if ( !DLFLProgress::step() ) return false;
+        fp = (*fl_first); ++fl_first; ++num_faces;
+        obj->eraseFace(fp);
+      }
 
-    num_edges = 0; 
-    el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last && num_edges < num_old_edges ) {
-			//progress bar shit - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
+      num_edges = 0; 
+      el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last && num_edges < num_old_edges ) {
+        if ( !DLFLProgress::step() ) return false;
 			
-      ep = (*el_first); ++el_first; ++num_edges;
-      obj->removeEdge(ep); delete ep;
-    }
-
-    num_verts = 0; 
-    vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last && num_verts < num_old_verts ) {
-			//progress bar stuff - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
+        ep = (*el_first); ++el_first; ++num_edges;
+        obj->eraseEdge(ep);
+      }
 
-      vp = (*vl_first); ++vl_first; ++num_verts;
-      obj->removeVertex(vp); delete vp;
+      num_verts = 0; 
+      vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last && num_verts < num_old_verts ) {
+        if ( !DLFLProgress::step() ) return false;
+        vp = (*vl_first); ++vl_first; ++num_verts;
+        obj->eraseVertex(vp);
+      }
     }
 
     // Go through eplist1,fplist1 and eplist2,fplist2 and connect corresponding half-edges
     DLFLFacePtr fp1, fp2, tfp1, tfp2;
     for (int i=0; i < num_old_edges; ++i) {
-			//progress bar stuff - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
-
+      if ( !DLFLProgress::step() ) return false;
       if ( eplist1[i] != NULL && eplist2[i] != NULL ) {
 				// Find the faces adjacent to the edges which are of type FTNew
 				// These will be the inner faces
@@ -790,9 +777,6 @@ namespace DLFL {
 				cout << "NULL pointers found! i = " << i << " "
 						 << eplist1[i] << " -- " << eplist2[i] << endl;
     }
-		// //progress bar stuff - dave
-		// if (progress)
-		// 	progress->setValue(num_old_faces*2+num_old_edges*2+num_old_verts);
 		return true;
   }
 
@@ -889,22 +873,25 @@ namespace DLFL {
     }
 
     // Go through the face_list,obj->num_edges and vertex_list and destroy all the old faces, edges and vertices
-    num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last && num_faces < num_old_faces ) {
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      obj->removeFace(fp); delete fp;
-    }
+    {
+      DLFLBatchScope batch(obj);
+      num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last && num_faces < num_old_faces ) {
+        fp = (*fl_first); ++fl_first; ++num_faces;
+        obj->eraseFace(fp);
+      }
 
-    num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last && num_edges < num_old_edges ) {
-      ep = (*el_first); ++el_first; ++num_edges;
-      obj->removeEdge(ep); delete ep;
-    }
+      num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last && num_edges < num_old_edges ) {
+        ep = (*el_first); ++el_first; ++num_edges;
+        obj->eraseEdge(ep);
+      }
 
-    num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last && num_verts < num_old_verts ) {
-      vp = (*vl_first); ++vl_first; ++num_verts;
-      obj->removeVertex(vp); delete vp;
+      num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last && num_verts < num_old_verts ) {
+        vp = (*vl_first); ++vl_first; ++num_verts;
+        obj->eraseVertex(vp);
+      }
     }
 
     // Go through eplist1,fplist1 and eplist2,fplist2 and connect corresponding half-edges
@@ -1064,22 +1051,25 @@ namespace DLFL {
     }
 
     // Go through the face_list,obj->num_edges and vertex_list and destroy all the old faces, edges and vertices
-    num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last && num_faces < num_old_faces ) {
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      obj->removeFace(fp); delete fp;
-    }
+    {
+      DLFLBatchScope batch(obj);
+      num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last && num_faces < num_old_faces ) {
+        fp = (*fl_first); ++fl_first; ++num_faces;
+        obj->eraseFace(fp);
+      }
 
-    num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last && num_edges < num_old_edges ) {
-      ep = (*el_first); ++el_first; ++num_edges;
-      obj->removeEdge(ep); delete ep;
-    }
+      num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last && num_edges < num_old_edges ) {
+        ep = (*el_first); ++el_first; ++num_edges;
+        obj->eraseEdge(ep);
+      }
 
-    num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last && num_verts < num_old_verts ) {
-      vp = (*vl_first); ++vl_first; ++num_verts;
-      obj->removeVertex(vp); delete vp;
+      num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last && num_verts < num_old_verts ) {
+        vp = (*vl_first); ++vl_first; ++num_verts;
+        obj->eraseVertex(vp);
+      }
     }
 
     // Go through eplist1,fplist1 and eplist2,fplist2 and connect corresponding half-edges
@@ -1230,22 +1220,25 @@ namespace DLFL {
     }
 
     // Go through the face_list,obj->num_edges and vertex_list and destroy all the old faces, edges and vertices
-    num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last && num_faces < num_old_faces ) {
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      obj->removeFace(fp); delete fp;
-    }
+    {
+      DLFLBatchScope batch(obj);
+      num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last && num_faces < num_old_faces ) {
+        fp = (*fl_first); ++fl_first; ++num_faces;
+        obj->eraseFace(fp);
+      }
 
-    num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last && num_edges < num_old_edges ) {
-      ep = (*el_first); ++el_first; ++num_edges;
-      obj->removeEdge(ep); delete ep;
-    }
+      num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last && num_edges < num_old_edges ) {
+        ep = (*el_first); ++el_first; ++num_edges;
+        obj->eraseEdge(ep);
+      }
 
-    num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last && num_verts < num_old_verts ) {
-      vp = (*vl_first); ++vl_first; ++num_verts;
-      obj->removeVertex(vp); delete vp;
+      num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last && num_verts < num_old_verts ) {
+        vp = (*vl_first); ++vl_first; ++num_verts;
+        obj->eraseVertex(vp);
+      }
     }
 
     // Go through eplist1,fplist1 and eplist2,fplist2 and connect corresponding half-edges
@@ -1350,12 +1343,14 @@ namespace DLFL {
     DLFLEdgePtr eptr = NULL;
     el_first = obj->beginEdge(); el_last = obj->endEdge();
   
+    obj->beginBatch();
     while ( el_first != el_last ) {
       eptr = (*el_first);
       ++el_first; ++count;
       deleteEdge(obj,eptr);
       if ( count >= numoldedges ) break; // Done with old edges
     }
+    obj->endBatch();
 
     // Go through vertex list and move all the old vertices
     count = 0;
@@ -1412,6 +1407,11 @@ namespace DLFL {
     int num_old_faces, num_old_edges;
   
 
+    // Faces and edges are visited twice (the new edges two per old edge),
+    // vertices once
+    num_old_edges = obj->num_edges();
+    DLFLProgress::begin("Catmull-Clark",2*obj->num_faces()+4*num_old_edges+obj->num_vertices());
+
     // Reset aux coords in each vertex
     vl_first = obj->beginVertex(); vl_last = obj->endVertex();
     while ( vl_first != vl_last ) {
@@ -1423,15 +1423,17 @@ namespace DLFL {
     // fields of each class
   
     // Go through each face and compute the centroid and store it in the aux-coords field
-    // Do the makeUnique also to make sure Face IDs are consecutive
+    // Do the makeFacesUnique first to make sure Face IDs are consecutive
     // Send the contribution to all vertexes belonging to this face
     Vector3d cen;
     num_faces = 0;
+    obj->makeFacesUnique();
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     while ( fl_first != fl_last ) {
+      if ( !DLFLProgress::step() ) return;
       fp = (*fl_first); ++fl_first; ++num_faces;
       cen = fp->geomCentroid();
-      fp->setAuxCoords(cen); fp->makeUnique();
+      fp->setAuxCoords(cen);
 
       // Send contribution of this face to all vertices in this face
       DLFLFaceVertexPtr current, head;
@@ -1448,6 +1450,7 @@ namespace DLFL {
     num_edges = 0;
     el_first = obj->beginEdge(); el_last = obj->endEdge();
     while ( el_first != el_last ) {
+      if ( !DLFLProgress::step() ) return;
       ep = (*el_first); ++el_first; ++num_edges;
       ep->getFacePointers(efp1,efp2);
       mp = ep->getMidPoint(true); afp = ( efp1->getAuxCoords() + efp2->getAuxCoords() ) / 2.0;
@@ -1466,6 +1469,7 @@ namespace DLFL {
     int n;
     vl_first = obj->beginVertex(); vl_last = obj->endVertex();
     while ( vl_first != vl_last ) {
+      if ( !DLFLProgress::step() ) return;
       vp = (*vl_first); ++vl_first;
       n = vp->valence();
       ave_fep = vp->getAuxCoords(); vp->resetAuxCoords();
@@ -1486,6 +1490,7 @@ namespace DLFL {
 
     num_old_faces = num_faces; num_faces = 0;
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
+      if ( !DLFLProgress::step() ) return;
       fp = (*fl_first); ++fl_first; ++num_faces;
       faceindex = fp->getID() - fistart;
       fvp = obj->createPointSphere(fp->getAuxCoords(),fp->material());
@@ -1510,6 +1515,7 @@ namespace DLFL {
     el_first = obj->beginEdge(); el_last = obj->endEdge();
     fvparray.reserve(2);
     while ( el_first != el_last && num_edges < num_old_edges ) {
+      if ( !DLFLProgress::step() ) return;
       ep = (*el_first); ++el_first; ++num_edges;
 
       edgept = ep->getAuxCoords(); ep->resetAuxCoords();
@@ -1533,6 +1539,7 @@ namespace DLFL {
     // Make all connections
     DLFLFaceVertexPtr fvp1, fvp2;
     for (int j=0; j < numconn; ++j) {
+      if ( !DLFLProgress::step() ) return;
       fvp1 = fvplist[j];
        
       // Find the face-vertex referring to vp which is in the same face as fvp1
@@ -1635,10 +1642,12 @@ namespace DLFL {
     DLFLEdgePtr ep = NULL;
     int num_edges = 0; 
   
+    obj->beginBatch();
     while ( el_first != el_last && num_edges < num_old_edges ) {
       ep = (*el_first); ++el_first; ++num_edges;
       deleteEdge(obj,ep,true);
     }
+    obj->endBatch();
 
     DLFLFaceVertexPtr fvp1, fvp2;
 
@@ -1758,7 +1767,7 @@ namespace DLFL {
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
       fp = (*fl_first); ++fl_first; ++num_faces;
       cen = fp->geomCentroid();
-      fp->setAuxCoords(cen); fp->makeUnique();
+      fp->setAuxCoords(cen);
 
       stellateFace(obj, fp, 0);
     }
@@ -1769,12 +1778,14 @@ namespace DLFL {
     DLFLEdgePtr eptr = NULL;
     el_first = obj->beginEdge(); el_last = obj->endEdge();
 
+    obj->beginBatch();
     while ( el_first != el_last ) {
       eptr = (*el_first);
       ++el_first; ++count;
       deleteEdge(obj,eptr);
       if ( count >= num_old_edges ) break; // Done with old edges
     }
+    obj->endBatch();
   }
 
   void twostellateSubdivide(DLFLObjectPtr obj, double offset, double curve) { // Eric
@@ -1791,7 +1802,7 @@ namespace DLFL {
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
       fp = (*fl_first); ++fl_first; ++num_faces;
       cen = fp->geomCentroid();
-      fp->setAuxCoords(cen); fp->makeUnique();
+      fp->setAuxCoords(cen);
       stellateFace(obj,fp, offset);
     }
 
@@ -1803,7 +1814,7 @@ namespace DLFL {
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
       fp = (*fl_first); ++fl_first; ++num_faces;
       cen = fp->geomCentroid();
-      fp->setAuxCoords(cen); fp->makeUnique();
+      fp->setAuxCoords(cen);
       stellateFace(obj,fp, curve);
     }
 
@@ -1812,12 +1823,14 @@ namespace DLFL {
     DLFLEdgePtrList::iterator el_first, el_last;
     DLFLEdgePtr eptr = NULL;
     el_first = obj->beginEdge(); el_last = obj->endEdge();
+    obj->beginBatch();
     while ( el_first != el_last ) {
       eptr = (*el_first);
       ++el_first; ++count;
       deleteEdge(obj,eptr);
       if ( count >= num_old_edges ) break; // Done with old edges
     }
+    obj->endBatch();
   }
 
   //----- Begin Additions by Bei & Cansin -----//
@@ -1909,11 +1922,7 @@ namespace DLFL {
     num_old_edges = obj->num_edges();
 
     // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    DLFLEdgePtrList::iterator efirst=obj->beginEdge(), elast=obj->endEdge();
-    while ( efirst != elast ) {
-      (*efirst)->makeUnique();
-      ++efirst;
-    }
+    obj->makeEdgesUnique();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     eplist1.reserve(num_old_edges); eplist2.reserve(num_old_edges);
@@ -1983,22 +1992,25 @@ namespace DLFL {
     }
 
     // Go through the face_list,obj->num_edges and vertex_list and destroy all the old faces, edges and vertices
-    num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last && num_faces < num_old_faces ) {
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      obj->removeFace(fp); delete fp;
-    }
+    {
+      DLFLBatchScope batch(obj);
+      num_faces = 0; fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last && num_faces < num_old_faces ) {
+        fp = (*fl_first); ++fl_first; ++num_faces;
+        obj->eraseFace(fp);
+      }
 
-    num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last && num_edges < num_old_edges ) {
-      ep = (*el_first); ++el_first; ++num_edges;
-      obj->removeEdge(ep); delete ep;
-    }
+      num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last && num_edges < num_old_edges ) {
+        ep = (*el_first); ++el_first; ++num_edges;
+        obj->eraseEdge(ep);
+      }
 
-    num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last && num_verts < num_old_verts ) {
-      vp = (*vl_first); ++vl_first; ++num_verts;
-      obj->removeVertex(vp); delete vp;
+      num_verts = 0; vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last && num_verts < num_old_verts ) {
+        vp = (*vl_first); ++vl_first; ++num_verts;
+        obj->eraseVertex(vp);
+      }
     }
 	
     // Go through eplist1,fplist1 and eplist2,fplist2 and connect corresponding half-edges
@@ -2121,10 +2133,12 @@ namespace DLFL {
 
     // delete old edges
     num_edges = 0; el_first = obj->beginEdge(); el_last = obj->endEdge();
+    obj->beginBatch();
     while ( el_first != el_last && num_edges < num_old_edges ) {
       ep = (*el_first); ++el_first; ++num_edges;
       deleteEdge(obj,ep);
     }
+    obj->endBatch();
 
     // delete old edges while insert an new edge between two newly extrude faces
     num_old_edges = obj->num_edges();
@@ -30,8 +30,9 @@
 #define _DLFLSUBDIV_H_
 
 #include <DLFLObject.hh>
-// #include <QApplication>
-// #include <QProgressDialog>
+
+// The global subdivision schemes report their progress and stop early when
+// cancelled, see DLFLProgress.hh. dooSabinSubdivide returns false then
 
 namespace DLFL {
 
@@ -42,7 +43,7 @@ namespace DLFL {
   void pentagonalSubdivide2(DLFLObjectPtr obj, double scale_factor=0.75);
   void pentagonalSubdivide(DLFLObjectPtr obj, double offset=0);
   void honeycombSubdivide(DLFLObjectPtr obj);
-  bool dooSabinSubdivide(DLFLObjectPtr obj, bool check=true /*,QProgressDialog *progress = 0*/);
+  bool dooSabinSubdivide(DLFLObjectPtr obj, bool check=true);
   void dooSabinSubdivideBC(DLFLObjectPtr obj, bool check=true);
   void dooSabinSubdivideBCNew(DLFLObjectPtr obj, double sf, double length);
   void cornerCuttingSubdivide(DLFLObjectPtr obj, float alpha);
@@ -7,6 +7,18 @@ TARGET = dlflaux
 INCLUDEPATH += .. ../vecmat ../dlflcore
 DESTDIR = ../../lib
 
+# multithreaded index building, comment out to build single threaded
+CONFIG += WITH_OPENMP
+
+CONFIG(WITH_OPENMP){
+ DEFINES *= WITH_OPENMP
+ win32-msvc* {
+  QMAKE_CXXFLAGS += -openmp
+ } else {
+  QMAKE_CXXFLAGS += -fopenmp
+ }
+}
+
 macx {
  # compile release + universal binary
  #QMAKE_LFLAGS += -F../../lib
@@ -29,6 +41,7 @@ HEADERS += \
 	DLFLMeshSmooth.hh  \
 	DLFLMultiConnect.hh  \
 	DLFLSculpting \
+	DLFLSimilarity.hh \
 	DLFLSubdiv.hh
 
 SOURCES += \
@@ -41,4 +54,5 @@ SOURCES += \
 	DLFLMeshSmooth.cc  \
 	DLFLMultiConnect.cc  \
 	DLFLSculpting.cc \
+	DLFLSimilarity.cc \
 	DLFLSubdiv.cc
@@ -0,0 +1,468 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file dlflbench.cc
+ */
+
+// Benchmark for the dlflcore and dlflaux operations.
+//
+// Builds deterministic meshes in memory and times each operation on a fresh
+// copy of each mesh. Prints one JSON object per line for every (mesh, op)
+// pair so the output of two builds can be compared directly.
+//
+//   dlflbench [-r repeats] [-m mesh]... [-o op]... [-l]
+//
+// Meshes are "cube", "sponge<level>" (Menger sponge built from cubes, as in
+// DLFLStandardObjects) and "grid<n>" (an n x 2n quad torus). On unix every
+// case runs in its own process, so the reported peak memory belongs to that
+// case alone and a crash only fails that case.
+
+#include <DLFLObject.hh>
+#include <DLFLCore.hh>
+#include <DLFLSubdiv.hh>
+#include <DLFLCrust.hh>
+#include <DLFLDual.hh>
+#include <DLFLMultiConnect.hh>
+#include <DLFLExtrude.hh>
+
+#ifdef WITH_PATCHES
+#include "TMPatchObject.hh"
+#include "DLFLLighting.hh"
+#include <PointLight.hh>
+#endif
+
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+
+#ifndef _WIN32
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace DLFL;
+
+//-- Mesh generation --//
+
+static void writeCube( ostream& o, double x, double y, double z, double s, int& nv ) {
+  static const int corners[8][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+                                     {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+  static const int faces[6][4] = { {0,3,2,1}, {4,5,6,7}, {0,1,5,4},
+                                   {2,3,7,6}, {1,2,6,5}, {0,4,7,3} };
+  for (int i=0; i < 8; ++i)
+    o << "v " << x+corners[i][0]*s << ' ' << y+corners[i][1]*s << ' ' << z+corners[i][2]*s << '\n';
+  for (int i=0; i < 6; ++i)
+    o << "f " << nv+faces[i][0] << ' ' << nv+faces[i][1] << ' '
+      << nv+faces[i][2] << ' ' << nv+faces[i][3] << '\n';
+  nv += 8;
+}
+
+// Menger sponge as separate cubes. Cell (i,j,k) of the 3x3x3 block is
+// dropped when two or more of its indices are 1
+static void writeSponge( ostream& o, int level, double x, double y, double z, double s, int& nv ) {
+  if ( level == 0 ) { writeCube(o,x,y,z,s,nv); return; }
+  double s3 = s/3.0;
+  for (int i=0; i < 3; ++i)
+    for (int j=0; j < 3; ++j)
+      for (int k=0; k < 3; ++k)
+        if ( (i==1) + (j==1) + (k==1) < 2 )
+          writeSponge(o,level-1,x+i*s3,y+j*s3,z+k*s3,s3,nv);
+}
+
+// Closed quad grid wrapped into a torus, n rings of 2n quads
+static void writeGrid( ostream& o, int n ) {
+  int m = 2*n;
+  for (int i=0; i < n; ++i) {
+    double v = 2.0*M_PI*i/n;
+    for (int j=0; j < m; ++j) {
+      double u = 2.0*M_PI*j/m;
+      double r = 2.0 + 0.75*cos(v);
+      o << "v " << r*cos(u) << ' ' << r*sin(u) << ' ' << 0.75*sin(v) << '\n';
+    }
+  }
+  for (int i=0; i < n; ++i)
+    for (int j=0; j < m; ++j) {
+      int i1 = (i+1)%n, j1 = (j+1)%m;
+      o << "f " << i*m+j+1 << ' ' << i*m+j1+1 << ' ' << i1*m+j1+1 << ' ' << i1*m+j+1 << '\n';
+    }
+}
+
+// OBJ text for the named mesh, empty if the name is not recognised
+static string meshText( const string& name ) {
+  ostringstream o;
+  o.precision(10);
+  int nv = 1;
+  if ( name == "cube" ) writeCube(o,-0.5,-0.5,-0.5,1.0,nv);
+  else if ( name.compare(0,6,"sponge") == 0 && name.size() > 6 ) {
+    int level = atoi(name.c_str()+6);
+    if ( level < 1 || level > 4 ) return string();
+    writeSponge(o,level,-1.5,-1.5,-1.5,3.0,nv);
+  } else if ( name.compare(0,4,"grid") == 0 && name.size() > 4 ) {
+    int n = atoi(name.c_str()+4);
+    if ( n < 3 ) return string();
+    writeGrid(o,n);
+  }
+  return o.str();
+}
+
+static void loadMesh( DLFLObject& obj, const string& text ) {
+  istringstream in(text), mtl("");
+  obj.readObject(in,mtl);
+  obj.computeNormals();
+}
+
+//-- Operations --//
+
+// State for one run of an operation. setup() prepares it untimed, run() is timed
+struct BenchCase {
+  string text;                 // OBJ text of the mesh
+  DLFLObjectPtr obj;           // Fresh copy of the mesh
+  DLFLFaceVertexPtrArray fvs;  // Corner pairs for the edge insertion storm
+  DLFLEdgePtrArray edges;      // Edges for the edge deletion storm
+  DLFLFacePtrArray faces;      // Faces for multiConnectFaces
+#ifdef WITH_PATCHES
+  TMPatchObject * patches;
+  PointLight light;
+#endif
+};
+
+typedef void (*BenchFunc)( BenchCase& );
+
+struct BenchOp {
+  const char * name;
+  BenchFunc setup;             // May be NULL
+  BenchFunc run;
+};
+
+static void opLoad( BenchCase& c ) { loadMesh(*c.obj,c.text); }
+static void opSave( BenchCase& c ) { ostringstream o, m; c.obj->writeObject(o,m); }
+static void opSaveDLFL( BenchCase& c ) { ostringstream o, m; c.obj->writeDLFL(o,m); }
+static void opNormals( BenchCase& c ) { c.obj->computeNormals(); }
+
+// Pick a diagonal in every face with 4 or more corners
+static void setupInsert( BenchCase& c ) {
+  c.fvs.clear();
+  DLFLFacePtrList::iterator fl = c.obj->beginFace(), fle = c.obj->endFace();
+  while ( fl != fle ) {
+    DLFLFacePtr fp = *fl; ++fl;
+    if ( fp->size() < 4 ) continue;
+    DLFLFaceVertexPtr fv = fp->firstVertex();
+    c.fvs.push_back(fv); c.fvs.push_back(fv->next()->next());
+  }
+}
+
+static void opInsert( BenchCase& c ) {
+  c.edges.clear();
+  for (uint i=0; i+1 < c.fvs.size(); i += 2)
+    c.edges.push_back(insertEdge(c.obj,c.fvs[i],c.fvs[i+1]));
+}
+
+static void setupDelete( BenchCase& c ) { setupInsert(c); opInsert(c); }
+
+static void opDelete( BenchCase& c ) {
+  for (uint i=0; i < c.edges.size(); ++i)
+    if ( c.edges[i] ) deleteEdge(c.obj,c.edges[i],true);
+}
+
+// A few faces spread over the mesh
+static void setupMultiConnect( BenchCase& c ) {
+  c.obj->getFaces(c.faces);
+  DLFLFacePtrArray sel;
+  uint step = c.faces.size()/4;
+  for (uint i=0; i < c.faces.size() && sel.size() < 4; i += (step ? step : 1)) sel.push_back(c.faces[i]);
+  c.faces = sel;
+}
+
+static void opMultiConnect( BenchCase& c ) { multiConnectFaces(c.obj,c.faces,0.01); }
+
+// Every eighth face, for the multi-face handle algorithms
+static void setupMultiHandle( BenchCase& c ) {
+  DLFLFacePtrArray all;
+  c.obj->getFaces(all);
+  c.faces.clear();
+  for (uint i=0; i < all.size(); i += 8) c.faces.push_back(all[i]);
+}
+
+static void opMultiHandle( BenchCase& c ) { multiConnectFaces(c.obj,c.faces); }
+static void opMultiHull( BenchCase& c ) { multiConnectFaces(c.obj,c.faces,1.0,0.0,true); }
+
+// Every face, for the extrusions of the selection
+static void setupExtrude( BenchCase& c ) { c.obj->getFaces(c.faces); }
+
+static void opExtrude( BenchCase& c ) { extrudeFaces(c.obj,c.faces,0.2,1,10.0,0.8); }
+static void opExtrudeDS( BenchCase& c ) { extrudeFacesDS(c.obj,c.faces,0.2,1,0.1,0.9); }
+static void opExtrudeDual( BenchCase& c ) { extrudeDualFaces(c.obj,c.faces,0.2,1,10.0,0.9); }
+static void opStellateFaces( BenchCase& c ) { stellateFaces(c.obj,c.faces,0.2); }
+
+static void opCrust( BenchCase& c ) { CrustInfo ci; createCrust(c.obj,ci,0.05,true); }
+static void opDual( BenchCase& c ) { createDual(c.obj); }
+static void opSponge( BenchCase& c ) { createSponge(c.obj,0.1); }
+
+static void opLoop( BenchCase& c ) { loopSubdivide(c.obj); }
+static void opCheckerBoard( BenchCase& c ) { checkerBoardRemeshing(c.obj); }
+static void opSimplest( BenchCase& c ) { simplestSubdivide(c.obj); }
+static void opVertexCutting( BenchCase& c ) { vertexCuttingSubdivide(c.obj); }
+static void opPentagonal( BenchCase& c ) { pentagonalSubdivide(c.obj); }
+static void opPentagonal2( BenchCase& c ) { pentagonalSubdivide2(c.obj); }
+static void opHoneycomb( BenchCase& c ) { honeycombSubdivide(c.obj); }
+static void opDooSabin( BenchCase& c ) { dooSabinSubdivide(c.obj); }
+static void opDooSabinBC( BenchCase& c ) { dooSabinSubdivideBC(c.obj); }
+static void opDooSabinBCNew( BenchCase& c ) { dooSabinSubdivideBCNew(c.obj,1.0,1.0); }
+static void opCornerCutting( BenchCase& c ) { cornerCuttingSubdivide(c.obj,0.25); }
+static void opModCornerCutting( BenchCase& c ) { modifiedCornerCuttingSubdivide(c.obj,0.1); }
+static void opModCornerCutting2( BenchCase& c ) { modifiedCornerCuttingSubdivide2(c.obj,0.5); }
+static void opRoot4( BenchCase& c ) { root4Subdivide(c.obj); }
+static void opCatmullClark( BenchCase& c ) { catmullClarkSubdivide(c.obj); }
+static void opStar( BenchCase& c ) { starSubdivide(c.obj); }
+static void opSqrt3( BenchCase& c ) { sqrt3Subdivide(c.obj); }
+static void opFractal( BenchCase& c ) { fractalSubdivide(c.obj); }
+static void opStellate( BenchCase& c ) { stellateSubdivide(c.obj); }
+static void opTwoStellate( BenchCase& c ) { twostellateSubdivide(c.obj,0.0,0.0); }
+static void opDome( BenchCase& c ) { domeSubdivide(c.obj,1.0,1.0); }
+static void opDual1264( BenchCase& c ) { dual1264Subdivide(c.obj,0.5); }
+static void opLoopStyle( BenchCase& c ) { loopStyleSubdivide(c.obj,1.0); }
+
+#ifdef WITH_PATCHES
+// Same light setup as GLWidget
+static void setupLight( BenchCase& c ) {
+  c.light.position.set(50,25,0);
+  c.light.warmcolor.set(1,1,0.6);
+  c.light.coolcolor.set(0.2,0.2,0.4);
+  c.light.intensity = 2.0;
+}
+
+static void opPatches( BenchCase& c ) { c.patches->updatePatches(c.obj); }
+
+static void setupLighting( BenchCase& c ) { setupLight(c); opPatches(c); }
+
+static void opLighting( BenchCase& c ) { computeLighting(c.obj,c.patches,&c.light); }
+#endif
+
+static const BenchOp ops[] = {
+  { "load", NULL, opLoad },
+  { "save", NULL, opSave },
+  { "savedlfl", NULL, opSaveDLFL },
+  { "normals", NULL, opNormals },
+  { "insertedges", setupInsert, opInsert },
+  { "deleteedges", setupDelete, opDelete },
+  { "loop", NULL, opLoop },
+  { "checkerboard", NULL, opCheckerBoard },
+  { "simplest", NULL, opSimplest },
+  { "vertexcutting", NULL, opVertexCutting },
+  { "pentagonal", NULL, opPentagonal },
+  { "pentagonal2", NULL, opPentagonal2 },
+  { "honeycomb", NULL, opHoneycomb },
+  { "doosabin", NULL, opDooSabin },
+  { "doosabinbc", NULL, opDooSabinBC },
+  { "doosabinbcnew", NULL, opDooSabinBCNew },
+  { "cornercutting", NULL, opCornerCutting },
+  { "modcornercutting", NULL, opModCornerCutting },
+  { "modcornercutting2", NULL, opModCornerCutting2 },
+  { "root4", NULL, opRoot4 },
+  { "catmullclark", NULL, opCatmullClark },
+  { "star", NULL, opStar },
+  { "sqrt3", NULL, opSqrt3 },
+  { "fractal", NULL, opFractal },
+  { "stellate", NULL, opStellate },
+  { "twostellate", NULL, opTwoStellate },
+  { "dome", NULL, opDome },
+  { "dual1264", NULL, opDual1264 },
+  { "loopstyle", NULL, opLoopStyle },
+  { "crust", NULL, opCrust },
+  { "dual", NULL, opDual },
+  { "sponge", NULL, opSponge },
+  { "multiconnect", setupMultiConnect, opMultiConnect },
+  { "multihandle", setupMultiHandle, opMultiHandle },
+  { "multihull", setupMultiHandle, opMultiHull },
+  { "extrude", setupExtrude, opExtrude },
+  { "extrudeds", setupExtrude, opExtrudeDS },
+  { "extrudedual", setupExtrude, opExtrudeDual },
+  { "stellatefaces", setupExtrude, opStellateFaces },
+#ifdef WITH_PATCHES
+  { "patches", NULL, opPatches },
+  { "lighting", setupLighting, opLighting },
+#endif
+  { NULL, NULL, NULL }
+};
+
+static const char * defaultMeshes[] = { "cube", "sponge1", "sponge2", "grid8", "grid16", NULL };
+
+//-- Timing --//
+
+static FILE * results = stdout; // Result lines, kept apart from anything the library prints
+
+// Wall clock time in seconds
+static double now( ) {
+#ifndef _WIN32
+  struct timeval tv;
+  gettimeofday(&tv,NULL);
+  return tv.tv_sec + tv.tv_usec*1e-6;
+#else
+  return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+// Peak resident size of this process in kilobytes, 0 if unknown
+static long peakMemory( ) {
+#ifndef _WIN32
+  struct rusage ru;
+  if ( getrusage(RUSAGE_SELF,&ru) != 0 ) return 0;
+#ifdef __APPLE__
+  return ru.ru_maxrss/1024; // Bytes on Mac OS X
+#else
+  return ru.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+// Run one (mesh, op) case and print its result line
+static void runCase( const string& mesh, const BenchOp& op, int repeats ) {
+  BenchCase c;
+  c.text = meshText(mesh);
+  double best = 0.0, total = 0.0, destroy = 0.0;
+  size_t faces = 0, verts = 0, edges = 0;
+  size_t ofaces = 0, overts = 0, oedges = 0;
+  for (int r=0; r < repeats; ++r) {
+    c.obj = new DLFLObject();
+#ifdef WITH_PATCHES
+    c.patches = new TMPatchObject(0);
+#endif
+    if ( op.run != opLoad ) loadMesh(*c.obj,c.text);
+    if ( op.setup ) op.setup(c);
+    faces = c.obj->num_faces(); verts = c.obj->num_vertices(); edges = c.obj->num_edges();
+
+    double start = now();
+    op.run(c);
+    double t = now() - start;
+
+    if ( r == 0 || t < best ) best = t;
+    total += t;
+    ofaces = c.obj->num_faces(); overts = c.obj->num_vertices(); oedges = c.obj->num_edges();
+#ifdef WITH_PATCHES
+    delete c.patches;
+#endif
+    // Tearing down the result is timed separately, it is not free for large meshes
+    start = now();
+    delete c.obj;
+    t = now() - start;
+    if ( r == 0 || t < destroy ) destroy = t;
+  }
+  fprintf(results,"{\"mesh\":\"%s\",\"op\":\"%s\",\"status\":\"ok\",\"repeats\":%d,"
+         "\"faces\":%lu,\"vertices\":%lu,\"edges\":%lu,"
+         "\"out_faces\":%lu,\"out_vertices\":%lu,\"out_edges\":%lu,"
+         "\"best_s\":%.6f,\"mean_s\":%.6f,\"delete_s\":%.6f,\"peak_kb\":%ld}\n",
+         mesh.c_str(),op.name,repeats,
+         (unsigned long)faces,(unsigned long)verts,(unsigned long)edges,
+         (unsigned long)ofaces,(unsigned long)overts,(unsigned long)oedges,
+         best,total/repeats,destroy,peakMemory());
+  fflush(results);
+}
+
+// Run a case in a child process when possible. A case which crashes is
+// reported with its exit status instead of taking down the whole run
+static void benchCase( const string& mesh, const BenchOp& op, int repeats ) {
+#ifndef _WIN32
+  fflush(results);
+  pid_t pid = fork();
+  if ( pid == 0 ) {
+    runCase(mesh,op,repeats);
+    _exit(0);
+  }
+  int status = 0;
+  if ( pid > 0 && waitpid(pid,&status,0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0 )
+    return;
+  fprintf(results,"{\"mesh\":\"%s\",\"op\":\"%s\",\"status\":\"failed\",\"signal\":%d}\n",
+         mesh.c_str(),op.name,(pid > 0 && WIFSIGNALED(status)) ? WTERMSIG(status) : 0);
+  fflush(results);
+#else
+  runCase(mesh,op,repeats);
+#endif
+}
+
+static void usage( const char * prog ) {
+  fprintf(stderr,"usage: %s [-r repeats] [-m mesh]... [-o op]... [-l]\n",prog);
+  fprintf(stderr,"  meshes: cube, sponge<1-4>, grid<n> (default:");
+  for (int i=0; defaultMeshes[i]; ++i) fprintf(stderr," %s",defaultMeshes[i]);
+  fprintf(stderr,")\n  -l lists the operations\n");
+}
+
+int main( int argc, char ** argv ) {
+  int repeats = 3;
+  vector<string> meshes;
+  vector<const BenchOp *> selected;
+
+  for (int i=1; i < argc; ++i) {
+    if ( !strcmp(argv[i],"-r") && i+1 < argc ) {
+      repeats = atoi(argv[++i]);
+      if ( repeats < 1 ) repeats = 1;
+    } else if ( !strcmp(argv[i],"-m") && i+1 < argc ) {
+      meshes.push_back(argv[++i]);
+      if ( meshText(meshes.back()).empty() ) {
+        fprintf(stderr,"unknown mesh %s\n",argv[i]);
+        return 1;
+      }
+    } else if ( !strcmp(argv[i],"-o") && i+1 < argc ) {
+      const BenchOp * op = ops;
+      while ( op->name && strcmp(op->name,argv[i+1]) ) ++op;
+      if ( !op->name ) {
+        fprintf(stderr,"unknown operation %s\n",argv[i+1]);
+        return 1;
+      }
+      selected.push_back(op); ++i;
+    } else if ( !strcmp(argv[i],"-l") ) {
+      for (const BenchOp * op = ops; op->name; ++op) printf("%s\n",op->name);
+      return 0;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if ( meshes.empty() )
+    for (int i=0; defaultMeshes[i]; ++i) meshes.push_back(defaultMeshes[i]);
+  if ( selected.empty() )
+    for (const BenchOp * op = ops; op->name; ++op) selected.push_back(op);
+
+#ifndef _WIN32
+  // Some operations print progress to stdout. Send the results to the real
+  // stdout and the chatter to /dev/null
+  results = fdopen(dup(fileno(stdout)),"w");
+  if ( !results || !freopen("/dev/null","w",stdout) ) results = stdout;
+#endif
+
+  for (uint m=0; m < meshes.size(); ++m)
+    for (uint o=0; o < selected.size(); ++o)
+      benchCase(meshes[m],*selected[o],repeats);
+  return 0;
+}
@@ -0,0 +1,51 @@
+TEMPLATE = app
+CONFIG -= qt
+CONFIG += console release warn_off
+TARGET = dlflbench
+INCLUDEPATH += .. ../vecmat ../dlflcore ../dlflaux
+
+# Run with no arguments for the default set of meshes and operations,
+# see dlflbench.cc for the options and the output format.
+
+LIBS += -L../../lib -ldlflaux -ldlflcore -lvecmat
+PRE_TARGETDEPS += ../../lib/libdlflaux.a ../../lib/libdlflcore.a ../../lib/libvecmat.a
+
+# the libraries are built with OpenMP, comment out if they are not
+CONFIG += WITH_OPENMP
+
+CONFIG(WITH_OPENMP){
+ DEFINES *= WITH_OPENMP
+ win32-msvc* {
+  QMAKE_CXXFLAGS += -openmp
+ } else {
+  QMAKE_CXXFLAGS += -fopenmp
+  QMAKE_LFLAGS += -fopenmp
+ }
+}
+
+# time patch updates and lighting as well, with qmake "CONFIG+=WITH_PATCHES".
+# Off by default since these need Qt with OpenGL and the patch sources of
+# the main application, which the libraries don't
+
+CONFIG(WITH_PATCHES){
+ DEFINES *= WITH_PATCHES
+ CONFIG += qt
+ QT += opengl
+ INCLUDEPATH += ../.. ../Light ../Graphics
+ HEADERS += \
+	../../TMPatch.hh \
+	../../TMPatchFace.hh \
+	../../TMPatchObject.hh \
+	../../DLFLLighting.hh
+ SOURCES += \
+	../../TMPatchFace.cc \
+	../../TMPatchObject.cc \
+	../../DLFLLighting.cc
+}
+
+macx {
+ CONFIG -= app_bundle
+}
+
+SOURCES += \
+	dlflbench.cc
@@ -0,0 +1,132 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLAdjacency.cc
+ */
+
+#include "DLFLAdjacency.hh"
+#include "DLFLObject.hh"
+#include "DLFLProfile.hh"
+
+namespace DLFL {
+
+  void DLFLAdjacency::invalidate( ) {
+    object = NULL; valid = orderedValid = false;
+    vertices.clear(); slots.clear(); offsets.clear();
+    corners.clear(); edges.clear(); faces.clear(); neighbors.clear();
+    orderedoffsets.clear(); orderedcorners.clear();
+  }
+
+  void DLFLAdjacency::sync( DLFLObjectPtr obj ) {
+    if ( obj != object || obj->topologyCount() != stamp || !valid ) {
+      invalidate();
+      object = obj; stamp = obj->topologyCount();
+      build();
+    }
+  }
+
+  void DLFLAdjacency::build( ) {
+    DLFLProfileScope profile("buildAdjacency");
+    vertices.assign(object->beginVertex(),object->endVertex());
+    int n = vertices.size();
+
+    // Count the corners of each vertex, then lay the rings out one after the other
+    offsets.resize(n+1);
+    uint maxid = 0;
+    for (int i=0; i < n; ++i) {
+      offsets[i+1] = vertices[i]->numEdges();
+      if ( vertices[i]->getID() > maxid ) maxid = vertices[i]->getID();
+    }
+    offsets[0] = 0;
+    for (int i=0; i < n; ++i) offsets[i+1] += offsets[i];
+
+    slots.assign(n ? maxid+1 : 0,-1);
+    for (int i=0; i < n; ++i) slots[vertices[i]->getID()] = i;
+
+    uint total = offsets[n];
+    corners.resize(total); edges.resize(total); faces.resize(total); neighbors.resize(total);
+
+    // Each vertex only writes its own part of the arrays
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+    for (int i=0; i < n; ++i) {
+      uint k = offsets[i];
+      DLFLFaceVertexPtrList::const_iterator first = vertices[i]->beginFaceVertex(), last = vertices[i]->endFaceVertex();
+      for (; first != last; ++first, ++k) {
+        DLFLFaceVertexPtr fvp = *first, ofvp = NULL;
+        DLFLEdgePtr ep = fvp->getEdgePtr();
+        if ( ep ) ofvp = ep->getOtherFaceVertexPtr(fvp);
+        corners[k] = fvp; edges[k] = ep; faces[k] = fvp->getFacePtr();
+        neighbors[k] = ( ofvp ) ? ofvp->vertex : NULL;
+      }
+    }
+    valid = true;
+    profile.setElements(total);
+  }
+
+  int DLFLAdjacency::indexOf( DLFLVertexPtr vp ) const {
+    if ( vp == NULL ) return -1;
+    uint id = vp->getID();
+    if ( id >= slots.size() ) return -1;
+    int i = slots[id];
+    return ( i >= 0 && vertices[i] == vp ) ? i : -1;
+  }
+
+  DLFLEdgePtr DLFLAdjacency::edgeBetween( DLFLVertexPtr vp1, DLFLVertexPtr vp2 ) const {
+    int i = indexOf(vp1);
+    if ( i < 0 ) return NULL;
+    for (uint k=offsets[i]; k < offsets[i+1]; ++k)
+      if ( neighbors[k] == vp2 ) return edges[k];
+    return NULL;
+  }
+
+  void DLFLAdjacency::buildOrdered( ) {
+    if ( orderedValid || !valid ) return;
+    int n = vertices.size();
+
+    // The rotation order comes from walking around the vertex, which can visit
+    // a different number of corners than the corner list on a non-manifold vertex
+    vector<DLFLFaceVertexPtrArray> rings(n);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+    for (int i=0; i < n; ++i)
+      if ( offsets[i+1] > offsets[i] ) vertices[i]->getOrderedCorners(rings[i]);
+
+    orderedoffsets.resize(n+1);
+    orderedoffsets[0] = 0;
+    for (int i=0; i < n; ++i) orderedoffsets[i+1] = orderedoffsets[i] + rings[i].size();
+    orderedcorners.resize(orderedoffsets[n]);
+    for (int i=0; i < n; ++i)
+      copy(rings[i].begin(),rings[i].end(),orderedcorners.begin()+orderedoffsets[i]);
+    orderedValid = true;
+  }
+
+} // end namespace
@@ -0,0 +1,114 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLAdjacency.hh
+ */
+
+#ifndef _DLFL_ADJACENCY_HH_
+#define _DLFL_ADJACENCY_HH_
+
+// Cache of the one-ring of every vertex of an object, kept in flat arrays.
+// Vertex i (in vertex list order) owns the entries ringBegin(i)..ringEnd(i)-1,
+// one per corner of the vertex, in the order of the vertex's corner list, so
+// they match DLFLVertex::getFaceVertices/getEdges/getFaces. Each entry has the
+// corner, its edge, its face and the vertex at the other end of the edge.
+// The corners in rotation order (DLFLVertex::getOrderedCorners) are kept
+// separately and only built when first asked for.
+//
+// The cache is rebuilt by sync() when the object's topology count has moved
+// on (see DLFLObject::topologyCount()), vertex coordinates can change freely.
+// Meant for passes which read the mesh without changing its topology; an
+// operation which edits the mesh has to take what it needs before it starts.
+// sync() is not thread safe, the accessors are.
+
+#include "DLFLCommon.hh"
+
+namespace DLFL {
+
+  class DLFLAdjacency {
+  public :
+
+    DLFLAdjacency( )
+      : object(NULL), stamp(0), valid(false), orderedValid(false) { };
+
+    // Drop everything. Must be called if the object is destroyed while the cache is kept
+    void invalidate( );
+
+    // Rebuild the cache if it was built for another object or an older topology
+    void sync( DLFLObjectPtr obj );
+
+    uint numVertices( ) const { return vertices.size(); };
+    DLFLVertexPtr vertex( uint i ) const { return vertices[i]; };
+
+    // Position of a vertex in the cache, -1 if it isn't there
+    int indexOf( DLFLVertexPtr vp ) const;
+
+    uint valence( uint i ) const { return offsets[i+1] - offsets[i]; };
+    uint ringBegin( uint i ) const { return offsets[i]; };
+    uint ringEnd( uint i ) const { return offsets[i+1]; };
+
+    DLFLFaceVertexPtr corner( uint k ) const { return corners[k]; };
+    DLFLEdgePtr edge( uint k ) const { return edges[k]; };             // NULL for a point-sphere
+    DLFLFacePtr face( uint k ) const { return faces[k]; };
+    DLFLVertexPtr neighbor( uint k ) const { return neighbors[k]; };   // NULL for a point-sphere
+
+    // Edge between two vertices of the cache, NULL if there is none
+    DLFLEdgePtr edgeBetween( DLFLVertexPtr vp1, DLFLVertexPtr vp2 ) const;
+
+    // Corners of vertex i in rotation order. Builds them the first time, so
+    // buildOrdered() has to be called before using these from several threads
+    void buildOrdered( );
+    uint orderedBegin( uint i ) const { return orderedoffsets[i]; };
+    uint orderedEnd( uint i ) const { return orderedoffsets[i+1]; };
+    DLFLFaceVertexPtr orderedCorner( uint k ) const { return orderedcorners[k]; };
+
+  protected :
+
+    DLFLObjectPtr object;                  // Object the cache was built for
+    uint stamp;                            // Topology count of object when it was built
+    bool valid, orderedValid;
+
+    DLFLVertexPtrArray vertices;           // Vertices in list order
+    vector<int> slots;                     // Vertex ID -> position in vertices, -1 if none
+
+    vector<uint> offsets;                  // Start of the ring of each vertex, plus the end
+    DLFLFaceVertexPtrArray corners;
+    DLFLEdgePtrArray edges;
+    DLFLFacePtrArray faces;
+    DLFLVertexPtrArray neighbors;
+
+    vector<uint> orderedoffsets;
+    DLFLFaceVertexPtrArray orderedcorners;
+
+    void build( );
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_ADJACENCY_HH_ */
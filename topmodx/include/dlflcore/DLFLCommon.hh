@@ -231,6 +231,12 @@ namespace DLFL {
   void clear(DLFLObjectPtrList& oplist);
   void clear(DLFLMaterialPtrList& mplist);
 
+  // Atomic post-increment for the class wide ID counters, so elements can be
+  // created on several threads at once. Returns the old value
+  inline uint fetchAndIncrement( uint& counter ) {
+    return __sync_fetch_and_add(&counter,1);
+  }
+
   struct eqstr {
     bool operator() ( int a, int b ) const {
       return a == b;
@@ -38,6 +38,7 @@
 #include "DLFLCore.hh"
 #include <cmath>
 #include <cassert>
+#include <map>
 
 namespace DLFL {
 
@@ -252,8 +253,7 @@ namespace DLFL {
       ep->setNullFaceVertexPtr(temp);
     }
     //Delete face 2 from the face list and free the pointer
-    obj->removeFace(fp2);
-    delete fp2;
+    obj->eraseFace(fp2);
 
     //Create the new Edge and do necessary updates
     newedgeptr = new DLFLEdge;
@@ -346,13 +346,11 @@ namespace DLFL {
 
       //The Edge can now be removed from the EdgeList
       // Free the pointer also since the edge_list owns the DLFLEdge pointed to by edgeptr
-      obj->removeEdge(edgeptr);
-      delete edgeptr;
+      obj->eraseEdge(edgeptr);
 
       //Destroy f2 and delete it from the face list
       f2->destroy();
-      obj->removeFace(f2);
-      delete f2;
+      obj->eraseFace(f2);
 			rfpa.push_back(f1);
     } else {
       //Two edge sides belong to same face
@@ -402,8 +400,7 @@ namespace DLFL {
       }
       //The Edge can now be removed from the EdgeList
       // Free the pointer also, since edge_list owns the object pointed to by edgeptr
-      obj->removeEdge(edgeptr);
-      delete edgeptr;
+      obj->eraseEdge(edgeptr);
       
       //Add the new Face to the FaceList
       obj->addFacePtr(nfp);
@@ -427,26 +424,22 @@ namespace DLFL {
 				if (f1->size() == 1) {
 					fvp = f1->firstVertex();
 					vp = fvp->vertex;
-					obj->removeVertex(vp);
-					delete vp;
+					obj->eraseVertex(vp);
 
 					f1->destroy();
-					obj->removeFace(f1);
+					obj->eraseFace(f1);
 					if(!rfpa.empty())
 						rfpa.erase( rfpa.begin() );
-					delete f1;
 				}
 				if (nfp->size() == 1) {
 					fvp = nfp->firstVertex();
 					vp = fvp->vertex;
-					obj->removeVertex(vp);
-					delete vp;
+					obj->eraseVertex(vp);
 
 					nfp->destroy();
-					obj->removeFace(nfp);
+					obj->eraseFace(nfp);
 					if(!rfpa.empty())
 						rfpa.erase( --(rfpa.end()) );
-					delete nfp;
 				}
       }
     }
@@ -545,12 +538,10 @@ namespace DLFL {
     }
 
     //Delete Vertex 2(vp2) from Vertex list and free memory
-    obj->removeVertex(vp2);
-    delete vp2;
+    obj->eraseVertex(vp2);
 
     //Delete edge to be collapsed from edge list and free memory
-    obj->removeEdge(edgeptr);
-    delete edgeptr;
+    obj->eraseEdge(edgeptr);
 
     //Do cleanup of 2 - gons if boolean flag is true
     if (cleanup == true) {
@@ -677,8 +668,7 @@ namespace DLFL {
     }
     //Remove the existing Edge from the EdgeList
     // Free the pointer also
-    obj->removeEdge(edgeptr);
-    delete edgeptr;
+    obj->eraseEdge(edgeptr);
 
     //Add the 2 new Edges into the EdgeList
     obj->addEdgePtr(nep1);
@@ -943,11 +933,29 @@ namespace DLFL {
     edgeCleanup( obj, obj->getEdgeList() );
   }
 
+  // Should the edge be deleted by edgeCleanup? The normal of each face is
+  // only computed once, a face along many of the edges can be very large
+  static bool isRedundantEdge( DLFLEdgePtr edge, map<DLFLFacePtr,Vector3d>& normals ) {
+    DLFLFacePtr fp[2];
+    edge->getFacePointers(fp[0],fp[1]);
+    if ( fp[0] == fp[1] ) return true;
+
+    Vector3d fpn[2];
+    for (int i=0; i < 2; ++i) {
+      map<DLFLFacePtr,Vector3d>::iterator it = normals.find(fp[i]);
+      if ( it == normals.end() ) it = normals.insert(make_pair(fp[i],fp[i]->computeNormal())).first;
+      fpn[i] = it->second;
+    }
+    // Normals of faces on both sides of edge are same
+    // This edge can be deleted
+    return ( Abs(fpn[0]*fpn[1]-1.0) < 1.0e-5 );
+  }
+
   void edgeCleanup( DLFLObjectPtr obj, const DLFLEdgePtrList& edges) {
     DLFLEdgePtrList deletion_list; // List of edges to be deleted
     DLFLEdgePtrList::const_iterator first, last;
     DLFLEdgePtr edge;
-    DLFLFacePtr fp1, fp2;
+    map<DLFLFacePtr,Vector3d> normals;
 
     // First go through all edges and find out ones which have to be deleted.
     // If we do deletion on the fly, some normal computation could be affected
@@ -955,18 +963,7 @@ namespace DLFL {
     first = edges.begin(); last = edges.end();
     while ( first != last ) {
       edge = (*first); ++first;
-      edge->getFacePointers(fp1,fp2);
-
-      if ( fp1 != fp2 ) {
-				Vector3d fp1n = fp1->computeNormal();
-				Vector3d fp2n = fp2->computeNormal();
-				if ( Abs(fp1n*fp2n-1.0) < 1.0e-5 ) {
-					// Normals of faces on both sides of edge are same
-					// This edge can be deleted
-					deletion_list.push_back(edge);
-				}
-      } else
-				deletion_list.push_back(edge);
+      if ( isRedundantEdge(edge,normals) ) deletion_list.push_back(edge);
     }
 
     first = deletion_list.begin(); last = deletion_list.end();
@@ -979,25 +976,14 @@ namespace DLFL {
     DLFLEdgePtrList deletion_list; // List of edges to be deleted
     DLFLEdgePtrList::iterator first, last;
     DLFLEdgePtr edge;
-    DLFLFacePtr fp1, fp2;
+    map<DLFLFacePtr,Vector3d> normals;
 
     // First go through all edges and find out ones which have to be deleted.
     // If we do deletion on the fly, some normal computation could be affected
     // causing errors
     for (int i=0; i < edges.size(); ++i) {
       edge = edges[i];
-      edge->getFacePointers(fp1,fp2);
-
-      if ( fp1 != fp2 ) {
-				Vector3d fp1n = fp1->computeNormal();
-				Vector3d fp2n = fp2->computeNormal();
-				if ( Abs(fp1n*fp2n-1.0) < 1.0e-5 ) {
-					// Normals of faces on both sides of edge are same
-					// This edge can be deleted
-					deletion_list.push_back(edge);
-				}
-      } else
-				deletion_list.push_back(edge);
+      if ( isRedundantEdge(edge,normals) ) deletion_list.push_back(edge);
     }
 
     first = deletion_list.begin(); last = deletion_list.end();
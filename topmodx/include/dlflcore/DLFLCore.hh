@@ -53,6 +53,8 @@ namespace DLFL {
    * The general case insertEdge subroutine. Calls one of the insertEdge implementations, 
    * depending on whether the corners are cofacial or not. If the 2 corners are cofacial
    * checks to see if the 2 pointers refer to the same corner, if so doesn't do insert.
+   * A face merged away by a non-cofacial insert goes through DLFLObject::eraseFace,
+   * so it is only freed at the end of a batch.
    */
   DLFLEdgePtr insertEdge( DLFLObjectPtr obj, DLFLFaceVertexPtr fvptr1, DLFLFaceVertexPtr fvptr2, bool set_type = false, DLFLMaterialPtr matl = NULL  );
   DLFLEdgePtr insertEdgeCoFacial( DLFLObjectPtr obj, DLFLFaceVertexPtr fvptr1, DLFLFaceVertexPtr fvptr2, bool set_type = false );
@@ -65,6 +67,9 @@ namespace DLFL {
 
   // If the cleanup flag is true, any point-spheres created
   // because of the edge deletion will be removed from the object
+  // Removed elements go through DLFLObject::erase*, so many deletions can be
+  // wrapped in beginBatch()/endBatch(). The edge_index versions walk the edge
+  // list and can't be used inside a batch
 	std::vector<int>  deleteEdgeID( DLFLObjectPtr obj, uint edgeId, bool cleanup = true );
   void deleteEdge( DLFLObjectPtr obj, uint edge_index, bool cleanup = true );
   DLFLFacePtrArray deleteEdge( DLFLObjectPtr obj, DLFLEdgePtr edgeptr, bool cleanup = true );
@@ -81,7 +86,8 @@ namespace DLFL {
    * Subdivide Edge *
    ******************/
 
-  // Return pointer to the newly added vertex 
+  // Return pointer to the newly added vertex. The old edge goes through
+  // DLFLObject::eraseEdge, so it is only freed at the end of a batch
   int subdivideEdgeID( DLFLObjectPtr obj, uint edgeId, bool set_type = false );
   DLFLVertexPtr subdivideEdge( DLFLObjectPtr obj, DLFLEdgePtr edgeptr, bool set_type = false );
   DLFLVertexPtr subdivideEdge( DLFLObjectPtr obj, uint edge_index );
@@ -407,7 +407,12 @@ namespace DLFL {
   // Calculate doo-sabin coordinates for the given array of points,
   // assuming they form a polygon and are specified in the correct order
   void computeDooSabinCoords(Vector3dArray& points) {
-    Vector3dArray op(points);
+    Vector3dArray op;
+    computeDooSabinCoords(points,op);
+  }
+
+  void computeDooSabinCoords(Vector3dArray& points, Vector3dArray& op) {
+    op.assign(points.begin(),points.end());
     Vector3d p;
     int numpts = op.size();
     double coef, alpha;
@@ -119,6 +119,10 @@ namespace DLFL {
   // Calculate doo-sabin coordinates for the given array of points,
   // assuming they form a polygon and are specified in the correct order
   void computeDooSabinCoords(Vector3dArray& points);
+
+  // Same as above, using scratch to hold a copy of the input points
+  // so repeated calls don't allocate
+  void computeDooSabinCoords(Vector3dArray& points, Vector3dArray& scratch);
   
   // Calculate modified doo-sabin coordinates for the given array of points,
   // assuming they form a polygon and are specified in the correct order
@@ -79,14 +79,16 @@ namespace DLFL {
 
     // Generate a new unique ID
     static uint newID(void) {
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return fetchAndIncrement(suLastID);
     }
      
     // Assign a unique ID for this instance
     void assignID(void) {
-      uID = DLFLEdge :: newID();
+      assignID(DLFLEdge :: newID());
+    }
+
+    void assignID(uint id) {
+      uID = id;
       ismarked = 0;
 			isvisited = 0;
     }
@@ -323,6 +325,17 @@ namespace DLFL {
       assignID();
     }
 
+    // Same as above with the new ID given by the caller.
+    // DLFLObject uses this to number its edges
+    void makeUnique(uint id) {
+      assignID(id);
+    }
+
+    // Change only the ID. Done by DLFLObject when the edge is added to it
+    void setID(uint id) {
+      uID = id;
+    }
+
     friend void makeEdgeUnique(DLFLEdgePtr dep);
 /*
     friend void makeEdgeUnique(DLFLEdgePtr dep) {
@@ -955,8 +955,9 @@ namespace DLFL {
     // Reorder the face-vertices so that the given face-vertex is the first one
     // Simply have to change the head pointer to point to the new face vertex
     // Check if fvptr belongs to this face. If yes, simply reset head to be fvptr
-    // Otherwise don't change anything
-    if ( fvptr && this->contains(fvptr) ) head = fvptr;
+    // Otherwise don't change anything. The face-vertex's own face pointer is
+    // checked first so the usual case doesn't have to walk the face
+    if ( fvptr && ( fvptr->getFacePtr() == this || this->contains(fvptr) ) ) head = fvptr;
   }
 
   void DLFLFace::reverse(void) {
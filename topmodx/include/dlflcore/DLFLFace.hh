@@ -58,9 +58,7 @@ namespace DLFL {
     static uint suLastID;                             //!< Distinct ID for each instance
 
     static uint newID(void) {                           //!< Generate a new unique ID
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return fetchAndIncrement(suLastID);
     }
      
     uint uID;                                         //!< ID for this Face
@@ -81,7 +79,11 @@ namespace DLFL {
 
      // Assign a unique ID for this instance
     void assignID(void) {
-      uID = DLFLFace :: newID();
+      assignID(DLFLFace :: newID());
+    }
+
+    void assignID(uint id) {
+      uID = id;
       ismarked = 0;
     }
 
@@ -199,6 +201,17 @@ namespace DLFL {
       assignID();
     }
 
+    //! Same as above with the new ID given by the caller.
+    //! DLFLObject uses this to number its faces
+    void makeUnique(uint id) {
+      assignID(id);
+    }
+
+    //! Change only the ID. Done by DLFLObject when the face is added to it
+    void setID(uint id) {
+      uID = id;
+    }
+
     // Delete all the face-vertices of this face
     void destroy(void);
      
@@ -207,6 +220,12 @@ namespace DLFL {
       matl_ptr = NULL;
     }
 
+    //! Forget the material without taking the face out of its face list.
+    //! For when the material has already been told, see DLFLMaterial::deleteFaces
+    void dropMaterial(void) {
+      matl_ptr = NULL;
+    }
+
     DLFLFaceVertexPtr addVertex(const DLFLFaceVertex& dfv);        // Insert a copy
     DLFLFaceVertexPtr addVertex(DLFLFaceVertexPtr dfvp);           // Insert a copy
     void addVertexPtr(DLFLFaceVertexPtr dfvp);        // Insert the pointer
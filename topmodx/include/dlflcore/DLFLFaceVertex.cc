@@ -279,9 +279,11 @@ namespace DLFL {
 
   void DLFLFaceVertex::updateNormal( ) {
     // If this is a winged corner, assign normal of nearest non-winged corner
-    // Otherwise compute for this corner and adjust for concave corners
-    if ( isWingedCorner() ) {
-      DLFLFaceVertexPtr fvp = closestNonWingedCorner();
+    // Otherwise compute for this corner and adjust for concave corners.
+    // A face whose corners are all winged (eg. all on one point) has no
+    // non-winged corner, its corners are computed like any other
+    DLFLFaceVertexPtr fvp = isWingedCorner() ? closestNonWingedCorner() : NULL;
+    if ( fvp ) {
       normal = fvp->computeNormal();
     } else {
       // compute the normal using adjacent vertices
@@ -62,9 +62,7 @@ namespace DLFL {
     static uint suLastID;
 
     static uint newID( ) {
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return fetchAndIncrement(suLastID);
     };
 
   public :
@@ -164,6 +162,7 @@ namespace DLFL {
     void setVertexPtr(DLFLVertexPtr vptr) { vertex = vptr; };
     void setEdgePtr(DLFLEdgePtr eptr) { epEPtr = eptr; };
     void setFacePtr(DLFLFacePtr fptr) { fpFPtr = fptr; };
+    void setIndex(uint i) { index = i; };
     void setNormal(const Vector3d& n) { normal = normalized(n); };
 
     /* Check if this corner is a concave corner or not
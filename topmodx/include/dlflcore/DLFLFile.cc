@@ -32,23 +32,19 @@
 */
 
 #include "DLFLObject.hh"
+#include "DLFLWriteBuffer.hh"
 #include <cstdio>
 #include <cstring>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace DLFL {
 
 	typedef vector<Vector3d> Vector3dArray;
 	typedef vector<Vector2d> Vector2dArray;
 
-	// Temporary array to store the vertices and face vertices
-	static DLFLVertexPtrArray vertex_array;
-	static DLFLFaceVertexPtrArray face_vertex_array;
-	static Vector3dArray normals;
-	static Vector2dArray texcoords;
-
-
-	static char *dname;
-
 	void DLFLObject::readObject(istream& i, istream &imtl) {
 		// std::cout << "reading obj file \n";
 		if ( !i ) {
@@ -59,6 +55,11 @@ namespace DLFL {
 		// Clear the object first
 		reset();
 
+		// Temporary arrays to store the vertices, normals and texture coordinates
+		DLFLVertexPtrArray vertex_array;
+		Vector3dArray normals;
+		Vector2dArray texcoords;
+
 		DLFLVertexPtr newvptr;
 		DLFLFaceVertexPtr newfvptr;
 		DLFLFacePtr newfptr;
@@ -205,107 +206,270 @@ namespace DLFL {
 		// std::cout << "done reading obj\n;";
 	}
 
-	void DLFLObject::writeObject(ostream& o, ostream &omtl, bool with_normals, bool with_tex_coords) const {
-		//write mtl file
-		if (!omtl.fail())
-			writeMTL(omtl);
-		
-		// Write out the DLFL object as an OBJ file into the given output stream
-		o << "mtllib " << mFilename << ".mtl\n";
-
-		// First make the Position ID's unique for the VertexList so Vertex IDs will
-		// be contiguous and monotonically increasing
-		// Don't Do this, that way the IDs stay the same
-		for_each(vertex_list.begin(),vertex_list.end(),makeVertexUnique);
-
-		// Get the Position ID for the first Vertex in the list
-		// -1 is because OBJ file indices start at 1 and not 0
-		uint min_id = vertex_list.front()->getID() - 1;
+	// The exporters format vertices and faces in chunks of this many. With
+	// OpenMP the chunks of a batch are formatted on separate threads into
+	// strings, which are then written out in order
+	#define DLFL_WRITE_CHUNK 2048
+
+	// Formats the elements [first,last) of a chunk
+	class DLFLChunkWriter {
+	public :
+		virtual ~DLFLChunkWriter( ) { }
+		virtual void write( DLFLWriteBuffer& b, uint first, uint last ) const = 0;
+	};
+
+	static void writeChunked( DLFLWriteBuffer& out, uint n, const DLFLChunkWriter& w ) {
+#ifdef WITH_OPENMP
+		uint nchunks = ( n + DLFL_WRITE_CHUNK - 1 ) / DLFL_WRITE_CHUNK;
+		uint batch = 4 * omp_get_max_threads();
+		if ( nchunks > 1 && batch > 1 ) {
+			vector<string> parts(batch);
+			for (uint c = 0; c < nchunks; c += batch) {
+				int nb = min(batch,nchunks-c);
+#pragma omp parallel for schedule(dynamic,1)
+				for (int i = 0; i < nb; ++i) {
+					parts[i].clear();
+					DLFLWriteBuffer b(parts[i],out.getPrecision());
+					uint first = (c+i) * DLFL_WRITE_CHUNK;
+					w.write(b,first,min(n,first+DLFL_WRITE_CHUNK));
+				}
+				for (int i = 0; i < nb; ++i) out.put(parts[i]);
+			}
+			return;
+		}
+#endif
+		w.write(out,0,n);
+	}
 
-		// Output the Vertex list
-		DLFLVertexPtrList::const_iterator vf = vertex_list.begin(), vl = vertex_list.end();
-		while ( vf != vl ) {
-			o << *(*vf);
-			++vf;
+	// Split a polygon into triangles, 3 corner indices each. Triangles fan
+	// out from the first corner, which is right for the convex faces the
+	// modeler produces. Quads are split along the shorter diagonal
+	static void triangulatePolygon( const Vector3dArray& p, vector<uint>& tris ) {
+		tris.clear();
+		uint n = p.size();
+		if ( n < 3 ) return;
+		if ( n == 4 && normsqr(p[1]-p[3]) < normsqr(p[0]-p[2]) ) {
+			uint t[6] = { 1, 2, 3, 1, 3, 0 };
+			tris.assign(t,t+6);
+			return;
+		}
+		for (uint i = 1; i+1 < n; ++i) {
+			tris.push_back(0); tris.push_back(i); tris.push_back(i+1);
 		}
+	}
 
-		o << "# " << vertex_list.size() << " vertices" << endl << endl;
+	// Number of triangles triangulatePolygon makes from a face
+	static uint numTriangles( uint corners ) {
+		return ( corners < 3 ) ? 0 : corners - 2;
+	}
 
-		DLFLFacePtrList::const_iterator ff, fl = face_list.end();
+	// Corners of a face in order
+	static void getCorners( DLFLFacePtr fp, DLFLFaceVertexPtrArray& corners ) {
+		corners.clear();
+		DLFLFaceVertexPtr head = fp->front();
+		if ( !head ) return;
+		DLFLFaceVertexPtr current = head;
+		do {
+			corners.push_back(current);
+			current = current->next();
+		} while ( current != head );
+	}
 
-		if ( with_normals ) {
-			ff = face_list.begin();
-			// Output the normals for each FaceVertex in each Face
-			while ( ff != fl ) {
-				(*ff)->objWriteNormals(o);
-				++ff;
+	static void getCornerCoords( const DLFLFaceVertexPtrArray& corners, Vector3dArray& p ) {
+		p.resize(corners.size());
+		for (uint i = 0; i < corners.size(); ++i)
+			p[i] = corners[i]->getVertexCoords();
+	}
+
+	struct ObjVertexWriter : public DLFLChunkWriter {
+		const DLFLVertexPtrArray& verts;
+		ObjVertexWriter( const DLFLVertexPtrArray& v ) : verts(v) { }
+		void write( DLFLWriteBuffer& b, uint first, uint last ) const {
+			double x,y,z;
+			for (uint i = first; i < last; ++i) {
+				verts[i]->coords.get(x,y,z);
+				b.put("v ",2); b.putDouble(x);
+				b.put(' '); b.putDouble(y);
+				b.put(' '); b.putDouble(z); b.put('\n');
 			}
 		}
-		if ( with_tex_coords ) {
-			ff = face_list.begin();
-			// Output the texture coordinates for each FaceVertex in each Face
-			while ( ff != fl ) {
-				(*ff)->objWriteTexCoords(o);
-				++ff;
+	};
+
+	// "vn" or "vt" lines for every corner of the faces
+	struct ObjCornerWriter : public DLFLChunkWriter {
+		const DLFLFacePtrArray& faces;
+		bool normals;
+		ObjCornerWriter( const DLFLFacePtrArray& f, bool n ) : faces(f), normals(n) { }
+		void write( DLFLWriteBuffer& b, uint first, uint last ) const {
+			DLFLFaceVertexPtrArray corners;
+			for (uint i = first; i < last; ++i) {
+				getCorners(faces[i],corners);
+				for (uint k = 0; k < corners.size(); ++k) {
+					if ( normals ) {
+						Vector3d n = corners[k]->getNormal();
+						b.put("vn ",3); b.putDouble(n[0]);
+						b.put(' '); b.putDouble(n[1]);
+						b.put(' '); b.putDouble(n[2]); b.put('\n');
+					} else {
+						Vector2d t = corners[k]->getTexCoords();
+						b.put("vt ",3); b.putDouble(t[0]);
+						b.put(' '); b.putDouble(t[1]); b.put('\n');
+					}
+				}
 			}
 		}
-		ff = face_list.begin();
-		DLFLMaterialPtr mptr = (*ff)->material();
-		o << "usemtl " << mptr->name << "\n";						
-		
-		if ( with_normals ) {
-			uint normal_id_start = 1;
-			if ( with_tex_coords ) {
-				// Output the Face list with normals and texture coords
-				uint tex_id_start = 1;
-				while ( ff != fl ) {
-					if (mptr != (*ff)->material()){
-						mptr = (*ff)->material();
-						o << "usemtl " << mptr->name << "\n";						
-					}
-					(*ff)->objWriteWithNormalsAndTexCoords(o,min_id,normal_id_start,tex_id_start);
-					++ff;
+	};
+
+	struct ObjFaceWriter : public DLFLChunkWriter {
+		const DLFLFacePtrArray& faces;
+		const vector<uint>& cornerstart;   // OBJ index of the normal/texcoord of each face's first corner
+		bool normals, texcoords, triangulate;
+
+		ObjFaceWriter( const DLFLFacePtrArray& f, const vector<uint>& cs, bool n, bool t, bool tri )
+			: faces(f), cornerstart(cs), normals(n), texcoords(t), triangulate(tri) { }
+
+		void putCorner( DLFLWriteBuffer& b, DLFLFaceVertexPtr fvp, uint index ) const {
+			// +1 is because OBJ file indices start at 1 and not 0
+			b.put(' '); b.putUInt(fvp->vertex->getIndex() + 1);
+			if ( normals && texcoords ) {
+				b.put('/'); b.putUInt(index); b.put('/'); b.putUInt(index);
+			} else if ( normals ) {
+				b.put("//",2); b.putUInt(index);
+			} else if ( texcoords ) {
+				b.put('/'); b.putUInt(index);
+			}
+		}
+
+		void write( DLFLWriteBuffer& b, uint first, uint last ) const {
+			DLFLFaceVertexPtrArray corners;
+			Vector3dArray p;
+			vector<uint> tris;
+			// A material switch is written whenever the material differs from the previous face's
+			DLFLMaterialPtr mptr = ( first > 0 ) ? faces[first-1]->material() : NULL;
+			for (uint i = first; i < last; ++i) {
+				if ( i == 0 || mptr != faces[i]->material() ) {
+					mptr = faces[i]->material();
+					if ( mptr ) { b.put("usemtl ",7); b.put(mptr->name); b.put('\n'); }
 				}
-			} 
-			else {
-				// Output the Face list with normals only
-				while ( ff != fl ) {
-					if (mptr != (*ff)->material()){
-						mptr = (*ff)->material();
-						o << "usemtl " << mptr->name << "\n";						
-					}
-					
-					(*ff)->objWriteWithNormals(o,min_id,normal_id_start);
-					++ff;
+				getCorners(faces[i],corners);
+				if ( corners.empty() ) continue;
+				uint start = cornerstart[i];
+				if ( !triangulate ) {
+					b.put('f');
+					for (uint k = 0; k < corners.size(); ++k)
+						putCorner(b,corners[k],start+k);
+					b.put('\n');
+					continue;
+				}
+				getCornerCoords(corners,p);
+				triangulatePolygon(p,tris);
+				for (uint t = 0; t < tris.size(); t += 3) {
+					b.put('f');
+					for (uint k = 0; k < 3; ++k)
+						putCorner(b,corners[tris[t+k]],start+tris[t+k]);
+					b.put('\n');
 				}
 			}
 		}
-		else if ( with_tex_coords ) {
-			// Output the face list with texture coords but without normals
-			uint tex_id_start = 1;
-			while ( ff != fl ) {
-				if (mptr != (*ff)->material()){
-					mptr = (*ff)->material();
-					o << "usemtl " << mptr->name << "\n";						
-				}
-				
-				(*ff)->objWriteWithTexCoords(o,min_id,tex_id_start);
-				++ff;
+	};
+
+	// Facets of the triangulated faces, in ASCII or binary STL
+	struct STLFacetWriter : public DLFLChunkWriter {
+		const DLFLFacePtrArray& faces;
+		bool binary;
+
+		STLFacetWriter( const DLFLFacePtrArray& f, bool bin ) : faces(f), binary(bin) { }
+
+		void putVector( DLFLWriteBuffer& b, const Vector3d& v ) const {
+			if ( binary ) {
+				b.putFloat32LE(v[0]); b.putFloat32LE(v[1]); b.putFloat32LE(v[2]);
+			} else {
+				b.putDouble(v[0]); b.put(' ');
+				b.putDouble(v[1]); b.put(' ');
+				b.putDouble(v[2]); b.put('\n');
 			}
-		} 
-		else {
-			// Output the Face list without normals or texture coordinates
-			while ( ff != fl ) {
-				if (mptr != (*ff)->material()){
-					mptr = (*ff)->material();
-					o << "usemtl " << mptr->name << "\n";						
-				}				
-				(*ff)->objWrite(o,min_id);
-				++ff;
+		}
+
+		void write( DLFLWriteBuffer& b, uint first, uint last ) const {
+			DLFLFaceVertexPtrArray corners;
+			Vector3dArray p;
+			vector<uint> tris;
+			for (uint i = first; i < last; ++i) {
+				getCorners(faces[i],corners);
+				getCornerCoords(corners,p);
+				triangulatePolygon(p,tris);
+				for (uint t = 0; t < tris.size(); t += 3) {
+					const Vector3d& p0 = p[tris[t]];
+					const Vector3d& p1 = p[tris[t+1]];
+					const Vector3d& p2 = p[tris[t+2]];
+					Vector3d n = (p1-p0) % (p2-p0);
+					double l = norm(n);
+					if ( l > 0.0 ) n /= l;
+					if ( binary ) {
+						putVector(b,n);
+						putVector(b,p0); putVector(b,p1); putVector(b,p2);
+						b.putUInt16LE(0);
+					} else {
+						b.put("  facet normal ",15); putVector(b,n);
+						b.put("    outer loop\n",15);
+						b.put("      vertex  ",14); putVector(b,p0);
+						b.put("      vertex  ",14); putVector(b,p1);
+						b.put("      vertex  ",14); putVector(b,p2);
+						b.put("    endloop\n",12);
+						b.put("  endfacet\n",11);
+					}
+				}
 			}
 		}
+	};
+	void DLFLObject::writeObject(ostream& o, ostream &omtl, bool with_normals, bool with_tex_coords, bool triangulate) const {
+		//write mtl file
+		if (!omtl.fail())
+			writeMTL(omtl);
+		
+		DLFLWriteBuffer b(o);
 
-		o << "# " << face_list.size() << " faces" << endl << endl;
+		// Write out the DLFL object as an OBJ file into the given output stream
+		b.put("mtllib "); if ( mFilename ) b.put(mFilename); b.put(".mtl\n");
+
+		// Number the vertices in list order through their file output index, like
+		// writeDLFL does. The IDs are left alone, caches and the sync find vertices by them
+		DLFLVertexPtrArray verts;
+		verts.reserve(vertex_list.size());
+		uint vindex = 0;
+		DLFLVertexPtrList::const_iterator vf = vertex_list.begin(), vl = vertex_list.end();
+		while ( vf != vl ) {
+			(*vf)->setIndex(vindex++);
+			verts.push_back(*vf);
+			++vf;
+		}
+
+		// Output the Vertex list
+		writeChunked(b,verts.size(),ObjVertexWriter(verts));
+
+		b.put("# "); b.putUInt(verts.size()); b.put(" vertices\n\n");
+
+		// Normals and texture coordinates are written for each FaceVertex in
+		// each Face. Index of the first one of every face for the face list
+		DLFLFacePtrArray faces(face_list.begin(),face_list.end());
+		vector<uint> cornerstart(faces.size());
+		uint corner = 1;
+		for (uint i = 0; i < faces.size(); ++i) {
+			cornerstart[i] = corner;
+			corner += faces[i]->size();
+		}
+
+		if ( with_normals )
+			writeChunked(b,faces.size(),ObjCornerWriter(faces,true));
+		if ( with_tex_coords )
+			writeChunked(b,faces.size(),ObjCornerWriter(faces,false));
+
+		// Output the Face list, with material switches
+		writeChunked(b,faces.size(),ObjFaceWriter(faces,cornerstart,with_normals,with_tex_coords,triangulate));
+
+		b.put("# "); b.putUInt(faces.size()); b.put(" faces\n\n");
+		b.flush();
+		o.flush();
 	}//end write object function
 
 	void DLFLObject::readDLFL(istream& i, istream &imtl,  bool clearold) {
@@ -320,6 +484,10 @@ namespace DLFL {
 		// Otherwise new vertices,faces and edges will be appended to the existing lists
 		if ( clearold ) reset();
 
+		// Temporary arrays to store the vertices and face vertices
+		DLFLVertexPtrArray vertex_array;
+		DLFLFaceVertexPtrArray face_vertex_array;
+
 		DLFLVertexPtr newvptr;
 		DLFLFaceVertexPtr newfvptr, fvptr;
 		DLFLEdgePtr neweptr;
@@ -513,7 +681,8 @@ namespace DLFL {
 		// Write the object in DLFL format into give output stream
 		// Write marker at beginning indicating DLFL format
 		o << "DLFL" << endl;
-		o << "mtllib " << mFilename << ".mtl" << endl;
+		// A NULL name would put the stream into a failed state, as for a new object
+		o << "mtllib "; if ( mFilename ) o << mFilename; o << ".mtl" << endl;
 		o << '#' << endl;
 
 		// std::cout << "writing dlfl\t" << mFilename << "\n";
@@ -564,15 +733,16 @@ namespace DLFL {
 		}
 
 		o << '#' << endl;
-		DLFLMaterialPtr mptr = (*ff)->material();
-		// o << "usemtl " << mptr->name << "\n";						
+		// No material yet, so the first face gets a usemtl line. ff is at
+		// the end of the face list here and can't be dereferenced
+		DLFLMaterialPtr mptr = NULL;
 		// Write the face list
 		ff = face_list.begin(); fl = face_list.end();
 		if ( reverse_faces ) {
 			while ( ff != fl ) {
 				if (mptr != (*ff)->material()){
 					mptr = (*ff)->material();
-					o << "usemtl " << mptr->name << "\n";						
+					if ( mptr ) o << "usemtl " << mptr->name << "\n";
 				}				
 				(*ff)->writeDLFLReverse(o);
 				++ff;
@@ -582,7 +752,7 @@ namespace DLFL {
 			while ( ff != fl ) {
 				if (mptr != (*ff)->material()){
 					mptr = (*ff)->material();
-					o << "usemtl " << mptr->name << "\n";						
+					if ( mptr ) o << "usemtl " << mptr->name << "\n";
 				}				
 				(*ff)->writeDLFL(o);
 				++ff;
@@ -714,52 +884,31 @@ namespace DLFL {
 		}
 	}
 	
-	void DLFLObject::writeSTL(ostream& o) const{		
-		// if(binary)
-		// {
-		// 	// Write Header
-		// 	char *header="VCG                                                                                                  ";
-		// 	if(objectname)	strncpy(header,objectname,80);
-		// 	fwrite(header,80,1,fp);
-		// 	// write number of facets
-		// 	fwrite(&m.fn,1,sizeof(int),fp); 
-		// 	Point3f p;
-		// 	unsigned short attributes=0;
-		//     
-		//     FaceIterator fi;		
-		// 	for(fi=m.face.begin(); fi!=m.face.end(); ++fi) if( !(*fi).IsD() )
-		// 	{
-		// 		// For each triangle write the normal, the three coords and a short set to zero
-		// 		p.Import(vcg::NormalizedNormal(*fi));
-		// 		fwrite(p.V(),3,sizeof(float),fp);
-		//  
-		// 		for(int k=0;k<3;++k){
-		// 			p.Import((*fi).V(k)->P());
-		// 			fwrite(p.V(),3,sizeof(float),fp);
-		// 		}
-		// 		fwrite(&attributes,1,sizeof(short),fp);
-		// 	}
-		// }
-		// else
-		// {
-			DLFLFacePtrList::const_iterator ff = face_list.begin(); 
-			DLFLFacePtrList::const_iterator fl = face_list.end();
-			Vector3dArray coords; int i=0;
-			
-			o << "solid ascii\n";
-			while ( ff != fl ) {
-				o << "  facet normal "	<< (*ff)->getNormal(true)[0] << " "  << (*ff)->getNormal()[1] << " " << (*ff)->getNormal()[2] << "\n";
-				o << "    outer loop\n";	
-				(*ff)->getVertexCoords(coords);
-				for (i=0; i < coords.size(); i++){
-					o << "      vertex  " << coords[i][0] << " " << coords[i][1] << " " << coords[i][2] << "\n"; 
-				}
-				o << "    endloop\n";
-				o << "  endfacet\n";
-				++ff;
-			}			
-			o << "endsolid ascii";
-		// }
+	void DLFLObject::writeSTL(ostream& o, bool binary) const {
+		// Faces are triangulated while they are written, the object itself
+		// is left alone
+		DLFLFacePtrArray faces(face_list.begin(),face_list.end());
+		DLFLWriteBuffer b(o);
+		STLFacetWriter w(faces,binary);
+
+		if ( binary ) {
+			// 80 byte header which must not start with "solid",
+			// number of triangles, then 50 bytes per triangle
+			string header = "TopMod binary STL";
+			header.resize(80,' ');
+			b.put(header);
+			unsigned long ntris = 0;
+			for (uint i = 0; i < faces.size(); ++i)
+				ntris += numTriangles(faces[i]->size());
+			b.putUInt32LE(ntris);
+			writeChunked(b,faces.size(),w);
+		} else {
+			b.put("solid ascii\n");
+			writeChunked(b,faces.size(),w);
+			b.put("endsolid ascii");
+		}
+		b.flush();
+		o.flush();
 	}
 	
 } // end namespace
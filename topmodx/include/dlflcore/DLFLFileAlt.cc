@@ -96,18 +96,6 @@ namespace DLFL {
 
   typedef vector<Face> FaceArray;
 
-  static FaceArray faces;                                // Array of faces as read from the OBJ file
-  // When faces are read these arrays will be created
-  // And then used to create the object using repeated
-  // edge insertions
-
-  static DLFLVertexPtrArray vertex_array;                // Array containing vertices from each point-sphere
-  // created when vertices are read
-
-  static EdgeList open_edges;                            // Lists containing the edges not yet inserted
-  // because of ambiguities in finding correct corner
-  // These edges will be inserted at the end of the first loop
-
   static void updateCornersInFace(Face& face) {
     // Update the prev and next fields for all Corners in the Face
     // Assumes that the index fields have been correctly set for all Corners
@@ -278,8 +266,17 @@ namespace DLFL {
     // Clear the object first
     reset();
 
-    // Clear the static arrays
-    faces.clear(); vertex_array.clear();
+    FaceArray faces;                                // Array of faces as read from the OBJ file
+    // When faces are read these arrays will be created
+    // And then used to create the object using repeated
+    // edge insertions
+
+    DLFLVertexPtrArray vertex_array;                // Array containing vertices from each point-sphere
+    // created when vertices are read
+
+    EdgeList open_edges;                            // Lists containing the edges not yet inserted
+    // because of ambiguities in finding correct corner
+    // These edges will be inserted at the end of the first loop
 
     DLFLMaterialPtr cur_mtl = matl_list.front();
     RGBColor color;
@@ -35,6 +35,7 @@
 #include "DLFLCommon.hh"
 #include "DLFLFace.hh"
 #include <Graphics/Color.hh>
+#include <algorithm>
 
 namespace DLFL {
 
@@ -118,6 +119,15 @@ public :
       faces.remove(faceptr);
   }
 
+  // Remove many faces in one pass. The array has to be sorted
+  void deleteFaces(const DLFLFacePtrArray& sorted) {
+    DLFLFacePtrList::iterator first = faces.begin(), last = faces.end();
+    while ( first != last ) {
+      if ( binary_search(sorted.begin(),sorted.end(),*first) ) first = faces.erase(first);
+      else ++first;
+    }
+  }
+
   uint numFaces(void) const
   {
     return faces.size();
@@ -0,0 +1,181 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLNormals.cc
+ */
+
+
+#include "DLFLNormals.hh"
+#include "DLFLObject.hh"
+#include <cmath>
+
+namespace DLFL {
+
+  void DLFLNormals::invalidate( ) {
+    object = NULL; valid = false;
+    faces.clear(); weighted.clear(); ringfaces.clear();
+  }
+
+  void DLFLNormals::compute( DLFLObjectPtr obj ) {
+    DLFLAdjacency& adj = obj->adjacency();
+    object = obj; stamp = obj->topologyCount(); valid = true;
+
+    faces.assign(obj->beginFace(),obj->endFace());
+    int n = faces.size();
+    weighted.assign(n,Vector3d());
+
+    // The adjacency entries of each corner of a face get the position of the
+    // face. Each face only writes the entries of its own corners
+    uint nv = adj.numVertices();
+    ringfaces.assign(nv ? adj.ringEnd(nv-1) : 0,0);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+    for (int f=0; f < n; ++f) {
+      DLFLFaceVertexPtr head = faces[f]->front(), current = head;
+      if ( head == NULL ) continue;
+      do {
+        int i = adj.indexOf(current->vertex);
+        if ( i >= 0 )
+          for (uint k=adj.ringBegin(i); k < adj.ringEnd(i); ++k)
+            if ( adj.corner(k) == current ) { ringfaces[k] = f; break; }
+        current = current->next();
+      } while ( current != head );
+    }
+
+    vector<uint> all(n);
+    for (int f=0; f < n; ++f) all[f] = f;
+    vector<int> which(adj.numVertices());
+    for (uint i=0; i < which.size(); ++i) which[i] = i;
+
+    updateFaces(all);
+    updateVertices(obj,adj,which);
+  }
+
+  void DLFLNormals::update( DLFLObjectPtr obj, const DLFLVertexPtrArray& moved ) {
+    if ( !valid || obj != object || obj->topologyCount() != stamp ) {
+      compute(obj); return;
+    }
+    DLFLAdjacency& adj = obj->adjacency();
+
+    // Faces around the moved vertices, then every vertex of those faces
+    vector<char> facemark(faces.size(),0);
+    vector<uint> which;
+    for (uint m=0; m < moved.size(); ++m) {
+      int i = adj.indexOf(moved[m]);
+      if ( i < 0 ) continue;
+      for (uint k=adj.ringBegin(i); k < adj.ringEnd(i); ++k) {
+        uint f = ringfaces[k];
+        if ( !facemark[f] ) { facemark[f] = 1; which.push_back(f); }
+      }
+    }
+
+    vector<char> vertexmark(adj.numVertices(),0);
+    vector<int> vertices;
+    for (uint f=0; f < which.size(); ++f) {
+      DLFLFaceVertexPtr head = faces[which[f]]->front(), current = head;
+      if ( head == NULL ) continue;
+      do {
+        int i = adj.indexOf(current->vertex);
+        if ( i >= 0 && !vertexmark[i] ) { vertexmark[i] = 1; vertices.push_back(i); }
+        current = current->next();
+      } while ( current != head );
+    }
+
+    updateFaces(which);
+    updateVertices(obj,adj,vertices);
+  }
+
+  void DLFLNormals::updateFaces( const vector<uint>& which ) {
+    int n = which.size();
+
+    // Each face only writes its own corners
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+    for (int i=0; i < n; ++i) {
+      DLFLFacePtr fp = faces[which[i]];
+      DLFLFaceVertexPtr head = fp->front(), current = head;
+      Vector3d area;
+      fp->normal.reset();
+      if ( head ) {
+        // Same sums as DLFLFace::updateNormal. The polygon area comes from the
+        // cross products of consecutive vertices (Newell's method)
+        do {
+          current->updateNormal();
+          fp->normal += current->normal;
+          area += current->getVertexCoords() % current->next()->getVertexCoords();
+          current = current->next();
+        } while ( current != head );
+        normalize(fp->normal);
+      }
+      weighted[which[i]] = fp->normal * (0.5 * norm(area));
+    }
+  }
+
+  void DLFLNormals::updateVertices( DLFLObjectPtr obj, const DLFLAdjacency& adj, const vector<int>& which ) {
+    int n = which.size();
+    bool smooth = ( obj->normalMode() == Smooth );
+    double creaseangle = obj->creaseAngle();
+    bool creases = ( creaseangle > 0.0 && creaseangle < 180.0 );
+    double mincos = cos(creaseangle * M_PI / 180.0);
+
+    // Each vertex only writes its own corners
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+    for (int j=0; j < n; ++j) {
+      int i = which[j];
+      DLFLVertexPtr vp = adj.vertex(i);
+      if ( !smooth ) {
+        vp->updateNormal(false);
+        continue;
+      }
+
+      uint first = adj.ringBegin(i), last = adj.ringEnd(i);
+      Vector3d sum;
+      for (uint k=first; k < last; ++k) sum += weighted[ringfaces[k]];
+      vp->setNormal(sum);
+
+      for (uint k=first; k < last; ++k) {
+        DLFLFaceVertexPtr fvp = adj.corner(k);
+        if ( !creases ) { fvp->normal = vp->getNormal(); continue; }
+
+        // Only the faces which meet this corner's face at less than the crease angle
+        Vector3d fnormal = adj.face(k)->normal, csum;
+        for (uint l=first; l < last; ++l)
+          if ( l == k || fnormal * adj.face(l)->normal >= mincos )
+            csum += weighted[ringfaces[l]];
+        if ( normalize(csum) > 0.0 ) fvp->normal = csum;
+        else fvp->normal = vp->getNormal();
+      }
+    }
+  }
+
+} // end namespace
@@ -0,0 +1,91 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLNormals.hh
+ */
+
+
+#ifndef _DLFL_NORMALS_HH_
+#define _DLFL_NORMALS_HH_
+
+// Computes the face, vertex and corner normals of an object in parallel.
+// Faces are done first, each one only touching its own corners, then the
+// vertices over the one-ring cache (see DLFLAdjacency), each one only touching
+// the corners around it.
+//
+// In the faceted mode (the default) the normals are the ones TopMod has always
+// used: every corner gets the normal of its own corner of the polygon, vertex
+// normals are the average of their corner normals. In the smooth mode vertex
+// normals are the sum of the normals of the faces around them weighted by the
+// area of the faces, and corners get the same sum limited to the faces within
+// the crease angle of their own face, so sharp edges stay sharp.
+//
+// The mode and crease angle are settings of the object (see
+// DLFLObject::normalMode()). The area weighted face normals are kept between
+// calls, by the position of the face in the face list, so that update() can
+// redo only the part of the mesh around vertices which have been moved.
+
+#include "DLFLCommon.hh"
+#include "DLFLAdjacency.hh"
+
+namespace DLFL {
+
+  class DLFLNormals {
+  public :
+
+    enum Mode { Faceted=0, Smooth=1 };
+
+    DLFLNormals( )
+      : object(NULL), stamp(0), valid(false) { };
+
+    void invalidate( );
+
+    // Compute all the normals of the object
+    void compute( DLFLObjectPtr obj );
+
+    // Recompute the normals which depend on the given vertices after they
+    // have been moved. Does everything if the topology changed since the last call
+    void update( DLFLObjectPtr obj, const DLFLVertexPtrArray& moved );
+
+  protected :
+
+    DLFLObjectPtr object;                  // Object the weights were computed for
+    uint stamp;                            // Topology count of object at that time
+    bool valid;
+    DLFLFacePtrArray faces;                // Faces in list order
+    Vector3dArray weighted;                // Face normal times face area, by position in faces
+    vector<uint> ringfaces;                // Position of the face of each adjacency entry
+
+    void updateFaces( const vector<uint>& which );
+    void updateVertices( DLFLObjectPtr obj, const DLFLAdjacency& adj, const vector<int>& which );
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_NORMALS_HH_ */
@@ -36,6 +36,9 @@
  */
 
 #include "DLFLObject.hh"
+#include "DLFLProfile.hh"
+#include <algorithm>
+#include <cmath>
 
 namespace DLFL {
 
@@ -80,16 +83,307 @@ namespace DLFL {
     // Combine 2 objects. The lists are simply spliced together.
     // Entities must be removed from the second object to prevent dangling pointers
     // when it is destroyed.
+    // The spliced entities get new IDs from this object, their old IDs were
+    // handed out by the other object and can be in use here already
+    DLFLVertexPtrList::iterator vf = object.vertex_list.begin(), vl = object.vertex_list.end();
+    while ( vf != vl ) {
+      (*vf)->setID(vertex_id++); ++vf;
+    }
+    DLFLEdgePtrList::iterator ef = object.edge_list.begin(), el = object.edge_list.end();
+    while ( ef != el ) {
+      (*ef)->setID(edge_id++);
+      edgeMap[(*ef)->getID()] = (unsigned int)(*ef);
+      ++ef;
+    }
+    DLFLFacePtrList::iterator ff = object.face_list.begin(), fl = object.face_list.end();
+    while ( ff != fl ) {
+      (*ff)->setID(face_id++);
+      faceMap[(*ff)->getID()] = (unsigned int)(*ff);
+      ++ff;
+    }
+    object.edgeMap.clear(); object.faceMap.clear();
+
     vertex_list.splice(vertex_list.end(),object.vertex_list);
     edge_list.splice(edge_list.end(),object.edge_list);
     face_list.splice(face_list.end(),object.face_list);
     matl_list.splice(matl_list.end(),object.matl_list);
+    touch(); object.touch();
+    touchTopology(); object.touchTopology();
+  }
+
+  void DLFLObject::swap(DLFLObject& object) {
+    vertex_list.swap(object.vertex_list);
+    edge_list.swap(object.edge_list);
+    face_list.swap(object.face_list);
+    matl_list.swap(object.matl_list);
+    edgeMap.swap(object.edgeMap);
+    faceMap.swap(object.faceMap);
+    std::swap(vertex_id,object.vertex_id);
+    std::swap(edge_id,object.edge_id);
+    std::swap(face_id,object.face_id);
+    touch(); object.touch();
+    touchTopology(); object.touchTopology();
+  }
+
+  void DLFLObject::appendCopy(const DLFLObject& object, bool reverse,
+                              DLFLVertexPtrArray *vmap, DLFLFacePtrArray *fmap) {
+    // Sizes are taken up front since object can be this object, in which case
+    // the lists grow while we go through them
+    uint num_verts = object.vertex_list.size();
+    uint num_edges = object.edge_list.size();
+    uint num_faces = object.face_list.size();
+
+    // The vertex and face-vertex index fields are used to look up the copies,
+    // same as the index numbers written by writeDLFL
+    DLFLVertexPtrArray newverts(num_verts,NULL);
+    DLFLFaceVertexPtrArray newcorners;
+    DLFLFacePtrArray newfaces(num_faces,NULL);
+
+    DLFLVertexPtrList::const_iterator vf = object.vertex_list.begin();
+    DLFLVertexPtr vptr;
+    for (uint i=0; i < num_verts; ++i, ++vf) {
+      (*vf)->setIndex(i);
+      vptr = new DLFLVertex((*vf)->coords);
+      addVertexPtr(vptr);
+      newverts[i] = vptr;
+    }
+
+    // Copy the face-vertices, in face order
+    DLFLFacePtrList::const_iterator ff = object.face_list.begin();
+    DLFLFaceVertexPtr head, current, newfvptr;
+    for (uint i=0; i < num_faces; ++i, ++ff) {
+      head = (*ff)->front();
+      if ( head == NULL ) continue;
+      current = head;
+      do {
+        current->setIndex(newcorners.size());
+        newfvptr = new DLFLFaceVertex;
+        newfvptr->vertex = newverts[current->vertex->getIndex()];
+        newfvptr->normal = current->normal;
+        newfvptr->texcoord = current->texcoord;
+        newcorners.push_back(newfvptr);
+        current = current->next();
+      } while ( current != head );
+    }
+
+    // Edges. When the faces are reversed an edge starts at the corner after
+    // the original one in each face
+    DLFLEdgePtrList::const_iterator ef = object.edge_list.begin();
+    DLFLFaceVertexPtr fvp1, fvp2;
+    DLFLEdgePtr neweptr;
+    for (uint i=0; i < num_edges; ++i, ++ef) {
+      (*ef)->getFaceVertexPointers(fvp1,fvp2);
+      if ( reverse ) {
+        fvp1 = fvp1->next(); fvp2 = fvp2->next();
+      }
+      neweptr = new DLFLEdge;
+      neweptr->setFaceVertexPointers(newcorners[fvp1->getIndex()],newcorners[fvp2->getIndex()],false);
+      neweptr->updateFaceVertices();
+      addEdgePtr(neweptr);
+    }
+
+    // Faces, using the same materials as the originals. Materials of another
+    // object are matched by name and added to this object if missing
+    DLFLFacePtr newfptr;
+    DLFLMaterialPtr mptr;
+    ff = object.face_list.begin();
+    for (uint i=0; i < num_faces; ++i, ++ff) {
+      newfptr = new DLFLFace;
+      head = (*ff)->front();
+      if ( head ) {
+        current = head;
+        do {
+          newfptr->addVertexPtr(newcorners[current->getIndex()]);
+          current = ( reverse ) ? current->prev() : current->next();
+        } while ( current != head );
+      }
+
+      mptr = (*ff)->material();
+      if ( mptr && &object != this ) {
+        DLFLMaterialPtr found = findMaterial(mptr->name);
+        if ( found == NULL ) {
+          found = new DLFLMaterial(mptr->name,mptr->color);
+          found->Ka = mptr->Ka; found->Kd = mptr->Kd; found->Ks = mptr->Ks;
+          matl_list.push_back(found);
+        }
+        mptr = found;
+      }
+      if ( mptr == NULL ) mptr = matl_list.front();
+      newfptr->setMaterial(mptr);
+
+      newfptr->updateFacePointers();
+      newfptr->addFaceVerticesToVertices();
+      addFacePtr(newfptr);
+      newfaces[i] = newfptr;
+    }
+
+    // Renumber everything like readDLFL does. Crust modeling relies on the
+    // face IDs being consecutive
+    makeUnique();
+
+    if ( vmap ) vmap->swap(newverts);
+    if ( fmap ) fmap->swap(newfaces);
+  }
+
+  // Cell of the weld grid a position falls in
+  struct WeldCell {
+    long long x, y, z;
+    WeldCell( const Vector3d& p, double size )
+      : x((long long)floor(p[0]/size)), y((long long)floor(p[1]/size)), z((long long)floor(p[2]/size)) { }
+    WeldCell( long long a, long long b, long long c ) : x(a), y(b), z(c) { }
+    size_t hash( ) const {
+      return (size_t)(x*73856093LL ^ y*19349663LL ^ z*83492791LL);
+    }
+  };
+
+  // Unordered vertex pair of an edge, for matching up the two sides of an edge
+  static size_t vertexPairHash( DLFLVertexPtr a, DLFLVertexPtr b ) {
+    size_t ha = (size_t)a, hb = (size_t)b;
+    return (ha ^ hb) * 2654435761UL + ( ha < hb ? ha : hb );
+  }
+
+  static bool sameVertexPair( DLFLEdgePtr e, DLFLVertexPtr a, DLFLVertexPtr b ) {
+    DLFLVertexPtr ea = e->getFaceVertexPtr1()->vertex, eb = e->getFaceVertexPtr2()->vertex;
+    return ( ea == a && eb == b ) || ( ea == b && eb == a );
+  }
+
+  void DLFLObject::rebuildEdges( ) {
+    DLFLEdgePtrList::iterator ef = edge_list.begin(), el = edge_list.end();
+    for (; ef != el; ++ef) delete *ef;
+    edge_list.clear(); edgeMap.clear();
+
+    DLFLFaceVertexPtrArray corners;
+    DLFLFacePtrList::iterator ff = face_list.begin(), fl = face_list.end();
+    for (; ff != fl; ++ff) {
+      DLFLFaceVertexPtr head = (*ff)->front(), current = head;
+      if ( head == NULL ) continue;
+      do {
+        current->setEdgePtr(NULL);
+        corners.push_back(current);
+        current = current->next();
+      } while ( current != head );
+    }
+    rebuildEdges(corners);
+  }
+
+  void DLFLObject::rebuildEdges( const DLFLFaceVertexPtrArray& corners ) {
+    size_t tablesize = 1;
+    while ( tablesize < 2*corners.size() ) tablesize <<= 1;
+    DLFLEdgePtrArray table(tablesize,(DLFLEdgePtr)NULL);
+    for (uint i=0; i < corners.size(); ++i) {
+      DLFLFaceVertexPtr fvp = corners[i], nfvp = fvp->next();
+      DLFLVertexPtr a = fvp->vertex, b = nfvp->vertex;
+      size_t h = vertexPairHash(a,b) & (tablesize-1);
+      while ( table[h] && !sameVertexPair(table[h],a,b) ) h = (h+1) & (tablesize-1);
+      DLFLEdgePtr eptr = table[h];
+      if ( eptr && eptr->getFaceVertexPtr2() == eptr->getFaceVertexPtr1()->next() ) {
+        // Second side of an edge which only has its first side so far. Keep
+        // the corner at the same vertex as the second corner of the edge
+        if ( eptr->getFaceVertexPtr2()->vertex == a ) eptr->setFaceVertexPtr2(fvp);
+        else eptr->setFaceVertexPtr2(nfvp);
+      } else {
+        eptr = new DLFLEdge(fvp,nfvp);
+        table[h] = eptr;
+        addEdgePtr(eptr);
+      }
+      // Every corner points to the edge to the next corner, also when the
+      // edge has only one side
+      fvp->setEdgePtr(eptr);
+    }
+  }
+
+  uint DLFLObject::weldVertices(double tolerance) {
+    DLFLProfileScope profile("weldVertices");
+    DLFLVertexPtrArray verts(vertex_list.begin(),vertex_list.end());
+    uint n = verts.size();
+    profile.setElements(n);
+    if ( n < 2 ) return 0;
+    if ( tolerance < 0.0 ) tolerance = 0.0;
+
+    // Uniform grid of cells as large as the tolerance, hashed into a table.
+    // Only the vertices which are kept go into the grid. A vertex is welded
+    // to the first kept vertex within the tolerance, which can only be in
+    // one of the 27 cells around its own
+    double cellsize = ( tolerance > 0.0 ) ? tolerance : 1.0e-9;
+    double tol2 = tolerance * tolerance;
+    size_t tablesize = 1;
+    while ( tablesize < 2*(size_t)n ) tablesize <<= 1;
+    vector<int> bucket(tablesize,-1), chain(n,-1);
+    vector<int> weldto(n,-1);
+    uint numwelded = 0;
+
+    for (uint i=0; i < n; ++i) {
+      const Vector3d& p = verts[i]->coords;
+      WeldCell c(p,cellsize);
+      for (int dx=-1; dx <= 1 && weldto[i] < 0; ++dx)
+        for (int dy=-1; dy <= 1 && weldto[i] < 0; ++dy)
+          for (int dz=-1; dz <= 1 && weldto[i] < 0; ++dz) {
+            WeldCell nc(c.x+dx,c.y+dy,c.z+dz);
+            for (int k = bucket[nc.hash() & (tablesize-1)]; k >= 0; k = chain[k])
+              if ( normsqr(verts[k]->coords - p) <= tol2 ) {
+                weldto[i] = k; break;
+              }
+          }
+      if ( weldto[i] >= 0 ) { ++numwelded; continue; }
+      size_t h = c.hash() & (tablesize-1);
+      chain[i] = bucket[h]; bucket[h] = i;
+    }
+    if ( numwelded == 0 ) return 0;
+
+    // Move the corners of the welded vertices to the vertices they are welded to
+    DLFLVertexPtrArray kept;
+    for (uint i=0; i < n; ++i) {
+      if ( weldto[i] < 0 ) continue;
+      DLFLVertexPtr from = verts[i], to = verts[weldto[i]];
+      DLFLFaceVertexPtrList::const_iterator fvf = from->beginFaceVertex(), fvl = from->endFaceVertex();
+      for (; fvf != fvl; ++fvf) {
+        (*fvf)->setVertexPtr(to);
+        to->addToFaceVertexList(*fvf);
+      }
+      kept.push_back(to);
+    }
+    sort(kept.begin(),kept.end());
+    kept.erase(unique(kept.begin(),kept.end()),kept.end());
+
+    // Corners of a face which ended up on the same vertex are merged, as long
+    // as the face keeps at least 3 corners
+    for (uint i=0; i < kept.size(); ++i) {
+      DLFLFaceVertexPtrList corners = kept[i]->getFaceVertexList();
+      DLFLFaceVertexPtrList::iterator fvf = corners.begin(), fvl = corners.end();
+      for (; fvf != fvl; ++fvf) {
+        DLFLFaceVertexPtr fvp = *fvf;
+        DLFLFacePtr fp = fvp->getFacePtr();
+        if ( fp && fvp->next() != fvp && fvp->next()->vertex == fvp->vertex && fp->size() > 3 ) {
+          fp->deleteVertexPtr(fvp);
+          kept[i]->deleteFromFaceVertexList(fvp);
+          delete fvp;
+        }
+      }
+    }
+
+    DLFLVertexPtrList::iterator vf = vertex_list.begin();
+    for (uint i=0; i < n; ++i) {
+      if ( weldto[i] >= 0 ) {
+        delete *vf;
+        vf = vertex_list.erase(vf);
+      } else ++vf;
+    }
+
+    // Edges are all built again, since edges from different vertices can now
+    // join the same two vertices. Rebuilding only the edges at the kept
+    // vertices isn't enough: in a polygon soup the edges have one side only,
+    // and the corners don't reliably point to their own edge
+    rebuildEdges();
+
+    touch();
+    return numwelded;
   }
 
   // Reverse the orientation of all faces in the object
   // This also requires reversing all edges in the object
   void DLFLObject::reverse(void)
   {
+    touchTopology();
     // Reverse the edges first, since they depend on the ordering of the
     // original faces.
     DLFLEdgePtrList::iterator efirst=edge_list.begin(), elast=edge_list.end();
@@ -478,21 +772,78 @@ namespace DLFL {
     addFacePtr(faceptr->copy());
   }
 
-  void DLFLObject::computeNormals( ) {
-    DLFLVertexPtrList::iterator first, last;
+  void DLFLObject::eraseVertex( DLFLVertexPtr vp ) {
+    if ( batch_depth > 0 ) { ++topology_count; dead_vertices.push_back(vp); }
+    else { removeVertex(vp); delete vp; }
+  }
 
-    first = vertex_list.begin(); last = vertex_list.end();
+  void DLFLObject::eraseEdge( DLFLEdgePtr ep ) {
+    if ( batch_depth > 0 ) { ++topology_count; edgeMap.erase(ep->getID()); dead_edges.push_back(ep); }
+    else { removeEdge(ep); delete ep; }
+  }
+
+  void DLFLObject::eraseFace( DLFLFacePtr fp ) {
+    if ( batch_depth > 0 ) { ++topology_count; faceMap.erase(fp->getID()); dead_faces.push_back(fp); }
+    else { removeFace(fp); delete fp; }
+  }
+
+  // Take the elements of a sorted array out of a list, keeping the order of the rest
+  template <class T>
+  static void compactList( list<T>& l, const vector<T>& sorted ) {
+    typename list<T>::iterator first = l.begin(), last = l.end();
     while ( first != last ) {
-      (*first)->updateNormal();
-      ++first;
+      if ( binary_search(sorted.begin(),sorted.end(),*first) ) first = l.erase(first);
+      else ++first;
     }
-    DLFLFacePtrList::iterator ffirst, flast;
+  }
 
-    ffirst = face_list.begin(); flast = face_list.end();
-    while ( ffirst != flast ) {
-      (*ffirst)->updateNormal();
-      ++ffirst;
+  void DLFLObject::endBatch( ) {
+    if ( batch_depth == 0 || --batch_depth > 0 ) return;
+    DLFLProfileScope profile("endBatch",dead_vertices.size()+dead_edges.size()+dead_faces.size());
+
+    if ( !dead_faces.empty() ) {
+      sort(dead_faces.begin(),dead_faces.end());
+      compactList(face_list,dead_faces);
+      // Take the faces out of their materials in one pass per material, so
+      // the face destructor doesn't have to search the material's list
+      DLFLMaterialPtrArray matls;
+      for (uint i=0; i < dead_faces.size(); ++i) {
+        DLFLMaterialPtr mp = dead_faces[i]->material();
+        if ( mp && find(matls.begin(),matls.end(),mp) == matls.end() ) matls.push_back(mp);
+        dead_faces[i]->dropMaterial();
+      }
+      for (uint i=0; i < matls.size(); ++i) matls[i]->deleteFaces(dead_faces);
+      for (uint i=0; i < dead_faces.size(); ++i) delete dead_faces[i];
+      dead_faces.clear();
     }
+
+    if ( !dead_edges.empty() ) {
+      sort(dead_edges.begin(),dead_edges.end());
+      compactList(edge_list,dead_edges);
+      for (uint i=0; i < dead_edges.size(); ++i) delete dead_edges[i];
+      dead_edges.clear();
+    }
+
+    if ( !dead_vertices.empty() ) {
+      sort(dead_vertices.begin(),dead_vertices.end());
+      compactList(vertex_list,dead_vertices);
+      for (uint i=0; i < dead_vertices.size(); ++i) delete dead_vertices[i];
+      dead_vertices.clear();
+    }
+  }
+
+  void DLFLObject::computeNormals( ) {
+    DLFLProfileScope profile("computeNormals");
+    touch();
+    normals_cache.compute(this);
+    profile.setElements(face_list.size());
+  }
+
+  void DLFLObject::updateNormals( const DLFLVertexPtrArray& moved ) {
+    DLFLProfileScope profile("updateNormals");
+    touch();
+    normals_cache.update(this,moved);
+    profile.setElements(moved.size());
   }
   /*
 		void DLFLObject::deleteVertex(uint vertex_index) {
@@ -54,6 +54,9 @@
 #include "DLFLEdge.hh"
 #include "DLFLFace.hh"
 #include "DLFLMaterial.hh"
+#include "DLFLSelection.hh"
+#include "DLFLAdjacency.hh"
+#include "DLFLNormals.hh"
 #include <Graphics/Transform.hh>
 
 
@@ -66,7 +69,9 @@ public :
   /// Constructor
   DLFLObject()
     : position(), scale_factor(1), rotation(),
-      vertex_list(), edge_list(), face_list()/*, patch_list(), patchsize(4)*/ {
+      vertex_list(), edge_list(), face_list()/*, patch_list(), patchsize(4)*/,
+      vertex_id(0), edge_id(0), face_id(0), change_count(0), topology_count(0),
+      normal_mode(DLFLNormals::Faceted), crease_angle(0.0), batch_depth(0) {
     assignID();
     // Add a default material
     matl_list.push_back(new DLFLMaterial("default",0.5,0.5,0.5));
@@ -88,20 +93,18 @@ protected :
 
   // Generate a new unique ID
   static uint newID( ) {
-    uint temp = suLastID;
-    suLastID++;
-    return temp;
+    return fetchAndIncrement(suLastID);
   };
 
 public :
  
 	static Transformation tr;                         // For doing GL transformations
 
-  DLFLVertexPtrArray sel_vptr_array; // List of selected DLFLVertex pointers
+  DLFLVertexSelection sel_vptr_array; // List of selected DLFLVertex pointers
 
-  DLFLEdgePtrArray sel_eptr_array; // List of selected DLFLEdge pointers
-  DLFLFacePtrArray sel_fptr_array; // List of selected DLFLFace pointers
-  DLFLFaceVertexPtrArray sel_fvptr_array; // List of selected DLFLFaceVertex pointers
+  DLFLEdgeSelection sel_eptr_array; // List of selected DLFLEdge pointers
+  DLFLFaceSelection sel_fptr_array; // List of selected DLFLFace pointers
+  DLFLFaceVertexSelection sel_fvptr_array; // List of selected DLFLFaceVertex pointers
 
   void clearSelected( ) {
     sel_vptr_array.clear();
@@ -110,6 +113,33 @@ public :
     sel_fvptr_array.clear();
   };
 
+  //--- Bulk selection operations, linear in the size of the mesh/selection ---//
+  //--- Defined in DLFLSelection.cc ---//
+
+  // Select everything that is not selected and deselect the rest
+  void selectInverseVertices( );
+  void selectInverseEdges( );
+  void selectInverseFaces( );
+
+  // Add the neighbours of the selected elements (across edges) to the selection
+  void growSelectedVertices( );
+  void growSelectedEdges( );
+  void growSelectedFaces( );
+
+  // Deselect elements which have a neighbour that is not selected
+  void shrinkSelectedVertices( );
+  void shrinkSelectedEdges( );
+  void shrinkSelectedFaces( );
+
+  // Add the elements adjacent to the selected elements of another type.
+  // The source selection is left alone
+  void selectEdgesFromFaces( );
+  void selectEdgesFromVertices( );
+  void selectFacesFromEdges( );
+  void selectFacesFromVertices( );
+  void selectVerticesFromFaces( );
+  void selectVerticesFromEdges( );
+
 	HashMap faceMap;
 	HashMap edgeMap;
 
@@ -122,12 +152,55 @@ public :
   Vector3d           scale_factor;                  // Scale of object
   Quaternion         rotation;                      // Rotation of object
 
-  inline void removeVertex( DLFLVertexPtr vp ) { vertex_list.remove(vp); };
-  inline void removeEdge( DLFLEdgePtr ep ) { edgeMap.erase(ep->getID()); edge_list.remove(ep); };
-  inline void removeFace( DLFLFacePtr fp ) { faceMap.erase(fp->getID()); face_list.remove(fp); };
-
+  inline void removeVertex( DLFLVertexPtr vp ) { ++topology_count; vertex_list.remove(vp); };
+  inline void removeEdge( DLFLEdgePtr ep ) { ++topology_count; edgeMap.erase(ep->getID()); edge_list.remove(ep); };
+  inline void removeFace( DLFLFacePtr fp ) { ++topology_count; faceMap.erase(fp->getID()); face_list.remove(fp); };
+
+  // Remove an element from the object and free it. Outside a batch this is
+  // removeX() followed by delete. Inside a batch the element is only taken out
+  // of the edge/face maps right away; taking it out of its list and freeing it
+  // is left to endBatch(), which does it for all such elements in one pass.
+  // So between beginBatch() and endBatch() the lists (and num_vertices() etc.)
+  // still hold the erased elements and must not be walked to find live ones.
+  // Batches can be nested, only the outermost endBatch() compacts the lists
+  void eraseVertex( DLFLVertexPtr vp );
+  void eraseEdge( DLFLEdgePtr ep );
+  void eraseFace( DLFLFacePtr fp );
+
+  void beginBatch( ) { ++batch_depth; };
+  void endBatch( );
+  bool inBatch( ) const { return batch_depth > 0; };
+
+  // Compute the face, vertex and corner normals. See DLFLNormals
   void computeNormals( );
 
+  // How computeNormals() does it for this object. The crease angle is the
+  // angle in degrees between two faces above which their edge is a crease in
+  // the smooth mode, 0 (or 180 and above) turns creases off
+  DLFLNormals::Mode normalMode( ) const { return normal_mode; };
+  void setNormalMode( DLFLNormals::Mode m ) { normal_mode = m; };
+  double creaseAngle( ) const { return crease_angle; };
+  void setCreaseAngle( double angle ) { crease_angle = angle; };
+
+  // Recompute only the normals around vertices which have been moved
+  void updateNormals( const DLFLVertexPtrArray& moved );
+
+  // Counter bumped whenever the mesh is known to have changed. Operations end
+  // with computeNormals() which bumps it, other edits (eg. dragging a vertex) call touch().
+  // Caches built from the mesh compare against it to find out if they are stale
+  void touch( ) { ++change_count; };
+  uint changeCount( ) const { return change_count; };
+
+  // Counter bumped whenever elements are added, removed or renumbered, which
+  // covers every change of the connectivity. Code which rewires corners by
+  // hand without doing so calls touchTopology()
+  void touchTopology( ) { ++topology_count; };
+  uint topologyCount( ) const { return topology_count; };
+
+  // One-ring cache of the vertices, brought up to date if the topology changed
+  // since it was last used. See DLFLAdjacency
+  DLFLAdjacency& adjacency( ) { adjacency_cache.sync(this); return adjacency_cache; };
+
 protected :
 
   DLFLVertexPtrList          vertex_list;           // The vertex list
@@ -139,6 +212,20 @@ protected :
   //int patchsize;				 // Size of each patch
      
   uint uID;                                      // ID for this object
+  // Next IDs for the vertices, edges and faces of this object. Elements are
+  // numbered by the object they are added to, so IDs in one object don't
+  // depend on what is going on in other objects
+  uint vertex_id, edge_id, face_id;
+  uint change_count;                             // See touch()
+  uint topology_count;                           // See touchTopology()
+  DLFLAdjacency adjacency_cache;                 // See adjacency()
+  DLFLNormals normals_cache;                     // Face weights kept by computeNormals()
+  DLFLNormals::Mode normal_mode;                 // See normalMode()
+  double crease_angle;
+  uint batch_depth;                              // Nesting depth of beginBatch()
+  DLFLVertexPtrArray dead_vertices;              // Erased inside the current batch
+  DLFLEdgePtrArray dead_edges;
+  DLFLFacePtrArray dead_faces;
   char *mFilename;
   char *mDirname;
   // Assign a unique ID for this instance
@@ -159,11 +246,21 @@ protected :
   void clearLists( ) {
     clear(vertex_list);
     clear(edge_list);
+    // Our materials are freed below, so faces using them needn't search
+    // the material's face list one by one on their way out
+    DLFLMaterialPtrArray matls(matl_list.begin(),matl_list.end());
+    sort(matls.begin(),matls.end());
+    for (DLFLFacePtrList::iterator fi=face_list.begin(); fi != face_list.end(); ++fi)
+      if ( binary_search(matls.begin(),matls.end(),(*fi)->material()) ) (*fi)->dropMaterial();
     clear(face_list);
     clear(matl_list);
     //destroyPatches();
 		edgeMap.clear();
 		faceMap.clear();
+    // Elements erased in an unfinished batch were still in the lists, and are gone now
+    dead_vertices.clear(); dead_edges.clear(); dead_faces.clear();
+    vertex_id = edge_id = face_id = 0;
+    touch(); touchTopology();
   };
 
 private :
@@ -173,7 +270,9 @@ private :
     : position(dlfl.position), scale_factor(dlfl.scale_factor), rotation(dlfl.rotation),
       vertex_list(dlfl.vertex_list), edge_list(dlfl.edge_list), face_list(dlfl.face_list), matl_list(dlfl.matl_list),
       //patch_list(dlfl.patch_list), patchsize(dlfl.patchsize),
-      uID(dlfl.uID) { };
+      uID(dlfl.uID), vertex_id(dlfl.vertex_id), edge_id(dlfl.edge_id), face_id(dlfl.face_id),
+      change_count(0), topology_count(0), adjacency_cache(), normals_cache(),
+      normal_mode(dlfl.normal_mode), crease_angle(dlfl.crease_angle), batch_depth(0) { };
 
   // Assignment operator
   DLFLObject& operator=( const DLFLObject& dlfl ) {
@@ -196,6 +295,7 @@ private :
 		faceMap = dlfl.faceMap;
 
     uID = dlfl.uID;
+    vertex_id = dlfl.vertex_id; edge_id = dlfl.edge_id; face_id = dlfl.face_id;
     return (*this);
   };
 
@@ -344,11 +444,16 @@ public :
     matl_list.push_back(new DLFLMaterial("default",0.5,0.5,0.5));
   };
 
+  // Renumber the vertices/edges/faces from 0 in list order.
+  // IDs of elements added afterwards carry on from there. The adjacency
+  // cache and the sync find elements by ID, so this changes the topology count
   void makeVerticesUnique( ) {
     // Make vertices unique
     DLFLVertexPtrList::iterator vfirst=vertex_list.begin(), vlast=vertex_list.end();
+    touchTopology();
+    vertex_id = 0;
     while ( vfirst != vlast ) {
-      (*vfirst)->makeUnique();
+      (*vfirst)->makeUnique(vertex_id++);
       ++vfirst;
     }
   };
@@ -356,9 +461,11 @@ public :
   void makeEdgesUnique( ) {
     // Make edges unique
     DLFLEdgePtrList::iterator efirst=edge_list.begin(), elast=edge_list.end();
+    touchTopology();
+    edge_id = 0;
+		edgeMap.clear();
     while ( efirst != elast ) {
-			edgeMap.erase((*efirst)->getID());
-      (*efirst)->makeUnique();
+      (*efirst)->makeUnique(edge_id++);
 			edgeMap[(*efirst)->getID()] = (unsigned int)(*efirst);
       ++efirst;
     }
@@ -367,9 +474,11 @@ public :
   void makeFacesUnique( ) {
     // Make faces unique
     DLFLFacePtrList::iterator ffirst=face_list.begin(), flast=face_list.end();
+    touchTopology();
+    face_id = 0;
+		faceMap.clear();
     while ( ffirst != flast ) {
-			faceMap.erase((*ffirst)->getID());
-      (*ffirst)->makeUnique();
+      (*ffirst)->makeUnique(face_id++);
 			faceMap[(*ffirst)->getID()] = (unsigned int)(*ffirst);
       ++ffirst;
     }
@@ -396,6 +505,32 @@ public :
   // pointers in this object will become invalid.
   void splice(DLFLObject& object);
 
+  // Exchange the meshes (elements, materials and ID counters) of two objects.
+  // Position, scale, rotation and file names stay where they are
+  void swap(DLFLObject& object);
+
+  // Append a copy of the given object (which may be this object) to this object,
+  // with the orientation of the copied faces reversed if asked. Same result as
+  // writing the object in DLFL format and reading it back with clearold=false,
+  // without going through a stream. Copied vertices and faces are returned in the
+  // order of the source lists, i.e. vmap[i] is the copy of the i'th source vertex
+  void appendCopy(const DLFLObject& object, bool reverse = false,
+                  DLFLVertexPtrArray *vmap = NULL, DLFLFacePtrArray *fmap = NULL);
+
+  // Merge vertices which are within the given distance of each other and
+  // join up the edges at them. Meant for polygon soups (eg. OBJ files with a
+  // vertex per face corner) and spliced objects, which have coincident but
+  // separate vertices. Returns the number of vertices removed
+  uint weldVertices(double tolerance = 1.0e-6);
+
+  // Throw the edges away and build them again from the faces, pairing up the
+  // two sides of each edge by its vertices. Corners must be in their faces
+  void rebuildEdges( );
+
+  // The same for the given corners only, whose edges have been thrown away.
+  // Used to patch the edges up after faces were taken out or put in
+  void rebuildEdges( const DLFLFaceVertexPtrArray& corners );
+
   // Reverse the orientation of all faces in the object
   // This also requires reversing all edges in the object
   void reverse( );
@@ -403,29 +538,35 @@ public :
   void addVertex(const DLFLVertex& vertex);         // Insert a copy
   void addVertex(DLFLVertexPtr vertexptr);          // Insert a copy
   void addVertexPtr(DLFLVertexPtr vertexptr) {
-    // Insert the pointer.
+    // Insert the pointer. The vertex gets the next ID of this object
     // **** WARNING!!! **** Pointer will be freed when list is deleted
+    vertexptr->setID(vertex_id++);
     vertex_list.push_back(vertexptr);
+    ++topology_count;
   };
 
   void addEdge(const DLFLEdge& edge);               // Insert a copy
   void addEdge(DLFLEdgePtr edgeptr);                // Insert a copy
   void addEdgePtr(DLFLEdgePtr edgeptr) {
-    // Insert the pointer.
+    // Insert the pointer. The edge gets the next ID of this object
     // **** WARNING!!! **** Pointer will be freed when list is deleted
+    edgeptr->setID(edge_id++);
     edge_list.push_back(edgeptr);
+    ++topology_count;
 		edgeMap[edgeptr->getID()] = (unsigned int)edgeptr;
   };
 
   void addFace(const DLFLFace& face);               // Insert a copy
   void addFace(DLFLFacePtr faceptr);                // Insert a copy
   void addFacePtr(DLFLFacePtr faceptr) {
-    // Insert the pointer.
+    // Insert the pointer. The face gets the next ID of this object
     // **** WARNING!!! **** Pointer will be freed when list is deleted
     if ( faceptr->material() == NULL )
       // If Face doesn't have a material assigned to it, assign the default material
 	    faceptr->setMaterial(matl_list.front());
+    faceptr->setID(face_id++);
     face_list.push_back(faceptr);
+    ++topology_count;
 		faceMap[faceptr->getID()] = (unsigned int)faceptr;
   };
 
@@ -536,9 +677,10 @@ public :
 	bool readMTL( istream &i);
 	bool writeMTL( ostream& o )  const;
 	
-  void writeObject( ostream& o, ostream &omtl , bool with_normals = true, bool with_tex_coords = true ) const;
+  // Polygons are split into triangles on the fly if triangulate is set
+  void writeObject( ostream& o, ostream &omtl , bool with_normals = true, bool with_tex_coords = true, bool triangulate = false ) const;
   void writeDLFL(ostream& o, ostream &omtl, bool reverse_faces = false) const;
-  void writeSTL(ostream& o) const;
+  void writeSTL(ostream& o, bool binary = false) const; //!< faces are triangulated on the fly
   void writeLG3d(ostream& o, bool select = false) const ; //!< added by dave - for LiveGraphics3D support to embed 3d models into html
   inline void setFilename( const char *filename ) { 
     // if( mFilename) { delete [] mFilename; mFilename = NULL; }
@@ -669,6 +811,16 @@ public :
     p = tp;
   }
 
+};
+
+// Batch of edits for the rest of the enclosing block, see DLFLObject::beginBatch
+class DLFLBatchScope {
+protected :
+  DLFLObjectPtr obj;
+
+public :
+  DLFLBatchScope( DLFLObjectPtr o ) : obj(o) { obj->beginBatch(); };
+  ~DLFLBatchScope( ) { obj->endBatch(); };
 };
   // Build the list of patch faces
   /*void createPatches() {
@@ -0,0 +1,394 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLProfile.cc
+ */
+
+#include "DLFLProfile.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#if defined(__GNUC__)
+#define DLFL_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define DLFL_THREAD_LOCAL __declspec(thread)
+#else
+#define DLFL_THREAD_LOCAL
+#endif
+
+#define DLFL_PROFILE_RECORDS 8192
+#define DLFL_PROFILE_COUNTERS 2048
+
+#ifdef WITH_ALLOC_COUNT
+
+// Heap allocations made by the process. Counted by the replacement
+// operator new below, so everything linked with dlflcore is counted. Off by
+// default since it replaces the allocator of the whole program, see dlflcore.pro
+static volatile long numallocations = 0;
+
+#if __cplusplus >= 201103L
+#define DLFL_THROW_BAD_ALLOC
+#define DLFL_NOTHROW noexcept
+#else
+#define DLFL_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define DLFL_NOTHROW throw()
+#endif
+
+static inline void countAlloc( ) {
+#if defined(__GNUC__)
+  __sync_fetch_and_add(&numallocations,1);
+#elif defined(_WIN32)
+  InterlockedIncrement(&numallocations);
+#else
+  ++numallocations;
+#endif
+}
+
+static inline void * countedAlloc( size_t n ) {
+  countAlloc();
+  return malloc(n ? n : 1);
+}
+
+void * operator new( size_t n ) DLFL_THROW_BAD_ALLOC {
+  void * p = countedAlloc(n);
+  if ( !p ) throw std::bad_alloc();
+  return p;
+}
+
+void * operator new[]( size_t n ) DLFL_THROW_BAD_ALLOC {
+  void * p = countedAlloc(n);
+  if ( !p ) throw std::bad_alloc();
+  return p;
+}
+
+void * operator new( size_t n, const std::nothrow_t& ) DLFL_NOTHROW { return countedAlloc(n); }
+void * operator new[]( size_t n, const std::nothrow_t& ) DLFL_NOTHROW { return countedAlloc(n); }
+void operator delete( void * p ) DLFL_NOTHROW { free(p); }
+void operator delete[]( void * p ) DLFL_NOTHROW { free(p); }
+void operator delete( void * p, const std::nothrow_t& ) DLFL_NOTHROW { free(p); }
+void operator delete[]( void * p, const std::nothrow_t& ) DLFL_NOTHROW { free(p); }
+
+// C++14 sized deallocation, which would otherwise go to the library's delete
+#ifdef __cpp_sized_deallocation
+void operator delete( void * p, size_t ) DLFL_NOTHROW { free(p); }
+void operator delete[]( void * p, size_t ) DLFL_NOTHROW { free(p); }
+#endif
+
+// C++17 over-aligned types, their memory can't come from malloc
+#ifdef __cpp_aligned_new
+static inline void * countedAlignedAlloc( size_t n, std::align_val_t a ) {
+  countAlloc();
+  size_t align = (size_t)a;
+  if ( align < sizeof(void *) ) align = sizeof(void *);
+#ifdef _WIN32
+  return _aligned_malloc(n ? n : 1,align);
+#else
+  void * p = NULL;
+  if ( posix_memalign(&p,align,n ? n : 1) != 0 ) return NULL;
+  return p;
+#endif
+}
+
+static inline void alignedFree( void * p ) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+void * operator new( size_t n, std::align_val_t a ) {
+  void * p = countedAlignedAlloc(n,a);
+  if ( !p ) throw std::bad_alloc();
+  return p;
+}
+
+void * operator new[]( size_t n, std::align_val_t a ) {
+  void * p = countedAlignedAlloc(n,a);
+  if ( !p ) throw std::bad_alloc();
+  return p;
+}
+
+void * operator new( size_t n, std::align_val_t a, const std::nothrow_t& ) noexcept { return countedAlignedAlloc(n,a); }
+void * operator new[]( size_t n, std::align_val_t a, const std::nothrow_t& ) noexcept { return countedAlignedAlloc(n,a); }
+void operator delete( void * p, std::align_val_t ) noexcept { alignedFree(p); }
+void operator delete[]( void * p, std::align_val_t ) noexcept { alignedFree(p); }
+void operator delete( void * p, size_t, std::align_val_t ) noexcept { alignedFree(p); }
+void operator delete[]( void * p, size_t, std::align_val_t ) noexcept { alignedFree(p); }
+void operator delete( void * p, std::align_val_t, const std::nothrow_t& ) noexcept { alignedFree(p); }
+void operator delete[]( void * p, std::align_val_t, const std::nothrow_t& ) noexcept { alignedFree(p); }
+#endif
+
+#endif // WITH_ALLOC_COUNT
+
+namespace DLFL {
+
+  // Number of the calling thread, handed out in the order threads first record something
+  static volatile int numthreads = 0;
+  static DLFL_THREAD_LOCAL int threadnumber = -1;
+
+  static unsigned int currentThread( ) {
+    if ( threadnumber < 0 ) {
+#if defined(__GNUC__)
+      threadnumber = __sync_fetch_and_add(&numthreads,1);
+#elif defined(_WIN32)
+      threadnumber = InterlockedIncrement((volatile long *)&numthreads) - 1;
+#else
+      threadnumber = numthreads++;
+#endif
+    }
+    return threadnumber;
+  }
+
+  // Seconds on a monotonic-enough wall clock
+  static double clockSeconds( ) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER t;
+    if ( freq.QuadPart == 0 ) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+  }
+
+  static double clockbase = clockSeconds();
+
+  DLFLProfiler::DLFLProfiler( )
+    : records(DLFL_PROFILE_RECORDS), recordhead(0), recordcount(0),
+      counterrecords(DLFL_PROFILE_COUNTERS), counterhead(0), countercount(0),
+      stats(), counters(), lastcounters(), names(),
+      frame(0), framestart(-1.0), lastframe(0.0), frameaverage(0.0),
+      enabled(true), lock(0) {
+  }
+
+  DLFLProfiler& DLFLProfiler::instance( ) {
+    static DLFLProfiler profiler;
+    return profiler;
+  }
+
+  void DLFLProfiler::acquire( ) {
+#if defined(__GNUC__)
+    while ( __sync_lock_test_and_set(&lock,1) ) ;
+#elif defined(_WIN32)
+    while ( InterlockedExchange((volatile long *)&lock,1) ) ;
+#endif
+  }
+
+  void DLFLProfiler::release( ) {
+#if defined(__GNUC__)
+    __sync_lock_release(&lock);
+#elif defined(_WIN32)
+    InterlockedExchange((volatile long *)&lock,0);
+#endif
+  }
+
+  double DLFLProfiler::now( ) const {
+    return clockSeconds() - clockbase;
+  }
+
+  long DLFLProfiler::allocations( ) {
+#ifdef WITH_ALLOC_COUNT
+    return numallocations;
+#else
+    return -1;
+#endif
+  }
+
+  void DLFLProfiler::setCapacity( unsigned int n ) {
+    if ( n < 1 ) n = 1;
+    acquire();
+    records.clear(); records.resize(n);
+    recordhead = recordcount = 0;
+    release();
+  }
+
+  void DLFLProfiler::reset( ) {
+    acquire();
+    recordhead = recordcount = 0;
+    counterhead = countercount = 0;
+    stats.clear(); counters.clear(); lastcounters.clear();
+    lastframe = frameaverage = 0.0;
+    release();
+  }
+
+  const char * DLFLProfiler::intern( const string& name ) {
+    acquire();
+    const char * s = names.insert(name).first->c_str();
+    release();
+    return s;
+  }
+
+  void DLFLProfiler::addRecord( const char * name, double start, double duration, long allocations, long elements ) {
+    DLFLProfileRecord& r = records[recordhead];
+    r.name = name; r.start = start; r.duration = duration;
+    r.allocations = allocations; r.elements = elements;
+    r.frame = frame; r.thread = currentThread();
+    recordhead = (recordhead+1) % records.size();
+    if ( recordcount < records.size() ) ++recordcount;
+
+    StatMap::iterator it = stats.find(name);
+    if ( it == stats.end() ) {
+      DLFLProfileStat s;
+      s.name = name; s.calls = 0; s.total = s.max = 0.0;
+      it = stats.insert(make_pair(name,s)).first;
+    }
+    DLFLProfileStat& s = it->second;
+    ++s.calls; s.total += duration; s.last = duration;
+    if ( duration > s.max ) s.max = duration;
+    s.allocations = allocations; s.elements = elements;
+  }
+
+  void DLFLProfiler::add( const char * name, double start, double duration, long allocations, long elements ) {
+    if ( !enabled ) return;
+    acquire();
+    addRecord(name,start,duration,allocations,elements);
+    release();
+  }
+
+  void DLFLProfiler::count( const char * name, long n ) {
+    if ( !enabled ) return;
+    acquire();
+    counters[name] += n;
+    release();
+  }
+
+  void DLFLProfiler::beginFrame( ) {
+    framestart = now();
+  }
+
+  void DLFLProfiler::endFrame( ) {
+    if ( framestart < 0.0 ) return;
+    double t = now();
+    double d = t - framestart;
+    acquire();
+    if ( enabled ) addRecord("frame",framestart,d,-1,-1);
+    lastframe = d;
+    frameaverage = ( frameaverage == 0.0 ) ? d : 0.9*frameaverage + 0.1*d;
+    CounterMap::iterator it;
+    for (it = counters.begin(); it != counters.end(); ++it) {
+      DLFLProfileCounter& c = counterrecords[counterhead];
+      c.name = it->first; c.time = t; c.value = it->second;
+      counterhead = (counterhead+1) % counterrecords.size();
+      if ( countercount < counterrecords.size() ) ++countercount;
+    }
+    lastcounters.swap(counters);
+    counters.clear();
+    ++frame;
+    release();
+    framestart = -1.0;
+  }
+
+  void DLFLProfiler::getStats( vector<DLFLProfileStat>& s ) {
+    acquire();
+    s.clear(); s.reserve(stats.size());
+    for (StatMap::const_iterator it = stats.begin(); it != stats.end(); ++it)
+      s.push_back(it->second);
+    release();
+  }
+
+  void DLFLProfiler::getCounters( vector<DLFLProfileCounter>& c ) {
+    acquire();
+    c.clear(); c.reserve(lastcounters.size());
+    for (CounterMap::const_iterator it = lastcounters.begin(); it != lastcounters.end(); ++it) {
+      DLFLProfileCounter pc;
+      pc.name = it->first; pc.time = 0.0; pc.value = it->second;
+      c.push_back(pc);
+    }
+    release();
+  }
+
+  void DLFLProfiler::getRecords( vector<DLFLProfileRecord>& r ) {
+    acquire();
+    r.clear(); r.reserve(recordcount);
+    unsigned int first = (recordhead + records.size() - recordcount) % records.size();
+    for (unsigned int i=0; i < recordcount; ++i)
+      r.push_back(records[(first+i) % records.size()]);
+    release();
+  }
+
+  // Write a string as a JSON string literal
+  static void writeJSONString( ostream& o, const char * s ) {
+    o << '"';
+    for (; *s; ++s) {
+      if ( *s == '"' || *s == '\\' ) o << '\\' << *s;
+      else if ( (unsigned char)*s < 0x20 ) {
+        char buf[8]; sprintf(buf,"\\u%04x",(unsigned char)*s); o << buf;
+      } else o << *s;
+    }
+    o << '"';
+  }
+
+  void DLFLProfiler::writeTrace( ostream& o ) {
+    vector<DLFLProfileRecord> r;
+    getRecords(r);
+    vector<DLFLProfileCounter> c;
+    acquire();
+    unsigned int first = (counterhead + counterrecords.size() - countercount) % counterrecords.size();
+    for (unsigned int i=0; i < countercount; ++i)
+      c.push_back(counterrecords[(first+i) % counterrecords.size()]);
+    release();
+
+    // Times are in microseconds
+    o << "{\"traceEvents\":[";
+    bool comma = false;
+    for (unsigned int i=0; i < r.size(); ++i) {
+      if ( comma ) o << ",";
+      o << "\n{\"name\":"; writeJSONString(o,r[i].name);
+      o << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << r[i].thread
+        << ",\"ts\":" << (long long)(r[i].start*1e6)
+        << ",\"dur\":" << (long long)(r[i].duration*1e6)
+        << ",\"args\":{\"frame\":" << r[i].frame;
+      if ( r[i].allocations >= 0 ) o << ",\"allocations\":" << r[i].allocations;
+      if ( r[i].elements >= 0 ) o << ",\"elements\":" << r[i].elements;
+      o << "}}";
+      comma = true;
+    }
+    for (unsigned int i=0; i < c.size(); ++i) {
+      if ( comma ) o << ",";
+      o << "\n{\"name\":"; writeJSONString(o,c[i].name);
+      o << ",\"ph\":\"C\",\"pid\":1,\"ts\":" << (long long)(c[i].time*1e6)
+        << ",\"args\":{\"value\":" << c[i].value << "}}";
+      comma = true;
+    }
+    o << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  }
+
+} // end namespace
@@ -0,0 +1,207 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLProfile.hh
+ */
+
+#ifndef _DLFL_PROFILE_HH_
+#define _DLFL_PROFILE_HH_
+
+// Lightweight profiler for interactive use. Code marks the scopes it wants
+// timed with DLFL_PROFILE("name"). Every scope which ends leaves a record
+// (time, heap allocations made inside it, mesh elements it worked on) in a
+// ring buffer and is added to per-name totals. Frames are delimited with
+// beginFrame/endFrame, and counters are summed per frame.
+// The ring buffer can be written out in the Chrome trace event format
+// (chrome://tracing, Perfetto).
+//
+// Allocations are only counted when dlflcore is built WITH_ALLOC_COUNT (off
+// by default, see dlflcore.pro), otherwise they are reported as -1. The count
+// is process wide, so a scope also sees allocations made by other threads
+// while it runs.
+
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+namespace DLFL {
+
+  // One timed scope
+  struct DLFLProfileRecord {
+    const char * name;      // Interned scope name
+    double start;           // Seconds since the profiler was created
+    double duration;        // Seconds
+    long allocations;       // Heap allocations inside the scope, -1 if not counted
+    long elements;          // Mesh elements the scope worked on, -1 if unknown
+    unsigned int frame;     // Frame the scope ended in
+    unsigned int thread;    // Small thread number, 0 for the first thread seen
+  };
+
+  // Totals for all scopes with the same name
+  struct DLFLProfileStat {
+    const char * name;
+    unsigned int calls;
+    double total, last, max;  // Seconds
+    long allocations;         // Allocations in the last call
+    long elements;            // Elements in the last call
+  };
+
+  // Value of a counter at the end of a frame
+  struct DLFLProfileCounter {
+    const char * name;
+    double time;
+    long value;
+  };
+
+  class DLFLProfiler {
+  public :
+
+    struct NameLess {
+      bool operator()( const char * a, const char * b ) const { return strcmp(a,b) < 0; }
+    };
+
+    typedef map<const char *, DLFLProfileStat, NameLess> StatMap;
+    typedef map<const char *, long, NameLess> CounterMap;
+
+  protected :
+
+    vector<DLFLProfileRecord> records;   // Ring buffer of finished scopes
+    unsigned int recordhead;             // Next slot to write
+    unsigned int recordcount;            // Number of valid records
+
+    vector<DLFLProfileCounter> counterrecords; // Ring buffer of per-frame counter values
+    unsigned int counterhead, countercount;
+
+    StatMap stats;                       // Totals per scope name
+    CounterMap counters;                 // Counters of the frame in progress
+    CounterMap lastcounters;             // Counters of the last finished frame
+    set<string> names;                   // Storage for interned names
+
+    unsigned int frame;                  // Number of the frame in progress
+    double framestart;                   // Start of the frame in progress, -1 outside frames
+    double lastframe;                    // Duration of the last finished frame
+    double frameaverage;                 // Running average of the frame duration
+    bool enabled;
+
+    volatile int lock;                   // Spin lock, scopes may end on any thread
+
+    DLFLProfiler( );
+
+    void acquire( );
+    void release( );
+
+    // Record a finished scope. Expects the lock to be held
+    void addRecord( const char * name, double start, double duration, long allocations, long elements );
+
+  public :
+
+    // The profiler shared by the whole program
+    static DLFLProfiler& instance( );
+
+    // Seconds since the profiler was created
+    double now( ) const;
+
+    // Heap allocations made so far by the whole process, -1 if not counted
+    static long allocations( );
+
+    bool isEnabled( ) const { return enabled; }
+    void setEnabled( bool on ) { enabled = on; }
+
+    // Change the size of the ring buffer, dropping all records
+    void setCapacity( unsigned int n );
+
+    // Forget all records, totals and counters
+    void reset( );
+
+    // Persistent copy of a name which doesn't outlive the caller
+    const char * intern( const string& name );
+
+    // Record a scope timed by the caller. Name must stay valid, see intern()
+    void add( const char * name, double start, double duration, long allocations = -1, long elements = -1 );
+
+    // Add to a counter of the current frame
+    void count( const char * name, long n = 1 );
+
+    void beginFrame( );
+    void endFrame( );
+
+    unsigned int currentFrame( ) const { return frame; }
+    double lastFrameTime( ) const { return lastframe; }
+    double averageFrameTime( ) const { return frameaverage; }
+
+    // Copies, so they can be read while other threads keep recording
+    void getStats( vector<DLFLProfileStat>& s );
+    void getCounters( vector<DLFLProfileCounter>& c );   // Of the last finished frame
+    void getRecords( vector<DLFLProfileRecord>& r );     // Oldest first
+
+    // Write the ring buffer as a Chrome trace event file
+    void writeTrace( ostream& o );
+  };
+
+  // Times the enclosing scope
+  class DLFLProfileScope {
+  protected :
+    const char * name;
+    double start;
+    long allocs;
+    long elements;
+    bool active;
+
+  public :
+
+    DLFLProfileScope( const char * n, long e = -1 )
+      : name(n), start(0.0), allocs(0), elements(e), active(DLFLProfiler::instance().isEnabled()) {
+      if ( active ) { allocs = DLFLProfiler::allocations(); start = DLFLProfiler::instance().now(); }
+    }
+
+    ~DLFLProfileScope( ) {
+      if ( !active ) return;
+      DLFLProfiler& p = DLFLProfiler::instance();
+      double d = p.now() - start;
+      long a = DLFLProfiler::allocations();
+      p.add(name,start,d,(a < 0) ? -1 : a-allocs,elements);
+    }
+
+    void setElements( long e ) { elements = e; }
+  };
+
+} // end namespace
+
+#define DLFL_PROFILE_CONCAT2(a,b) a##b
+#define DLFL_PROFILE_CONCAT(a,b) DLFL_PROFILE_CONCAT2(a,b)
+
+// Time the rest of the enclosing block under the given name
+#define DLFL_PROFILE(name) DLFL::DLFLProfileScope DLFL_PROFILE_CONCAT(dlfl_profile_,__LINE__)(name)
+
+#endif /* #ifndef _DLFL_PROFILE_HH_ */
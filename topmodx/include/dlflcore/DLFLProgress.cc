@@ -0,0 +1,57 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLProgress.cc
+ */
+
+#include "DLFLProgress.hh"
+
+#include <cstddef>
+
+#if defined(__GNUC__)
+#define DLFL_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define DLFL_THREAD_LOCAL __declspec(thread)
+#else
+#define DLFL_THREAD_LOCAL
+#endif
+
+namespace DLFL {
+
+  static DLFL_THREAD_LOCAL DLFLProgress * currentprogress = NULL;
+
+  DLFLProgress * DLFLProgress::current( ) {
+    return currentprogress;
+  }
+
+  void DLFLProgress::setCurrent( DLFLProgress * p ) {
+    currentprogress = p;
+  }
+
+} // end namespace
@@ -0,0 +1,115 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLProgress.hh
+ */
+
+#ifndef _DLFL_PROGRESS_HH_
+#define _DLFL_PROGRESS_HH_
+
+// Progress reporting and cancellation for long operations. The caller
+// installs a DLFLProgress for its thread with setCurrent, the algorithms
+// announce how much work they have with begin() and call step() as they go.
+// step() returns false once cancel() was called (from any thread), and the
+// algorithm is expected to return as soon as it can. It leaves the object
+// half done, so cancellable operations should be run on a copy.
+// Without a DLFLProgress for the thread begin and step do nothing and step
+// always returns true, so the algorithms can be called as before.
+//
+// The counters are only written by the thread doing the work and may be
+// polled from any other, eg. by a timer driving a progress bar.
+
+#include <cstddef>
+
+namespace DLFL {
+
+  class DLFLProgress {
+  protected :
+
+    volatile long done;               // Steps done in the current stage
+    volatile long total;              // Steps in the current stage, 0 if unknown
+    volatile int stages;              // Number of stages begun so far
+    const char * volatile stage;      // Name of the current stage, must stay valid
+    volatile bool cancelled;
+
+  public :
+
+    DLFLProgress( )
+      : done(0), total(0), stages(0), stage(""), cancelled(false) { }
+
+    void reset( ) {
+      done = total = 0; stages = 0; stage = ""; cancelled = false;
+    }
+
+    // Ask the operation to stop
+    void cancel( ) { cancelled = true; }
+    bool isCancelled( ) const { return cancelled; }
+
+    long getDone( ) const { return done; }
+    long getTotal( ) const { return total; }
+    int getStages( ) const { return stages; }
+    const char * getStage( ) const { return stage; }
+
+    // Progress of the calling thread, NULL if there is none
+    static DLFLProgress * current( );
+    static void setCurrent( DLFLProgress * p );
+
+    // Start a new stage of the given number of steps
+    static void begin( const char * name, long steps ) {
+      DLFLProgress * p = current();
+      if ( p ) { p->stage = name; p->total = steps; p->done = 0; ++p->stages; }
+    }
+
+    // Count some steps done. Returns false if the operation should stop
+    static bool step( long n = 1 ) {
+      DLFLProgress * p = current();
+      if ( p == NULL ) return true;
+      p->done += n;
+      return !p->cancelled;
+    }
+
+    static bool wasCancelled( ) {
+      DLFLProgress * p = current();
+      return p && p->cancelled;
+    }
+  };
+
+  // Installs a DLFLProgress for the calling thread for the lifetime of the scope
+  class DLFLProgressScope {
+  protected :
+    DLFLProgress * previous;
+
+  public :
+    DLFLProgressScope( DLFLProgress * p ) : previous(DLFLProgress::current()) { DLFLProgress::setCurrent(p); }
+    ~DLFLProgressScope( ) { DLFLProgress::setCurrent(previous); }
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_PROGRESS_HH_ */
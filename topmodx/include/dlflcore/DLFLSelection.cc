@@ -0,0 +1,205 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*
+* Short description of this file
+*
+* name of .hh file containing function prototypes
+*
+*/
+
+#include "DLFLObject.hh"
+
+namespace DLFL {
+
+	// All of these go through each selected element once and use the
+	// constant time lookups of DLFLSelection, so they are linear in the
+	// size of the selection (or the mesh, for the inverse)
+
+	void DLFLObject::selectInverseVertices( ) {
+		sel_vptr_array.invert(vertex_list.begin(),vertex_list.end());
+	}
+
+	void DLFLObject::selectInverseEdges( ) {
+		sel_eptr_array.invert(edge_list.begin(),edge_list.end());
+	}
+
+	void DLFLObject::selectInverseFaces( ) {
+		sel_fptr_array.invert(face_list.begin(),face_list.end());
+	}
+
+	// Elements added while growing are not grown again, so only the
+	// elements selected on entry are visited. Vertex neighbourhoods
+	// come from the adjacency cache
+
+	void DLFLObject::growSelectedVertices( ) {
+		DLFLAdjacency& adj = adjacency();
+		uint n = sel_vptr_array.size();
+		for (uint i=0; i < n; ++i) {
+			int v = adj.indexOf(sel_vptr_array[i]);
+			if ( v < 0 ) continue;
+			for (uint k=adj.ringBegin(v); k < adj.ringEnd(v); ++k)
+				sel_vptr_array.add(adj.neighbor(k));
+		}
+	}
+
+	void DLFLObject::growSelectedEdges( ) {
+		DLFLAdjacency& adj = adjacency();
+		DLFLVertexPtr vp[2];
+		uint n = sel_eptr_array.size();
+		for (uint i=0; i < n; ++i) {
+			sel_eptr_array[i]->getVertexPointers(vp[0],vp[1]);
+			for (int j=0; j < 2; ++j) {
+				int v = adj.indexOf(vp[j]);
+				if ( v < 0 ) continue;
+				for (uint k=adj.ringBegin(v); k < adj.ringEnd(v); ++k)
+					sel_eptr_array.add(adj.edge(k));
+			}
+		}
+	}
+
+	void DLFLObject::growSelectedFaces( ) {
+		DLFLEdgePtrArray edges;
+		DLFLFacePtr fp1, fp2;
+		uint n = sel_fptr_array.size();
+		for (uint i=0; i < n; ++i) {
+			sel_fptr_array[i]->getEdges(edges);
+			for (uint j=0; j < edges.size(); ++j) {
+				edges[j]->getFacePointers(fp1,fp2);
+				sel_fptr_array.add(fp1); sel_fptr_array.add(fp2);
+			}
+		}
+	}
+
+	// Shrinking first decides which elements to drop using the selection as it
+	// was on entry, then removes them
+
+	void DLFLObject::shrinkSelectedVertices( ) {
+		DLFLAdjacency& adj = adjacency();
+		DLFLVertexPtrArray deselect;
+		DLFLVertexPtr vp;
+		for (uint i=0; i < sel_vptr_array.size(); ++i) {
+			vp = sel_vptr_array[i];
+			int v = adj.indexOf(vp);
+			if ( v < 0 ) continue;
+			for (uint k=adj.ringBegin(v); k < adj.ringEnd(v); ++k) {
+				if ( adj.neighbor(k) && !sel_vptr_array.contains(adj.neighbor(k)) ) {
+					deselect.push_back(vp); break;
+				}
+			}
+		}
+		for (uint i=0; i < deselect.size(); ++i) sel_vptr_array.remove(deselect[i]);
+	}
+
+	void DLFLObject::shrinkSelectedEdges( ) {
+		DLFLAdjacency& adj = adjacency();
+		DLFLEdgePtrArray deselect;
+		DLFLEdgePtr ep;
+		DLFLVertexPtr vp[2];
+		for (uint i=0; i < sel_eptr_array.size(); ++i) {
+			ep = sel_eptr_array[i];
+			ep->getVertexPointers(vp[0],vp[1]);
+			bool inside = true;
+			for (int j=0; j < 2 && inside; ++j) {
+				int v = adj.indexOf(vp[j]);
+				if ( v < 0 ) continue;
+				for (uint k=adj.ringBegin(v); k < adj.ringEnd(v); ++k)
+					if ( !sel_eptr_array.contains(adj.edge(k)) ) { inside = false; break; }
+			}
+			if ( !inside ) deselect.push_back(ep);
+		}
+		for (uint i=0; i < deselect.size(); ++i) sel_eptr_array.remove(deselect[i]);
+	}
+
+	void DLFLObject::shrinkSelectedFaces( ) {
+		DLFLEdgePtrArray edges;
+		DLFLFacePtrArray deselect;
+		DLFLFacePtr fp, fp1, fp2;
+		for (uint i=0; i < sel_fptr_array.size(); ++i) {
+			fp = sel_fptr_array[i];
+			fp->getEdges(edges);
+			for (uint j=0; j < edges.size(); ++j) {
+				edges[j]->getFacePointers(fp1,fp2);
+				if ( !sel_fptr_array.contains(fp1) || !sel_fptr_array.contains(fp2) ) {
+					deselect.push_back(fp); break;
+				}
+			}
+		}
+		for (uint i=0; i < deselect.size(); ++i) sel_fptr_array.remove(deselect[i]);
+	}
+
+	void DLFLObject::selectEdgesFromFaces( ) {
+		DLFLEdgePtrArray edges;
+		for (uint i=0; i < sel_fptr_array.size(); ++i) {
+			sel_fptr_array[i]->getEdges(edges);
+			for (uint j=0; j < edges.size(); ++j) sel_eptr_array.add(edges[j]);
+		}
+	}
+
+	void DLFLObject::selectEdgesFromVertices( ) {
+		DLFLEdgePtrArray edges;
+		for (uint i=0; i < sel_vptr_array.size(); ++i) {
+			sel_vptr_array[i]->getEdges(edges);
+			for (uint j=0; j < edges.size(); ++j) sel_eptr_array.add(edges[j]);
+		}
+	}
+
+	void DLFLObject::selectFacesFromEdges( ) {
+		DLFLFacePtr fp1, fp2;
+		for (uint i=0; i < sel_eptr_array.size(); ++i) {
+			sel_eptr_array[i]->getFacePointers(fp1,fp2);
+			sel_fptr_array.add(fp1); sel_fptr_array.add(fp2);
+		}
+	}
+
+	void DLFLObject::selectFacesFromVertices( ) {
+		DLFLFacePtrArray faces;
+		for (uint i=0; i < sel_vptr_array.size(); ++i) {
+			sel_vptr_array[i]->getFaces(faces);
+			for (uint j=0; j < faces.size(); ++j) sel_fptr_array.add(faces[j]);
+		}
+	}
+
+	void DLFLObject::selectVerticesFromFaces( ) {
+		for (uint i=0; i < sel_fptr_array.size(); ++i) {
+			DLFLFaceVertexPtr head = sel_fptr_array[i]->firstVertex(), fvp = head;
+			if ( !head ) continue;
+			do {
+				sel_vptr_array.add(fvp->getVertexPtr());
+				fvp = fvp->next();
+			} while ( fvp != head );
+		}
+	}
+
+	void DLFLObject::selectVerticesFromEdges( ) {
+		DLFLVertexPtr vp1, vp2;
+		for (uint i=0; i < sel_eptr_array.size(); ++i) {
+			sel_eptr_array[i]->getVertexPointers(vp1,vp2);
+			sel_vptr_array.add(vp1); sel_vptr_array.add(vp2);
+		}
+	}
+
+} // end namespace
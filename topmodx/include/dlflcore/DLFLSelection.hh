@@ -0,0 +1,194 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLSelection.hh
+ */
+
+#ifndef _DLFL_SELECTION_HH_
+#define _DLFL_SELECTION_HH_
+
+// Selection set for mesh elements. Keeps the elements in the order they were
+// selected (so index based access works as with a plain array) plus a hash
+// index from element to position, giving constant time add, remove and test.
+// Removal leaves a hole which is squeezed out the next time the array is read,
+// so removing many elements in a row stays linear overall.
+
+#include "DLFLCommon.hh"
+
+namespace DLFL {
+
+  // Hash for element pointers. The low bits are always zero because of alignment
+  struct PtrHash {
+    size_t operator()( const void * p ) const {
+      size_t h = (size_t)p;
+      return h ^ (h >> 4) ^ (h >> 16);
+    }
+  };
+
+  template <class T>
+  class DLFLSelection {
+  public :
+
+    typedef typename vector<T>::const_iterator const_iterator;
+    typedef const_iterator iterator; // Elements can't be changed through iterators
+
+  protected :
+
+    typedef __gnu_cxx::hash_map<T, uint, PtrHash> IndexMap;
+
+    mutable vector<T> items;           // Selected elements, NULL where an element was removed
+    mutable IndexMap index;            // Element -> position in items
+    mutable uint numremoved;           // Number of holes in items
+
+    // Squeeze out the holes left by remove()
+    void compact( ) const {
+      if ( numremoved == 0 ) return;
+      uint j = 0;
+      for (uint i=0; i < items.size(); ++i)
+        if ( items[i] ) {
+          if ( i != j ) { items[j] = items[i]; index[items[j]] = j; }
+          ++j;
+        }
+      items.resize(j);
+      numremoved = 0;
+    }
+
+  public :
+
+    DLFLSelection( ) : items(), index(), numremoved(0) { }
+
+    DLFLSelection( const DLFLSelection& sel )
+      : items(sel.array()), index(), numremoved(0) {
+      for (uint i=0; i < items.size(); ++i) index[items[i]] = i;
+    }
+
+    DLFLSelection& operator = ( const DLFLSelection& sel ) {
+      if ( this != &sel ) assign(sel.begin(),sel.end());
+      return (*this);
+    }
+
+    // Replace the selection with the contents of an array
+    DLFLSelection& operator = ( const vector<T>& array ) {
+      assign(array.begin(),array.end());
+      return (*this);
+    }
+
+    ~DLFLSelection( ) { }
+
+    // Selected elements in selection order
+    const vector<T>& array( ) const { compact(); return items; }
+    operator const vector<T>& ( ) const { return array(); }
+
+    uint size( ) const { return items.size() - numremoved; }
+    bool empty( ) const { return size() == 0; }
+
+    T operator [] ( uint i ) const { compact(); return items[i]; }
+    const_iterator begin( ) const { compact(); return items.begin(); }
+    const_iterator end( ) const { compact(); return items.end(); }
+
+    bool contains( T p ) const {
+      return ( p != NULL && index.find(p) != index.end() );
+    }
+
+    // Add an element at the end. NULL and already selected elements are ignored.
+    // Returns true if the element was added
+    bool add( T p ) {
+      if ( p == NULL || contains(p) ) return false;
+      index[p] = items.size();
+      items.push_back(p);
+      return true;
+    }
+
+    void push_back( T p ) { add(p); }
+
+    // Remove an element. Returns true if it was selected
+    bool remove( T p ) {
+      if ( p == NULL ) return false;
+      typename IndexMap::iterator it = index.find(p);
+      if ( it == index.end() ) return false;
+      items[it->second] = NULL;
+      index.erase(it);
+      ++numremoved;
+      return true;
+    }
+
+    // Toggle the selection state of an element
+    void toggle( T p ) {
+      if ( !remove(p) ) add(p);
+    }
+
+    // Put an element at the given position, replacing what was there.
+    // If the position is past the end the element is added at the end.
+    // Does nothing if the element is already selected
+    void set( uint i, T p ) {
+      if ( p == NULL || contains(p) ) return;
+      compact();
+      if ( i < items.size() ) {
+        index.erase(items[i]);
+        items[i] = p; index[p] = i;
+      } else add(p);
+    }
+
+    void clear( ) {
+      items.clear(); index.clear(); numremoved = 0;
+    }
+
+    void reserve( uint n ) {
+      items.reserve(n); index.resize(n);
+    }
+
+    // Replace the selection with the elements in [first,last)
+    template <class InputIterator>
+    void assign( InputIterator first, InputIterator last ) {
+      clear();
+      while ( first != last ) { add(*first); ++first; }
+    }
+
+    // Replace the selection with the elements in [first,last) which are
+    // not currently selected, keeping their order in the range
+    template <class InputIterator>
+    void invert( InputIterator first, InputIterator last ) {
+      vector<T> inverse;
+      inverse.reserve(size());
+      while ( first != last ) {
+        if ( !contains(*first) ) inverse.push_back(*first);
+        ++first;
+      }
+      assign(inverse.begin(),inverse.end());
+    }
+  };
+
+  typedef DLFLSelection<DLFLVertexPtr> DLFLVertexSelection;
+  typedef DLFLSelection<DLFLEdgePtr> DLFLEdgeSelection;
+  typedef DLFLSelection<DLFLFacePtr> DLFLFaceSelection;
+  typedef DLFLSelection<DLFLFaceVertexPtr> DLFLFaceVertexSelection;
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_SELECTION_HH_ */
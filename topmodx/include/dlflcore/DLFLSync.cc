@@ -0,0 +1,533 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/**
+ * \file DLFLSync.cc
+ */
+
+#include "DLFLSync.hh"
+#include "DLFLObject.hh"
+#include "DLFLProfile.hh"
+
+#include <cstring>
+#include <set>
+#include <algorithm>
+
+namespace DLFL {
+
+  static inline bool sameCoords( const Vector3d& a, const Vector3d& b ) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+  }
+
+  //--- Encoding ---//
+
+  // 7 bits per byte, high bit set on all but the last byte
+  static void putVarint( string& s, unsigned long long n ) {
+    while ( n >= 0x80 ) {
+      s += (char)((n & 0x7f) | 0x80); n >>= 7;
+    }
+    s += (char)n;
+  }
+
+  // Keys as differences to the previous key, zigzag coded so small negative
+  // differences stay small. Elements made one after the other by the same peer
+  // have keys which differ by 1
+  static void putKey( string& s, DLFLSyncKey key, DLFLSyncKey& prev ) {
+    long long d = (long long)(key - prev);
+    putVarint(s,((unsigned long long)d << 1) ^ (unsigned long long)(d >> 63));
+    prev = key;
+  }
+
+  static void putKeys( string& s, const vector<DLFLSyncKey>& keys ) {
+    DLFLSyncKey prev = 0;
+    putVarint(s,keys.size());
+    for (uint i=0; i < keys.size(); ++i) putKey(s,keys[i],prev);
+  }
+
+  // Doubles as their 8 bytes, little endian
+  static void putCoords( string& s, const Vector3dArray& coords ) {
+    for (uint i=0; i < coords.size(); ++i)
+      for (int j=0; j < 3; ++j) {
+        double x = coords[i][j];
+        unsigned long long bits;
+        memcpy(&bits,&x,8);
+        for (int b=0; b < 8; ++b) s += (char)((bits >> (8*b)) & 0xff);
+      }
+  }
+
+  class DLFLSyncReader {
+  public :
+    const unsigned char * p, * end;
+    bool ok;
+
+    DLFLSyncReader( const char * data, size_t size )
+      : p((const unsigned char *)data), end((const unsigned char *)data + size), ok(true) { };
+
+    unsigned long long varint( ) {
+      unsigned long long n = 0;
+      for (int shift=0; ok; shift += 7) {
+        if ( p == end || shift > 63 ) { ok = false; break; }
+        unsigned char c = *p++;
+        n |= (unsigned long long)(c & 0x7f) << shift;
+        if ( !(c & 0x80) ) break;
+      }
+      return n;
+    }
+
+    // A count of items which take at least minsize bytes each
+    size_t count( size_t minsize ) {
+      unsigned long long n = varint();
+      if ( ok && n > (unsigned long long)(end - p) / minsize ) ok = false;
+      return ok ? (size_t)n : 0;
+    }
+
+    DLFLSyncKey key( DLFLSyncKey& prev ) {
+      unsigned long long z = varint();
+      long long d = (long long)(z >> 1) ^ -(long long)(z & 1);
+      prev += (DLFLSyncKey)d;
+      return prev;
+    }
+
+    void keys( vector<DLFLSyncKey>& k ) {
+      DLFLSyncKey prev = 0;
+      k.resize(count(1));
+      for (uint i=0; i < k.size() && ok; ++i) k[i] = key(prev);
+    }
+
+    void coords( Vector3dArray& c, size_t n ) {
+      if ( !ok || n > (size_t)(end - p) / 24 ) { ok = false; return; }
+      c.resize(n);
+      for (size_t i=0; i < n; ++i)
+        for (int j=0; j < 3; ++j) {
+          unsigned long long bits = 0;
+          for (int b=0; b < 8; ++b) bits |= (unsigned long long)(*p++) << (8*b);
+          double x;
+          memcpy(&x,&bits,8);
+          c[i][j] = x;
+        }
+    }
+  };
+
+  void DLFLSyncDelta::clear( ) {
+    removedFaces.clear(); removedVertices.clear();
+    addedVertices.clear(); addedCoords.clear();
+    movedVertices.clear(); movedCoords.clear();
+    faces.clear(); faceSizes.clear(); faceVertices.clear();
+  }
+
+  bool DLFLSyncDelta::empty( ) const {
+    return !changesTopology() && movedVertices.empty();
+  }
+
+  void DLFLSyncDelta::encode( string& s ) const {
+    putKeys(s,removedFaces);
+    putKeys(s,removedVertices);
+    putKeys(s,addedVertices);
+    putCoords(s,addedCoords);
+    putKeys(s,movedVertices);
+    putCoords(s,movedCoords);
+    putKeys(s,faces);
+    DLFLSyncKey prev = 0;
+    for (uint i=0; i < faces.size(); ++i) putVarint(s,faceSizes[i]);
+    for (uint i=0; i < faceVertices.size(); ++i) putKey(s,faceVertices[i],prev);
+  }
+
+  bool DLFLSyncDelta::decode( const char * data, size_t size ) {
+    clear();
+    DLFLSyncReader r(data,size);
+    r.keys(removedFaces);
+    r.keys(removedVertices);
+    r.keys(addedVertices);
+    r.coords(addedCoords,addedVertices.size());
+    r.keys(movedVertices);
+    r.coords(movedCoords,movedVertices.size());
+    r.keys(faces);
+    faceSizes.resize(faces.size());
+    size_t total = 0;
+    for (uint i=0; i < faces.size() && r.ok; ++i) {
+      faceSizes[i] = r.varint();
+      total += faceSizes[i];
+      if ( total > size ) r.ok = false;
+    }
+    if ( r.ok ) {
+      DLFLSyncKey prev = 0;
+      faceVertices.resize(total);
+      for (size_t i=0; i < total && r.ok; ++i) faceVertices[i] = r.key(prev);
+    }
+    if ( !r.ok || r.p != r.end ) { clear(); return false; }
+    return true;
+  }
+
+  //--- Synchronized state ---//
+
+  void DLFLSync::clear( ) {
+    object = NULL; changes = topology = 0;
+    vkeys.clear(); vcoords.clear(); vlocal.clear();
+    fkeys.clear(); fverts.clear(); flocal.clear();
+    vptrs.clear(); fptrs.clear(); vptrstamp = 0;
+  }
+
+  void DLFLSync::stamp( DLFLObjectPtr obj ) {
+    object = obj;
+    changes = obj->changeCount(); topology = obj->topologyCount();
+  }
+
+  void DLFLSync::attach( DLFLObjectPtr obj ) {
+    clear();
+    DLFLSyncDelta d;
+    diffAll(obj,d);
+    stamp(obj);
+  }
+
+  void DLFLSync::state( DLFLSyncDelta& d ) const {
+    d.clear();
+    for (uint i=0; i < vkeys.size(); ++i)
+      if ( vkeys[i] ) {
+        d.addedVertices.push_back(vkeys[i]); d.addedCoords.push_back(vcoords[i]);
+      }
+    for (uint i=0; i < fkeys.size(); ++i)
+      if ( fkeys[i] ) {
+        d.faces.push_back(fkeys[i]); d.faceSizes.push_back(fverts[i].size());
+        for (uint j=0; j < fverts[i].size(); ++j) d.faceVertices.push_back(vkeys[fverts[i][j]]);
+      }
+  }
+
+  bool DLFLSync::diff( DLFLObjectPtr obj, DLFLSyncDelta& d ) {
+    d.clear();
+    if ( obj == object && obj->changeCount() == changes && obj->topologyCount() == topology ) return false;
+    DLFLProfileScope profile("syncDiff",obj->num_vertices());
+    if ( obj != object || obj->topologyCount() != topology || !diffCoords(obj,d) ) diffAll(obj,d);
+    stamp(obj);
+    return !d.empty();
+  }
+
+  bool DLFLSync::diffCoords( DLFLObjectPtr obj, DLFLSyncDelta& d ) {
+    // Only if the object still has the same vertices, the count
+    // can stay the same when an operation doesn't add or remove anything
+    if ( obj->num_vertices() != vlocal.size() ) return false;
+    DLFLVertexPtrList::iterator first = obj->beginVertex(), last = obj->endVertex();
+    for (; first != last; ++first) {
+      uint id = (*first)->getID();
+      if ( id >= vkeys.size() || !vkeys[id] ) return false;
+    }
+    for (first = obj->beginVertex(); first != last; ++first) {
+      uint id = (*first)->getID();
+      const Vector3d& c = (*first)->coords;
+      if ( !sameCoords(c,vcoords[id]) ) {
+        d.movedVertices.push_back(vkeys[id]); d.movedCoords.push_back(c);
+        vcoords[id] = c;
+      }
+    }
+    return true;
+  }
+
+  void DLFLSync::diffAll( DLFLObjectPtr obj, DLFLSyncDelta& d ) {
+    // Vertices which are new, moved or gone
+    vector<char> seen(vkeys.size(),0);
+    DLFLVertexPtrList::iterator vf = obj->beginVertex(), vl = obj->endVertex();
+    for (; vf != vl; ++vf) {
+      uint id = (*vf)->getID();
+      if ( id >= vkeys.size() ) {
+        vkeys.resize(id+1,0); vcoords.resize(id+1); seen.resize(id+1,0);
+      }
+      const Vector3d& c = (*vf)->coords;
+      if ( !vkeys[id] ) {
+        DLFLSyncKey key = newKey();
+        vkeys[id] = key; vlocal[key] = id; vcoords[id] = c;
+        d.addedVertices.push_back(key); d.addedCoords.push_back(c);
+      } else if ( !sameCoords(c,vcoords[id]) ) {
+        vcoords[id] = c;
+        d.movedVertices.push_back(vkeys[id]); d.movedCoords.push_back(c);
+      }
+      seen[id] = 1;
+    }
+    for (uint id=0; id < vkeys.size(); ++id)
+      if ( vkeys[id] && !seen[id] ) {
+        d.removedVertices.push_back(vkeys[id]);
+        vlocal.erase(vkeys[id]); vkeys[id] = 0;
+      }
+
+    // Faces which are new, have other corners or are gone
+    vector<char> fseen(fkeys.size(),0);
+    vector<uint> ids;
+    DLFLFacePtrList::iterator ff = obj->beginFace(), fl = obj->endFace();
+    for (; ff != fl; ++ff) {
+      uint id = (*ff)->getID();
+      if ( id >= fkeys.size() ) {
+        fkeys.resize(id+1,0); fverts.resize(id+1); fseen.resize(id+1,0);
+      }
+      ids.clear();
+      DLFLFaceVertexPtr head = (*ff)->front(), current = head;
+      if ( head ) {
+        do {
+          ids.push_back(current->vertex->getID());
+          current = current->next();
+        } while ( current != head );
+      }
+      fseen[id] = 1;
+      if ( !fkeys[id] ) {
+        DLFLSyncKey key = newKey();
+        fkeys[id] = key; flocal[key] = id;
+      } else if ( fverts[id] == ids ) continue;
+      fverts[id] = ids;
+      d.faces.push_back(fkeys[id]); d.faceSizes.push_back(ids.size());
+      for (uint j=0; j < ids.size(); ++j) d.faceVertices.push_back(vkeys[ids[j]]);
+    }
+    for (uint id=0; id < fkeys.size(); ++id)
+      if ( fkeys[id] && !fseen[id] ) {
+        d.removedFaces.push_back(fkeys[id]);
+        flocal.erase(fkeys[id]); fkeys[id] = 0; fverts[id].clear();
+      }
+  }
+
+  void DLFLSync::pointers( DLFLObjectPtr obj ) {
+    if ( obj == object && vptrstamp == obj->topologyCount() &&
+         vptrs.size() == vkeys.size() && fptrs.size() == fkeys.size() ) return;
+    vptrs.assign(vkeys.size(),(DLFLVertexPtr)NULL);
+    fptrs.assign(fkeys.size(),(DLFLFacePtr)NULL);
+    DLFLVertexPtrList::iterator vf = obj->beginVertex(), vl = obj->endVertex();
+    for (; vf != vl; ++vf)
+      if ( (*vf)->getID() < vptrs.size() ) vptrs[(*vf)->getID()] = *vf;
+    DLFLFacePtrList::iterator ff = obj->beginFace(), fl = obj->endFace();
+    for (; ff != fl; ++ff)
+      if ( (*ff)->getID() < fptrs.size() ) fptrs[(*ff)->getID()] = *ff;
+    object = obj;
+    vptrstamp = obj->topologyCount();
+  }
+
+  void DLFLSync::dropFace( uint id, DLFLFacePtrArray& dropped ) {
+    if ( !fkeys[id] ) return;
+    flocal.erase(fkeys[id]);
+    fkeys[id] = 0; fverts[id].clear();
+    if ( fptrs[id] ) dropped.push_back(fptrs[id]);
+    fptrs[id] = NULL;
+  }
+
+  DLFLSync::Result DLFLSync::apply( DLFLObjectPtr obj, const DLFLSyncDelta& d, DLFLVertexPtrArray& moved ) {
+    moved.clear();
+    pointers(obj);
+
+    if ( !d.changesTopology() ) {
+      // Vertices are moved in place, looked up by ID
+      for (uint i=0; i < d.movedVertices.size(); ++i) {
+        map<DLFLSyncKey,uint>::iterator it = vlocal.find(d.movedVertices[i]);
+        if ( it == vlocal.end() || vptrs[it->second] == NULL ) continue;
+        vptrs[it->second]->coords = d.movedCoords[i];
+        vcoords[it->second] = d.movedCoords[i];
+        moved.push_back(vptrs[it->second]);
+      }
+      if ( !moved.empty() ) obj->touch();
+      stamp(obj);
+      return moved.empty() ? Unchanged : Moved;
+    }
+
+    // Only the faces in the delta are changed in the object, the others keep
+    // their IDs, materials and texture coordinates. Faces which are gone and
+    // faces which get other corners lose their corners and the edges along
+    // them, the corners on the other side of those edges are paired up again
+    // with the new corners at the end
+    DLFLProfileScope profile("syncApply");
+    map<DLFLSyncKey,uint>::iterator it;
+    DLFLFacePtrArray dropped, rewired;
+    vector< vector<uint> > rewiredverts;
+    DLFLVertexPtrArray loose;              // Vertices which may have no faces left
+
+    for (uint i=0; i < d.removedFaces.size(); ++i) {
+      it = flocal.find(d.removedFaces[i]);
+      if ( it != flocal.end() ) dropFace(it->second,dropped);
+    }
+    // A face still using a vertex which is gone (changed here while the other
+    // peer removed the vertex) is dropped
+    for (uint i=0; i < d.removedVertices.size(); ++i) {
+      it = vlocal.find(d.removedVertices[i]);
+      if ( it == vlocal.end() ) continue;
+      uint id = it->second;
+      vkeys[id] = 0;
+      vlocal.erase(it);
+      DLFLVertexPtr vp = vptrs[id];
+      if ( vp == NULL ) continue;
+      DLFLFaceVertexPtrList::const_iterator cf = vp->beginFaceVertex(), cl = vp->endFaceVertex();
+      for (; cf != cl; ++cf) {
+        DLFLFacePtr fp = (*cf)->getFacePtr();
+        if ( fp && fp->getID() < fkeys.size() && fptrs[fp->getID()] == fp ) dropFace(fp->getID(),dropped);
+      }
+      loose.push_back(vp);
+    }
+    for (uint i=0; i < d.addedVertices.size(); ++i) {
+      it = vlocal.find(d.addedVertices[i]);
+      if ( it != vlocal.end() ) {
+        vcoords[it->second] = d.addedCoords[i];
+        if ( vptrs[it->second] ) vptrs[it->second]->coords = d.addedCoords[i];
+        continue;
+      }
+      DLFLVertexPtr vp = new DLFLVertex(d.addedCoords[i]);
+      obj->addVertexPtr(vp);
+      uint id = vp->getID();
+      if ( id >= vkeys.size() ) {
+        vkeys.resize(id+1,0); vcoords.resize(id+1); vptrs.resize(id+1,(DLFLVertexPtr)NULL);
+      }
+      vkeys[id] = d.addedVertices[i]; vcoords[id] = d.addedCoords[i]; vptrs[id] = vp;
+      vlocal[d.addedVertices[i]] = id;
+      loose.push_back(vp);
+    }
+    for (uint i=0; i < d.movedVertices.size(); ++i) {
+      it = vlocal.find(d.movedVertices[i]);
+      if ( it == vlocal.end() ) continue;
+      vcoords[it->second] = d.movedCoords[i];
+      if ( vptrs[it->second] ) vptrs[it->second]->coords = d.movedCoords[i];
+    }
+
+    // Faces which are new or have other corners. A face which uses a vertex
+    // this peer doesn't have is dropped, like above
+    DLFLFaceVertexPtrArray corners;        // Corners which need an edge
+    vector<uint> ids;
+    uint k = 0;
+    for (uint i=0; i < d.faces.size(); ++i) {
+      bool ok = true;
+      ids.resize(d.faceSizes[i]);
+      for (uint j=0; j < d.faceSizes[i]; ++j, ++k) {
+        it = vlocal.find(d.faceVertices[k]);
+        if ( it == vlocal.end() || vptrs[it->second] == NULL ) ok = false;
+        else ids[j] = it->second;
+      }
+      it = flocal.find(d.faces[i]);
+      if ( !ok || ids.empty() ) {
+        if ( it != flocal.end() ) dropFace(it->second,dropped);
+      } else if ( it != flocal.end() ) {
+        fverts[it->second] = ids;
+        if ( fptrs[it->second] ) {
+          rewired.push_back(fptrs[it->second]);
+          rewiredverts.push_back(ids);
+        }
+      } else {
+        DLFLFacePtr fp = new DLFLFace;
+        for (uint j=0; j < ids.size(); ++j) {
+          DLFLFaceVertexPtr fvp = new DLFLFaceVertex;
+          fvp->vertex = vptrs[ids[j]];
+          fp->addVertexPtr(fvp);
+          corners.push_back(fvp);
+        }
+        fp->updateFacePointers();
+        fp->addFaceVerticesToVertices();
+        obj->addFacePtr(fp);
+        uint id = fp->getID();
+        if ( id >= fkeys.size() ) {
+          fkeys.resize(id+1,0); fverts.resize(id+1); fptrs.resize(id+1,(DLFLFacePtr)NULL);
+        }
+        fkeys[id] = d.faces[i]; fverts[id] = ids; fptrs[id] = fp;
+        flocal[d.faces[i]] = id;
+      }
+    }
+
+    // The corners of the dropped and rewired faces are taken off their
+    // vertices, and their edges are thrown away
+    set<DLFLFacePtr> gone(dropped.begin(),dropped.end());
+    gone.insert(rewired.begin(),rewired.end());
+    DLFLEdgePtrArray edges;
+    for (set<DLFLFacePtr>::iterator gf = gone.begin(); gf != gone.end(); ++gf) {
+      DLFLFaceVertexPtr head = (*gf)->front(), current = head;
+      if ( head == NULL ) continue;
+      do {
+        current->deleteSelfFromVertex();
+        loose.push_back(current->vertex);
+        if ( current->getEdgePtr() ) edges.push_back(current->getEdgePtr());
+        current = current->next();
+      } while ( current != head );
+    }
+    sort(edges.begin(),edges.end());
+    edges.erase(unique(edges.begin(),edges.end()),edges.end());
+
+    obj->beginBatch();
+    for (uint i=0; i < edges.size(); ++i) {
+      DLFLEdgePtr ep = edges[i];
+      DLFLFaceVertexPtr sides[2] = { ep->getFaceVertexPtr1(), ep->getFaceVertexPtr2() };
+      for (int s=0; s < 2; ++s) {
+        DLFLFaceVertexPtr fvp = sides[s];
+        if ( fvp == NULL || fvp->getFacePtr() == NULL || gone.count(fvp->getFacePtr()) ) continue;
+        // The corner of a side is the one at the start of the edge in its face
+        if ( fvp->getEdgePtr() != ep ) fvp = fvp->prev();
+        if ( fvp && fvp->getEdgePtr() == ep ) {
+          fvp->setEdgePtr(NULL);
+          corners.push_back(fvp);
+        }
+      }
+      obj->eraseEdge(ep);
+    }
+
+    // Rewired faces stay the same faces, with new corners. Texture coordinates
+    // and colors of the corners at vertices the face keeps are kept
+    for (uint i=0; i < rewired.size(); ++i) {
+      DLFLFacePtr fp = rewired[i];
+      DLFLFaceVertexPtrArray old;
+      fp->getCorners(old);
+      DLFLFaceVertexPtrArray fresh;
+      for (uint j=0; j < rewiredverts[i].size(); ++j) {
+        DLFLFaceVertexPtr fvp = new DLFLFaceVertex;
+        fvp->vertex = vptrs[rewiredverts[i][j]];
+        for (uint c=0; c < old.size(); ++c)
+          if ( old[c]->vertex == fvp->vertex ) {
+            fvp->texcoord = old[c]->texcoord; fvp->color = old[c]->color;
+            break;
+          }
+        fresh.push_back(fvp);
+      }
+      fp->destroy();
+      for (uint j=0; j < fresh.size(); ++j) fp->addVertexPtr(fresh[j]);
+      fp->updateFacePointers();
+      fp->addFaceVerticesToVertices();
+      corners.insert(corners.end(),fresh.begin(),fresh.end());
+    }
+    if ( !rewired.empty() ) obj->touchTopology();
+
+    for (uint i=0; i < dropped.size(); ++i) obj->eraseFace(dropped[i]);
+
+    // Vertices no face uses anymore are left out
+    sort(loose.begin(),loose.end());
+    loose.erase(unique(loose.begin(),loose.end()),loose.end());
+    for (uint i=0; i < loose.size(); ++i) {
+      DLFLVertexPtr vp = loose[i];
+      if ( vp->valence() > 0 ) continue;
+      uint id = vp->getID();
+      if ( id < vkeys.size() && vptrs[id] == vp ) {
+        if ( vkeys[id] ) vlocal.erase(vkeys[id]);
+        vkeys[id] = 0; vptrs[id] = NULL;
+      }
+      obj->eraseVertex(vp);
+    }
+    obj->endBatch();
+
+    obj->rebuildEdges(corners);
+    obj->touch();
+    stamp(obj);
+    vptrstamp = obj->topologyCount();
+    profile.setElements(dropped.size()+rewired.size()+d.faces.size());
+    return Rebuilt;
+  }
+
+} // end namespace
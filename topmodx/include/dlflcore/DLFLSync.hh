@@ -0,0 +1,157 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/**
+ * \file DLFLSync.hh
+ */
+
+#ifndef _DLFL_SYNC_HH_
+#define _DLFL_SYNC_HH_
+
+// Keeps copies of an object in several TopMod instances in step by passing
+// around what changed instead of the whole mesh.
+//
+// A DLFLSync remembers the object as it was last sent or received: the
+// coordinates of every vertex and the vertices of every face, by ID. diff()
+// compares the object against that and returns the difference as a delta,
+// which only looks at the vertex coordinates if the topology count of the
+// object hasn't moved (see DLFLObject::topologyCount()). All edits made since
+// the last diff() go into one delta, so a vertex dragged across many frames is
+// sent once with its last position.
+//
+// IDs are local to an object, so elements are known to the peers by a key:
+// the number of the peer which made the element in the high 32 bits and a
+// serial number of that peer in the low 32 bits. apply() takes a delta made
+// by another peer and changes only the elements named in it, the rest of the
+// object keeps its IDs, materials and texture coordinates. A face which gets
+// other corners keeps its material and the texture coordinates at the vertices
+// it keeps. Materials and texture coordinates are not sent, faces made by
+// another peer get the default material.
+
+#include "DLFLCommon.hh"
+
+#include <map>
+#include <string>
+
+namespace DLFL {
+
+  typedef unsigned long long DLFLSyncKey;
+
+  // What changed between two states of an object
+  struct DLFLSyncDelta {
+    vector<DLFLSyncKey> removedFaces;
+    vector<DLFLSyncKey> removedVertices;
+    vector<DLFLSyncKey> addedVertices;
+    Vector3dArray addedCoords;
+    vector<DLFLSyncKey> movedVertices;
+    Vector3dArray movedCoords;
+    // Faces which are new or whose corners changed, with the keys of their vertices in order
+    vector<DLFLSyncKey> faces;
+    vector<uint> faceSizes;
+    vector<DLFLSyncKey> faceVertices;
+
+    void clear( );
+    bool empty( ) const;
+
+    // Everything but moving vertices
+    bool changesTopology( ) const {
+      return !( removedFaces.empty() && removedVertices.empty() && addedVertices.empty() && faces.empty() );
+    };
+
+    // Compact binary form. Keys are delta coded variable length integers,
+    // coordinates are written as they are. decode() returns false if the data is broken
+    void encode( string& s ) const;
+    bool decode( const char * data, size_t size );
+  };
+
+  class DLFLSync {
+  public :
+
+    enum Result { Unchanged=0, Moved=1, Rebuilt=2 };
+
+    DLFLSync( )
+      : object(NULL), changes(0), topology(0), peerid(1), serial(0), vptrstamp(0) { };
+
+    // Number of this peer, must be set before any keys are handed out
+    uint peer( ) const { return peerid; };
+    void setPeer( uint p ) { peerid = p; };
+
+    // Forget the remembered state
+    void clear( );
+
+    // Take the object as it is as the synchronized state. Nothing is reported
+    // for it by diff(), peers get it from state()
+    void attach( DLFLObjectPtr obj );
+
+    // The whole remembered state as a delta, for a peer which joins
+    void state( DLFLSyncDelta& d ) const;
+
+    // Changes of the object since the last call to diff() or apply().
+    // Returns false if there are none
+    bool diff( DLFLObjectPtr obj, DLFLSyncDelta& d );
+
+    // Apply a delta from another peer to the object, which must be the object
+    // of the last call to attach(), diff() or apply() (or an empty object
+    // after clear()). Changes to the object which haven't been taken by diff()
+    // aren't known to the state, so diff() has to be called first. The
+    // vertices which were moved are returned for updating the normals if
+    // nothing else changed
+    Result apply( DLFLObjectPtr obj, const DLFLSyncDelta& d, DLFLVertexPtrArray& moved );
+
+  protected :
+
+    DLFLObjectPtr object;                  // Object the state belongs to
+    uint changes, topology;                // Change and topology counts of object at the last diff/apply
+    uint peerid;
+    uint serial;                           // Next serial number for keys of this peer
+
+    // Remembered state, by the ID of the element in object. Key 0 is no element
+    vector<DLFLSyncKey> vkeys;
+    Vector3dArray vcoords;
+    map<DLFLSyncKey,uint> vlocal;          // Vertex key -> ID
+    vector<DLFLSyncKey> fkeys;
+    vector< vector<uint> > fverts;         // Vertex IDs of each face
+    map<DLFLSyncKey,uint> flocal;          // Face key -> ID
+
+    DLFLVertexPtrArray vptrs;              // Vertex ID -> vertex, for applying deltas in place
+    DLFLFacePtrArray fptrs;                // Face ID -> face
+    uint vptrstamp;                        // Topology count of object when they were made
+
+    DLFLSyncKey newKey( ) { return ((DLFLSyncKey)peerid << 32) | serial++; };
+
+    bool diffCoords( DLFLObjectPtr obj, DLFLSyncDelta& d );
+    void diffAll( DLFLObjectPtr obj, DLFLSyncDelta& d );
+    void pointers( DLFLObjectPtr obj );
+    void dropFace( uint id, DLFLFacePtrArray& dropped );
+    void stamp( DLFLObjectPtr obj );
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_SYNC_HH_ */
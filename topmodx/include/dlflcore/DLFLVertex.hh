@@ -54,9 +54,7 @@ namespace DLFL {
 
     // Generate a new unique ID
     static uint newID(void) {
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return fetchAndIncrement(suLastID);
     };
      
   public :
@@ -78,7 +76,11 @@ namespace DLFL {
 
     // Assign a unique ID for this instance
     void assignID(void) {
-      uID = DLFLVertex :: newID();
+      assignID(DLFLVertex :: newID());
+    };
+
+    void assignID(uint id) {
+      uID = id;
       index = 0;
       ismarked = 0;
 		 isvisited = 0;
@@ -136,6 +138,17 @@ namespace DLFL {
       assignID();
     }
 
+    // Same as above with the new ID given by the caller.
+    // DLFLObject uses this to number its vertices
+    void makeUnique(uint id) {
+      assignID(id);
+    }
+
+    // Change only the ID. Done by DLFLObject when the vertex is added to it
+    void setID(uint id) {
+      uID = id;
+    }
+
     friend void makeVertexUnique(DLFLVertexPtr dvp);
 /*
     friend void makeVertexUnique(DLFLVertexPtr dvp) {
@@ -156,6 +169,15 @@ namespace DLFL {
       return fvpList;
     }
 
+    // Walk the corners of this vertex without copying the list
+    DLFLFaceVertexPtrList::const_iterator beginFaceVertex(void) const {
+      return fvpList.begin();
+    }
+
+    DLFLFaceVertexPtrList::const_iterator endFaceVertex(void) const {
+      return fvpList.end();
+    }
+
     // Number of Edges incident on this Vertex = no. of Faces adjacent to this Vertex
     // = size of the FaceVertex list = valence of Vertex
     uint numEdges(void) const {
@@ -218,6 +240,10 @@ namespace DLFL {
       coords = p;
     }
 
+    void setIndex(uint i) {
+      index = i;
+    }
+
     // Set the aux. coords
     void setAuxCoords(const Vector3d& p) {
       auxcoords = p;
@@ -0,0 +1,118 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/**
+ * \file DLFLWriteBuffer.cc
+ */
+
+#include "DLFLWriteBuffer.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+namespace DLFL {
+
+  // Powers of ten, exact in double up to 1e22
+  static const double powersoften[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  void DLFLWriteBuffer::putDoubleSlow( double x ) {
+    char s[64];
+    int n = snprintf(s,sizeof(s),"%.*g",precision,x);
+    if ( n > 0 ) put(s,(n < (int)sizeof(s)) ? n : sizeof(s)-1);
+  }
+
+  void DLFLWriteBuffer::putDouble( double x ) {
+    // Fast path for the numbers found in meshes: %g in fixed notation with
+    // few digits. Anything the scaled integer can't round with certainty
+    // (ties, exponent notation, inf, nan) goes through snprintf
+    if ( x == 0.0 ) {
+      if ( signbit(x) ) put("-0",2); else put('0');
+      return;
+    }
+    double ax = fabs(x);
+    if ( precision > 9 || !(ax >= 1e-4 && ax < 1e9) ) {
+      putDoubleSlow(x); return;
+    }
+
+    // Decimal exponent, corrected below if log10 is off by one
+    int e = (int)floor(log10(ax));
+    double lo = powersoften[precision-1], hi = powersoften[precision];
+    double scaled = 0.0;
+    for (int tries = 0; tries < 2; ++tries) {
+      int k = precision - 1 - e;
+      scaled = ( k >= 0 ) ? ax * powersoften[k] : ax / powersoften[-k];
+      if ( scaled < lo ) --e;
+      else if ( scaled >= hi ) ++e;
+      else break;
+    }
+    if ( scaled < lo || scaled >= hi ) { putDoubleSlow(x); return; }
+
+    double m = floor(scaled);
+    double frac = scaled - m;
+    if ( fabs(frac - 0.5) < 1e-6 ) { putDoubleSlow(x); return; }
+    if ( frac > 0.5 ) m += 1.0;
+    if ( m >= hi ) { m = lo; ++e; }
+    if ( e < -4 || e >= precision ) { putDoubleSlow(x); return; }
+
+    // precision digits of m with the decimal point after e+1 of them
+    char d[16];
+    unsigned long n = (unsigned long)m;
+    for (int i = precision-1; i >= 0; --i) { d[i] = '0' + n % 10; n /= 10; }
+    int ndigits = precision;
+    int point = e + 1;                     // Digits before the point
+    int last = ndigits;
+    while ( last > 0 && last > point && d[last-1] == '0' ) --last;
+
+    char s[32]; int len = 0;
+    if ( x < 0.0 ) s[len++] = '-';
+    if ( point <= 0 ) {
+      s[len++] = '0'; s[len++] = '.';
+      for (int i = point; i < 0; ++i) s[len++] = '0';
+      for (int i = 0; i < last; ++i) s[len++] = d[i];
+    } else {
+      for (int i = 0; i < point; ++i) s[len++] = d[i];
+      if ( last > point ) {
+        s[len++] = '.';
+        for (int i = point; i < last; ++i) s[len++] = d[i];
+      }
+    }
+    put(s,len);
+  }
+
+  void DLFLWriteBuffer::putFloat32LE( float f ) {
+    unsigned int n;
+    memcpy(&n,&f,4);
+    putUInt32LE(n);
+  }
+
+} // end namespace
@@ -0,0 +1,147 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/**
+ * \file DLFLWriteBuffer.hh
+ */
+
+#ifndef _DLFL_WRITE_BUFFER_HH_
+#define _DLFL_WRITE_BUFFER_HH_
+
+// Output buffer for the file exporters. Text is collected in a large block
+// and handed to the stream with a single write, instead of going through
+// operator << for every token. Floating point numbers are formatted like an
+// ostream with default flags does (%g with the stream's precision), so files
+// come out byte for byte the same as before.
+//
+// A buffer can also collect into a string, which lets the exporters format
+// parts of a file on several threads and write the parts in order.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace DLFL {
+
+  class DLFLWriteBuffer {
+  protected :
+
+    ostream * stream;          // Destination stream, or
+    string * str;              // destination string
+    vector<char> buf;
+    size_t len;                // Bytes in buf
+    int precision;             // Significant digits for doubles
+
+    void putDoubleSlow( double x );
+
+  public :
+
+    // Write to a stream, with the stream's precision
+    DLFLWriteBuffer( ostream& o, size_t size = 1<<20 )
+      : stream(&o), str(NULL), buf(size), len(0), precision(o.precision()) {
+      if ( precision <= 0 ) precision = 6;
+    }
+
+    // Append to a string
+    DLFLWriteBuffer( string& s, int prec = 6, size_t size = 1<<16 )
+      : stream(NULL), str(&s), buf(size), len(0), precision(prec) {
+      if ( precision <= 0 ) precision = 6;
+    }
+
+    ~DLFLWriteBuffer( ) { flush(); }
+
+    int getPrecision( ) const { return precision; }
+
+    void flush( ) {
+      if ( len == 0 ) return;
+      if ( stream ) stream->write(&buf[0],len);
+      else str->append(&buf[0],len);
+      len = 0;
+    }
+
+    // Make room for n more bytes. Large blocks are passed on directly
+    void reserve( size_t n ) {
+      if ( len + n > buf.size() ) flush();
+    }
+
+    void put( char c ) {
+      if ( len == buf.size() ) flush();
+      buf[len++] = c;
+    }
+
+    void put( const char * s, size_t n ) {
+      reserve(n);
+      if ( n > buf.size() ) {
+        if ( stream ) stream->write(s,n); else str->append(s,n);
+        return;
+      }
+      for (size_t i=0; i < n; ++i) buf[len+i] = s[i];
+      len += n;
+    }
+
+    void put( const char * s ) {
+      for (; *s; ++s) put(*s);
+    }
+
+    void put( const string& s ) {
+      put(s.data(),s.size());
+    }
+
+    void putUInt( unsigned long n ) {
+      char d[24]; int i = 24;
+      do { d[--i] = '0' + n % 10; n /= 10; } while ( n );
+      put(d+i,24-i);
+    }
+
+    void putInt( long n ) {
+      if ( n < 0 ) { put('-'); putUInt(0UL - (unsigned long)n); }
+      else putUInt(n);
+    }
+
+    // Same text as ostream << x with default flags
+    void putDouble( double x );
+
+    // Little endian binary values, for binary formats
+    void putUInt16LE( unsigned short n ) {
+      put((char)(n & 0xff)); put((char)(n >> 8));
+    }
+
+    void putUInt32LE( unsigned int n ) {
+      put((char)(n & 0xff)); put((char)((n >> 8) & 0xff));
+      put((char)((n >> 16) & 0xff)); put((char)(n >> 24));
+    }
+
+    void putFloat32LE( float f );
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_WRITE_BUFFER_HH_ */
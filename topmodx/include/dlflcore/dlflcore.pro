@@ -7,6 +7,27 @@ TARGET = dlflcore
 INCLUDEPATH += .. ../vecmat
 DESTDIR = ../../lib
 
+# count heap allocations for the profiler (DLFLProfile). This replaces the
+# global operator new and delete of every program linked with dlflcore, so it
+# is off by default. Turn it on with qmake "CONFIG+=WITH_ALLOC_COUNT", the
+# profiler reports -1 allocations without it
+
+CONFIG(WITH_ALLOC_COUNT){
+ DEFINES *= WITH_ALLOC_COUNT
+}
+
+# exporters format the file on several threads, comment out to build single threaded
+CONFIG += WITH_OPENMP
+
+CONFIG(WITH_OPENMP){
+ DEFINES *= WITH_OPENMP
+ win32-msvc* {
+  QMAKE_CXXFLAGS += -openmp
+ } else {
+  QMAKE_CXXFLAGS += -fopenmp
+ }
+}
+
 macx {
  # compile release + universal binary
  #QMAKE_LFLAGS += -F../../lib
@@ -23,6 +44,7 @@ else:win32 {
 }
 
 HEADERS += \
+	DLFLAdjacency.hh \
 	DLFLCommon.hh \
 	DLFLCore.hh \
 	DLFLCoreExt.hh \
@@ -30,10 +52,17 @@ HEADERS += \
 	DLFLFace.hh \
 	DLFLFaceVertex.hh \
 	DLFLMaterial.hh \
+	DLFLNormals.hh \
 	DLFLObject.hh \
-	DLFLVertex.hh
+	DLFLProfile.hh \
+	DLFLProgress.hh \
+	DLFLSelection.hh \
+	DLFLSync.hh \
+	DLFLVertex.hh \
+	DLFLWriteBuffer.hh
 
 SOURCES += \
+	DLFLAdjacency.cc \
 	DLFLCommon.cc \
 	DLFLCore.cc \
 	DLFLCoreExt.cc \
@@ -42,5 +71,11 @@ SOURCES += \
 	DLFLFaceVertex.cc \
 	DLFLFile.cc \
         DLFLFileAlt.cc \
+	DLFLNormals.cc \
 	DLFLObject.cc \
-	DLFLVertex.cc
+	DLFLProfile.cc \
+	DLFLProgress.cc \
+	DLFLSelection.cc \
+	DLFLSync.cc \
+	DLFLVertex.cc \
+	DLFLWriteBuffer.cc
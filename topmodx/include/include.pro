@@ -6,5 +6,6 @@ SUBDIRS = \
 	vecmat \
 #	arcball \
 	dlflcore \
-	dlflaux
+	dlflaux \
+	dlflbench
   
@@ -104,6 +104,7 @@ static PyObject *dlfl_subdivide(PyObject *self, PyObject *args);
 static PyObject *dlfl_subdivide_face(PyObject *self, PyObject *args);
 static PyObject *dlfl_subdivide_faces(PyObject *self, PyObject *args);
 static PyObject *dlfl_dual(PyObject *self, PyObject *args);
+static PyObject *dlfl_weld(PyObject *self, PyObject *args);
 static PyObject *dlfl_connectEdges(PyObject *self, PyObject *args);
 static PyObject *dlfl_connectCorners(PyObject *self, PyObject *args);
 static PyObject *dlfl_connectFaces(PyObject *self, PyObject *args);
@@ -171,6 +172,7 @@ static PyMethodDef DLFLMethods[] = {
   {"subdivideFace",  dlfl_subdivide_face, METH_VARARGS, "Subdivide a Face"},
   {"subdivideFaces",  dlfl_subdivide_faces, METH_VARARGS, "Subdivide a list of Faces"},
   {"dual",           dlfl_dual,           METH_VARARGS, "Dual of mesh"},
+  {"weld",           dlfl_weld,           METH_VARARGS, "Merge vertices closer than the tolerance (default 1e-6). Returns the number of vertices removed"},
   {"connectEdges",   dlfl_connectEdges,   METH_VARARGS, "Connect an edge on one face with another"},
   {"connectCorners", dlfl_connectCorners, METH_VARARGS, "Connect two corners (i.e. Add Hole/Handle)"},
   {"connectFaces",   dlfl_connectFaces,   METH_VARARGS, "Connect two faces (i.e. Add Hole/Handle Closest Vertex)"},
@@ -1325,6 +1327,20 @@ PyObject *dlfl_dual(PyObject *self, PyObject *args)
   return Py_None;
 }
 
+static 
+PyObject *dlfl_weld(PyObject *self, PyObject *args) 
+{
+  double tolerance = 1.0e-6;
+  int welded = 0;
+  if( !PyArg_ParseTuple(args, "|d", &tolerance) )
+    return NULL;
+  if( currObj ) {
+    welded = currObj->weldVertices( tolerance );
+    currObj->clearSelected( );
+  }
+  return Py_BuildValue("i", welded );
+}
+
 static PyObject *dlfl_connectEdges(PyObject *self, PyObject *args) { 
 	int edgeId1, edgeId2;
 	int faceId1, faceId2;
@@ -1461,15 +1477,16 @@ static PyObject *dlfl_rindmodel(PyObject *self, PyObject *args) {
 			if(fp) { faces.push_back(fp); }
 		}
 
+		DLFL::CrustInfo crust;
 		if( useScaling ) {
-			DLFL::createCrustWithScaling( currObj, thickScale );
+			DLFL::createCrustWithScaling( currObj, crust, thickScale );
 		} else {
-			DLFL::createCrust( currObj, thickScale, uniform );
+			DLFL::createCrust( currObj, crust, thickScale, uniform );
 		}
 
 		for( it = faces.begin(); it != faces.end(); it++ )
 			(*it)->setType(DLFL::FTHole);
-		DLFL::punchHoles(currObj);
+		DLFL::punchHoles(currObj,crust);
 	}
 
 	Py_INCREF(Py_None);
@@ -0,0 +1,204 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file synctest.cc
+ */
+
+// Test of DLFLSyncSession: a host and a client in one process, connected over
+// localhost. The object of the host goes to the client when it joins, after
+// that edits on either side have to show up on the other. Faces which aren't
+// part of an edit have to keep their ID, material and texture coordinates,
+// and saving the object must not renumber its vertices.
+//
+//   synctest [port]
+
+#include "DLFLSyncSession.hh"
+
+#include <DLFLObject.hh>
+#include <DLFLCore.hh>
+#include <DLFLExtrude.hh>
+
+#include <QCoreApplication>
+#include <QTime>
+
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static const char * cubeobj =
+	"v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\n"
+	"v -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n"
+	"f 1 4 3 2\nf 5 6 7 8\nf 1 2 6 5\nf 2 3 7 6\nf 3 4 8 7\nf 4 1 5 8\n";
+
+static int failures = 0;
+
+static void check( bool ok, const char *what ) {
+	printf("%-40s %s\n", what, ok ? "ok" : "FAILED");
+	if ( !ok ) ++failures;
+}
+
+// The faces as their corner coordinates, starting at the smallest, sorted.
+// Two objects with the same mesh give the same string whatever the IDs are
+static string canonical( DLFLObject& obj ) {
+	vector<string> faces;
+	DLFLFacePtrList::iterator ff = obj.beginFace(), fl = obj.endFace();
+	for (; ff != fl; ++ff) {
+		vector<string> corners;
+		DLFLFaceVertexPtr head = (*ff)->front(), current = head;
+		do {
+			char buf[128];
+			const Vector3d& c = current->vertex->coords;
+			sprintf(buf, "%.17g %.17g %.17g", c[0], c[1], c[2]);
+			corners.push_back(buf);
+			current = current->next();
+		} while ( current != head );
+		size_t first = min_element(corners.begin(), corners.end()) - corners.begin();
+		string face;
+		for (size_t i=0; i < corners.size(); ++i) face += corners[(first+i) % corners.size()] + ";";
+		faces.push_back(face);
+	}
+	sort(faces.begin(), faces.end());
+	stringstream s;
+	s << obj.num_vertices() << " " << obj.num_edges() << " " << obj.num_faces() << "\n";
+	for (size_t i=0; i < faces.size(); ++i) s << faces[i] << "\n";
+	return s.str();
+}
+
+// Every corner is on its vertex and points to an edge which has it as a side
+static bool connected( DLFLObject& obj ) {
+	DLFLFacePtrList::iterator ff = obj.beginFace(), fl = obj.endFace();
+	for (; ff != fl; ++ff) {
+		DLFLFaceVertexPtr head = (*ff)->front(), current = head;
+		do {
+			DLFLEdgePtr ep = current->getEdgePtr();
+			if ( ep == NULL ) return false;
+			if ( ep->getFaceVertexPtr1() != current && ep->getFaceVertexPtr2() != current ) return false;
+			if ( find(current->vertex->beginFaceVertex(), current->vertex->endFaceVertex(), current) == current->vertex->endFaceVertex() ) return false;
+			current = current->next();
+		} while ( current != head );
+	}
+	return true;
+}
+
+// Run both sessions until the objects are the same, or for two seconds
+static bool exchange( DLFLSyncSession& a, DLFLObject& oa, DLFLSyncSession& b, DLFLObject& ob ) {
+	DLFLVertexPtrArray moved;
+	QTime clock;
+	clock.start();
+	while ( clock.elapsed() < 2000 ) {
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+		a.update(&oa, moved);
+		b.update(&ob, moved);
+		if ( clock.elapsed() > 100 && canonical(oa) == canonical(ob) ) return true;
+	}
+	return false;
+}
+
+int main( int argc, char **argv ) {
+	QCoreApplication app(argc, argv);
+	quint16 port = ( argc > 1 ) ? (quint16)atoi(argv[1]) : (quint16)DLFLSyncSession::DefaultPort;
+
+	DLFLObject hostobj, clientobj;
+	istringstream obj(cubeobj), mtl("");
+	hostobj.readObject(obj, mtl);
+	hostobj.computeNormals();
+
+	DLFLSyncSession host, client;
+	check(host.host(port), "host");
+	client.join("127.0.0.1", port);
+	check(exchange(host, hostobj, client, clientobj), "client gets the object");
+	check(connected(clientobj), "client edges");
+
+	// The host paints its faces and sets texture coordinates
+	DLFLMaterialPtr red = hostobj.addMaterial(RGBColor(1,0,0));
+	DLFLFacePtrList::iterator ff = hostobj.beginFace(), fl = hostobj.endFace();
+	for (; ff != fl; ++ff) {
+		(*ff)->setMaterial(red);
+		DLFLFaceVertexPtr head = (*ff)->front(), current = head;
+		do {
+			current->texcoord.set(current->vertex->getID(), 1);
+			current = current->next();
+		} while ( current != head );
+	}
+	vector<uint> ids;
+	for (ff = hostobj.beginFace(); ff != fl; ++ff) ids.push_back((*ff)->getID());
+
+	// The client extrudes a face, the host gets the new faces
+	extrudeFace(&clientobj, clientobj.firstFace(), 1.0);
+	clientobj.computeNormals();
+	check(exchange(host, hostobj, client, clientobj), "host gets the extrusion");
+	check(connected(hostobj), "host edges");
+
+	// Only the extruded face has other corners, the sides are new
+	uint kept = 0, painted = 0, textured = 0;
+	for (ff = hostobj.beginFace(); ff != fl; ++ff) {
+		if ( find(ids.begin(), ids.end(), (*ff)->getID()) != ids.end() ) ++kept;
+		if ( (*ff)->material() == red ) ++painted;
+		bool same = true;
+		DLFLFaceVertexPtr head = (*ff)->front(), current = head;
+		do {
+			if ( current->texcoord[0] != current->vertex->getID() ) same = false;
+			current = current->next();
+		} while ( current != head );
+		if ( same ) ++textured;
+	}
+	check(hostobj.num_faces() == 10, "host has 10 faces");
+	check(kept == 6, "face IDs kept");
+	check(painted == 6, "materials kept");
+	check(textured >= 5, "texture coordinates kept");
+
+	// The host moves a vertex
+	hostobj.firstVertex()->coords += Vector3d(0.0, 0.0, 0.5);
+	hostobj.touch();
+	check(exchange(host, hostobj, client, clientobj), "client gets the move");
+
+	// The host collapses an edge, which leaves a gap in its vertex IDs, and
+	// saves between two diffs. Saving must keep the IDs, the sync knows the
+	// vertices by them
+	collapseEdge(&hostobj, hostobj.firstEdge());
+	hostobj.computeNormals();
+	check(exchange(host, hostobj, client, clientobj), "client gets the collapse");
+	vector<uint> vids, saved;
+	DLFLVertexPtrList::iterator vf, vl = hostobj.endVertex();
+	for (vf = hostobj.beginVertex(); vf != vl; ++vf) vids.push_back((*vf)->getID());
+	ostringstream objout, mtlout;
+	hostobj.writeObject(objout, mtlout);
+	for (vf = hostobj.beginVertex(); vf != vl; ++vf) saved.push_back((*vf)->getID());
+	check(saved == vids, "save keeps the vertex IDs");
+	hostobj.lastVertex()->coords += Vector3d(0.5, 0.0, 0.0);
+	hostobj.touch();
+	check(exchange(host, hostobj, client, clientobj), "client gets the move after the save");
+
+	client.leave();
+	check(!client.isActive(), "client left");
+
+	printf("%d failed\n", failures);
+	return failures;
+}
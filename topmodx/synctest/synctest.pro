@@ -0,0 +1,36 @@
+TEMPLATE = app
+CONFIG += qt console warn_off
+QT -= gui
+QT += network
+TARGET = synctest
+INCLUDEPATH += .. ../include ../include/vecmat ../include/dlflcore ../include/dlflaux
+
+# Two session instances in one process, talking over localhost. Build the
+# libraries first (see makeall.sh), then run synctest [port]. Prints a line
+# per check and exits with the number of failed checks.
+
+LIBS += -L../lib -ldlflaux -ldlflcore -lvecmat
+PRE_TARGETDEPS += ../lib/libdlflaux.a ../lib/libdlflcore.a ../lib/libvecmat.a
+
+# the libraries are built with OpenMP, comment out if they are not
+CONFIG += WITH_OPENMP
+
+CONFIG(WITH_OPENMP){
+ win32-msvc* {
+  QMAKE_CXXFLAGS += -openmp
+ } else {
+  QMAKE_CXXFLAGS += -fopenmp
+  QMAKE_LFLAGS += -fopenmp
+ }
+}
+
+macx {
+ CONFIG -= app_bundle
+}
+
+HEADERS += \
+	../DLFLSyncSession.hh
+
+SOURCES += \
+	../DLFLSyncSession.cc \
+	synctest.cc
@@ -12,7 +12,7 @@ QT_VERSTR = '\\"$${QTVERSION}\\"'  # place quotes around the version string
 DEFINES += QT_VER=\"$${QT_VERSTR}\" # create a QT_VER macro containing the version string
 
 # main stuff
-QT += opengl xml
+QT += opengl xml network
 CONFIG += qt debug warn_off link_prl
 
 QMAKE_CXXFLAGS_DEBUG += -pg
@@ -20,9 +20,12 @@ QMAKE_LFLAGS_DEBUG += -pg
 
 # exclude verse python or spacenav drivers
 # or include them with CONFIG += 
-CONFIG -=  WITH_PYTHON WITH_SPACENAV WITH_VERSE
+CONFIG -=  WITH_PYTHON WITH_SPACENAV WITH_VERSE WITH_OPENMP
 CONFIG += WITH_PYTHON 
 
+# multithreaded mesh/patch evaluation, comment out to build single threaded
+CONFIG += WITH_OPENMP
+
 # to include the popup command line interface leave the following line uncommented
 DEFINES *= QCOMPLETER
 
@@ -75,6 +78,17 @@ CONFIG(WITH_PYTHON){
 	DEFINES *= WITH_PYTHON
 }
 
+CONFIG(WITH_OPENMP){
+	message("OpenMP support will be included")
+	DEFINES *= WITH_OPENMP
+	win32-msvc* {
+		QMAKE_CXXFLAGS += -openmp
+	} else {
+		QMAKE_CXXFLAGS += -fopenmp
+		QMAKE_LFLAGS += -fopenmp
+	}
+}
+
 CONFIG(WITH_SPACENAV){
 	message("SPACENAV support will be included")
 	DEFINES *= WITH_SPACENAV
@@ -182,10 +196,13 @@ macx {
 # Input
 HEADERS += \
 	DLFLScriptEditor.hh \
+	DLFLScriptThread.hh \
 	TopModPreferences.hh \
 	TdxDeviceWrappers.hh \
 	CommandCompleter.hh \
 	DLFLLocator.hh \
+	DLFLExecutor.hh \
+	DLFLSyncSession.hh \
 	GLWidget.hh \
 	TopMod.hh \
 	MainWindow.hh \
@@ -227,12 +244,15 @@ HEADERS += \
 	include/Light/SpotLight.hh \
 	CgData.hh \
 	# include/Camera2.hh \
-	include/Camera3.hh
+	include/Camera3.hh \
+	include/TextureCache.hh \
+	include/SilhouetteExtractor.hh
 
 FORMS += shortcutdialog.ui stylesheeteditor.ui
 
 SOURCES += \
 	DLFLScriptEditor.cc \
+	DLFLScriptThread.cc \
 	TopModPreferences.cc \
 	TdxDeviceWrappers.cc \
 	GLWidget.cc \
@@ -259,11 +279,15 @@ SOURCES += \
 	# DLFLSculpting.cc \
 	DLFLUndo.cc \
 	DLFLLocator.cc \
+	DLFLExecutor.cc \
+	DLFLSyncSession.cc \
 	TMPatchObject.cc \
 	TMPatchFace.cc \
 	stylesheeteditor.cc \
 	CgData.cc \
 	include/Camera3.cc \
+	include/TextureCache.cc \
+	include/SilhouetteExtractor.cc \
 	CommandCompleter.cc
 
 RESOURCES += application.qrc